@@ -17,6 +17,9 @@ pub struct CacheBuildOptions {
     pub release: bool,
     pub lto: bool,
     pub emit_ir: bool,
+    /// Resolved optimization level, as its `-O` suffix (`"0"` to `"3"`, `"s"`, `"z"`)
+    pub opt_level: String,
+    pub inline_threshold: Option<u32>,
 }
 
 /// Compilation inputs for caching
@@ -1,5 +1,6 @@
 use std::collections::HashMap;
-use std::path::PathBuf;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
 
 /// Compilation cache manager
 pub struct CacheManager {
@@ -42,20 +43,24 @@ impl CacheManager {
         self.entries.clear();
     }
 
+    /// Cache key for a build: changes whenever the source, its modules, any
+    /// option that affects the emitted binary, or the compiler version does.
     pub fn fingerprint(
         &self,
-        _inputs: &super::CompilationInputs,
-        _options: &super::CacheBuildOptions,
-        _version: &str,
+        inputs: &super::CompilationInputs,
+        options: &super::CacheBuildOptions,
+        version: &str,
     ) -> String {
-        // Simple fingerprinting - in a real implementation this would hash the inputs
-        format!(
-            "cache_key_{}",
-            std::time::SystemTime::now()
-                .duration_since(std::time::UNIX_EPOCH)
-                .unwrap()
-                .as_secs()
-        )
+        let mut hasher = DefaultHasher::new();
+        version.hash(&mut hasher);
+        hash_file(&inputs.source_path, &mut hasher);
+        for module in inputs.dependencies.iter().chain(&inputs.imports) {
+            hash_file(Path::new(module), &mut hasher);
+        }
+        // Cache location and size limits do not change the binary.
+        (options.release, options.lto, options.emit_ir).hash(&mut hasher);
+        (&options.opt_level, options.inline_threshold).hash(&mut hasher);
+        format!("cache_key_{:016x}", hasher.finish())
     }
 
     pub fn lookup(&self, key: &str) -> Option<CacheEntry> {
@@ -81,3 +86,50 @@ impl CacheManager {
         Ok(())
     }
 }
+
+/// Hashes a file's path and contents; an unreadable file contributes its path.
+fn hash_file(path: &Path, hasher: &mut DefaultHasher) {
+    path.hash(hasher);
+    std::fs::read(path).ok().hash(hasher);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{CacheBuildOptions, CompilationInputs};
+
+    fn options(opt_level: &str, inline_threshold: Option<u32>) -> CacheBuildOptions {
+        CacheBuildOptions {
+            enable_cache: true,
+            cache_dir: PathBuf::from("cache"),
+            max_cache_size: 0,
+            release: false,
+            lto: false,
+            emit_ir: false,
+            opt_level: opt_level.to_string(),
+            inline_threshold,
+        }
+    }
+
+    #[test]
+    fn fingerprint_is_stable_and_keyed_on_codegen_settings() {
+        let manager = CacheManager::new();
+        let inputs = CompilationInputs::new(PathBuf::from("missing.ot"), Vec::new());
+        let key = |options: &CacheBuildOptions| manager.fingerprint(&inputs, options, "1.0");
+
+        let base = key(&options("2", None));
+        assert_eq!(base, key(&options("2", None)));
+        assert_ne!(base, key(&options("3", None)));
+        assert_ne!(base, key(&options("s", None)));
+        assert_ne!(base, key(&options("2", Some(500))));
+        assert_ne!(key(&options("2", Some(100))), key(&options("2", Some(500))));
+        assert_ne!(
+            base,
+            manager.fingerprint(&inputs, &options("2", None), "1.1")
+        );
+
+        let mut relocated = options("2", None);
+        relocated.cache_dir = PathBuf::from("elsewhere");
+        assert_eq!(base, key(&relocated));
+    }
+}
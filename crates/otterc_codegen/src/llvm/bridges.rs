@@ -4,14 +4,20 @@ use std::path::PathBuf;
 use anyhow::{Context, Result, bail};
 use libloading::Library;
 use otterc_ast::nodes::{Program, Statement};
-use otterc_ffi::{BridgeSymbolRegistry, CargoBridge, DynamicLibraryLoader, FunctionSpec, TypeSpec};
+use otterc_ffi::{
+    BridgeLinkage, BridgeSymbolRegistry, CargoBridge, DynamicLibraryLoader, FunctionSpec, TypeSpec,
+};
 
 use otterc_ffi::register_dynamic_exports;
+use otterc_ffi::rust_stubgen::json_dispatch_symbol;
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
+/// Builds and registers every `use rust:` bridge in `program`, returning the
+/// library each one should be linked from under `linkage`.
 pub(crate) fn prepare_rust_bridges(
     program: &Program,
     registry: &SymbolRegistry,
+    linkage: BridgeLinkage,
 ) -> Result<Vec<PathBuf>> {
     let imports = collect_rust_imports(program);
     if imports.is_empty() {
@@ -25,7 +31,10 @@ pub(crate) fn prepare_rust_bridges(
 
     for (crate_name, aliases) in imports {
         let metadata = bridge_registry.ensure_metadata(&crate_name)?;
-        let artifacts = cargo_bridge.ensure_bridge(&crate_name)?;
+        let artifacts = match linkage {
+            BridgeLinkage::Dynamic => cargo_bridge.ensure_bridge(&crate_name)?,
+            BridgeLinkage::Static => cargo_bridge.ensure_static_bridge(&crate_name)?,
+        };
         loader.load(&artifacts.library_path).with_context(|| {
             format!("failed to load Rust bridge library for crate `{crate_name}`")
         })?;
@@ -40,8 +49,18 @@ pub(crate) fn prepare_rust_bridges(
             register_dynamic_exports(&lib, registry)?;
         }
         // Also register planned functions to ensure symbol aliases are available immediately
-        register_bridge_functions(&crate_name, &aliases, &metadata.functions, registry)?;
-        libraries.push(artifacts.library_path.clone());
+        register_bridge_functions(
+            &crate_name,
+            &json_dispatch_symbol(&metadata.dependency.name),
+            &aliases,
+            &metadata.functions,
+            registry,
+        )?;
+        libraries.push(
+            artifacts
+                .static_library_path
+                .unwrap_or(artifacts.library_path),
+        );
     }
 
     Ok(libraries)
@@ -74,6 +93,7 @@ fn collect_rust_imports(program: &Program) -> HashMap<String, HashSet<String>> {
 
 fn register_bridge_functions(
     crate_name: &str,
+    dispatch_symbol: &str,
     aliases: &HashSet<String>,
     functions: &[FunctionSpec],
     registry: &SymbolRegistry,
@@ -121,14 +141,14 @@ fn register_bridge_functions(
 
     registry.register(FfiFunction {
         name: format!("{crate_name}.__call_json"),
-        symbol: "otter_call_json".into(),
+        symbol: dispatch_symbol.into(),
         signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str),
     });
 
     for alias in aliases {
         registry.register(FfiFunction {
             name: format!("{alias}.__call_json"),
-            symbol: "otter_call_json".into(),
+            symbol: dispatch_symbol.into(),
             signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str),
         });
     }
@@ -13,6 +13,7 @@ use otterc_ast::nodes::Program;
 use otterc_span::Span;
 
 use otterc_config::{CodegenOptLevel, CodegenOptions, TargetTriple};
+use otterc_ffi::BridgeLinkage;
 use otterc_typecheck::{EnumLayout, TypeInfo};
 
 use super::bridges::prepare_rust_bridges;
@@ -132,7 +133,12 @@ pub fn build_executable(
     let module = context.create_module("otter");
     let builder = context.create_builder();
     let registry = otterc_ffi::bootstrap_stdlib();
-    let bridge_libraries = prepare_rust_bridges(program, registry)?;
+    let bridge_linkage = if options.static_bridges {
+        BridgeLinkage::Static
+    } else {
+        BridgeLinkage::Dynamic
+    };
+    let bridge_libraries = prepare_rust_bridges(program, registry, bridge_linkage)?;
 
     // Determine target triple early so compiler can use it for ABI decisions
     Target::initialize_all(&InitializationConfig::default());
@@ -215,22 +221,33 @@ pub fn build_executable(
         options.pgo_profile_file.as_deref(),
         options.inline_threshold,
         &target_machine,
-    );
+    )?;
 
     if let Some(parent) = output.parent() {
         fs::create_dir_all(parent)
             .with_context(|| format!("failed to create output directory {}", parent.display()))?;
     }
 
+    // Static bridges are bitcode, so emit the Otter module as bitcode as well
+    // and let the linker's LTO pass optimise across the language boundary.
+    let cross_language_lto =
+        bridge_linkage == BridgeLinkage::Static && !bridge_libraries.is_empty();
+
     let object_path = output.with_extension("o");
-    target_machine
-        .write_to_file(&compiler.module, FileType::Object, &object_path)
-        .map_err(|e| {
-            anyhow!(
-                "failed to emit object file at {}: {e}",
-                object_path.display()
-            )
-        })?;
+    if cross_language_lto {
+        if !compiler.module.write_bitcode_to_path(&object_path) {
+            bail!("failed to emit bitcode at {}", object_path.display());
+        }
+    } else {
+        target_machine
+            .write_to_file(&compiler.module, FileType::Object, &object_path)
+            .map_err(|e| {
+                anyhow!(
+                    "failed to emit object file at {}: {e}",
+                    object_path.display()
+                )
+            })?;
+    }
 
     // Build and link the runtime static library (check once)
     let runtime_lib = find_runtime_library(&runtime_triple)?;
@@ -290,8 +307,13 @@ pub fn build_executable(
         None
     };
 
-    // Link the object files together (target-specific)
-    let linker = runtime_triple.linker();
+    // Link the object files together (target-specific). Instrumented builds
+    // link through clang, which knows where its profiling runtime lives.
+    let linker = if options.pgo_instrument() && !runtime_triple.is_wasm() {
+        "clang".to_string()
+    } else {
+        runtime_triple.linker()
+    };
     let mut cc = Command::new(&linker);
 
     // Add target-specific linker flags
@@ -351,31 +373,29 @@ pub fn build_executable(
         cc.arg(&flag);
     }
 
-    if options.enable_lto && !runtime_triple.is_wasm() {
+    if (options.enable_lto || cross_language_lto) && !runtime_triple.is_wasm() {
         cc.arg("-flto");
         // Note: clang doesn't support -flto=O2/O3, use -O flags instead
-        match options.opt_level {
-            CodegenOptLevel::None => {}
-            CodegenOptLevel::Default => {
-                cc.arg("-O2");
-            }
-            CodegenOptLevel::Aggressive => {
-                cc.arg("-O3");
-            }
+        if options.opt_level != CodegenOptLevel::None {
+            cc.arg(options.opt_level.driver_flag());
         }
     }
 
-    // PGO support: if profile file is provided, use it for optimization
-    if options.enable_pgo && !runtime_triple.is_wasm() {
-        if let Some(ref profile_file) = options.pgo_profile_file {
-            cc.arg("-fprofile-use");
-            cc.arg(profile_file);
-        } else {
-            // Generate profile instrumentation
-            cc.arg("-fprofile-instr-generate");
-        }
+    // The profile itself was applied to the IR; instrumented builds only
+    // need the profiling runtime that writes `.profraw` files at exit.
+    if options.pgo_instrument() && !runtime_triple.is_wasm() {
+        cc.arg("-fprofile-instr-generate");
+    }
+
+    if cross_language_lto && runtime_triple.os != "darwin" {
+        // The system linker cannot read rustc's bitcode; lld can.
+        cc.arg("-fuse-ld=lld");
     }
 
+    // Static bridges export only crate-scoped symbols, so any duplicate
+    // definition is a real conflict. The copies of std and shared
+    // dependencies each Rust staticlib bundles are identical archive members,
+    // and the linker only pulls the first one it needs.
     for lib in &bridge_libraries {
         cc.arg(lib);
     }
@@ -498,7 +518,7 @@ pub fn build_shared_library(
     let module = context.create_module("otter_jit");
     let builder = context.create_builder();
     let registry = otterc_ffi::bootstrap_stdlib();
-    let bridge_libraries = prepare_rust_bridges(program, registry)?;
+    let bridge_libraries = prepare_rust_bridges(program, registry, BridgeLinkage::Dynamic)?;
 
     // Initialize all LLVM targets before creating any target triples
     Target::initialize_all(&InitializationConfig::default());
@@ -575,7 +595,7 @@ pub fn build_shared_library(
         options.pgo_profile_file.as_deref(),
         options.inline_threshold,
         &target_machine,
-    );
+    )?;
 
     if let Some(parent) = output.parent() {
         fs::create_dir_all(parent)
@@ -664,7 +684,11 @@ pub fn build_shared_library(
     let use_rust_runtime = runtime_lib.exists();
 
     // Link as shared library (target-specific)
-    let linker = runtime_triple.linker();
+    let linker = if options.pgo_instrument() && !runtime_triple.is_wasm() {
+        "clang".to_string()
+    } else {
+        runtime_triple.linker()
+    };
     let mut cc = Command::new(&linker);
 
     let linker_target_flag = preferred_target_flag(&linker);
@@ -705,26 +729,15 @@ pub fn build_shared_library(
     if options.enable_lto && !runtime_triple.is_wasm() {
         cc.arg("-flto");
         // Note: clang doesn't support -flto=O2/O3, use -O flags instead
-        match options.opt_level {
-            CodegenOptLevel::None => {}
-            CodegenOptLevel::Default => {
-                cc.arg("-O2");
-            }
-            CodegenOptLevel::Aggressive => {
-                cc.arg("-O3");
-            }
+        if options.opt_level != CodegenOptLevel::None {
+            cc.arg(options.opt_level.driver_flag());
         }
     }
 
-    // PGO support: if profile file is provided, use it for optimization
-    if options.enable_pgo && !runtime_triple.is_wasm() {
-        if let Some(ref profile_file) = options.pgo_profile_file {
-            cc.arg("-fprofile-use");
-            cc.arg(profile_file);
-        } else {
-            // Generate profile instrumentation
-            cc.arg("-fprofile-instr-generate");
-        }
+    // The profile itself was applied to the IR; instrumented builds only
+    // need the profiling runtime that writes `.profraw` files at exit.
+    if options.pgo_instrument() && !runtime_triple.is_wasm() {
+        cc.arg("-fprofile-instr-generate");
     }
 
     for lib in &bridge_libraries {
@@ -0,0 +1,567 @@
+//! Bounds-check elimination for counted loops.
+//!
+//! `list.get_int(xs, i)` and `list.get_float(xs, i)` look the list up in the
+//! runtime's handle table and check `i` against it on every call. In a loop
+//! `for i in start..end` that reads `xs` only at `i + c` for constant offsets
+//! `c`, every index lies in `start + min(c) .. end + max(c)`, so a single
+//! check before the loop covers all of them.
+//!
+//! Codegen versions such loops. Before entering the loop, the runtime checks
+//! the range and copies those items into a buffer. The fast version then
+//! loads from the buffer with no checks and no calls, which LLVM can
+//! vectorize. If the range is not inside the list, the unchanged loop runs
+//! instead.
+//!
+//! Sometimes the check can only fail for a loop that runs zero times. That
+//! holds when the range is `start..len(xs)`, `start` is a constant no less
+//! than zero, and no offset takes an index outside `0..len(xs)`. In that case
+//! the checked version is left out.
+//!
+//! The copy is only sound if the body cannot change the list. The analysis
+//! rejects bodies that rebind the loop variable or the list. It also rejects
+//! bodies that build collections or leave the loop through `return`. It
+//! collects the name of every function the body calls, and codegen checks
+//! each callee's declared effects before versioning.
+//!
+//! The copy costs one pass over the whole range up front, which only pays
+//! off when the loop runs to the end. Bodies that can `break` out of the loop
+//! are therefore left alone, since a search that stops early would read far
+//! fewer items than it copies.
+
+use std::collections::{BTreeMap, HashSet};
+
+use otterc_ast::nodes::{BinaryOp, Block, Expr, Literal, Node, Statement};
+use otterc_symbol::registry::{FfiAccess, SymbolRegistry};
+
+/// Bodies larger than this are not duplicated.
+const MAX_BODY_STATEMENTS: usize = 64;
+
+/// Largest constant offset folded into a view.
+const MAX_OFFSET: i64 = 1 << 20;
+
+/// Element type of a list view, chosen by the getter it replaces.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum ViewKind {
+    Int,
+    Float,
+}
+
+impl ViewKind {
+    fn of_getter(name: &str) -> Option<Self> {
+        match name {
+            "list.get_int" => Some(Self::Int),
+            "list.get_float" => Some(Self::Float),
+            _ => None,
+        }
+    }
+
+    /// Runtime function that checks the range and copies the items.
+    pub(crate) fn constructor(self) -> &'static str {
+        match self {
+            Self::Int => "list.view_int",
+            Self::Float => "list.view_float",
+        }
+    }
+}
+
+/// A getter call of the form `list.get_*(list, index + offset)`.
+pub(crate) struct ViewAccess<'a> {
+    pub list: &'a str,
+    pub kind: ViewKind,
+    pub index: &'a str,
+    pub offset: i64,
+}
+
+/// Matches a call to `func_name` with `args` against [`ViewAccess`].
+pub(crate) fn view_access<'a>(func_name: &str, args: &'a [Node<Expr>]) -> Option<ViewAccess<'a>> {
+    let kind = ViewKind::of_getter(func_name)?;
+    let [list, index] = args else {
+        return None;
+    };
+    let Expr::Identifier(list) = list.as_ref() else {
+        return None;
+    };
+    let (index, offset) = split_index(index.as_ref())?;
+    Some(ViewAccess {
+        list,
+        kind,
+        index,
+        offset,
+    })
+}
+
+/// A list the fast version reads through a view.
+pub(crate) struct ViewSpec {
+    pub list: String,
+    pub kind: ViewKind,
+    pub min_offset: i64,
+    pub max_offset: i64,
+}
+
+pub(crate) struct RangeLoopPlan {
+    pub views: Vec<ViewSpec>,
+    /// Every function the body calls, by the name codegen resolves.
+    pub callees: HashSet<String>,
+    /// Whether the range check can only fail when the loop runs zero times.
+    pub in_bounds: bool,
+}
+
+impl RangeLoopPlan {
+    /// Whether no call in the body can modify a list. `verdict` answers for
+    /// the callees codegen resolves itself, such as user functions and
+    /// methods of local values; any other callee must be a runtime function
+    /// whose declared effects do not write runtime state.
+    pub(crate) fn calls_preserve_lists(
+        &self,
+        registry: &SymbolRegistry,
+        verdict: impl Fn(&str) -> Option<bool>,
+    ) -> bool {
+        self.callees.iter().all(|name| {
+            verdict(name).unwrap_or_else(|| {
+                registry.resolve(name).is_some_and(|function| {
+                    matches!(
+                        function.signature.effects.memory.runtime,
+                        FfiAccess::None | FfiAccess::Read
+                    )
+                })
+            })
+        })
+    }
+}
+
+/// Plans the versioning of `for var in start..end: body`. Returns `None` when
+/// the body reads no list through the loop variable, or cannot be versioned.
+pub(crate) fn plan_range_loop(
+    var: &str,
+    start: &Expr,
+    end: &Expr,
+    body: &Block,
+) -> Option<RangeLoopPlan> {
+    let size: usize = body
+        .statements
+        .iter()
+        .map(|stmt| stmt.as_ref().recursive_count())
+        .sum();
+    if size > MAX_BODY_STATEMENTS {
+        return None;
+    }
+
+    let mut analysis = LoopAnalysis {
+        var,
+        offsets: BTreeMap::new(),
+        callees: HashSet::new(),
+        bound: HashSet::new(),
+        loop_depth: 0,
+        eligible: true,
+    };
+    analysis.visit_block(body);
+    let LoopAnalysis {
+        offsets,
+        callees,
+        bound,
+        eligible,
+        ..
+    } = analysis;
+    if !eligible || bound.contains(var) {
+        return None;
+    }
+
+    let views: Vec<ViewSpec> = offsets
+        .into_iter()
+        .filter(|((list, _), _)| list != var && !bound.contains(list))
+        .map(|((list, kind), (min_offset, max_offset))| ViewSpec {
+            list,
+            kind,
+            min_offset,
+            max_offset,
+        })
+        .collect();
+    if views.is_empty() {
+        return None;
+    }
+
+    let in_bounds = int_literal(start).is_some_and(|start| {
+        start >= 0
+            && len_argument(end).is_some_and(|list| {
+                views.iter().all(|view| {
+                    view.list == list && view.min_offset >= -start && view.max_offset <= 0
+                })
+            })
+    });
+
+    Some(RangeLoopPlan {
+        views,
+        callees,
+        in_bounds,
+    })
+}
+
+struct LoopAnalysis<'a> {
+    var: &'a str,
+    /// Smallest and largest offset each list is read at through the loop
+    /// variable. Ordered so the views are built in a stable order.
+    offsets: BTreeMap<(String, ViewKind), (i64, i64)>,
+    callees: HashSet<String>,
+    /// Names the body assigns or binds.
+    bound: HashSet<String>,
+    /// Loops nested inside the body around the statement being visited.
+    loop_depth: usize,
+    eligible: bool,
+}
+
+impl LoopAnalysis<'_> {
+    fn visit_block(&mut self, block: &Block) {
+        for stmt in &block.statements {
+            self.visit_statement(stmt.as_ref());
+        }
+    }
+
+    fn visit_statement(&mut self, stmt: &Statement) {
+        match stmt {
+            Statement::Let { name, expr, .. } | Statement::Assignment { name, expr } => {
+                self.bound.insert(name.as_ref().clone());
+                self.visit_expr(expr.as_ref());
+            }
+            Statement::Expr(expr) => self.visit_expr(expr.as_ref()),
+            Statement::If {
+                cond,
+                then_block,
+                elif_blocks,
+                else_block,
+            } => {
+                self.visit_expr(cond.as_ref());
+                self.visit_block(then_block.as_ref());
+                for (elif_cond, elif_block) in elif_blocks {
+                    self.visit_expr(elif_cond.as_ref());
+                    self.visit_block(elif_block.as_ref());
+                }
+                if let Some(block) = else_block {
+                    self.visit_block(block.as_ref());
+                }
+            }
+            Statement::For {
+                var,
+                iterable,
+                body,
+            } => {
+                self.bound.insert(var.as_ref().clone());
+                // A range loop's list is internal to the loop.
+                match iterable.as_ref() {
+                    Expr::Range { start, end } => {
+                        self.visit_expr(start.as_ref().as_ref());
+                        self.visit_expr(end.as_ref().as_ref());
+                    }
+                    iterable => self.visit_expr(iterable),
+                }
+                self.visit_loop_body(body.as_ref());
+            }
+            Statement::While { cond, body } => {
+                self.visit_expr(cond.as_ref());
+                self.visit_loop_body(body.as_ref());
+            }
+            Statement::Block(block) => self.visit_block(block.as_ref()),
+            // Leaving the versioned loop early wastes the copy; leaving a
+            // nested loop does not.
+            Statement::Break if self.loop_depth == 0 => self.eligible = false,
+            Statement::Break | Statement::Continue | Statement::Pass => {}
+            // Returning would skip freeing the views, and definitions must
+            // not be emitted twice.
+            Statement::Return(_)
+            | Statement::Function(_)
+            | Statement::Struct { .. }
+            | Statement::Enum { .. }
+            | Statement::TypeAlias { .. }
+            | Statement::Use { .. }
+            | Statement::PubUse { .. } => self.eligible = false,
+        }
+    }
+
+    fn visit_loop_body(&mut self, body: &Block) {
+        self.loop_depth += 1;
+        self.visit_block(body);
+        self.loop_depth -= 1;
+    }
+
+    fn visit_expr(&mut self, expr: &Expr) {
+        match expr {
+            Expr::Identifier(_) | Expr::Literal(_) => {}
+            Expr::Member { object, .. } => self.visit_expr(object.as_ref().as_ref()),
+            Expr::Call { func, args } => {
+                let Some(name) = callee_name(func.as_ref().as_ref()) else {
+                    self.eligible = false;
+                    return;
+                };
+                if let Some(access) = view_access(&name, args)
+                    && access.index == self.var
+                {
+                    let offsets = self
+                        .offsets
+                        .entry((access.list.to_string(), access.kind))
+                        .or_insert((access.offset, access.offset));
+                    offsets.0 = offsets.0.min(access.offset);
+                    offsets.1 = offsets.1.max(access.offset);
+                }
+                self.callees.insert(name);
+                for arg in args {
+                    self.visit_expr(arg.as_ref());
+                }
+            }
+            Expr::Binary { left, right, .. } => {
+                self.visit_expr(left.as_ref().as_ref());
+                self.visit_expr(right.as_ref().as_ref());
+            }
+            Expr::Unary { expr, .. } => self.visit_expr(expr.as_ref().as_ref()),
+            Expr::If {
+                cond,
+                then_branch,
+                else_branch,
+            } => {
+                self.visit_expr(cond.as_ref().as_ref());
+                self.visit_expr(then_branch.as_ref().as_ref());
+                if let Some(else_branch) = else_branch {
+                    self.visit_expr(else_branch.as_ref().as_ref());
+                }
+            }
+            Expr::Struct { fields, .. } => {
+                for (_, value) in fields {
+                    self.visit_expr(value.as_ref());
+                }
+            }
+            // Collections are built by runtime calls the analysis cannot see,
+            // `match` arms may bind names, and tasks outlive the iteration.
+            Expr::Match { .. }
+            | Expr::Range { .. }
+            | Expr::Array(_)
+            | Expr::Dict(_)
+            | Expr::ListComprehension { .. }
+            | Expr::DictComprehension { .. }
+            | Expr::FString { .. }
+            | Expr::Await(_)
+            | Expr::Spawn(_) => self.eligible = false,
+        }
+    }
+}
+
+/// The name a call resolves through: `f` or `object.f`.
+fn callee_name(func: &Expr) -> Option<String> {
+    match func {
+        Expr::Identifier(name) => Some(name.clone()),
+        Expr::Member { object, field } => match object.as_ref().as_ref() {
+            Expr::Identifier(object) => Some(format!("{object}.{field}")),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+/// Splits an index of the form `i`, `i + c`, `c + i` or `i - c`.
+fn split_index(index: &Expr) -> Option<(&str, i64)> {
+    match index {
+        Expr::Identifier(name) => Some((name, 0)),
+        Expr::Binary { op, left, right } => {
+            match (op, left.as_ref().as_ref(), right.as_ref().as_ref()) {
+                (BinaryOp::Add, Expr::Identifier(name), offset)
+                | (BinaryOp::Add, offset, Expr::Identifier(name)) => {
+                    Some((name, int_literal(offset)?))
+                }
+                (BinaryOp::Sub, Expr::Identifier(name), offset) => {
+                    Some((name, -int_literal(offset)?))
+                }
+                _ => None,
+            }
+        }
+        _ => None,
+    }
+}
+
+/// The list `expr` takes the length of, if it is `len(list)`.
+fn len_argument(expr: &Expr) -> Option<&str> {
+    let Expr::Call { func, args } = expr else {
+        return None;
+    };
+    match (func.as_ref().as_ref(), &args[..]) {
+        (Expr::Identifier(len), [list]) if len == "len" => match list.as_ref() {
+            Expr::Identifier(list) => Some(list),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+fn int_literal(expr: &Expr) -> Option<i64> {
+    let Expr::Literal(literal) = expr else {
+        return None;
+    };
+    let Literal::Number(number) = literal.as_ref() else {
+        return None;
+    };
+    let value = number.value;
+    let integral = !number.is_float_literal && value.fract() == 0.0;
+    (integral && value.abs() <= MAX_OFFSET as f64).then_some(value as i64)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use otterc_symbol::registry::{FfiEffects, FfiFunction, FfiSignature, FfiType};
+
+    /// Plans the first top-level range loop of `fn f(xs, ys, n)` with `body`
+    /// as the function body.
+    fn plan(body: &str) -> Option<RangeLoopPlan> {
+        let source = format!("fn f(xs: List, ys: List, n: int) -> float:\n{body}");
+        let tokens = otterc_lexer::tokenize(&source).unwrap();
+        let program = otterc_parser::parse(&tokens).unwrap();
+        let func = program
+            .statements
+            .into_iter()
+            .find_map(|stmt| match stmt.into_inner() {
+                Statement::Function(func) => Some(func.into_inner()),
+                _ => None,
+            })
+            .unwrap();
+        func.body
+            .as_ref()
+            .statements
+            .iter()
+            .find_map(|stmt| match stmt.as_ref() {
+                Statement::For {
+                    var,
+                    iterable,
+                    body,
+                } => match iterable.as_ref() {
+                    Expr::Range { start, end } => Some(plan_range_loop(
+                        var.as_ref(),
+                        start.as_ref().as_ref(),
+                        end.as_ref().as_ref(),
+                        body.as_ref(),
+                    )),
+                    _ => None,
+                },
+                _ => None,
+            })
+            .unwrap()
+    }
+
+    /// A range loop over `range` whose body is `body`, indented once.
+    fn range_loop(range: &str, body: &str) -> String {
+        let body: String = body
+            .lines()
+            .map(|line| format!("        {line}\n"))
+            .collect();
+        format!("    let total = 0.0\n    for i in {range}:\n{body}    return total\n")
+    }
+
+    #[test]
+    fn views_span_the_smallest_and_largest_offset() {
+        let plan = plan(&range_loop(
+            "1..n",
+            "total = total + list.get_float(xs, i - 1) + list.get_float(xs, 2 + i)\ntotal = total + list.get_int(ys, i)",
+        ))
+        .unwrap();
+        let views: Vec<_> = plan
+            .views
+            .iter()
+            .map(|view| {
+                (
+                    view.list.as_str(),
+                    view.kind,
+                    view.min_offset,
+                    view.max_offset,
+                )
+            })
+            .collect();
+        assert_eq!(
+            views,
+            [("xs", ViewKind::Float, -1, 2), ("ys", ViewKind::Int, 0, 0)]
+        );
+        assert!(!plan.in_bounds);
+    }
+
+    #[test]
+    fn in_bounds_needs_a_constant_start_and_the_viewed_length() {
+        let in_bounds = |range: &str, index: &str| {
+            let body = format!("total = total + list.get_float(xs, {index})");
+            plan(&range_loop(range, &body)).unwrap().in_bounds
+        };
+        assert!(in_bounds("0..len(xs)", "i"));
+        assert!(in_bounds("1..len(xs)", "i - 1"));
+        assert!(in_bounds("2..len(xs)", "i - 1"));
+        assert!(!in_bounds("0..len(xs)", "i - 1"));
+        assert!(!in_bounds("0..len(xs)", "i + 1"));
+        assert!(!in_bounds("0..len(ys)", "i"));
+        assert!(!in_bounds("n..len(xs)", "i"));
+        assert!(!in_bounds("0..n", "i"));
+    }
+
+    #[test]
+    fn rebinding_the_index_or_the_list_prevents_versioning() {
+        let read = "total = total + list.get_float(xs, i)";
+        assert!(plan(&range_loop("0..n", read)).is_some());
+        assert!(plan(&range_loop("0..n", &format!("{read}\ni = i + 1"))).is_none());
+        assert!(plan(&range_loop("0..n", &format!("{read}\nxs = ys"))).is_none());
+        assert!(plan(&range_loop("0..n", &format!("let xs = ys\n{read}"))).is_none());
+        // Only the rebound list loses its view.
+        let other = format!("{read}\nys = xs\ntotal = total + list.get_float(ys, i)");
+        let plan = plan(&range_loop("0..n", &other)).unwrap();
+        assert_eq!(plan.views.len(), 1);
+        assert_eq!(plan.views[0].list, "xs");
+    }
+
+    #[test]
+    fn early_exits_prevent_versioning() {
+        let read = "total = total + list.get_float(xs, i)";
+        assert!(plan(&range_loop("0..n", &format!("{read}\nbreak"))).is_none());
+        assert!(
+            plan(&range_loop(
+                "0..n",
+                &format!("if total > 10.0:\n    break\n{read}")
+            ))
+            .is_none()
+        );
+        assert!(plan(&range_loop("0..n", &format!("{read}\nreturn total"))).is_none());
+        // Leaving an inner loop does not leave the versioned one.
+        let inner = format!("{read}\nwhile total > 10.0:\n    total = total - 1.0\n    break");
+        assert!(plan(&range_loop("0..n", &inner)).is_some());
+        let continues = format!("if total > 10.0:\n    continue\n{read}");
+        assert!(plan(&range_loop("0..n", &continues)).is_some());
+    }
+
+    #[test]
+    fn calls_must_not_write_runtime_state() {
+        let registry = SymbolRegistry::new();
+        let register = |name: &str, effects: FfiEffects| {
+            registry.register(FfiFunction {
+                name: name.into(),
+                symbol: name.replace('.', "_"),
+                signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64)
+                    .with_effects(effects),
+            });
+        };
+        register("list.get_float", FfiEffects::READS_RUNTIME);
+        register("math.sqrt", FfiEffects::PURE);
+        register("list.set_float", FfiEffects::UPDATES_RUNTIME);
+        register("list.clear", FfiEffects::default());
+        let preserves = |call: &str| {
+            let body = format!("total = total + list.get_float(xs, i)\n{call}");
+            plan(&range_loop("0..n", &body))
+                .unwrap()
+                .calls_preserve_lists(&registry, |_| None)
+        };
+
+        assert!(preserves("total = math.sqrt(total)"));
+        assert!(!preserves("list.set_float(xs, i, 0.0)"));
+        assert!(!preserves("list.clear(ys)"));
+        assert!(!preserves("unregistered(xs)"));
+
+        let plan = plan(&range_loop(
+            "0..n",
+            "total = total + list.get_float(xs, i)\nhelper(xs)",
+        ))
+        .unwrap();
+        assert!(!plan.calls_preserve_lists(&registry, |_| None));
+        assert!(plan.calls_preserve_lists(&registry, |name| (name == "helper").then_some(true)));
+        assert!(!plan.calls_preserve_lists(&registry, |name| {
+            (name == "list.get_float").then_some(false)
+        }));
+    }
+}
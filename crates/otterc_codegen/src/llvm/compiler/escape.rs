@@ -0,0 +1,347 @@
+//! Escape analysis for enum values.
+//!
+//! Enum constructions normally place their tagged union in a GC allocation.
+//! When a value provably never outlives the function that builds it, codegen
+//! puts the union in an entry-block `alloca` instead. A construction matched
+//! directly stays a pointer to that alloca, so SROA can split it into scalars
+//! and the allocation disappears entirely. A `let`-bound value is stored in
+//! an `i64` variable like any other enum handle; SROA cannot split the union
+//! until InstCombine folds the resulting `ptrtoint`/`inttoptr` pair, but the
+//! value still never touches the GC.
+//!
+//! The analysis is deliberately conservative. A construction stays local only
+//! when it is the scrutinee of a `match`, or when it is bound by `let` to a
+//! name whose every use is as a `match` scrutinee. Any other use of the name
+//! (call argument, return value, collection or struct field, `spawn` capture,
+//! whole-value pattern binding) counts as an escape.
+
+use std::collections::{HashMap, HashSet};
+
+use otterc_ast::nodes::{Block, Expr, FStringPart, Function, Pattern, Statement};
+
+/// Identity of an expression node, matching the keys of `expr_types`.
+pub(crate) fn expr_id(expr: &Expr) -> usize {
+    expr as *const Expr as usize
+}
+
+/// Returns the ids of construction sites in `func` whose values never escape
+/// the function.
+///
+/// Sites are recognised syntactically (`Enum.Variant` and
+/// `Enum.Variant(...)`), so the set may also contain ordinary member accesses
+/// and calls; codegen only consults it when a site really builds an enum.
+pub fn non_escaping_allocations(func: &Function) -> HashSet<usize> {
+    let mut analysis = EscapeAnalysis::default();
+    analysis.visit_block(func.body.as_ref());
+    analysis.finish()
+}
+
+#[derive(Default)]
+struct EscapeAnalysis {
+    /// Construction sites that flow straight into a `match`.
+    scrutinees: HashSet<usize>,
+    /// Construction sites bound by `let`, grouped by the bound name.
+    bindings: HashMap<String, Vec<usize>>,
+    /// Names with at least one use other than as a `match` scrutinee.
+    escaped: HashSet<String>,
+    /// Depth of code that runs outside this function's frame (`spawn`,
+    /// nested functions). Nothing inside it may use the frame.
+    captured: usize,
+}
+
+impl EscapeAnalysis {
+    fn finish(self) -> HashSet<usize> {
+        let Self {
+            mut scrutinees,
+            bindings,
+            escaped,
+            ..
+        } = self;
+        for (name, sites) in bindings {
+            if !escaped.contains(&name) {
+                scrutinees.extend(sites);
+            }
+        }
+        scrutinees
+    }
+
+    fn visit_block(&mut self, block: &Block) {
+        for stmt in &block.statements {
+            self.visit_statement(stmt.as_ref());
+        }
+    }
+
+    fn visit_statement(&mut self, stmt: &Statement) {
+        match stmt {
+            Statement::Let { name, expr, .. } => {
+                let expr = expr.as_ref();
+                if self.captured == 0 && is_construction(expr) {
+                    self.bindings
+                        .entry(name.as_ref().clone())
+                        .or_default()
+                        .push(expr_id(expr));
+                }
+                self.visit_expr(expr);
+            }
+            Statement::Assignment { expr, .. }
+            | Statement::Expr(expr)
+            | Statement::Return(Some(expr)) => self.visit_expr(expr.as_ref()),
+            Statement::If {
+                cond,
+                then_block,
+                elif_blocks,
+                else_block,
+            } => {
+                self.visit_expr(cond.as_ref());
+                self.visit_block(then_block.as_ref());
+                for (elif_cond, elif_block) in elif_blocks {
+                    self.visit_expr(elif_cond.as_ref());
+                    self.visit_block(elif_block.as_ref());
+                }
+                if let Some(block) = else_block {
+                    self.visit_block(block.as_ref());
+                }
+            }
+            Statement::For { iterable, body, .. } => {
+                self.visit_expr(iterable.as_ref());
+                self.visit_block(body.as_ref());
+            }
+            Statement::While { cond, body } => {
+                self.visit_expr(cond.as_ref());
+                self.visit_block(body.as_ref());
+            }
+            Statement::Block(block) => self.visit_block(block.as_ref()),
+            Statement::Function(func) => {
+                self.captured += 1;
+                self.visit_block(func.as_ref().body.as_ref());
+                self.captured -= 1;
+            }
+            Statement::Break
+            | Statement::Continue
+            | Statement::Pass
+            | Statement::Return(None)
+            | Statement::Struct { .. }
+            | Statement::Enum { .. }
+            | Statement::TypeAlias { .. }
+            | Statement::Use { .. }
+            | Statement::PubUse { .. } => {}
+        }
+    }
+
+    fn visit_expr(&mut self, expr: &Expr) {
+        match expr {
+            Expr::Identifier(name) => {
+                self.escaped.insert(name.clone());
+            }
+            Expr::Match { value, arms } => {
+                let value = value.as_ref().as_ref();
+                let binds_whole_value = arms
+                    .iter()
+                    .any(|arm| matches!(arm.as_ref().pattern.as_ref(), Pattern::Identifier(_)));
+                let local = self.captured == 0 && !binds_whole_value;
+                if local && is_construction(value) {
+                    self.scrutinees.insert(expr_id(value));
+                }
+                if !(local && matches!(value, Expr::Identifier(_))) {
+                    self.visit_expr(value);
+                }
+                for arm in arms {
+                    let arm = arm.as_ref();
+                    if let Some(guard) = &arm.guard {
+                        self.visit_expr(guard.as_ref());
+                    }
+                    self.visit_block(arm.body.as_ref());
+                }
+            }
+            Expr::Member { object, .. } => self.visit_expr(object.as_ref().as_ref()),
+            Expr::Call { func, args } => {
+                self.visit_expr(func.as_ref().as_ref());
+                for arg in args {
+                    self.visit_expr(arg.as_ref());
+                }
+            }
+            Expr::Binary { left, right, .. }
+            | Expr::Range {
+                start: left,
+                end: right,
+            } => {
+                self.visit_expr(left.as_ref().as_ref());
+                self.visit_expr(right.as_ref().as_ref());
+            }
+            Expr::Unary { expr, .. } | Expr::Await(expr) => self.visit_expr(expr.as_ref().as_ref()),
+            Expr::If {
+                cond,
+                then_branch,
+                else_branch,
+            } => {
+                self.visit_expr(cond.as_ref().as_ref());
+                self.visit_expr(then_branch.as_ref().as_ref());
+                if let Some(else_branch) = else_branch {
+                    self.visit_expr(else_branch.as_ref().as_ref());
+                }
+            }
+            Expr::Array(elements) => {
+                for element in elements {
+                    self.visit_expr(element.as_ref());
+                }
+            }
+            Expr::Dict(entries) => {
+                for (key, value) in entries {
+                    self.visit_expr(key.as_ref());
+                    self.visit_expr(value.as_ref());
+                }
+            }
+            Expr::ListComprehension {
+                element,
+                iterable,
+                condition,
+                ..
+            } => {
+                self.visit_expr(element.as_ref().as_ref());
+                self.visit_expr(iterable.as_ref().as_ref());
+                if let Some(condition) = condition {
+                    self.visit_expr(condition.as_ref().as_ref());
+                }
+            }
+            Expr::DictComprehension {
+                key,
+                value,
+                iterable,
+                condition,
+                ..
+            } => {
+                self.visit_expr(key.as_ref().as_ref());
+                self.visit_expr(value.as_ref().as_ref());
+                self.visit_expr(iterable.as_ref().as_ref());
+                if let Some(condition) = condition {
+                    self.visit_expr(condition.as_ref().as_ref());
+                }
+            }
+            Expr::FString { parts } => {
+                for part in parts {
+                    if let FStringPart::Expr(expr) = part.as_ref() {
+                        self.visit_expr(expr.as_ref());
+                    }
+                }
+            }
+            Expr::Spawn(expr) => {
+                self.captured += 1;
+                self.visit_expr(expr.as_ref().as_ref());
+                self.captured -= 1;
+            }
+            Expr::Struct { fields, .. } => {
+                for (_, value) in fields {
+                    self.visit_expr(value.as_ref());
+                }
+            }
+            Expr::Literal(_) => {}
+        }
+    }
+}
+
+/// Whether `expr` has the shape of an enum construction.
+fn is_construction(expr: &Expr) -> bool {
+    match expr {
+        Expr::Member { .. } => true,
+        Expr::Call { func, .. } => matches!(func.as_ref().as_ref(), Expr::Member { .. }),
+        _ => false,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const SHAPE: &str = "enum Shape:\n    Point\n    Circle: (float)\n\n";
+
+    fn function(body: &str) -> Function {
+        let source = format!("{SHAPE}fn f(n: float) -> float:\n{body}");
+        let tokens = otterc_lexer::tokenize(&source).unwrap();
+        let program = otterc_parser::parse(&tokens).unwrap();
+        program
+            .statements
+            .into_iter()
+            .find_map(|stmt| match stmt.into_inner() {
+                Statement::Function(func) => Some(func.into_inner()),
+                _ => None,
+            })
+            .unwrap()
+    }
+
+    /// Id of the initializer of the top-level `let name = ...`.
+    fn let_site(func: &Function, name: &str) -> usize {
+        func.body
+            .as_ref()
+            .statements
+            .iter()
+            .find_map(|stmt| match stmt.as_ref() {
+                Statement::Let {
+                    name: bound, expr, ..
+                } if bound.as_ref() == name => Some(expr_id(expr.as_ref())),
+                _ => None,
+            })
+            .unwrap()
+    }
+
+    /// Id of the scrutinee of the `match` bound by the top-level `let name`.
+    fn scrutinee_site(func: &Function, name: &str) -> usize {
+        func.body
+            .as_ref()
+            .statements
+            .iter()
+            .find_map(|stmt| match stmt.as_ref() {
+                Statement::Let {
+                    name: bound, expr, ..
+                } if bound.as_ref() == name => match expr.as_ref() {
+                    Expr::Match { value, .. } => Some(expr_id(value.as_ref().as_ref())),
+                    _ => None,
+                },
+                _ => None,
+            })
+            .unwrap()
+    }
+
+    const MATCH_S: &str = "    let r = match s:\n        case Shape.Circle(x):\n            x\n        case _:\n            0.0\n";
+
+    #[test]
+    fn direct_scrutinee_does_not_escape() {
+        let func = function(
+            "    let r = match Shape.Circle(n):\n        case Shape.Circle(x):\n            x\n        case _:\n            0.0\n    return r\n",
+        );
+        let local = non_escaping_allocations(&func);
+        assert!(local.contains(&scrutinee_site(&func, "r")));
+    }
+
+    #[test]
+    fn binding_used_only_as_scrutinee_does_not_escape() {
+        let func = function(&format!(
+            "    let s = Shape.Circle(n)\n{MATCH_S}    let t = match s:\n        case Shape.Point:\n            1.0\n        case _:\n            2.0\n    return r + t\n"
+        ));
+        assert!(non_escaping_allocations(&func).contains(&let_site(&func, "s")));
+    }
+
+    #[test]
+    fn other_uses_of_a_binding_escape() {
+        for use_site in [
+            "    return s\n",
+            "    print_shape(s)\n",
+            "    let xs = [s]\n",
+            "    let text = f\"{s}\"\n",
+            "    spawn print_shape(s)\n",
+            "    let t = s\n",
+        ] {
+            let func = function(&format!("    let s = Shape.Circle(n)\n{MATCH_S}{use_site}"));
+            let local = non_escaping_allocations(&func);
+            assert!(!local.contains(&let_site(&func, "s")), "{use_site}");
+        }
+    }
+
+    #[test]
+    fn whole_value_pattern_binding_escapes() {
+        let func = function(
+            "    let r = match Shape.Circle(n):\n        case other:\n            keep(other)\n    return r\n",
+        );
+        let local = non_escaping_allocations(&func);
+        assert!(!local.contains(&scrutinee_site(&func, "r")));
+    }
+}
@@ -1,11 +1,17 @@
 use anyhow::{Result, anyhow, bail};
-use inkwell::AddressSpace;
-use inkwell::IntPredicate;
+use inkwell::intrinsics::Intrinsic;
 use inkwell::types::{BasicTypeEnum, PointerType, StructType};
-use inkwell::values::{BasicMetadataValueEnum, BasicValueEnum, FunctionValue, IntValue};
+use inkwell::values::{
+    BasicMetadataValueEnum, BasicValue, BasicValueEnum, FunctionValue, IntValue, PointerValue,
+};
+use inkwell::{AddressSpace, AtomicOrdering, AtomicRMWBinOp};
+use inkwell::{FloatPredicate, IntPredicate};
 use std::collections::BTreeSet;
 
 use crate::llvm::compiler::Compiler;
+use crate::llvm::compiler::bounds::{self, ViewKind};
+use crate::llvm::compiler::escape;
+use crate::llvm::compiler::stmt::RANGE_BUILTINS;
 use crate::llvm::compiler::types::{EvaluatedValue, FunctionContext, OtterType, Variable};
 use otterc_ast::nodes::{BinaryOp, Block, Expr, FStringPart, Literal, Node, Statement, UnaryOp};
 use otterc_typecheck::TypeInfo;
@@ -412,6 +418,18 @@ impl<'ctx> Compiler<'ctx> {
                             value: None,
                         })
                     }
+                } else if let Some(function) = self.declared_functions.get(name).copied() {
+                    // A bare function name evaluates to its address so it can
+                    // be handed to runtime helpers that call back into it.
+                    let address = self.builder.build_ptr_to_int(
+                        function.as_global_value().as_pointer_value(),
+                        self.context.i64_type(),
+                        name,
+                    )?;
+                    Ok(EvaluatedValue::with_value(
+                        address.into(),
+                        OtterType::Opaque,
+                    ))
                 } else {
                     bail!("Variable {} not found", name);
                 }
@@ -735,17 +753,12 @@ impl<'ctx> Compiler<'ctx> {
                 variant,
                 fields,
             } => {
-                let get_tag_fn = self.get_or_declare_ffi_function("runtime.enum.get_tag")?;
                 let handle = matched_val
                     .value
                     .ok_or_else(|| anyhow!("Enum value is void"))?;
 
                 let tag_val = self
-                    .builder
-                    .build_call(get_tag_fn, &[handle.into()], "tag")?
-                    .try_as_basic_value()
-                    .left()
-                    .unwrap()
+                    .build_enum_slot_load(handle, 0, self.context.i64_type().into(), "tag")?
                     .into_int_value();
 
                 let layout = self
@@ -801,26 +814,8 @@ impl<'ctx> Compiler<'ctx> {
                             })?
                             .clone();
 
-                        // Use type-specific getter based on field type
-                        let get_field_fn_name = match enum_field_kind(&field_type) {
-                            EnumFieldKind::Int => "runtime.enum.get_i64",
-                            EnumFieldKind::Float => "runtime.enum.get_f64",
-                            EnumFieldKind::Bool => "runtime.enum.get_bool",
-                            EnumFieldKind::Ptr => "runtime.enum.get_ptr",
-                        };
-                        let get_field_fn = self.get_or_declare_ffi_function(get_field_fn_name)?;
-                        let field_idx_val =
-                            self.context.i64_type().const_int(field_idx as u64, false);
-                        let field_val = self
-                            .builder
-                            .build_call(
-                                get_field_fn,
-                                &[handle.into(), field_idx_val.into()],
-                                "field",
-                            )?
-                            .try_as_basic_value()
-                            .left()
-                            .unwrap();
+                        let field_val =
+                            self.load_enum_field(handle, field_idx as u32, &field_type)?;
 
                         // Convert to appropriate OtterType
                         let field_otter_type = match enum_field_kind(&field_type) {
@@ -1874,6 +1869,36 @@ impl<'ctx> Compiler<'ctx> {
                 _ => bail!("Complex function expressions not yet supported"),
             };
 
+            if implicit_self.is_none()
+                && let Some(value) = self.try_build_atomic_intrinsic(&func_name, args, ctx)?
+            {
+                return Ok(value);
+            }
+
+            if implicit_self.is_none()
+                && let Some(value) = self.try_build_math_intrinsic(&func_name, args, ctx)?
+            {
+                return Ok(value);
+            }
+
+            if implicit_self.is_none()
+                && let Some(value) = self.try_build_list_view_load(&func_name, args, ctx)?
+            {
+                return Ok(value);
+            }
+
+            // Range builtins used as values build their list in the runtime;
+            // `for` loops over them never get here.
+            let func_name = match RANGE_BUILTINS.iter().find(|(name, _)| *name == func_name) {
+                Some((_, constructor))
+                    if implicit_self.is_none()
+                        && !self.function_defaults.contains_key(&func_name) =>
+                {
+                    (*constructor).to_string()
+                }
+                _ => func_name,
+            };
+
             // Handle overloaded builtins like len() - evaluate first arg to determine type
             let (function, resolved_func_name, first_arg_evaluated) =
                 if func_name == "len" && !args.is_empty() {
@@ -2799,6 +2824,247 @@ impl<'ctx> Compiler<'ctx> {
             .ok_or_else(|| anyhow!("FFI function {name} returned void"))
     }
 
+    /// Lowers `sync.atomic_get/add/set` to native atomic instructions. An
+    /// atomic handle is the address of the runtime's `AtomicI64`, so no call
+    /// into the runtime is needed. A `0` handle skips the instruction and
+    /// yields what the runtime functions return for it: `0`, or nothing.
+    fn try_build_atomic_intrinsic(
+        &mut self,
+        func_name: &str,
+        args: &[Node<Expr>],
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<Option<EvaluatedValue<'ctx>>> {
+        let arity = match func_name {
+            "sync.atomic_get" => 1,
+            "sync.atomic_add" | "sync.atomic_set" => 2,
+            _ => return Ok(None),
+        };
+        // A program function of the same name shadows the runtime one.
+        if args.len() != arity || self.function_defaults.contains_key(func_name) {
+            return Ok(None);
+        }
+
+        // Both arguments are evaluated before the check, as for a call.
+        let handle = self.eval_expr(args[0].as_ref(), ctx)?;
+        let handle = self.value_as_i64(handle)?;
+        let operand = match args.get(1) {
+            Some(arg) => {
+                let operand = self.eval_expr(arg.as_ref(), ctx)?;
+                Some(self.value_as_i64(operand)?)
+            }
+            None => None,
+        };
+
+        let i64_type = self.context.i64_type();
+        let check_bb = self
+            .builder
+            .get_insert_block()
+            .ok_or_else(|| anyhow!("atomic call outside a basic block"))?;
+        let function = check_bb
+            .get_parent()
+            .ok_or_else(|| anyhow!("Cannot determine current function for atomic call"))?;
+        let live_bb = self.context.append_basic_block(function, "atomic_live");
+        let done_bb = self.context.append_basic_block(function, "atomic_done");
+        let is_null = self.builder.build_int_compare(
+            IntPredicate::EQ,
+            handle,
+            i64_type.const_zero(),
+            "atomic_null",
+        )?;
+        self.builder
+            .build_conditional_branch(is_null, done_bb, live_bb)?;
+
+        self.builder.position_at_end(live_bb);
+        let ptr = self
+            .builder
+            .build_int_to_ptr(handle, self.string_ptr_type, "atomic_ptr")?;
+        let ordering = AtomicOrdering::SequentiallyConsistent;
+        let result = match (func_name, operand) {
+            ("sync.atomic_get", _) => {
+                let value = self.builder.build_load(i64_type, ptr, "atomic_get")?;
+                let load = value
+                    .as_instruction_value()
+                    .ok_or_else(|| anyhow!("atomic load is not an instruction"))?;
+                load.set_alignment(8).map_err(|err| anyhow!(err))?;
+                load.set_atomic_ordering(ordering)
+                    .map_err(|err| anyhow!(err))?;
+                Some(value.into_int_value())
+            }
+            ("sync.atomic_add", Some(operand)) => {
+                Some(
+                    self.builder
+                        .build_atomicrmw(AtomicRMWBinOp::Add, ptr, operand, ordering)?,
+                )
+            }
+            (_, Some(operand)) => {
+                let store = self.builder.build_store(ptr, operand)?;
+                store.set_alignment(8).map_err(|err| anyhow!(err))?;
+                store
+                    .set_atomic_ordering(ordering)
+                    .map_err(|err| anyhow!(err))?;
+                None
+            }
+            (_, None) => bail!("{func_name} expects an operand"),
+        };
+        self.builder.build_unconditional_branch(done_bb)?;
+
+        self.builder.position_at_end(done_bb);
+        let Some(result) = result else {
+            return Ok(Some(EvaluatedValue {
+                ty: OtterType::Unit,
+                value: None,
+            }));
+        };
+        let phi = self.builder.build_phi(i64_type, "atomic_result")?;
+        phi.add_incoming(&[(&i64_type.const_zero(), check_bb), (&result, live_bb)]);
+        Ok(Some(EvaluatedValue::with_value(
+            phi.as_basic_value(),
+            OtterType::I64,
+        )))
+    }
+
+    /// Lowers `math.*` calls to LLVM intrinsics or plain float arithmetic,
+    /// which the optimizer can constant fold and vectorize; an opaque runtime
+    /// call blocks both. Each lowering computes exactly what the runtime
+    /// function does.
+    fn try_build_math_intrinsic(
+        &mut self,
+        func_name: &str,
+        args: &[Node<Expr>],
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<Option<EvaluatedValue<'ctx>>> {
+        let Some(function) = func_name.strip_prefix("math.") else {
+            return Ok(None);
+        };
+        let (intrinsic, arity) = match function {
+            "abs" => (Some("llvm.fabs"), 1),
+            "sqrt" => (Some("llvm.sqrt"), 1),
+            "floor" => (Some("llvm.floor"), 1),
+            "ceil" => (Some("llvm.ceil"), 1),
+            "round" => (Some("llvm.round"), 1),
+            "exp" => (Some("llvm.exp"), 1),
+            "log" => (Some("llvm.log"), 1),
+            "sin" => (Some("llvm.sin"), 1),
+            "cos" => (Some("llvm.cos"), 1),
+            "min" => (Some("llvm.minnum"), 2),
+            "max" => (Some("llvm.maxnum"), 2),
+            "pow" => (Some("llvm.pow"), 2),
+            "fma" => (Some("llvm.fma"), 3),
+            "clamp" | "lerp" => (None, 3),
+            _ => return Ok(None),
+        };
+        // A program function of the same name shadows the runtime one.
+        if args.len() != arity || self.function_defaults.contains_key(func_name) {
+            return Ok(None);
+        }
+        // Intrinsics without a matching instruction become libm calls, which
+        // freestanding targets cannot link; keep the runtime call there.
+        let needs_libm = !matches!(
+            function,
+            "abs" | "sqrt" | "floor" | "ceil" | "clamp" | "lerp"
+        );
+        if needs_libm
+            && self
+                .target_triple
+                .as_ref()
+                .is_some_and(|target| target.is_wasm() || target.is_embedded())
+        {
+            return Ok(None);
+        }
+
+        let mut operands = Vec::with_capacity(arity);
+        for arg in args {
+            let value = self.eval_expr(arg.as_ref(), ctx)?;
+            operands.push(self.value_as_f64(value)?.into_float_value());
+        }
+
+        let value: BasicValueEnum<'ctx> = match (intrinsic, operands.as_slice()) {
+            (Some(name), _) => {
+                let declaration = Intrinsic::find(name)
+                    .and_then(|intrinsic| {
+                        intrinsic.get_declaration(&self.module, &[self.context.f64_type().into()])
+                    })
+                    .ok_or_else(|| anyhow!("missing LLVM intrinsic {name}"))?;
+                let operands: Vec<BasicMetadataValueEnum> =
+                    operands.iter().map(|&operand| operand.into()).collect();
+                self.builder
+                    .build_call(declaration, &operands, function)?
+                    .try_as_basic_value()
+                    .left()
+                    .ok_or_else(|| anyhow!("{name} returned no value"))?
+            }
+            (None, &[value, low, high]) if function == "clamp" => {
+                let below =
+                    self.builder
+                        .build_float_compare(FloatPredicate::OLT, value, low, "below")?;
+                let above =
+                    self.builder
+                        .build_float_compare(FloatPredicate::OGT, value, high, "above")?;
+                let upper = self
+                    .builder
+                    .build_select(above, high, value, "clamp_high")?;
+                self.builder
+                    .build_select(below, low.into(), upper, "clamp")?
+            }
+            (None, &[start, end, t]) => {
+                let span = self.builder.build_float_sub(end, start, "lerp_span")?;
+                let offset = self.builder.build_float_mul(span, t, "lerp_offset")?;
+                self.builder.build_float_add(start, offset, "lerp")?.into()
+            }
+            (None, _) => bail!("unexpected operands for {func_name}"),
+        };
+        Ok(Some(EvaluatedValue::with_value(value, OtterType::F64)))
+    }
+
+    /// Inside a versioned loop, loads `list.get_int/get_float(xs, i + c)`
+    /// from the view of `xs` instead of calling into the runtime. The range
+    /// check made when the view was created covers every such index.
+    fn try_build_list_view_load(
+        &mut self,
+        func_name: &str,
+        args: &[Node<Expr>],
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<Option<EvaluatedValue<'ctx>>> {
+        if ctx.list_views.is_empty() {
+            return Ok(None);
+        }
+        let Some(access) = bounds::view_access(func_name, args) else {
+            return Ok(None);
+        };
+        let Some(view) = ctx.list_views.iter().rev().find(|view| {
+            view.list == access.list && view.kind == access.kind && view.index == access.index
+        }) else {
+            return Ok(None);
+        };
+        let (base, data) = (view.base, view.data);
+        let index_var = ctx
+            .get(access.index)
+            .ok_or_else(|| anyhow!("loop variable {} is not in scope", access.index))?;
+
+        let i64_type = self.context.i64_type();
+        let index = self
+            .builder
+            .build_load(i64_type, index_var.ptr, access.index)?
+            .into_int_value();
+        let index = self.builder.build_int_nsw_add(
+            index,
+            i64_type.const_int(access.offset as u64, true),
+            "view_index",
+        )?;
+        let slot = self.builder.build_int_nsw_sub(index, base, "view_slot")?;
+        let (item_type, ty): (BasicTypeEnum<'ctx>, _) = match access.kind {
+            ViewKind::Int => (i64_type.into(), OtterType::I64),
+            ViewKind::Float => (self.context.f64_type().into(), OtterType::F64),
+        };
+        // SAFETY: the view covers every index the loop variable reaches.
+        let item = unsafe {
+            self.builder
+                .build_in_bounds_gep(item_type, data, &[slot], "view_item")?
+        };
+        let value = self.builder.build_load(item_type, item, "view_load")?;
+        Ok(Some(EvaluatedValue::with_value(value, ty)))
+    }
+
     fn try_build_enum_constructor(
         &mut self,
         call_expr: &Expr,
@@ -2826,7 +3092,9 @@ impl<'ctx> Compiler<'ctx> {
             for arg in args {
                 evaluated_args.push(self.eval_expr(arg.as_ref(), ctx)?);
             }
-            let value = self.build_enum_value_from_type(&enum_type, field, evaluated_args)?;
+            let on_stack = self.is_stack_allocation(call_expr);
+            let value =
+                self.build_enum_value_from_type(&enum_type, field, evaluated_args, on_stack)?;
             return Ok(Some(value));
         }
         Ok(None)
@@ -2876,6 +3144,7 @@ impl<'ctx> Compiler<'ctx> {
                 tag,
                 &field_types,
                 evaluated_args,
+                false,
             )?;
 
             return Ok(Some(value));
@@ -2895,10 +3164,12 @@ impl<'ctx> Compiler<'ctx> {
             && variant.fields.is_empty()
         {
             let enum_type = enum_type_ref.clone();
+            let on_stack = self.is_stack_allocation(expr);
             return Ok(Some(self.build_enum_value_from_type(
                 &enum_type,
                 field,
                 Vec::new(),
+                on_stack,
             )?));
         }
         Ok(None)
@@ -2946,6 +3217,7 @@ impl<'ctx> Compiler<'ctx> {
         enum_type: &TypeInfo,
         variant_name: &str,
         values: Vec<EvaluatedValue<'ctx>>,
+        on_stack: bool,
     ) -> Result<EvaluatedValue<'ctx>> {
         if let TypeInfo::Enum { name, variants, .. } = enum_type {
             let layout = self
@@ -2967,34 +3239,77 @@ impl<'ctx> Compiler<'ctx> {
                 );
             }
 
-            self.create_enum_instance(name, variant_name, tag, &variant_info.fields, values)
+            self.create_enum_instance(
+                name,
+                variant_name,
+                tag,
+                &variant_info.fields,
+                values,
+                on_stack,
+            )
         } else {
             bail!("expected enum type when constructing variant {variant_name}");
         }
     }
 
+    /// Number of 8-byte payload slots an enum needs: the field count of its
+    /// largest variant.
+    fn enum_payload_slots(&self, enum_name: &str) -> usize {
+        self.enum_layout(enum_name)
+            .and_then(|layout| layout.variant_fields.values().map(Vec::len).max())
+            .unwrap_or(0)
+    }
+
+    /// Whether escape analysis proved the value built at `expr` stays inside
+    /// the current function.
+    fn is_stack_allocation(&self, expr: &Expr) -> bool {
+        self.stack_allocations.contains(&escape::expr_id(expr))
+    }
+
+    /// Enum values are tagged unions in a single allocation laid out as
+    /// `{ i64 tag, [N x i64] payload }`, where `N` comes from the enum layout.
+    /// Heap values are the allocation's address carried as an `i64`: an
+    /// unrooted GC object from `runtime.enum.alloc`, which the collector
+    /// never moves, finds by scanning the stack and traces the payload of.
+    ///
+    /// Non-escaping values (`on_stack`) use an entry-block alloca and stay a
+    /// pointer, so a `match` directly on the construction reads the union
+    /// with no `ptrtoint` and SROA can split it into registers. A `let`
+    /// binding stores the value in an `i64` variable instead; that
+    /// `ptrtoint`/`inttoptr` pair blocks SROA until InstCombine folds it.
     fn create_enum_instance(
         &mut self,
-        _enum_name: &str,
+        enum_name: &str,
         _variant_name: &str,
         tag: u32,
         field_types: &[TypeInfo],
         values: Vec<EvaluatedValue<'ctx>>,
+        on_stack: bool,
     ) -> Result<EvaluatedValue<'ctx>> {
         let i64_type = self.context.i64_type();
-        let tag_value = i64_type.const_int(tag as u64, false);
-        let field_count = i64_type.const_int(field_types.len() as u64, false);
-        let create_fn = self.get_or_declare_ffi_function("runtime.enum.create")?;
-        let handle = self
-            .builder
-            .build_call(
-                create_fn,
-                &[tag_value.into(), field_count.into()],
-                "enum_create",
-            )?
-            .try_as_basic_value()
-            .left()
-            .ok_or_else(|| anyhow!("runtime.enum.create returned void"))?;
+        let slots = self.enum_payload_slots(enum_name).max(field_types.len());
+        let handle = if on_stack {
+            let function = self
+                .builder
+                .get_insert_block()
+                .and_then(|block| block.get_parent())
+                .ok_or_else(|| anyhow!("enum construction outside of a function"))?;
+            let union_type = i64_type.array_type(1 + slots as u32);
+            self.create_entry_block_alloca_of(function, "enum_local", union_type.into())?
+                .into()
+        } else {
+            let field_count = i64_type.const_int(slots as u64, false);
+            let alloc_fn = self.get_or_declare_ffi_function("runtime.enum.alloc")?;
+            self.builder
+                .build_call(alloc_fn, &[field_count.into()], "enum_alloc")?
+                .try_as_basic_value()
+                .left()
+                .ok_or_else(|| anyhow!("runtime.enum.alloc returned void"))?
+        };
+
+        let tag_ptr = self.enum_slot_ptr(handle, 0)?;
+        self.builder
+            .build_store(tag_ptr, i64_type.const_int(tag as u64, false))?;
 
         for (index, (field_type, value)) in field_types.iter().zip(values.into_iter()).enumerate() {
             self.store_enum_field(handle, index as u32, field_type, value)?;
@@ -3003,57 +3318,92 @@ impl<'ctx> Compiler<'ctx> {
         Ok(EvaluatedValue::with_value(handle, OtterType::Opaque))
     }
 
-    fn store_enum_field(
+    /// Address of slot `slot` of an enum value; slot 0 is the tag and field
+    /// `i` lives in slot `i + 1`. Stack values arrive as the alloca itself,
+    /// heap values as an `i64` handle.
+    fn enum_slot_ptr(
+        &mut self,
+        handle: BasicValueEnum<'ctx>,
+        slot: u32,
+    ) -> Result<PointerValue<'ctx>> {
+        let base = match handle {
+            BasicValueEnum::PointerValue(ptr) => ptr,
+            other => self.builder.build_int_to_ptr(
+                other.into_int_value(),
+                self.string_ptr_type,
+                "enum_ptr",
+            )?,
+        };
+        if slot == 0 {
+            return Ok(base);
+        }
+        let i64_type = self.context.i64_type();
+        let offset = i64_type.const_int(slot as u64, false);
+        // SAFETY: every enum allocation holds a slot for each field of its
+        // largest variant, and the type checker bounds field indices by the
+        // variant's arity.
+        Ok(unsafe {
+            self.builder
+                .build_in_bounds_gep(i64_type, base, &[offset], "enum_slot")?
+        })
+    }
+
+    fn build_enum_slot_load(
+        &mut self,
+        handle: BasicValueEnum<'ctx>,
+        slot: u32,
+        ty: BasicTypeEnum<'ctx>,
+        name: &str,
+    ) -> Result<BasicValueEnum<'ctx>> {
+        let ptr = self.enum_slot_ptr(handle, slot)?;
+        Ok(self.builder.build_load(ty, ptr, name)?)
+    }
+
+    fn load_enum_field(
         &mut self,
         handle: BasicValueEnum<'ctx>,
         index: u32,
         field_type: &TypeInfo,
-        value: EvaluatedValue<'ctx>,
-    ) -> Result<()> {
+    ) -> Result<BasicValueEnum<'ctx>> {
         let i64_type = self.context.i64_type();
-        let index_val = i64_type.const_int(index as u64, false);
-        let handle_arg: BasicMetadataValueEnum = handle.into();
-        let index_arg: BasicMetadataValueEnum = index_val.into();
-
-        match enum_field_kind(field_type) {
-            EnumFieldKind::Int => {
-                let data = self.value_as_i64(value)?;
-                let setter = self.get_or_declare_ffi_function("runtime.enum.set_i64")?;
-                self.builder.build_call(
-                    setter,
-                    &[handle_arg, index_arg, data.into()],
-                    "enum_set_i64",
-                )?;
+        let slot = index + 1;
+        Ok(match enum_field_kind(field_type) {
+            EnumFieldKind::Int | EnumFieldKind::Ptr => {
+                self.build_enum_slot_load(handle, slot, i64_type.into(), "field")?
             }
             EnumFieldKind::Float => {
-                let data = self.value_as_f64(value)?;
-                let setter = self.get_or_declare_ffi_function("runtime.enum.set_f64")?;
-                self.builder.build_call(
-                    setter,
-                    &[handle_arg, index_arg, data.into()],
-                    "enum_set_f64",
-                )?;
+                self.build_enum_slot_load(handle, slot, self.context.f64_type().into(), "field")?
             }
             EnumFieldKind::Bool => {
-                let data = self.value_as_bool(value)?;
-                let setter = self.get_or_declare_ffi_function("runtime.enum.set_bool")?;
-                self.builder.build_call(
-                    setter,
-                    &[handle_arg, index_arg, data.into()],
-                    "enum_set_bool",
-                )?;
-            }
-            EnumFieldKind::Ptr => {
-                let data = self.value_as_i64(value)?;
-                let setter = self.get_or_declare_ffi_function("runtime.enum.set_ptr")?;
-                self.builder.build_call(
-                    setter,
-                    &[handle_arg, index_arg, data.into()],
-                    "enum_set_ptr",
-                )?;
+                let raw = self
+                    .build_enum_slot_load(handle, slot, i64_type.into(), "field_raw")?
+                    .into_int_value();
+                self.builder
+                    .build_int_compare(IntPredicate::NE, raw, i64_type.const_zero(), "field")?
+                    .into()
             }
-        }
+        })
+    }
 
+    fn store_enum_field(
+        &mut self,
+        handle: BasicValueEnum<'ctx>,
+        index: u32,
+        field_type: &TypeInfo,
+        value: EvaluatedValue<'ctx>,
+    ) -> Result<()> {
+        let data: BasicValueEnum<'ctx> = match enum_field_kind(field_type) {
+            EnumFieldKind::Int | EnumFieldKind::Ptr => self.value_as_i64(value)?.into(),
+            EnumFieldKind::Float => self.value_as_f64(value)?,
+            EnumFieldKind::Bool => {
+                let flag = self.value_as_bool(value)?;
+                self.builder
+                    .build_int_z_extend(flag, self.context.i64_type(), "bool_to_slot")?
+                    .into()
+            }
+        };
+        let ptr = self.enum_slot_ptr(handle, index + 1)?;
+        self.builder.build_store(ptr, data)?;
         Ok(())
     }
 
@@ -1,4 +1,4 @@
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::path::Path;
 use std::sync::atomic::AtomicUsize;
 
@@ -12,13 +12,17 @@ use inkwell::types::{BasicType, BasicTypeEnum, PointerType, StructType};
 use inkwell::values::{FunctionValue, PointerValue};
 
 use crate::llvm::bridges::prepare_rust_bridges;
+use crate::llvm::passes::{self, PgoPhase};
 use otterc_ast::nodes::{Block, Expr, FStringPart, Function, Node, Program, Statement};
 use otterc_config::CodegenOptLevel;
 use otterc_config::TargetTriple;
+use otterc_ffi::BridgeLinkage;
 use otterc_span::Span;
-use otterc_symbol::registry::SymbolRegistry;
+use otterc_symbol::registry::{FfiAccess, FfiEffects, FfiMemory, SymbolRegistry};
 use otterc_typecheck::{EnumLayout, TypeInfo};
 
+pub mod bounds;
+pub mod escape;
 pub mod expr;
 pub mod stmt;
 pub mod types;
@@ -53,6 +57,9 @@ pub struct Compiler<'ctx> {
     next_spawn_id: u64,
     struct_ids: HashMap<String, u32>,
     struct_infos: Vec<StructInfo<'ctx>>,
+    /// Enum construction sites in the current function that may live on the
+    /// stack, as computed by [`escape::non_escaping_allocations`].
+    pub(crate) stack_allocations: HashSet<usize>,
     pub cached_ir: Option<String>,
     /// Target triple for platform-specific ABI handling
     target_triple: Option<TargetTriple>,
@@ -258,6 +265,7 @@ impl<'ctx> Compiler<'ctx> {
             next_spawn_id: 0,
             struct_ids: HashMap::new(),
             struct_infos: Vec::new(),
+            stack_allocations: HashSet::new(),
             cached_ir: None,
             target_triple,
         }
@@ -375,7 +383,8 @@ impl<'ctx> Compiler<'ctx> {
         }
 
         // Prepare Rust bridges
-        let _libraries = prepare_rust_bridges(program, self.symbol_registry)?;
+        let _libraries =
+            prepare_rust_bridges(program, self.symbol_registry, BridgeLinkage::Dynamic)?;
 
         // First pass: register all functions and types
         for statement in &program.statements {
@@ -465,7 +474,8 @@ impl<'ctx> Compiler<'ctx> {
                 | FfiType::Str
                 | FfiType::Opaque
                 | FfiType::List
-                | FfiType::Map => 8,
+                | FfiType::Map
+                | FfiType::Function { .. } => 8,
                 FfiType::Struct { fields } | FfiType::Tuple(fields) => {
                     fields.iter().map(ffi_type_size).sum()
                 }
@@ -495,9 +505,11 @@ impl<'ctx> Compiler<'ctx> {
                 FfiType::Unit => context.i8_type().into(),
                 FfiType::Bool => context.bool_type().into(),
                 FfiType::I32 => context.i32_type().into(),
-                FfiType::I64 | FfiType::Opaque | FfiType::List | FfiType::Map => {
-                    context.i64_type().into()
-                }
+                FfiType::I64
+                | FfiType::Opaque
+                | FfiType::List
+                | FfiType::Map
+                | FfiType::Function { .. } => context.i64_type().into(),
                 FfiType::F64 => context.f64_type().into(),
                 FfiType::Str => string_ptr_type.into(),
                 FfiType::Struct { fields } | FfiType::Tuple(fields) => {
@@ -570,12 +582,87 @@ impl<'ctx> Compiler<'ctx> {
             );
         }
 
+        let pointer_params: Vec<u32> = ffi_func
+            .signature
+            .params
+            .iter()
+            .enumerate()
+            .filter(|(_, ty)| matches!(ty, FfiType::Str))
+            .map(|(index, _)| index as u32 + u32::from(ret_needs_sret))
+            .collect();
+        let params_by_pointer = ffi_func
+            .signature
+            .params
+            .iter()
+            .any(|ty| needs_ptr_passing(ty, is_win64));
+        self.apply_ffi_effects(
+            function,
+            &ffi_func.signature.effects,
+            &pointer_params,
+            ret_needs_sret,
+            params_by_pointer,
+        );
+
         // Cache it under the user-facing name
         self.declared_functions.insert(name.to_string(), function);
 
         Ok(function)
     }
 
+    /// Turns a runtime function's declared effects into LLVM attributes.
+    /// `pointer_params` are the indices of string parameters; the hidden
+    /// `sret` slot and by-pointer struct parameters widen the argument
+    /// memory the function may touch.
+    fn apply_ffi_effects(
+        &self,
+        function: FunctionValue<'ctx>,
+        effects: &FfiEffects,
+        pointer_params: &[u32],
+        writes_sret: bool,
+        params_by_pointer: bool,
+    ) {
+        use inkwell::attributes::{Attribute, AttributeLoc};
+
+        let enum_attribute = |name: &str, value: u64| {
+            self.context
+                .create_enum_attribute(Attribute::get_named_enum_kind_id(name), value)
+        };
+
+        // Runtime functions are `extern "C"`, so a Rust panic aborts instead
+        // of unwinding into generated code.
+        function.add_attribute(AttributeLoc::Function, enum_attribute("nounwind", 0));
+        if effects.will_return {
+            function.add_attribute(AttributeLoc::Function, enum_attribute("willreturn", 0));
+        }
+
+        let mut memory = effects.memory;
+        if params_by_pointer {
+            memory.args = widen_access(memory.args, FfiAccess::Read);
+        }
+        if writes_sret {
+            memory.args = widen_access(memory.args, FfiAccess::Write);
+        }
+        if memory != FfiMemory::ANY {
+            function.add_attribute(
+                AttributeLoc::Function,
+                enum_attribute("memory", encode_memory(memory)),
+            );
+        }
+
+        let returns_pointer = function
+            .get_type()
+            .get_return_type()
+            .is_some_and(|ty| ty.is_pointer_type());
+        if effects.noalias_result && returns_pointer {
+            function.add_attribute(AttributeLoc::Return, enum_attribute("noalias", 0));
+        }
+        if effects.nonnull_args {
+            for &index in pointer_params {
+                function.add_attribute(AttributeLoc::Param(index), enum_attribute("nonnull", 0));
+            }
+        }
+    }
+
     fn get_or_declare_ffi_function(&mut self, name: &str) -> Result<FunctionValue<'ctx>> {
         if let Some(function) = self.declared_functions.get(name) {
             return Ok(*function);
@@ -754,6 +841,7 @@ impl<'ctx> Compiler<'ctx> {
         self.builder.position_at_end(entry);
 
         let mut ctx = FunctionContext::new();
+        self.stack_allocations = escape::non_escaping_allocations(func);
 
         // Bind arguments
         for (i, param) in func.params.iter().enumerate() {
@@ -833,6 +921,19 @@ impl<'ctx> Compiler<'ctx> {
         function: FunctionValue<'ctx>,
         name: &str,
         otter_type: OtterType,
+    ) -> Result<PointerValue<'ctx>> {
+        let llvm_type: BasicTypeEnum = self
+            .basic_type(otter_type)?
+            .unwrap_or_else(|| self.context.i8_type().into());
+
+        self.create_entry_block_alloca_of(function, name, llvm_type)
+    }
+
+    pub(super) fn create_entry_block_alloca_of(
+        &self,
+        function: FunctionValue<'ctx>,
+        name: &str,
+        llvm_type: BasicTypeEnum<'ctx>,
     ) -> Result<PointerValue<'ctx>> {
         let builder = self.context.create_builder();
         let entry_block = function.get_first_basic_block().unwrap();
@@ -844,33 +945,41 @@ impl<'ctx> Compiler<'ctx> {
             None => builder.position_at_end(entry_block),
         }
 
-        let llvm_type: BasicTypeEnum = self
-            .basic_type(otter_type)?
-            .unwrap_or_else(|| self.context.i8_type().into());
-
         Ok(builder.build_alloca(llvm_type, name)?)
     }
 
+    /// Runs the optimization pipeline for `level`. With PGO enabled the
+    /// module is instrumented, or optimized with `pgo_profile_file` when one
+    /// is given.
     pub(super) fn run_default_passes(
         &self,
         level: CodegenOptLevel,
-        _enable_pgo: bool,
-        _pgo_profile_file: Option<&Path>,
-        _inline_threshold: Option<u32>,
+        enable_pgo: bool,
+        pgo_profile_file: Option<&Path>,
+        inline_threshold: Option<u32>,
         target_machine: &TargetMachine,
-    ) {
-        if matches!(level, CodegenOptLevel::None) {
-            return;
-        }
+    ) -> Result<()> {
+        let pgo = match (enable_pgo, pgo_profile_file) {
+            (false, _) => PgoPhase::Off,
+            (true, None) => PgoPhase::Instrument,
+            (true, Some(_)) => PgoPhase::Optimize,
+        };
+        let Some(pipeline) = passes::pipeline(level, pgo) else {
+            return Ok(());
+        };
+        passes::configure(
+            inline_threshold,
+            pgo_profile_file.filter(|_| pgo == PgoPhase::Optimize),
+        )?;
 
-        // Simplified pass running for now
         let pass_options = PassBuilderOptions::create();
         pass_options.set_loop_interleaving(true);
         pass_options.set_loop_vectorization(true);
+        pass_options.set_loop_slp_vectorization(true);
 
-        let _ = self
-            .module
-            .run_passes("default<O2>", target_machine, pass_options);
+        self.module
+            .run_passes(&pipeline, target_machine, pass_options)
+            .map_err(|e| anyhow!("failed to run optimization pipeline `{pipeline}`: {e}"))
     }
 
     /// Build a heap allocation using the GC
@@ -915,3 +1024,28 @@ impl<'ctx> Compiler<'ctx> {
         Ok(())
     }
 }
+
+fn widen_access(current: FfiAccess, extra: FfiAccess) -> FfiAccess {
+    match access_bits(current) | access_bits(extra) {
+        0 => FfiAccess::None,
+        1 => FfiAccess::Read,
+        2 => FfiAccess::Write,
+        _ => FfiAccess::ReadWrite,
+    }
+}
+
+fn access_bits(access: FfiAccess) -> u64 {
+    match access {
+        FfiAccess::None => 0,
+        FfiAccess::Read => 1,
+        FfiAccess::Write => 2,
+        FfiAccess::ReadWrite => 3,
+    }
+}
+
+/// Encodes `memory` as the integer payload of LLVM's `memory` attribute: two
+/// mod/ref bits for each location, in the order argument memory,
+/// inaccessible memory, other memory.
+fn encode_memory(memory: FfiMemory) -> u64 {
+    access_bits(memory.args) | (access_bits(memory.runtime) << 2) | (access_bits(memory.other) << 4)
+}
@@ -1,11 +1,71 @@
 use anyhow::{Result, bail};
-use inkwell::values::{BasicValueEnum, FunctionValue};
+use inkwell::intrinsics::Intrinsic;
+use inkwell::values::{BasicValueEnum, FloatValue, FunctionValue, IntValue};
 
 use crate::llvm::compiler::Compiler;
-use crate::llvm::compiler::types::{EvaluatedValue, FunctionContext, OtterType, Variable};
+use crate::llvm::compiler::bounds::{self, RangeLoopPlan};
+use crate::llvm::compiler::types::{
+    EvaluatedValue, FunctionContext, ListView, OtterType, Variable,
+};
 use otterc_ast::nodes::{Block, Expr, Statement};
 use otterc_typecheck::TypeInfo;
 
+// NaN-boxing layout of runtime values, mirroring `otterc_runtime::stdlib::builtins`.
+/// Top 16 bits of a boxed value with its tag bits clear.
+const BOX_PREFIX_TOP: u64 = 0xfff8;
+const BOX_TAG_SHIFT: u64 = 48;
+const BOX_PAYLOAD_MASK: u64 = (1 << BOX_TAG_SHIFT) - 1;
+/// Tag of an integer stored inline as a sign-extended 48-bit payload.
+const TAG_INT: u64 = 2;
+/// Encoding of `true`: the bool tag (1) with payload 1.
+const ENCODED_TRUE: u64 = ((BOX_PREFIX_TOP | 1) << BOX_TAG_SHIFT) | 1;
+
+/// Range builtins a `for` loop runs as counted loops, with the runtime
+/// function that builds the list when the range is used as a value.
+pub(crate) const RANGE_BUILTINS: [(&str, &str); 4] = [
+    ("range", "range<int>"),
+    ("range_float", "range<float>"),
+    ("range_step", "range_step<int>"),
+    ("enumerate", "enumerate<list>"),
+];
+
+/// A range a `for` loop counts through without building its list.
+#[derive(Clone, Copy)]
+enum CountedRange<'ctx> {
+    /// `start..end` or `range(start, end)`.
+    Int {
+        start: IntValue<'ctx>,
+        end: IntValue<'ctx>,
+    },
+    /// `range_step(start, end, step)`.
+    IntStep {
+        start: IntValue<'ctx>,
+        end: IntValue<'ctx>,
+        step: IntValue<'ctx>,
+    },
+    /// `start..end` with a float bound, or `range_float(start, end)`.
+    Float {
+        start: FloatValue<'ctx>,
+        end: FloatValue<'ctx>,
+    },
+    /// `enumerate(list)`, counting through the list's indices.
+    Enumerate { list: IntValue<'ctx> },
+}
+
+/// The bounds of a unit-step integer range written in the source.
+fn unit_range_ends(iterable: &Expr) -> Option<(&Expr, &Expr)> {
+    match iterable {
+        Expr::Range { start, end } => Some((start.as_ref().as_ref(), end.as_ref().as_ref())),
+        Expr::Call { func, args } => match (func.as_ref().as_ref(), &args[..]) {
+            (Expr::Identifier(name), [start, end]) if name == "range" => {
+                Some((start.as_ref(), end.as_ref()))
+            }
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
 struct IteratorRuntime<'ctx> {
     create_fn: FunctionValue<'ctx>,
     has_next_fn: FunctionValue<'ctx>,
@@ -83,7 +143,16 @@ impl<'ctx> Compiler<'ctx> {
                     let alloca =
                         self.create_entry_block_alloca(function, name.as_ref(), var_ty.clone())?;
 
-                    if let Some(v) = val_value {
+                    if let Some(mut v) = val_value {
+                        // Stack-allocated enum values are the alloca itself;
+                        // variables hold enum values as `i64` handles.
+                        if let (BasicValueEnum::PointerValue(ptr), OtterType::Opaque) = (v, &var_ty)
+                        {
+                            v = self
+                                .builder
+                                .build_ptr_to_int(ptr, self.context.i64_type(), "enum_handle")?
+                                .into();
+                        }
                         // Coerce value to variable type if needed
                         let coerced_val = self.coerce_type(v, val_ty, var_ty.clone())?;
                         self.builder.build_store(alloca, coerced_val)?;
@@ -291,61 +360,17 @@ impl<'ctx> Compiler<'ctx> {
     ) -> Result<()> {
         use otterc_ast::nodes::Expr;
 
-        // Iterator protocol implementation for range-based for loops
-
-        // Check if iterable is a range expression
-        if let Expr::Range { start, end } = iterable {
-            // Evaluate start and end
-            let start_val = self.eval_expr(start.as_ref().as_ref(), ctx)?;
-            let end_val = self.eval_expr(end.as_ref().as_ref(), ctx)?;
-            let start_ty = start_val.ty.clone();
-
-            // Determine if we're using I64 or F64 range
-            let is_float = start_ty == OtterType::F64;
-
-            // Call the appropriate range function to get a list handle
-            let range_fn_name = if is_float {
-                "range<float>"
-            } else {
-                "range<int>"
-            };
-
-            let range_fn = self.get_or_declare_ffi_function(range_fn_name)?;
-
-            let list_handle = self.builder.build_call(
-                range_fn,
-                &[
-                    start_val.value.unwrap().into(),
-                    end_val.value.unwrap().into(),
-                ],
-                "range_list",
-            )?;
-
-            let list_val = list_handle.try_as_basic_value().left().unwrap();
-
-            // Now treat it as a list iteration
-            let iter_create_fn = self.get_or_declare_ffi_function("__otter_iter_array")?;
-            let iter_has_next_fn =
-                self.get_or_declare_ffi_function("__otter_iter_has_next_array")?;
-            let iter_next_fn = self.get_or_declare_ffi_function("__otter_iter_next_array")?;
-            let iter_free_fn = self.get_or_declare_ffi_function("__otter_iter_free_array")?;
-
-            self.lower_collection_for_loop(
-                var,
-                EvaluatedValue::with_value(list_val, OtterType::list_of(start_ty.clone())),
-                body,
-                function,
-                ctx,
-                IteratorRuntime {
-                    create_fn: iter_create_fn,
-                    has_next_fn: iter_has_next_fn,
-                    next_fn: iter_next_fn,
-                    free_fn: iter_free_fn,
-                    element_type: start_ty, // Elements of range have same type as start
-                },
-            )?;
-
-            Ok(())
+        // Ranges run as loops over a native induction variable
+        if let Some(range) = self.counted_range(iterable, ctx)? {
+            if let CountedRange::Int { start, end } = range
+                && let Some((start_expr, end_expr)) = unit_range_ends(iterable)
+                && let Some(plan) = bounds::plan_range_loop(var, start_expr, end_expr, body)
+                && self.can_version_loop(&plan, ctx)
+            {
+                return self
+                    .lower_versioned_range_loop(var, start, end, &plan, body, function, ctx);
+            }
+            self.lower_counted_loop(var, range, body, function, ctx)
         } else {
             // Handle other iterable types (arrays, strings, etc.)
             let iterable_val = self.eval_expr(iterable, ctx)?;
@@ -418,6 +443,487 @@ impl<'ctx> Compiler<'ctx> {
         }
     }
 
+    /// Evaluates `iterable` if it is a range a loop can count through
+    /// without building the list: `start..end` or a call to one of
+    /// [`RANGE_BUILTINS`] that the program does not define itself.
+    fn counted_range(
+        &mut self,
+        iterable: &Expr,
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<Option<CountedRange<'ctx>>> {
+        let (name, args) = match iterable {
+            Expr::Range { start, end } => {
+                let start = self.eval_expr(start.as_ref().as_ref(), ctx)?;
+                let end = self.eval_expr(end.as_ref().as_ref(), ctx)?;
+                if start.ty == OtterType::F64 || end.ty == OtterType::F64 {
+                    return Ok(Some(CountedRange::Float {
+                        start: self.float_range_bound(&start)?,
+                        end: self.float_range_bound(&end)?,
+                    }));
+                }
+                return Ok(Some(CountedRange::Int {
+                    start: self.int_range_bound(&start)?,
+                    end: self.int_range_bound(&end)?,
+                }));
+            }
+            Expr::Call { func, args } => match func.as_ref().as_ref() {
+                Expr::Identifier(name)
+                    if RANGE_BUILTINS.iter().any(|(builtin, _)| builtin == name)
+                        && !self.function_defaults.contains_key(name) =>
+                {
+                    (name.as_str(), args.as_slice())
+                }
+                _ => return Ok(None),
+            },
+            _ => return Ok(None),
+        };
+
+        let mut values = Vec::with_capacity(args.len());
+        for arg in args {
+            values.push(self.eval_expr(arg.as_ref(), ctx)?);
+        }
+        let range = match (name, &values[..]) {
+            ("range", [start, end]) => CountedRange::Int {
+                start: self.int_range_bound(start)?,
+                end: self.int_range_bound(end)?,
+            },
+            ("range_float", [start, end]) => CountedRange::Float {
+                start: self.float_range_bound(start)?,
+                end: self.float_range_bound(end)?,
+            },
+            ("range_step", [start, end, step]) => CountedRange::IntStep {
+                start: self.int_range_bound(start)?,
+                end: self.int_range_bound(end)?,
+                step: self.int_range_bound(step)?,
+            },
+            ("enumerate", [list]) => {
+                if !matches!(list.ty, OtterType::List(_) | OtterType::Opaque) {
+                    bail!("enumerate() expects a list, got {:?}", list.ty);
+                }
+                CountedRange::Enumerate {
+                    list: self.int_range_bound(list)?,
+                }
+            }
+            _ => bail!(
+                "wrong number of arguments for {name}(): got {}",
+                values.len()
+            ),
+        };
+        Ok(Some(range))
+    }
+
+    /// An integer range bound as an i64. Lists pass through as their handle.
+    fn int_range_bound(&self, value: &EvaluatedValue<'ctx>) -> Result<IntValue<'ctx>> {
+        let raw = value
+            .value
+            .ok_or_else(|| anyhow::anyhow!("range bound has no value"))?;
+        let target = match &value.ty {
+            OtterType::I32 | OtterType::I64 => OtterType::I64,
+            ty @ (OtterType::List(_) | OtterType::Opaque) => ty.clone(),
+            other => bail!("range bounds must be integers, got {other:?}"),
+        };
+        Ok(self
+            .coerce_type(raw, value.ty.clone(), target)?
+            .into_int_value())
+    }
+
+    fn float_range_bound(&self, value: &EvaluatedValue<'ctx>) -> Result<FloatValue<'ctx>> {
+        let raw = value
+            .value
+            .ok_or_else(|| anyhow::anyhow!("range bound has no value"))?;
+        if !matches!(value.ty, OtterType::I32 | OtterType::I64 | OtterType::F64) {
+            bail!("range bounds must be numbers, got {:?}", value.ty);
+        }
+        Ok(self
+            .coerce_type(raw, value.ty.clone(), OtterType::F64)?
+            .into_float_value())
+    }
+
+    /// Lowers `for var in range: body` as a loop over a native induction
+    /// variable, and leaves the builder in the block the loop exits to.
+    fn lower_counted_loop(
+        &mut self,
+        var: &str,
+        range: CountedRange<'ctx>,
+        body: &Block,
+        function: FunctionValue<'ctx>,
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<()> {
+        let i64_type = self.context.i64_type();
+        let f64_type = self.context.f64_type();
+        let (counter_ty, var_ty) = match range {
+            CountedRange::Int { .. } | CountedRange::IntStep { .. } => {
+                (OtterType::I64, OtterType::I64)
+            }
+            CountedRange::Float { .. } => (OtterType::F64, OtterType::F64),
+            CountedRange::Enumerate { .. } => (OtterType::I64, OtterType::Str),
+        };
+        let counter_type = self
+            .basic_type(counter_ty.clone())?
+            .ok_or_else(|| anyhow::anyhow!("range counter has no type"))?;
+
+        // The counter is separate from the loop variable so the variable
+        // keeps the last element after the loop.
+        let counter = self.create_entry_block_alloca(function, "range_counter", counter_ty)?;
+        let var_alloca = self.create_entry_block_alloca(function, var, var_ty.clone())?;
+        ctx.insert(
+            var.to_string(),
+            Variable {
+                ptr: var_alloca,
+                ty: var_ty,
+            },
+        );
+
+        let start: BasicValueEnum<'ctx> = match range {
+            CountedRange::Int { start, .. } | CountedRange::IntStep { start, .. } => start.into(),
+            CountedRange::Float { start, .. } => start.into(),
+            CountedRange::Enumerate { .. } => i64_type.const_zero().into(),
+        };
+        self.builder.build_store(counter, start)?;
+        // A stepped range runs up to `end` for a positive step, down to it
+        // for a negative one, and not at all for a zero step.
+        let direction = match range {
+            CountedRange::IntStep { step, .. } => Some((
+                self.builder.build_int_compare(
+                    inkwell::IntPredicate::SGT,
+                    step,
+                    i64_type.const_zero(),
+                    "ascending",
+                )?,
+                self.builder.build_int_compare(
+                    inkwell::IntPredicate::SLT,
+                    step,
+                    i64_type.const_zero(),
+                    "descending",
+                )?,
+            )),
+            _ => None,
+        };
+        let (list_len_fn, item_fn) = match range {
+            CountedRange::Enumerate { .. } => (
+                Some(self.get_or_declare_ffi_function("len<list>")?),
+                Some(self.get_or_declare_ffi_function("enumerate<list>.item")?),
+            ),
+            _ => (None, None),
+        };
+
+        let cond_bb = self.context.append_basic_block(function, "range_cond");
+        let body_bb = self.context.append_basic_block(function, "range_body");
+        let latch_bb = self.context.append_basic_block(function, "range_latch");
+        let exit_bb = self.context.append_basic_block(function, "range_exit");
+        self.builder.build_unconditional_branch(cond_bb)?;
+
+        self.builder.position_at_end(cond_bb);
+        let current = self.builder.build_load(counter_type, counter, "counter")?;
+        let in_range = match range {
+            CountedRange::Int { end, .. } => self.builder.build_int_compare(
+                inkwell::IntPredicate::SLT,
+                current.into_int_value(),
+                end,
+                "in_range",
+            )?,
+            CountedRange::IntStep { end, .. } => {
+                let (ascending, descending) =
+                    direction.ok_or_else(|| anyhow::anyhow!("stepped range has no direction"))?;
+                let below = self.builder.build_int_compare(
+                    inkwell::IntPredicate::SLT,
+                    current.into_int_value(),
+                    end,
+                    "below_end",
+                )?;
+                let above = self.builder.build_int_compare(
+                    inkwell::IntPredicate::SGT,
+                    current.into_int_value(),
+                    end,
+                    "above_end",
+                )?;
+                let above = self.builder.build_and(descending, above, "down_in_range")?;
+                self.builder
+                    .build_select(ascending, below, above, "in_range")?
+                    .into_int_value()
+            }
+            CountedRange::Float { end, .. } => self.builder.build_float_compare(
+                inkwell::FloatPredicate::OLT,
+                current.into_float_value(),
+                end,
+                "in_range",
+            )?,
+            CountedRange::Enumerate { list } => {
+                // The length is read on every iteration, as iterating the
+                // list itself does, so the body may grow or shrink the list.
+                let len_fn = list_len_fn.ok_or_else(|| anyhow::anyhow!("len<list> missing"))?;
+                let len = self
+                    .builder
+                    .build_call(len_fn, &[list.into()], "list_len")?
+                    .try_as_basic_value()
+                    .left()
+                    .ok_or_else(|| anyhow::anyhow!("len<list> returned void"))?
+                    .into_int_value();
+                self.builder.build_int_compare(
+                    inkwell::IntPredicate::SLT,
+                    current.into_int_value(),
+                    len,
+                    "in_range",
+                )?
+            }
+        };
+        self.builder
+            .build_conditional_branch(in_range, body_bb, exit_bb)?;
+
+        self.builder.position_at_end(body_bb);
+        let element = match range {
+            CountedRange::Enumerate { list } => {
+                let item_fn =
+                    item_fn.ok_or_else(|| anyhow::anyhow!("enumerate<list>.item missing"))?;
+                self.builder
+                    .build_call(item_fn, &[list.into(), current.into()], "enumerate_item")?
+                    .try_as_basic_value()
+                    .left()
+                    .ok_or_else(|| anyhow::anyhow!("enumerate<list>.item returned void"))?
+            }
+            _ => current,
+        };
+        self.builder.build_store(var_alloca, element)?;
+        ctx.push_loop(latch_bb, exit_bb);
+        self.lower_block(body, function, ctx)?;
+        ctx.pop_loop();
+        if self
+            .builder
+            .get_insert_block()
+            .and_then(|b| b.get_terminator())
+            .is_none()
+        {
+            self.builder.build_unconditional_branch(latch_bb)?;
+        }
+
+        self.builder.position_at_end(latch_bb);
+        let current = self.builder.build_load(counter_type, counter, "counter")?;
+        match range {
+            CountedRange::Int { .. } | CountedRange::Enumerate { .. } => {
+                // Cannot overflow: the counter is below an i64 bound.
+                let next = self.builder.build_int_nsw_add(
+                    current.into_int_value(),
+                    i64_type.const_int(1, false),
+                    "counter_next",
+                )?;
+                self.builder.build_store(counter, next)?;
+                self.builder.build_unconditional_branch(cond_bb)?;
+            }
+            CountedRange::IntStep { step, .. } => {
+                // A step past the end of i64 ends the range, as it does in
+                // `range_step<int>`.
+                let add = Intrinsic::find("llvm.sadd.with.overflow")
+                    .and_then(|intrinsic| {
+                        intrinsic.get_declaration(&self.module, &[i64_type.into()])
+                    })
+                    .ok_or_else(|| {
+                        anyhow::anyhow!("missing LLVM intrinsic llvm.sadd.with.overflow")
+                    })?;
+                let sum = self
+                    .builder
+                    .build_call(add, &[current.into(), step.into()], "counter_step")?
+                    .try_as_basic_value()
+                    .left()
+                    .ok_or_else(|| anyhow::anyhow!("llvm.sadd.with.overflow returned void"))?
+                    .into_struct_value();
+                let next = self.builder.build_extract_value(sum, 0, "counter_next")?;
+                let overflow = self
+                    .builder
+                    .build_extract_value(sum, 1, "counter_overflow")?
+                    .into_int_value();
+                self.builder.build_store(counter, next)?;
+                self.builder
+                    .build_conditional_branch(overflow, exit_bb, cond_bb)?;
+            }
+            CountedRange::Float { .. } => {
+                let next = self.builder.build_float_add(
+                    current.into_float_value(),
+                    f64_type.const_float(1.0),
+                    "counter_next",
+                )?;
+                self.builder.build_store(counter, next)?;
+                self.builder.build_unconditional_branch(cond_bb)?;
+            }
+        }
+
+        self.builder.position_at_end(exit_bb);
+        Ok(())
+    }
+
+    /// Whether every list `plan` views is a list variable and no call in the
+    /// body can modify a list, as versioning requires.
+    fn can_version_loop(&self, plan: &RangeLoopPlan, ctx: &FunctionContext<'ctx>) -> bool {
+        let lists_in_scope = plan.views.iter().all(|view| {
+            ctx.get(&view.list)
+                .is_some_and(|variable| matches!(variable.ty, OtterType::List(_)))
+        });
+        lists_in_scope
+            && plan.calls_preserve_lists(self.symbol_registry, |name| {
+                self.known_call_preserves_lists(name, ctx)
+            })
+    }
+
+    /// Verdict for the callees that do not go through the symbol registry.
+    fn known_call_preserves_lists(&self, name: &str, ctx: &FunctionContext<'ctx>) -> Option<bool> {
+        // Methods of local values dispatch on their runtime type.
+        if let Some((object, _)) = name.split_once('.')
+            && ctx.get(object).is_some()
+        {
+            return Some(false);
+        }
+        if name == "len" {
+            return Some(true);
+        }
+        if self.function_defaults.contains_key(name) {
+            return Some(false);
+        }
+        // Range builtins as loop iterables run as counted loops.
+        if RANGE_BUILTINS.iter().any(|(builtin, _)| *builtin == name) {
+            return Some(true);
+        }
+        None
+    }
+
+    /// Lowers a range loop that reads lists through its loop variable as two
+    /// versions, see [`bounds`]. Both are counted loops; the fast version
+    /// loads from views and the checked version calls the list getters.
+    #[expect(
+        clippy::too_many_arguments,
+        reason = "the inputs of lower_counted_loop plus the plan"
+    )]
+    fn lower_versioned_range_loop(
+        &mut self,
+        var: &str,
+        start: IntValue<'ctx>,
+        end: IntValue<'ctx>,
+        plan: &RangeLoopPlan,
+        body: &Block,
+        function: FunctionValue<'ctx>,
+        ctx: &mut FunctionContext<'ctx>,
+    ) -> Result<()> {
+        let i64_type = self.context.i64_type();
+
+        // One range check per view, made by the runtime as it copies the
+        // items the loop reads.
+        let mut views = Vec::with_capacity(plan.views.len());
+        let mut lengths = Vec::with_capacity(plan.views.len());
+        let mut handles = Vec::with_capacity(plan.views.len());
+        let mut all_valid = None;
+        for spec in &plan.views {
+            let list = ctx
+                .get(&spec.list)
+                .ok_or_else(|| anyhow::anyhow!("list {} is not in scope", spec.list))?;
+            let list = self
+                .builder
+                .build_load(i64_type, list.ptr, &spec.list)?
+                .into_int_value();
+            let low = self.builder.build_int_add(
+                start,
+                i64_type.const_int(spec.min_offset as u64, true),
+                "view_start",
+            )?;
+            let high = self.builder.build_int_add(
+                end,
+                i64_type.const_int(spec.max_offset as u64, true),
+                "view_end",
+            )?;
+            let constructor = self.get_or_declare_ffi_function(spec.kind.constructor())?;
+            let handle = self
+                .builder
+                .build_call(constructor, &[list.into(), low.into(), high.into()], "view")?
+                .try_as_basic_value()
+                .left()
+                .ok_or_else(|| anyhow::anyhow!("{} returned void", spec.kind.constructor()))?
+                .into_int_value();
+            let valid = self.builder.build_int_compare(
+                inkwell::IntPredicate::NE,
+                handle,
+                i64_type.const_zero(),
+                "view_valid",
+            )?;
+            all_valid = Some(match all_valid {
+                Some(previous) => self.builder.build_and(previous, valid, "views_valid")?,
+                None => valid,
+            });
+            let data = self
+                .builder
+                .build_int_to_ptr(handle, self.string_ptr_type, "view_data")?;
+            views.push(ListView {
+                list: spec.list.clone(),
+                kind: spec.kind,
+                index: var.to_string(),
+                base: low,
+                data,
+            });
+            lengths.push(self.builder.build_int_sub(high, low, "view_len")?);
+            handles.push(handle);
+        }
+        let all_valid = all_valid.ok_or_else(|| anyhow::anyhow!("versioned loop has no views"))?;
+
+        let fast_bb = self.context.append_basic_block(function, "fast_loop");
+        let checked_bb = self.context.append_basic_block(function, "checked_loop");
+        let merge_bb = self
+            .context
+            .append_basic_block(function, "versioned_loop_exit");
+        self.builder
+            .build_conditional_branch(all_valid, fast_bb, checked_bb)?;
+
+        let outer_variables = ctx.variables.clone();
+
+        self.builder.position_at_end(fast_bb);
+        let outer_views = ctx.list_views.len();
+        ctx.list_views.extend(views);
+        self.lower_counted_loop(var, CountedRange::Int { start, end }, body, function, ctx)?;
+        ctx.list_views.truncate(outer_views);
+        let done_bb = self
+            .builder
+            .get_insert_block()
+            .ok_or_else(|| anyhow::anyhow!("fast loop has no exit block"))?;
+
+        // Checked version. Views that were created are freed first; freeing
+        // a 0 view does nothing.
+        self.builder.position_at_end(checked_bb);
+        let free_fn = self.get_or_declare_ffi_function("list.view_free")?;
+        for (handle, length) in handles.iter().zip(&lengths) {
+            self.builder
+                .build_call(free_fn, &[(*handle).into(), (*length).into()], "")?;
+        }
+        if plan.in_bounds {
+            // The views can only be missing when the loop runs zero times.
+            self.builder.build_unconditional_branch(merge_bb)?;
+        } else {
+            let fast_variables = std::mem::replace(&mut ctx.variables, outer_variables);
+            self.lower_counted_loop(var, CountedRange::Int { start, end }, body, function, ctx)?;
+            self.builder.build_unconditional_branch(merge_bb)?;
+
+            // Both versions bind the loop variable and the body's `let`s to
+            // their own slots; code after the loop uses the checked version's.
+            self.builder.position_at_end(done_bb);
+            for (name, checked) in &ctx.variables {
+                let Some(fast) = fast_variables.get(name) else {
+                    continue;
+                };
+                if fast.ptr == checked.ptr || fast.ty != checked.ty {
+                    continue;
+                }
+                if let Some(ty) = self.basic_type(checked.ty.clone())? {
+                    let value = self.builder.build_load(ty, fast.ptr, name)?;
+                    self.builder.build_store(checked.ptr, value)?;
+                }
+            }
+        }
+
+        self.builder.position_at_end(done_bb);
+        for (handle, length) in handles.iter().zip(&lengths) {
+            self.builder
+                .build_call(free_fn, &[(*handle).into(), (*length).into()], "")?;
+        }
+        self.builder.build_unconditional_branch(merge_bb)?;
+
+        self.builder.position_at_end(merge_bb);
+        Ok(())
+    }
+
     fn lower_collection_for_loop(
         &mut self,
         var: &str,
@@ -501,8 +1007,7 @@ impl<'ctx> Compiler<'ctx> {
             .left()
             .ok_or_else(|| anyhow::anyhow!("next element failed"))?;
 
-        // Decode the runtime type tag and convert to the correct type
-        // The runtime now returns tagged values: upper 8 bits = type tag, lower 56 bits = data
+        // Decode the NaN-boxed runtime value and convert to the correct type
         let decoded_value = self.decode_and_convert_tagged_value(element_val, &element_ty)?;
         if let Some(value) = decoded_value {
             self.builder.build_store(var_alloca, value)?;
@@ -623,178 +1128,39 @@ impl<'ctx> Compiler<'ctx> {
         encoded_value: BasicValueEnum<'ctx>,
         expected_type: &OtterType,
     ) -> Result<Option<BasicValueEnum<'ctx>>> {
-        // Runtime values are encoded with type information in upper 8 bits
-        // and either the direct value or a handle to full-precision data in lower 56 bits
-        // Type tags: 0=Unit, 1=Bool, 2=I64, 3=F64, 4=String, 5=List, 6=Map
-
+        // Runtime values are NaN-boxed (see `otterc_runtime::stdlib::builtins`):
+        // doubles are stored as-is, everything else sits in the quiet-NaN space
+        // with a 3-bit tag and a 48-bit payload. Scalars are decoded inline; we
+        // trust the type checker and only coerce between integers and doubles.
         let encoded_int = encoded_value.into_int_value();
-
-        // First, decode based on the runtime's actual type tag
-        // Then convert to expected type if needed
-
-        // Get the runtime type tag (upper 8 bits)
-        let tag_shift = self.context.i64_type().const_int(56, false);
-        let runtime_tag =
-            self.builder
-                .build_right_shift(encoded_int, tag_shift, false, "runtime_tag")?;
-
-        // Decode the value based on its runtime type, then convert to expected type
-        // We'll use a switch-like approach: decode as the runtime type, then coerce
-
-        // For now, try decoding as the expected type first (most common case)
-        // If that fails at runtime, we'd need runtime type checking, but for now
-        // we trust the type checker and decode directly
+        let i64_type = self.context.i64_type();
 
         let decoded_value = match expected_type {
             OtterType::Unit => return Ok(None),
 
-            OtterType::Bool => {
-                let decode_fn = self.get_or_declare_ffi_function("__otter_decode_value_as_bool")?;
-                let result =
-                    self.builder
-                        .build_call(decode_fn, &[encoded_int.into()], "decoded_bool")?;
-                result.try_as_basic_value().left().unwrap()
-            }
-
-            OtterType::I64 => {
-                // Decode as I64, but runtime might have stored as F64
-                // Try I64 first, but we may need to handle F64->I64 conversion
-                let decode_i64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_i64")?;
-                let decode_f64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_f64")?;
-
-                // Check runtime tag: if it's F64 (tag 3), decode as F64 then convert
-                let tag_three = self.context.i64_type().const_int(3, false);
-                let is_f64 = self.builder.build_int_compare(
+            OtterType::Bool => self
+                .builder
+                .build_int_compare(
                     inkwell::IntPredicate::EQ,
-                    runtime_tag,
-                    tag_three,
-                    "is_f64_tag",
-                )?;
-
-                // Create basic blocks for conditional decoding
-                let function = self
-                    .builder
-                    .get_insert_block()
-                    .unwrap()
-                    .get_parent()
-                    .unwrap();
-                let decode_i64_bb = self.context.append_basic_block(function, "decode_i64");
-                let decode_f64_bb = self.context.append_basic_block(function, "decode_f64");
-                let merge_bb = self.context.append_basic_block(function, "decode_merge");
-
-                self.builder
-                    .build_conditional_branch(is_f64, decode_f64_bb, decode_i64_bb)?;
-
-                // Decode as I64
-                self.builder.position_at_end(decode_i64_bb);
-                let i64_result =
-                    self.builder
-                        .build_call(decode_i64_fn, &[encoded_int.into()], "decoded_i64")?;
-                let i64_val = i64_result.try_as_basic_value().left().unwrap();
-                self.builder.build_unconditional_branch(merge_bb)?;
-
-                // Decode as F64 then convert to I64
-                self.builder.position_at_end(decode_f64_bb);
-                let f64_result =
-                    self.builder
-                        .build_call(decode_f64_fn, &[encoded_int.into()], "decoded_f64")?;
-                let f64_val = f64_result
-                    .try_as_basic_value()
-                    .left()
-                    .unwrap()
-                    .into_float_value();
-                let converted_i64 = self.builder.build_float_to_signed_int(
-                    f64_val,
-                    self.context.i64_type(),
-                    "f64_to_i64",
-                )?;
-                self.builder.build_unconditional_branch(merge_bb)?;
+                    encoded_int,
+                    i64_type.const_int(ENCODED_TRUE, false),
+                    "decoded_bool",
+                )?
+                .into(),
 
-                // Merge: create PHI node
-                self.builder.position_at_end(merge_bb);
-                let phi = self
-                    .builder
-                    .build_phi(self.context.i64_type(), "decoded_phi")?;
-                phi.add_incoming(&[
-                    (&i64_val.into_int_value(), decode_i64_bb),
-                    (&converted_i64, decode_f64_bb),
-                ]);
-                phi.as_basic_value()
-            }
+            OtterType::I64 => self.decode_boxed_number(encoded_int, false)?,
 
-            OtterType::F64 => {
-                // Decode as F64, but runtime might have stored as I64
-                let decode_i64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_i64")?;
-                let decode_f64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_f64")?;
-
-                // Check runtime tag: if it's I64 (tag 2), decode as I64 then convert
-                let tag_two = self.context.i64_type().const_int(2, false);
-                let is_i64 = self.builder.build_int_compare(
-                    inkwell::IntPredicate::EQ,
-                    runtime_tag,
-                    tag_two,
-                    "is_i64_tag",
-                )?;
-
-                // Create basic blocks for conditional decoding
-                let function = self
-                    .builder
-                    .get_insert_block()
-                    .unwrap()
-                    .get_parent()
-                    .unwrap();
-                let decode_i64_bb = self
-                    .context
-                    .append_basic_block(function, "decode_i64_for_f64");
-                let decode_f64_bb = self
-                    .context
-                    .append_basic_block(function, "decode_f64_direct");
-                let merge_bb = self
-                    .context
-                    .append_basic_block(function, "decode_f64_merge");
+            OtterType::F64 => self.decode_boxed_number(encoded_int, true)?,
 
+            OtterType::I32 => {
+                let value = self.decode_boxed_number(encoded_int, false)?;
                 self.builder
-                    .build_conditional_branch(is_i64, decode_i64_bb, decode_f64_bb)?;
-
-                // Decode as I64 then convert to F64
-                self.builder.position_at_end(decode_i64_bb);
-                let i64_result =
-                    self.builder
-                        .build_call(decode_i64_fn, &[encoded_int.into()], "decoded_i64")?;
-                let i64_val = i64_result
-                    .try_as_basic_value()
-                    .left()
-                    .unwrap()
-                    .into_int_value();
-                let converted_f64 = self.builder.build_signed_int_to_float(
-                    i64_val,
-                    self.context.f64_type(),
-                    "i64_to_f64",
-                )?;
-                self.builder.build_unconditional_branch(merge_bb)?;
-
-                // Decode as F64 directly
-                self.builder.position_at_end(decode_f64_bb);
-                let f64_result =
-                    self.builder
-                        .build_call(decode_f64_fn, &[encoded_int.into()], "decoded_f64")?;
-                let f64_val = f64_result.try_as_basic_value().left().unwrap();
-                self.builder.build_unconditional_branch(merge_bb)?;
-
-                // Merge: create PHI node
-                self.builder.position_at_end(merge_bb);
-                let phi = self
-                    .builder
-                    .build_phi(self.context.f64_type(), "decoded_f64_phi")?;
-                phi.add_incoming(&[
-                    (&converted_f64, decode_i64_bb),
-                    (&f64_val.into_float_value(), decode_f64_bb),
-                ]);
-                phi.as_basic_value()
+                    .build_int_truncate(
+                        value.into_int_value(),
+                        self.context.i32_type(),
+                        "truncated_i32",
+                    )?
+                    .into()
             }
 
             OtterType::Str => {
@@ -806,119 +1172,112 @@ impl<'ctx> Compiler<'ctx> {
                 result.try_as_basic_value().left().unwrap()
             }
 
-            OtterType::List(_) | OtterType::Map | OtterType::Opaque => {
-                let decode_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_handle")?;
-                let result =
-                    self.builder
-                        .build_call(decode_fn, &[encoded_int.into()], "decoded_handle")?;
-                result.try_as_basic_value().left().unwrap()
-            }
-
-            OtterType::I32 => {
-                // Decode as I64 then truncate
-                let decode_i64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_i64")?;
-                let decode_f64_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_f64")?;
-
-                // Check runtime tag
-                let tag_two = self.context.i64_type().const_int(2, false);
-                let tag_three = self.context.i64_type().const_int(3, false);
-                let is_i64 = self.builder.build_int_compare(
-                    inkwell::IntPredicate::EQ,
-                    runtime_tag,
-                    tag_two,
-                    "is_i64_tag",
-                )?;
-                let is_f64 = self.builder.build_int_compare(
-                    inkwell::IntPredicate::EQ,
-                    runtime_tag,
-                    tag_three,
-                    "is_f64_tag",
-                )?;
-
-                let function = self
-                    .builder
-                    .get_insert_block()
-                    .unwrap()
-                    .get_parent()
-                    .unwrap();
-                let decode_i64_bb = self
-                    .context
-                    .append_basic_block(function, "decode_i64_for_i32");
-                let decode_f64_bb = self
-                    .context
-                    .append_basic_block(function, "decode_f64_for_i32");
-                let decode_other_bb = self
-                    .context
-                    .append_basic_block(function, "decode_other_for_i32");
-                let merge_bb = self
-                    .context
-                    .append_basic_block(function, "decode_i32_merge");
-
-                // Branch based on type
-                self.builder
-                    .build_conditional_branch(is_i64, decode_i64_bb, decode_other_bb)?;
-                self.builder.position_at_end(decode_other_bb);
-                self.builder
-                    .build_conditional_branch(is_f64, decode_f64_bb, decode_i64_bb)?;
+            // Lists, maps, structs and tuples are handles carried in the payload.
+            OtterType::List(_)
+            | OtterType::Map
+            | OtterType::Opaque
+            | OtterType::Struct(_)
+            | OtterType::Tuple(_) => self
+                .builder
+                .build_and(
+                    encoded_int,
+                    i64_type.const_int(BOX_PAYLOAD_MASK, false),
+                    "decoded_handle",
+                )?
+                .into(),
+        };
 
-                // Decode as I64
-                self.builder.position_at_end(decode_i64_bb);
-                let i64_result =
-                    self.builder
-                        .build_call(decode_i64_fn, &[encoded_int.into()], "decoded_i64")?;
-                let i64_val = i64_result
-                    .try_as_basic_value()
-                    .left()
-                    .unwrap()
-                    .into_int_value();
-                let truncated = self.builder.build_int_truncate(
-                    i64_val,
-                    self.context.i32_type(),
-                    "truncated_i32",
-                )?;
-                self.builder.build_unconditional_branch(merge_bb)?;
+        Ok(Some(decoded_value))
+    }
 
-                // Decode as F64 then convert to I32
-                self.builder.position_at_end(decode_f64_bb);
-                let f64_result =
-                    self.builder
-                        .build_call(decode_f64_fn, &[encoded_int.into()], "decoded_f64")?;
-                let f64_val = f64_result
-                    .try_as_basic_value()
-                    .left()
-                    .unwrap()
-                    .into_float_value();
-                let converted_i32 = self.builder.build_float_to_signed_int(
-                    f64_val,
-                    self.context.i32_type(),
-                    "f64_to_i32",
-                )?;
-                self.builder.build_unconditional_branch(merge_bb)?;
+    /// Decode a NaN-boxed number as `i64` (or `f64` when `as_float`), converting
+    /// between the two as needed. Inline integers and doubles are decoded with a
+    /// few bit operations; only wide boxed integers call into the runtime.
+    fn decode_boxed_number(
+        &mut self,
+        encoded: IntValue<'ctx>,
+        as_float: bool,
+    ) -> Result<BasicValueEnum<'ctx>> {
+        let i64_type = self.context.i64_type();
+        let f64_type = self.context.f64_type();
+        let payload_bits = i64_type.const_int(64 - BOX_TAG_SHIFT, false);
+
+        let top = self.builder.build_right_shift(
+            encoded,
+            i64_type.const_int(BOX_TAG_SHIFT, false),
+            false,
+            "boxed_top",
+        )?;
+        let is_int = self.builder.build_int_compare(
+            inkwell::IntPredicate::EQ,
+            top,
+            i64_type.const_int(BOX_PREFIX_TOP | TAG_INT, false),
+            "is_inline_int",
+        )?;
+        let is_double = self.builder.build_int_compare(
+            inkwell::IntPredicate::ULT,
+            top,
+            i64_type.const_int(BOX_PREFIX_TOP, false),
+            "is_double",
+        )?;
 
-                // Merge
-                self.builder.position_at_end(merge_bb);
-                let phi = self
-                    .builder
-                    .build_phi(self.context.i32_type(), "decoded_i32_phi")?;
-                phi.add_incoming(&[(&truncated, decode_i64_bb), (&converted_i32, decode_f64_bb)]);
-                phi.as_basic_value()
-            }
+        let shifted = self
+            .builder
+            .build_left_shift(encoded, payload_bits, "int_payload")?;
+        let int_value =
+            self.builder
+                .build_right_shift(shifted, payload_bits, true, "inline_int")?;
+        let double_value = self
+            .builder
+            .build_bit_cast(encoded, f64_type, "boxed_double")?
+            .into_float_value();
 
-            OtterType::Struct(_) | OtterType::Tuple(_) => {
-                // Structs and tuples are handled as opaque handles
-                let decode_fn =
-                    self.get_or_declare_ffi_function("__otter_decode_value_as_handle")?;
-                let result =
-                    self.builder
-                        .build_call(decode_fn, &[encoded_int.into()], "decoded_handle")?;
-                result.try_as_basic_value().left().unwrap()
-            }
+        let fast_value: BasicValueEnum<'ctx> = if as_float {
+            let converted =
+                self.builder
+                    .build_signed_int_to_float(int_value, f64_type, "i64_to_f64")?;
+            self.builder
+                .build_select(is_int, converted, double_value, "fast_f64")?
+        } else {
+            let converted =
+                self.builder
+                    .build_float_to_signed_int(double_value, i64_type, "f64_to_i64")?;
+            self.builder
+                .build_select(is_int, int_value, converted, "fast_i64")?
         };
+        let is_fast = self.builder.build_or(is_int, is_double, "is_fast")?;
+
+        let fast_bb = self.builder.get_insert_block().unwrap();
+        let function = fast_bb.get_parent().unwrap();
+        let slow_bb = self
+            .context
+            .append_basic_block(function, "decode_boxed_slow");
+        let merge_bb = self
+            .context
+            .append_basic_block(function, "decode_boxed_merge");
+        self.builder
+            .build_conditional_branch(is_fast, merge_bb, slow_bb)?;
 
-        Ok(Some(decoded_value))
+        self.builder.position_at_end(slow_bb);
+        let decode_fn = self.get_or_declare_ffi_function(if as_float {
+            "__otter_decode_value_as_f64"
+        } else {
+            "__otter_decode_value_as_i64"
+        })?;
+        let slow_value = self
+            .builder
+            .build_call(decode_fn, &[encoded.into()], "decoded_boxed")?
+            .try_as_basic_value()
+            .left()
+            .unwrap();
+        self.builder.build_unconditional_branch(merge_bb)?;
+
+        self.builder.position_at_end(merge_bb);
+        let phi = self
+            .builder
+            .build_phi(fast_value.get_type(), "decoded_number")?;
+        phi.add_incoming(&[(&fast_value, fast_bb), (&slow_value, slow_bb)]);
+        Ok(phi.as_basic_value())
     }
 
     #[expect(dead_code, reason = "Work in progress")]
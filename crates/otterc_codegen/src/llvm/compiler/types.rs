@@ -1,7 +1,9 @@
 use inkwell::basic_block::BasicBlock;
-use inkwell::values::{BasicValueEnum, PointerValue};
+use inkwell::values::{BasicValueEnum, IntValue, PointerValue};
 use std::collections::HashMap;
 
+use crate::llvm::compiler::bounds::ViewKind;
+
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub enum OtterType {
     Unit,
@@ -64,11 +66,26 @@ pub struct LoopContext<'ctx> {
     pub exit_bb: BasicBlock<'ctx>,
 }
 
+/// Copy of the list items a versioned loop reads, see
+/// [`bounds`](crate::llvm::compiler::bounds).
+#[derive(Debug, Clone)]
+pub struct ListView<'ctx> {
+    pub list: String,
+    pub kind: ViewKind,
+    /// Loop variable the view is indexed by.
+    pub index: String,
+    /// List index of the first item in the view.
+    pub base: IntValue<'ctx>,
+    pub data: PointerValue<'ctx>,
+}
+
 #[derive(Debug, Clone)]
 pub struct FunctionContext<'ctx> {
     pub variables: HashMap<String, Variable<'ctx>>,
     pub loop_stack: Vec<LoopContext<'ctx>>,
     pub exception_landingpad: Option<BasicBlock<'ctx>>,
+    /// Views of the enclosing versioned loops, innermost last.
+    pub list_views: Vec<ListView<'ctx>>,
 }
 
 impl<'ctx> FunctionContext<'ctx> {
@@ -77,6 +94,7 @@ impl<'ctx> FunctionContext<'ctx> {
             variables: HashMap::new(),
             loop_stack: Vec::new(),
             exception_landingpad: None,
+            list_views: Vec::new(),
         }
     }
 
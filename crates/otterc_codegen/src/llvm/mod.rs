@@ -2,6 +2,7 @@ pub mod bridges;
 pub mod build;
 pub mod compiler;
 pub mod config;
+mod passes;
 
 pub use build::{build_executable, build_shared_library, current_llvm_version};
 pub use config::BuildArtifact;
@@ -0,0 +1,117 @@
+//! Optimization pipeline selection.
+//!
+//! Modules are optimized with LLVM's new pass manager `default<O*>` pipelines.
+//! IR-level profile-guided optimization adds `pgo-instr-gen` (instrumented
+//! build) or `pgo-instr-use` (optimized build) in front of the pipeline. The
+//! settings the pipeline text cannot express, the inliner threshold and the
+//! profile read by `pgo-instr-use`, are passed as LLVM command-line options.
+
+use std::collections::HashMap;
+use std::ffi::CString;
+use std::path::Path;
+use std::sync::{LazyLock, Mutex, PoisonError};
+
+use anyhow::{Result, bail};
+use inkwell::llvm_sys::support::LLVMParseCommandLineOptions;
+use otterc_config::CodegenOptLevel;
+
+/// Cleanup run before the PGO passes. Instrumented and optimized builds run
+/// the same passes here, so both see the same control flow graphs and the
+/// profile's function hashes match.
+const PGO_PREPARE: &str = "function(sroa,early-cse,simplifycfg)";
+
+/// LLVM options set so far. LLVM keeps them in process-wide globals and
+/// rejects an option given twice, so each one is only ever set once.
+static LLVM_OPTIONS: LazyLock<Mutex<HashMap<&'static str, String>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// How a build takes part in profile-guided optimization.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum PgoPhase {
+    Off,
+    Instrument,
+    Optimize,
+}
+
+/// Pass pipeline for `level`, or `None` when nothing needs to run.
+pub(crate) fn pipeline(level: CodegenOptLevel, pgo: PgoPhase) -> Option<String> {
+    let mut passes = Vec::new();
+    match pgo {
+        PgoPhase::Off if level == CodegenOptLevel::None => return None,
+        PgoPhase::Off => {}
+        PgoPhase::Instrument => passes.extend([PGO_PREPARE, "pgo-instr-gen"]),
+        PgoPhase::Optimize => passes.extend([PGO_PREPARE, "pgo-instr-use"]),
+    }
+    let default = level.pipeline();
+    passes.push(&default);
+    if pgo == PgoPhase::Instrument {
+        // Lower the counters last so the optimizer can still move them.
+        passes.push("instrprof");
+    }
+    Some(passes.join(","))
+}
+
+/// Applies the options that must be in place before the pipeline runs.
+pub(crate) fn configure(inline_threshold: Option<u32>, profile: Option<&Path>) -> Result<()> {
+    if let Some(threshold) = inline_threshold {
+        set_llvm_option("inline-threshold", threshold.to_string())?;
+    }
+    if let Some(profile) = profile {
+        if !profile.is_file() {
+            bail!("PGO profile {} does not exist", profile.display());
+        }
+        set_llvm_option("pgo-test-profile-file", profile.display().to_string())?;
+    }
+    Ok(())
+}
+
+fn set_llvm_option(name: &'static str, value: String) -> Result<()> {
+    let mut options = LLVM_OPTIONS.lock().unwrap_or_else(PoisonError::into_inner);
+    if let Some(current) = options.get(name) {
+        if *current == value {
+            return Ok(());
+        }
+        bail!("LLVM option -{name} is already set to {current} in this process");
+    }
+
+    let program = CString::new("otter")?;
+    let argument = CString::new(format!("-{name}={value}"))?;
+    let argv = [program.as_ptr(), argument.as_ptr()];
+    // SAFETY: `argv` holds two valid NUL-terminated strings that outlive the
+    // call, and the lock above serializes access to LLVM's option globals.
+    unsafe {
+        LLVMParseCommandLineOptions(argv.len() as i32, argv.as_ptr(), std::ptr::null());
+    }
+    options.insert(name, value);
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn pipeline_matches_the_level_and_pgo_phase() {
+        assert_eq!(pipeline(CodegenOptLevel::None, PgoPhase::Off), None);
+        assert_eq!(
+            pipeline(CodegenOptLevel::Less, PgoPhase::Off).as_deref(),
+            Some("default<O1>")
+        );
+        assert_eq!(
+            pipeline(CodegenOptLevel::Aggressive, PgoPhase::Off).as_deref(),
+            Some("default<O3>")
+        );
+        assert_eq!(
+            pipeline(CodegenOptLevel::MinSize, PgoPhase::Off).as_deref(),
+            Some("default<Oz>")
+        );
+        assert_eq!(
+            pipeline(CodegenOptLevel::None, PgoPhase::Instrument).as_deref(),
+            Some("function(sroa,early-cse,simplifycfg),pgo-instr-gen,default<O0>,instrprof")
+        );
+        assert_eq!(
+            pipeline(CodegenOptLevel::Size, PgoPhase::Optimize).as_deref(),
+            Some("function(sroa,early-cse,simplifycfg),pgo-instr-use,default<Os>")
+        );
+    }
+}
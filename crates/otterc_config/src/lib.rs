@@ -4,7 +4,8 @@ pub mod tiered_compiler;
 pub use crate::target::TargetTriple;
 pub use crate::tiered_compiler::*;
 use inkwell::OptimizationLevel;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
+use std::str::FromStr;
 
 pub const VERSION: &str = env!("CARGO_PKG_VERSION");
 
@@ -46,9 +47,60 @@ impl LanguageFeatureFlags {
 /// Codegen optimization level
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum CodegenOptLevel {
+    /// `-O0`
     None,
+    /// `-O1`
+    Less,
+    /// `-O2`
     Default,
+    /// `-O3`
     Aggressive,
+    /// `-Os`: optimize, preferring smaller code
+    Size,
+    /// `-Oz`: optimize for the smallest code
+    MinSize,
+}
+
+impl CodegenOptLevel {
+    /// Suffix used by LLVM pipeline names and compiler driver flags.
+    pub fn suffix(self) -> &'static str {
+        match self {
+            CodegenOptLevel::None => "0",
+            CodegenOptLevel::Less => "1",
+            CodegenOptLevel::Default => "2",
+            CodegenOptLevel::Aggressive => "3",
+            CodegenOptLevel::Size => "s",
+            CodegenOptLevel::MinSize => "z",
+        }
+    }
+
+    /// Name of the LLVM new pass manager pipeline for this level.
+    pub fn pipeline(self) -> String {
+        format!("default<O{}>", self.suffix())
+    }
+
+    /// Matching C compiler driver flag, e.g. `-O3`.
+    pub fn driver_flag(self) -> String {
+        format!("-O{}", self.suffix())
+    }
+}
+
+impl FromStr for CodegenOptLevel {
+    type Err = String;
+
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        match s.trim_start_matches('O') {
+            "0" => Ok(CodegenOptLevel::None),
+            "1" => Ok(CodegenOptLevel::Less),
+            "2" => Ok(CodegenOptLevel::Default),
+            "3" => Ok(CodegenOptLevel::Aggressive),
+            "s" => Ok(CodegenOptLevel::Size),
+            "z" => Ok(CodegenOptLevel::MinSize),
+            _ => Err(format!(
+                "unknown optimization level '{s}' (expected 0, 1, 2, 3, s or z)"
+            )),
+        }
+    }
 }
 
 /// Codegen options
@@ -57,9 +109,15 @@ pub struct CodegenOptions {
     pub emit_ir: bool,
     pub opt_level: CodegenOptLevel,
     pub enable_lto: bool,
+    /// Profile-guided optimization. Without `pgo_profile_file` the build is
+    /// instrumented to record a profile; with it, the merged `.profdata`
+    /// profile drives optimization.
     pub enable_pgo: bool,
     pub pgo_profile_file: Option<PathBuf>,
+    /// Overrides the inliner's cost threshold for every optimization level
     pub inline_threshold: Option<u32>,
+    /// Link Rust bridge crates as LTO bitcode archives instead of shared libraries
+    pub static_bridges: bool,
     /// Target triple for cross-compilation (defaults to native)
     pub target: Option<TargetTriple>,
 }
@@ -73,16 +131,38 @@ impl Default for CodegenOptions {
             enable_pgo: false,
             pgo_profile_file: None,
             inline_threshold: None,
+            static_bridges: false,
             target: None,
         }
     }
 }
 
+impl CodegenOptions {
+    /// Whether this build is instrumented to record a PGO profile.
+    pub fn pgo_instrument(&self) -> bool {
+        self.enable_pgo && self.pgo_profile_file.is_none()
+    }
+
+    /// Merged profile this build is optimized with, if any.
+    pub fn pgo_profile(&self) -> Option<&Path> {
+        if self.enable_pgo {
+            self.pgo_profile_file.as_deref()
+        } else {
+            None
+        }
+    }
+}
+
 impl From<CodegenOptLevel> for OptimizationLevel {
     fn from(value: CodegenOptLevel) -> Self {
         match value {
             CodegenOptLevel::None => OptimizationLevel::None,
-            CodegenOptLevel::Default => OptimizationLevel::Default,
+            CodegenOptLevel::Less => OptimizationLevel::Less,
+            // Size levels shrink code in the IR pipeline; instruction
+            // selection still runs at the default level, as clang does.
+            CodegenOptLevel::Default | CodegenOptLevel::Size | CodegenOptLevel::MinSize => {
+                OptimizationLevel::Default
+            }
             CodegenOptLevel::Aggressive => OptimizationLevel::Aggressive,
         }
     }
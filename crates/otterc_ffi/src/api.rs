@@ -1,4 +1,4 @@
-use std::ffi::{CStr, CString};
+use std::ffi::CString;
 use std::os::raw::c_char;
 
 use anyhow::{Context, Result};
@@ -10,7 +10,7 @@ pub fn otter_to_cstring(input: &str) -> Result<*mut c_char> {
         .into_raw())
 }
 
-/// Reconstructs a Rust `String` from an FFI-owned pointer and frees it using the
+/// Reconstructs a Rust `String` from an FFI-owned pointer, taking over its buffer via the
 /// standard `CString::from_raw` workflow.
 ///
 /// # Safety
@@ -22,12 +22,10 @@ pub unsafe fn cstring_to_otter(ptr: *mut c_char) -> Result<String> {
             return Ok(String::new());
         }
 
-        let value = CStr::from_ptr(ptr)
-            .to_str()
-            .context("failed to decode UTF-8 from ffi pointer")?
-            .to_owned();
-        drop(CString::from_raw(ptr));
-        Ok(value)
+        // Reclaim the bridge's allocation instead of copying out of it.
+        CString::from_raw(ptr)
+            .into_string()
+            .context("failed to decode UTF-8 from ffi pointer")
     }
 }
 
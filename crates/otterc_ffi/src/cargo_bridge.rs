@@ -7,7 +7,7 @@ use tracing::debug;
 
 use otterc_cache::path::cache_root;
 
-use super::rust_stubgen::RustStubGenerator;
+use super::rust_stubgen::{BRIDGE_STUB_VERSION, RustStubGenerator, STATIC_BRIDGE_CFG};
 use super::rustdoc_extractor::extract_crate_spec;
 use super::symbol_registry::BridgeSymbolRegistry;
 use super::types::{BridgeMetadata, CrateSpec, StubSource};
@@ -18,6 +18,20 @@ pub struct BridgeArtifacts {
     pub crate_root: PathBuf,
     pub manifest_path: PathBuf,
     pub library_path: PathBuf,
+    /// LTO-ready static archive, present when built via
+    /// [`CargoBridge::ensure_static_bridge`].
+    pub static_library_path: Option<PathBuf>,
+}
+
+/// How bridge crates are linked into Otter executables.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub enum BridgeLinkage {
+    /// Link against the bridge's `cdylib`, resolved by the dynamic loader at startup.
+    #[default]
+    Dynamic,
+    /// Link the bridge's `staticlib`, whose objects are LLVM bitcode so the
+    /// final LTO link can inline bridge functions into Otter code.
+    Static,
 }
 
 /// Coordinates stub generation, cargo builds, and symbol registration.
@@ -45,8 +59,8 @@ impl CargoBridge {
         let metadata = self.registry.ensure_metadata(crate_name)?;
         let cache_hash = metadata.dependency.cache_hash();
 
-        // Use hash-based cache directory: <crate_name>-<hash>
-        let cache_dir_name = format!("{}-{}", crate_name, cache_hash);
+        // Use hash-based cache directory: <crate_name>-<hash>-v<stub version>
+        let cache_dir_name = format!("{crate_name}-{cache_hash}-v{BRIDGE_STUB_VERSION}");
         let crate_root = self.root.join(&cache_dir_name);
 
         // Check if library already exists in cache
@@ -67,6 +81,7 @@ impl CargoBridge {
                 crate_root: crate_root.clone(),
                 manifest_path: crate_root.join("Cargo.toml"),
                 library_path: cached_library,
+                static_library_path: None,
             });
         }
 
@@ -127,9 +142,23 @@ impl CargoBridge {
             crate_root: crate_root.clone(),
             manifest_path: crate_root.join("Cargo.toml"),
             library_path,
+            static_library_path: None,
         })
     }
 
+    /// Like [`Self::ensure_bridge`], but additionally builds the bridge as a
+    /// `staticlib` compiled with `-Clinker-plugin-lto`. The dynamic library is
+    /// still produced because the compiler reads the bridge's export table
+    /// from it.
+    pub fn ensure_static_bridge(&self, crate_name: &str) -> Result<BridgeArtifacts> {
+        let mut artifacts = self.ensure_bridge(crate_name)?;
+        let static_library = self
+            .build_static_bridge(crate_name, &artifacts.crate_root)
+            .context("failed to compile static bridge crate")?;
+        artifacts.static_library_path = Some(static_library);
+        Ok(artifacts)
+    }
+
     fn write_bridge_with_functions(
         &self,
         metadata: &BridgeMetadata,
@@ -212,4 +241,74 @@ impl CargoBridge {
             Ok(library_path)
         }
     }
+
+    fn build_static_bridge(&self, crate_name: &str, crate_root: &Path) -> Result<PathBuf> {
+        let package_name = format!("otterffi_{crate_name}");
+        // Bitcode objects need their own target dir so they never mix with the
+        // dynamic build's native artifacts.
+        let target_dir = crate_root.join("target-lto");
+        let library_path = target_dir
+            .join("release")
+            .join(static_library_filename(&package_name));
+
+        if library_path.exists() {
+            return Ok(library_path);
+        }
+
+        fs::create_dir_all(&target_dir).with_context(|| {
+            format!(
+                "failed to create cargo target directory {}",
+                target_dir.display()
+            )
+        })?;
+
+        // RUSTFLAGS (rather than `cargo rustc -- ...`) so the wrapped crate and
+        // its dependencies are emitted as bitcode too, not just the stub.
+        let mut rustflags = std::env::var("RUSTFLAGS").unwrap_or_default();
+        if !rustflags.is_empty() {
+            rustflags.push(' ');
+        }
+        // The static build drops the exports every bridge shares, which
+        // would otherwise clash at link time.
+        rustflags.push_str("-Clinker-plugin-lto --cfg ");
+        rustflags.push_str(STATIC_BRIDGE_CFG);
+
+        let manifest_path = crate_root.join("Cargo.toml");
+        let output = duct::cmd!(
+            "cargo",
+            "rustc",
+            "--release",
+            "--lib",
+            "--crate-type",
+            "staticlib",
+            "--manifest-path",
+            &manifest_path
+        )
+        .dir(crate_root)
+        .env("CARGO_TARGET_DIR", &target_dir)
+        .env("RUSTFLAGS", rustflags)
+        .run()
+        .with_context(|| format!("failed to build static bridge crate `{crate_name}`"))?;
+
+        if !output.status.success() {
+            bail!("cargo rustc failed for static bridge crate `{crate_name}`");
+        }
+
+        if !library_path.exists() {
+            Err(anyhow!(
+                "expected static library `{}` not found",
+                library_path.display()
+            ))
+        } else {
+            Ok(library_path)
+        }
+    }
+}
+
+fn static_library_filename(package_name: &str) -> String {
+    if cfg!(target_env = "msvc") {
+        format!("{package_name}.lib")
+    } else {
+        format!("lib{package_name}.a")
+    }
 }
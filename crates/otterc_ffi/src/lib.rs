@@ -15,7 +15,7 @@ pub mod rustdoc_extractor;
 pub mod symbol_registry;
 pub mod types;
 
-pub use cargo_bridge::{BridgeArtifacts, CargoBridge};
+pub use cargo_bridge::{BridgeArtifacts, BridgeLinkage, CargoBridge};
 pub use dynamic::DynamicLibraryBackend;
 pub use dynamic_loader::{DynamicLibrary, DynamicLibraryLoader};
 pub use exports::{ExportFn, StableExportSet, StableFunction, register_dynamic_exports};
@@ -17,6 +17,28 @@ enum ArgContext<'a> {
     },
 }
 
+/// Version of the exports every generated bridge provides. Part of the bridge
+/// cache key, so cached bridges are regenerated when it changes.
+pub const BRIDGE_STUB_VERSION: u32 = 2;
+
+/// `cfg` set when a bridge is built as a staticlib and linked into the
+/// executable together with the runtime and other bridges.
+pub const STATIC_BRIDGE_CFG: &str = "otter_static_bridge";
+
+/// Symbol of the JSON dispatcher of the bridge for `crate_name`.
+///
+/// Each bridge also exports its dispatcher and handle helpers under shared
+/// names (`otter_call_json`, `otter_free`, ...) that the dynamic loader looks
+/// up per library. Statically linked bridges share one symbol namespace, so
+/// there they only export the crate-scoped names.
+pub fn json_dispatch_symbol(crate_name: &str) -> String {
+    format!("otter_{}__call_json", crate_name.replace('-', "_"))
+}
+
+fn scoped_helper_symbol(crate_name: &str, helper: &str) -> String {
+    format!("otter_{}__{helper}", crate_name.replace('-', "_"))
+}
+
 /// Emits the `Cargo.toml` and `lib.rs` contents for a bridge crate.
 #[derive(Clone, Debug)]
 pub struct RustStubGenerator {
@@ -80,15 +102,28 @@ impl RustStubGenerator {
 
                 if sig.is_async || matches!(sig.return_type, Some(RustTypeRef::Future { .. })) {
                     let spawn_name = format!("{}.{}_spawn", export_name, sig.name);
+                    // String arguments are borrowed from the caller, so the
+                    // spawned task has to own copies of them. The future is
+                    // awaited inside the task because it may borrow them.
                     let spawn_expr = {
                         let rp = rust_path.clone().unwrap();
+                        let owned = params
+                            .iter()
+                            .enumerate()
+                            .filter(|(_, param)| matches!(param, TypeSpec::Str))
+                            .map(|(i, _)| format!("let owned{i} = String::from({{{i}}}); "))
+                            .collect::<String>();
+                        let args = params
+                            .iter()
+                            .enumerate()
+                            .map(|(i, param)| match param {
+                                TypeSpec::Str => format!("&owned{i}"),
+                                _ => format!("{{{i}}}"),
+                            })
+                            .collect::<Vec<_>>()
+                            .join(", ");
                         format!(
-                            "ffi_store::insert(rt().spawn(async move {{ {rp}({args}) }}))",
-                            rp = rp,
-                            args = (0..params.len())
-                                .map(|i| format!("{{{}}}", i))
-                                .collect::<Vec<_>>()
-                                .join(", ")
+                            "{{ {owned}ffi_store::insert(rt().spawn(async move {{ {rp}({args}).await }})) }}"
                         )
                     };
                     out.push(FunctionSpec {
@@ -227,6 +262,9 @@ impl RustStubGenerator {
         manifest.push_str("serde = { version = \"1.0\", features = [\"derive\"] }\n");
         manifest.push_str("serde_json = \"1.0\"\n");
         manifest.push_str("tokio = { version = \"1\", features = [\"rt-multi-thread\"] }\n");
+        manifest.push_str(&format!(
+            "\n[lints.rust]\nunexpected_cfgs = {{ level = \"warn\", check-cfg = [\"cfg({STATIC_BRIDGE_CFG})\"] }}\n"
+        ));
         manifest
     }
 
@@ -270,12 +308,19 @@ impl RustStubGenerator {
         source.push_str(
             "static RUNTIME: once_cell::sync::Lazy<Runtime> = once_cell::sync::Lazy::new(|| {\n    tokio::runtime::Builder::new_multi_thread().enable_all().build().expect(\"failed to build tokio runtime\")\n});\n\nfn rt() -> &'static Runtime { &*RUNTIME }\n\n",
         );
-        source.push_str(
-            "#[no_mangle]\npub extern \"C\" fn otter_free(ptr: *mut c_char) {\n    if ptr.is_null() {\n        return;\n    }\n    unsafe {\n        let _ = CString::from_raw(ptr);\n    }\n}\n\n",
-        );
-        source.push_str(
-            "#[no_mangle]\npub extern \"C\" fn otter_handle_clone(handle: i64) -> i64 {\n    ffi_store::clone_handle(handle)\n}\n\n#[no_mangle]\npub extern \"C\" fn otter_handle_release(handle: i64) {\n    ffi_store::release_handle(handle)\n}\n\n",
-        );
+        let free = scoped_helper_symbol(&self.dependency.name, "free");
+        let handle_clone = scoped_helper_symbol(&self.dependency.name, "handle_clone");
+        let handle_release = scoped_helper_symbol(&self.dependency.name, "handle_release");
+        source.push_str(&format!(
+            "#[no_mangle]\npub extern \"C\" fn {free}(ptr: *mut c_char) {{\n    if ptr.is_null() {{\n        return;\n    }}\n    unsafe {{\n        let _ = CString::from_raw(ptr);\n    }}\n}}\n\n"
+        ));
+        source.push_str(&format!(
+            "#[no_mangle]\npub extern \"C\" fn {handle_clone}(handle: i64) -> i64 {{\n    ffi_store::clone_handle(handle)\n}}\n\n#[no_mangle]\npub extern \"C\" fn {handle_release}(handle: i64) {{\n    ffi_store::release_handle(handle)\n}}\n\n"
+        ));
+        let call_json = json_dispatch_symbol(&self.dependency.name);
+        source.push_str(&format!(
+            "#[cfg(not({STATIC_BRIDGE_CFG}))]\nmod shared_exports {{\n    use super::*;\n\n    #[no_mangle]\n    pub extern \"C\" fn otter_free(ptr: *mut c_char) {{\n        super::{free}(ptr)\n    }}\n\n    #[no_mangle]\n    pub extern \"C\" fn otter_handle_clone(handle: i64) -> i64 {{\n        super::{handle_clone}(handle)\n    }}\n\n    #[no_mangle]\n    pub extern \"C\" fn otter_handle_release(handle: i64) {{\n        super::{handle_release}(handle)\n    }}\n\n    #[no_mangle]\n    pub extern \"C\" fn otter_call_json(func: *const c_char, args_json: *const c_char) -> *mut c_char {{\n        super::{call_json}(func, args_json)\n    }}\n}}\n\n"
+        ));
 
         for function in functions {
             self.render_function(function, &mut source);
@@ -415,17 +460,18 @@ impl RustStubGenerator {
     }
 
     fn render_json_dispatch(&self, functions: &[FunctionSpec], out: &mut String) {
+        out.push_str(&format!(
+            "#[no_mangle]\npub extern \"C\" fn {}(func: *const c_char, args_json: *const c_char) -> *mut c_char {{\n",
+            json_dispatch_symbol(&self.dependency.name)
+        ));
         out.push_str(
-            "#[no_mangle]\npub extern \"C\" fn otter_call_json(func: *const c_char, args_json: *const c_char) -> *mut c_char {\n",
-        );
-        out.push_str(
-            "    let func_name = unsafe {\n        if func.is_null() {\n            return std::ptr::null_mut();\n        }\n        match CStr::from_ptr(func).to_str() {\n            Ok(value) => value.to_owned(),\n            Err(_) => return std::ptr::null_mut(),\n        }\n    };\n",
+            "    let func_name = unsafe {\n        if func.is_null() {\n            return std::ptr::null_mut();\n        }\n        match CStr::from_ptr(func).to_str() {\n            Ok(value) => value,\n            Err(_) => return std::ptr::null_mut(),\n        }\n    };\n",
         );
         out.push_str(
-            "    let args_string = unsafe {\n        if args_json.is_null() {\n            String::from(\"[]\")\n        } else {\n            match CStr::from_ptr(args_json).to_str() {\n                Ok(value) => value.to_owned(),\n                Err(_) => return std::ptr::null_mut(),\n            }\n        }\n    };\n",
+            "    let args_str: &str = unsafe {\n        if args_json.is_null() {\n            \"[]\"\n        } else {\n            match CStr::from_ptr(args_json).to_str() {\n                Ok(value) => value,\n                Err(_) => return std::ptr::null_mut(),\n            }\n        }\n    };\n",
         );
         out.push_str(
-            "    let invocation = || -> Result<String, String> {\n        let args_value: Value = serde_json::from_str(&args_string).map_err(|e| e.to_string())?;\n        let args_array = args_value.as_array().ok_or_else(|| \"expected array\".to_string())?;\n        match func_name.as_str() {\n",
+            "    let invocation = || -> Result<String, String> {\n        let args_value: Value = serde_json::from_str(args_str).map_err(|e| e.to_string())?;\n        let args_array = args_value.as_array().ok_or_else(|| \"expected array\".to_string())?;\n        match func_name {\n",
         );
         for function in functions {
             let key = &function.name;
@@ -477,9 +523,10 @@ impl RustStubGenerator {
     }
 
     fn render_exports(&self, functions: &[FunctionSpec], out: &mut String) {
-        out.push_str(
-            "#[no_mangle]\npub extern \"C\" fn otterlang_exports() -> StableExportSet {\n",
-        );
+        // Only the dynamic library's export table is read.
+        out.push_str(&format!(
+            "#[cfg(not({STATIC_BRIDGE_CFG}))]\n#[no_mangle]\npub extern \"C\" fn otterlang_exports() -> StableExportSet {{\n"
+        ));
         if functions.is_empty() {
             out.push_str("    StableExportSet { functions: RVec::from(vec![]) }\n}\n\n");
             return;
@@ -522,15 +569,17 @@ impl RustStubGenerator {
                         default_return,
                     },
                 ) => {
-                    let owned = format!("arg{idx}_string");
+                    // Borrow the caller's buffer for the duration of the call
+                    // instead of copying it into an owned `String`.
+                    let borrowed = format!("arg{idx}_str");
                     setup.push(format!(
-                        "{indent}let {owned} = unsafe {{\n{indent}    if {arg_name}.is_null() {{\n{indent}        String::new()\n{indent}    }} else {{\n{indent}        match CStr::from_ptr({arg_name}).to_str() {{\n{indent}            Ok(value) => value.to_owned(),\n{indent}            Err(_) => return {default_return},\n{indent}        }}\n{indent}    }}\n{indent}}};\n",
+                        "{indent}let {borrowed}: &str = unsafe {{\n{indent}    if {arg_name}.is_null() {{\n{indent}        \"\"\n{indent}    }} else {{\n{indent}        match CStr::from_ptr({arg_name}).to_str() {{\n{indent}            Ok(value) => value,\n{indent}            Err(_) => return {default_return},\n{indent}        }}\n{indent}    }}\n{indent}}};\n",
                         indent = indent,
-                        owned = owned,
+                        borrowed = borrowed,
                         arg_name = arg_name,
                         default_return = default_return
                     ));
-                    call_args.push(format!("&{owned}"));
+                    call_args.push(borrowed);
                 }
                 (
                     TypeSpec::Str,
@@ -540,7 +589,7 @@ impl RustStubGenerator {
                         func_name,
                     },
                 ) => {
-                    let owned = format!("arg{idx}_string");
+                    let borrowed = format!("arg{idx}_str");
                     setup.push(format!(
                         "{indent}let {arg_name}_value = {array}.get({idx}).ok_or_else(|| format!(\"missing argument {idx} for {func}\"))?;\n",
                         indent = indent,
@@ -550,14 +599,14 @@ impl RustStubGenerator {
                         func = func_name
                     ));
                     setup.push(format!(
-                        "{indent}let {owned} = {arg_name}_value.as_str().ok_or_else(|| format!(\"argument {idx} for {func} must be a string\"))?.to_owned();\n",
+                        "{indent}let {borrowed} = {arg_name}_value.as_str().ok_or_else(|| format!(\"argument {idx} for {func} must be a string\"))?;\n",
                         indent = indent,
-                        owned = owned,
+                        borrowed = borrowed,
                         arg_name = arg_name,
                         idx = idx,
                         func = func_name
                     ));
-                    call_args.push(format!("&{owned}"));
+                    call_args.push(borrowed);
                 }
                 (
                     TypeSpec::F64,
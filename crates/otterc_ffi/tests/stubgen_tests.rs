@@ -0,0 +1,96 @@
+use otterc_ffi::{
+    CallTemplate, CrateSpec, DependencyConfig, FnSig, PublicItem, RustPath, RustStubGenerator,
+    RustTypeRef,
+};
+
+fn generator() -> RustStubGenerator {
+    RustStubGenerator::new(
+        "fetcher".to_string(),
+        DependencyConfig {
+            name: "fetcher".to_string(),
+            version: Some("0.1".to_string()),
+            path: None,
+            features: Vec::new(),
+            default_features: true,
+        },
+    )
+}
+
+#[test]
+fn async_spawn_stub_awaits_with_owned_string_arguments() {
+    let spec = CrateSpec {
+        name: "fetcher".to_string(),
+        version: Some("0.1".to_string()),
+        items: vec![PublicItem::Function {
+            sig: FnSig {
+                name: "fetch".to_string(),
+                params: vec![
+                    RustTypeRef::Ref {
+                        mutable: false,
+                        inner: Box::new(RustTypeRef::Str),
+                        lifetime: None,
+                    },
+                    RustTypeRef::I64,
+                ],
+                return_type: Some(RustTypeRef::String),
+                is_async: true,
+                generics: Vec::new(),
+            },
+            path: RustPath {
+                segments: Vec::new(),
+            },
+            doc: None,
+        }],
+    };
+
+    let generator = generator();
+    let functions = generator.functions_from_crate_spec(&spec);
+    let spawn = functions
+        .iter()
+        .find(|function| function.name == "fetch.fetch_spawn")
+        .expect("async fn gets a spawn stub");
+    let CallTemplate::Expr(call) = &spawn.call else {
+        unreachable!("spawn stubs are expression templates");
+    };
+    assert!(call.contains("let owned0 = String::from({0});"), "{call}");
+    // The future borrows `owned0`, so it must be awaited inside the task
+    // that owns it rather than returned from the block.
+    assert!(
+        call.contains("async move { fetcher::fetch(&owned0, {1}).await }"),
+        "{call}"
+    );
+
+    let source = generator.generate(&functions).source;
+    assert!(source.contains("fetcher::fetch(&owned0, "), "{source}");
+    assert!(source.contains(").await }"), "{source}");
+}
+
+#[test]
+fn static_bridges_export_only_crate_scoped_helpers() {
+    let source = generator().generate(&[]).source;
+    let shared = source
+        .find("mod shared_exports")
+        .expect("bridges keep the shared exports for dynamic loading");
+    let gate = format!(
+        "#[cfg(not({}))]\nmod shared_exports",
+        otterc_ffi::rust_stubgen::STATIC_BRIDGE_CFG
+    );
+    assert!(source.contains(&gate), "{source}");
+    for helper in [
+        "otter_free",
+        "otter_handle_clone",
+        "otter_handle_release",
+        "otter_call_json",
+    ] {
+        let position = source
+            .find(&format!("fn {helper}("))
+            .expect("shared helper is generated");
+        assert!(position > shared, "{helper} must be inside shared_exports");
+    }
+    let dispatch = otterc_ffi::rust_stubgen::json_dispatch_symbol("fetcher");
+    assert_eq!(dispatch, "otter_fetcher__call_json");
+    assert!(
+        source.contains(&format!("pub extern \"C\" fn {dispatch}(")),
+        "{source}"
+    );
+}
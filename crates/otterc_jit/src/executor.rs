@@ -4,6 +4,7 @@ use otterc_ast::nodes::Program;
 use otterc_metrics::profiler::FunctionMetrics;
 use otterc_symbol::registry::SymbolRegistry;
 use std::collections::HashMap;
+use std::sync::Arc;
 
 /// Simplified JIT executor for running programs
 pub struct JitExecutor {
@@ -15,7 +16,7 @@ pub struct JitExecutor {
 impl JitExecutor {
     /// Create a new JIT executor with default LLVM backend
     pub fn new(
-        program: &Program,
+        program: impl Into<Arc<Program>>,
         symbol_registry: &'static SymbolRegistry,
     ) -> anyhow::Result<Self> {
         Self::new_with_backend(program, symbol_registry)
@@ -23,7 +24,7 @@ impl JitExecutor {
 
     /// Create a new JIT executor with specified backend
     pub fn new_with_backend(
-        program: &Program,
+        program: impl Into<Arc<Program>>,
         symbol_registry: &'static SymbolRegistry,
     ) -> anyhow::Result<Self> {
         let mut engine = JitEngine::new_with_backend(symbol_registry)?;
@@ -37,7 +38,7 @@ impl JitExecutor {
     }
 
     /// Recompile the current program without rebuilding the entire engine
-    pub fn recompile(&mut self, program: &Program) -> Result<()> {
+    pub fn recompile(&mut self, program: impl Into<Arc<Program>>) -> Result<()> {
         self.engine.compile_program(program)
     }
 
@@ -10,6 +10,6 @@ pub mod specialization;
 pub mod tiered_compiler;
 
 pub use concurrency::ConcurrencyManager;
-pub use engine::JitEngine;
+pub use engine::{JitEngine, NullaryFunction};
 pub use executor::JitExecutor;
 pub use layout::DataLayoutOptimizer;
@@ -23,16 +23,18 @@ impl Reoptimizer {
 
     pub fn with_opt_level(opt_level: CodegenOptLevel) -> Self {
         let inline_config = match opt_level {
-            CodegenOptLevel::None => InlineConfig {
+            CodegenOptLevel::None | CodegenOptLevel::MinSize => InlineConfig {
                 max_inline_size: 24,
                 max_depth: 1,
                 inline_hot_only: true,
             },
-            CodegenOptLevel::Default => InlineConfig {
-                max_inline_size: 48,
-                max_depth: 2,
-                inline_hot_only: true,
-            },
+            CodegenOptLevel::Less | CodegenOptLevel::Default | CodegenOptLevel::Size => {
+                InlineConfig {
+                    max_inline_size: 48,
+                    max_depth: 2,
+                    inline_hot_only: true,
+                }
+            }
             CodegenOptLevel::Aggressive => InlineConfig {
                 max_inline_size: 80,
                 max_depth: 3,
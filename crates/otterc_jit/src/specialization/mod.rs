@@ -39,7 +39,8 @@ impl From<FfiType> for RuntimeType {
             | FfiType::List
             | FfiType::Map
             | FfiType::Struct { .. }
-            | FfiType::Tuple(_) => RuntimeType::Opaque,
+            | FfiType::Tuple(_)
+            | FfiType::Function { .. } => RuntimeType::Opaque,
         }
     }
 }
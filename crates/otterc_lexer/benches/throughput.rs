@@ -0,0 +1,61 @@
+//! Lexer throughput over the bundled `examples/` and `stdlib/` sources.
+//!
+//! Run with `cargo bench -p otterc_lexer`.
+
+#![expect(clippy::print_stdout, reason = "Benchmark reports go to stdout")]
+
+use std::fs;
+use std::path::{Path, PathBuf};
+
+use otterc_lexer::tokenize;
+use otterc_utils::bench::Benchmark;
+
+const ITERATIONS: usize = 200;
+
+fn collect_sources(dir: &Path, out: &mut Vec<PathBuf>) {
+    let Ok(entries) = fs::read_dir(dir) else {
+        return;
+    };
+    for entry in entries.flatten() {
+        let path = entry.path();
+        if path.is_dir() {
+            collect_sources(&path, out);
+        } else if path.extension().is_some_and(|ext| ext == "ot") {
+            out.push(path);
+        }
+    }
+}
+
+fn bench_corpus(name: &str, dir: &Path) {
+    let mut paths = Vec::new();
+    collect_sources(dir, &mut paths);
+    paths.sort();
+    let sources: Vec<String> = paths
+        .iter()
+        .filter_map(|path| fs::read_to_string(path).ok())
+        .collect();
+    let bytes: usize = sources.iter().map(String::len).sum();
+    if bytes == 0 {
+        println!("{name}: no sources found in {}", dir.display());
+        return;
+    }
+
+    let result = Benchmark::new(format!("lex {name}"), ITERATIONS).run(|| {
+        for source in &sources {
+            let _ = tokenize(source);
+        }
+    });
+
+    let mb_per_sec = bytes as f64 / result.median().as_secs_f64() / 1_000_000.0;
+    println!(
+        "{name}: {} files, {bytes} bytes, median {:?}, {mb_per_sec:.1} MB/s",
+        sources.len(),
+        result.median(),
+    );
+}
+
+fn main() {
+    let root = Path::new(env!("CARGO_MANIFEST_DIR")).join("../..");
+    bench_corpus("examples", &root.join("examples"));
+    bench_corpus("stdlib", &root.join("stdlib"));
+}
@@ -104,24 +104,65 @@ impl LexerError {
 
 pub type LexResult<T> = Result<T, Vec<LexerError>>;
 
+// Byte classes used to find the end of token runs without per-byte branching.
+const CLASS_IDENT: u8 = 1 << 0;
+const CLASS_NUMBER: u8 = 1 << 1;
+const CLASS_NON_ASCII: u8 = 1 << 2;
+const CLASS_BLANK: u8 = 1 << 3;
+
+static BYTE_CLASS: [u8; 256] = build_byte_class_table();
+
+const fn build_byte_class_table() -> [u8; 256] {
+    let mut table = [0u8; 256];
+    let mut byte = 0;
+    while byte < 256 {
+        let ch = byte as u8;
+        let mut class = 0;
+        if ch.is_ascii_alphanumeric() || ch == b'_' {
+            class |= CLASS_IDENT;
+        }
+        if ch.is_ascii_digit() || ch == b'_' {
+            class |= CLASS_NUMBER;
+        }
+        if ch > 127 {
+            class |= CLASS_NON_ASCII;
+        }
+        if ch == b' ' || ch == b'\t' {
+            class |= CLASS_BLANK;
+        }
+        table[byte] = class;
+        byte += 1;
+    }
+    table
+}
+
+fn unescape(escaped: u8) -> char {
+    match escaped {
+        b'n' => '\n',
+        b't' => '\t',
+        b'r' => '\r',
+        _ => escaped as char, // `\\`, `\"`, `\{` etc. and unknown escapes keep the byte
+    }
+}
+
 // Optimized lexer state machine
-struct LexerState {
+struct LexerState<'a> {
     tokens: Vec<Token>,
     errors: Vec<LexerError>,
     indent_stack: Vec<usize>,
-    source: Vec<u8>,
+    source: &'a [u8],
     offset: usize,
     line: usize,
     column: usize,
 }
 
-impl LexerState {
-    fn new(source: &str) -> Self {
+impl<'a> LexerState<'a> {
+    fn new(source: &'a str) -> Self {
         Self {
             tokens: Vec::new(),
             errors: Vec::new(),
             indent_stack: vec![0],
-            source: source.as_bytes().to_vec(),
+            source: source.as_bytes(),
             offset: 0,
             line: 1,
             column: 1,
@@ -161,6 +202,42 @@ impl LexerState {
         }
     }
 
+    /// Advance over `count` bytes that are known not to contain a line break.
+    fn advance_in_line(&mut self, count: usize) {
+        self.offset += count;
+        self.column += count;
+    }
+
+    /// Length of the run at the current offset whose bytes all belong to `class`.
+    fn class_run_len(&self, class: u8) -> usize {
+        let rest = &self.source[self.offset..];
+        rest.iter()
+            .position(|&byte| BYTE_CLASS[byte as usize] & class == 0)
+            .unwrap_or(rest.len())
+    }
+
+    /// Copy `len` bytes of string text into `result`. The run must start and
+    /// end on character boundaries and must not contain a line break.
+    fn take_text(&mut self, len: usize, result: &mut String) {
+        let text = &self.source[self.offset..self.offset + len];
+        result.push_str(unsafe { std::str::from_utf8_unchecked(text) });
+        self.advance_in_line(len);
+    }
+
+    /// Consume a backslash escape inside a string literal.
+    fn take_escape(&mut self, result: &mut String) {
+        self.advance_in_line(1); // Skip backslash
+        match self.current_char() {
+            Some(escaped) if escaped.is_ascii() => {
+                result.push(unescape(escaped));
+                self.advance(1);
+            }
+            // A non-ASCII character after the backslash is kept as-is and copied
+            // with the next run of text.
+            _ => {}
+        }
+    }
+
     fn newline_len_at(&self, offset: usize) -> Option<usize> {
         match self.source.get(offset) {
             Some(b'\n') => Some(1),
@@ -225,7 +302,7 @@ pub fn tokenize(source: &str) -> LexResult<Vec<Token>> {
     }
 }
 
-impl LexerState {
+impl LexerState<'_> {
     fn process_line(&mut self) {
         let line_start = self.offset;
         let mut indent_width = 0;
@@ -240,8 +317,12 @@ impl LexerState {
 
             match ch {
                 b' ' => {
-                    indent_width += 1;
-                    self.advance(1);
+                    let spaces = self.source[self.offset..]
+                        .iter()
+                        .position(|&byte| byte != b' ')
+                        .unwrap_or(self.source.len() - self.offset);
+                    indent_width += spaces;
+                    self.advance_in_line(spaces);
                 }
                 b'\t' => {
                     let span = self.create_span(self.offset, 1);
@@ -288,7 +369,8 @@ impl LexerState {
 
             match ch {
                 b' ' | b'\t' => {
-                    self.advance(1);
+                    let blanks = self.class_run_len(CLASS_BLANK);
+                    self.advance_in_line(blanks);
                 }
                 b'#' => break,
                 _ => {
@@ -348,7 +430,8 @@ impl LexerState {
                     return;
                 }
                 b' ' | b'\t' => {
-                    self.advance(1);
+                    let blanks = self.class_run_len(CLASS_BLANK);
+                    self.advance_in_line(blanks);
                 }
                 _ => {
                     self.tokenize_token(start);
@@ -532,112 +615,87 @@ impl LexerState {
 
     fn tokenize_string(&mut self) {
         let start = self.offset;
-        self.advance(1); // Skip opening quote
+        self.advance_in_line(1); // Skip opening quote
+
+        if let Some(result) = self.scan_single_line_string(start) {
+            let span = Span::new(start, self.offset);
+            self.tokens
+                .push(Token::new(TokenKind::StringLiteral(result), span));
+        }
+    }
+
+    fn tokenize_fstring(&mut self) {
+        let start = self.offset;
+        self.advance_in_line(2); // Skip f"
+
+        if let Some(result) = self.scan_single_line_string(start) {
+            let span = Span::new(start, self.offset);
+            self.tokens
+                .push(Token::new(TokenKind::FString(result), span));
+        }
+    }
 
+    /// Scan the body of a `"` or `f"` string up to and including the closing
+    /// quote. Plain text between quotes, escapes and line breaks is located
+    /// with a vectorized search and copied in one go.
+    fn scan_single_line_string(&mut self, start: usize) -> Option<String> {
         let mut result = String::new();
 
-        while let Some(ch) = self.current_char() {
-            if self.current_newline_len().is_some() {
-                let span = self.create_span(start, self.offset - start);
-                self.emit_error(LexerError::UnterminatedString {
-                    line: self.line,
-                    column: self.column,
-                    span,
-                });
-                return;
-            }
+        loop {
+            let rest = &self.source[self.offset..];
+            let stop = memchr::memchr3(b'"', b'\\', b'\n', rest).unwrap_or(rest.len());
+            // A lone `\r` is a line break too; it is rare enough to look for
+            // only within the run.
+            let text_len = memchr::memchr(b'\r', &rest[..stop]).unwrap_or(stop);
+            self.take_text(text_len, &mut result);
 
-            match ch {
-                b'"' => {
-                    let span = Span::new(start, self.offset + 1);
-                    self.tokens
-                        .push(Token::new(TokenKind::StringLiteral(result), span));
-                    self.advance(1);
-                    return;
-                }
-                b'\\' => {
-                    // Escape sequence
-                    self.advance(1);
-                    if let Some(escaped) = self.current_char() {
-                        let escaped_char = match escaped {
-                            b'n' => '\n',
-                            b't' => '\t',
-                            b'r' => '\r',
-                            b'\\' => '\\',
-                            b'"' => '"',
-                            b'\'' => '\'',
-                            _ => escaped as char, // Unknown escape, keep as-is
-                        };
-                        result.push(escaped_char);
-                        self.advance(1);
-                    }
-                }
-                _ => {
-                    result.push(ch as char);
-                    self.advance(1);
+            match self.current_char() {
+                Some(b'"') => {
+                    self.advance_in_line(1);
+                    return Some(result);
                 }
+                Some(b'\\') => self.take_escape(&mut result),
+                // Line break or end of input
+                _ => break,
             }
         }
 
-        // Unterminated string at EOF
         let span = self.create_span(start, self.offset - start);
         self.emit_error(LexerError::UnterminatedString {
             line: self.line,
             column: self.column,
             span,
         });
+        None
     }
 
     fn tokenize_multiline_string(&mut self) {
         let start = self.offset;
-        self.advance(3); // Skip opening """
+        self.advance_in_line(3); // Skip opening """
 
         let mut result = String::new();
 
-        while let Some(ch) = self.current_char() {
-            if self.current_newline_len().is_some() {
-                // Actual newline in multi-line string
-                result.push('\n');
-                self.advance(1);
-                continue;
-            }
+        loop {
+            let rest = &self.source[self.offset..];
+            let stop = memchr::memchr2(b'"', b'\\', rest).unwrap_or(rest.len());
+            self.take_multiline_text(stop, &mut result);
 
-            match ch {
-                b'"' => {
+            match self.current_char() {
+                Some(b'"') => {
                     // Check if this is the closing """
                     if self.peek_char(1) == Some(b'"') && self.peek_char(2) == Some(b'"') {
                         let span = Span::new(start, self.offset + 3);
                         self.tokens
                             .push(Token::new(TokenKind::StringLiteral(result), span));
-                        self.advance(3); // Skip closing """
+                        self.advance_in_line(3); // Skip closing """
                         return;
-                    } else {
-                        // Just a regular " in the string
-                        result.push('"');
-                        self.advance(1);
                     }
+                    // Just a regular " in the string
+                    result.push('"');
+                    self.advance_in_line(1);
                 }
-                b'\\' => {
-                    // Escape sequence (same as regular strings)
-                    self.advance(1);
-                    if let Some(escaped) = self.current_char() {
-                        let escaped_char = match escaped {
-                            b'n' => '\n',
-                            b't' => '\t',
-                            b'r' => '\r',
-                            b'\\' => '\\',
-                            b'"' => '"',
-                            b'\'' => '\'',
-                            _ => escaped as char, // Unknown escape, keep as-is
-                        };
-                        result.push(escaped_char);
-                        self.advance(1);
-                    }
-                }
-                _ => {
-                    result.push(ch as char);
-                    self.advance(1);
-                }
+                Some(b'\\') => self.take_escape(&mut result),
+                _ => break,
             }
         }
 
@@ -650,92 +708,39 @@ impl LexerState {
         });
     }
 
-    fn tokenize_fstring(&mut self) {
-        let start = self.offset;
-        self.advance(2); // Skip f"
-
-        let mut result = String::new();
-
-        while let Some(ch) = self.current_char() {
-            if self.current_newline_len().is_some() {
-                let span = self.create_span(start, self.offset - start);
-                self.emit_error(LexerError::UnterminatedString {
-                    line: self.line,
-                    column: self.column,
-                    span,
-                });
-                return;
-            }
-
-            match ch {
-                b'"' => {
-                    let span = Span::new(start, self.offset + 1);
-                    self.tokens
-                        .push(Token::new(TokenKind::FString(result), span));
-                    self.advance(1);
-                    return;
-                }
-                b'\\' => {
-                    // Escape sequence
-                    self.advance(1);
-                    if let Some(escaped) = self.current_char() {
-                        let escaped_char = match escaped {
-                            b'n' => '\n',
-                            b't' => '\t',
-                            b'r' => '\r',
-                            b'\\' => '\\',
-                            b'"' => '"',
-                            b'\'' => '\'',
-                            b'{' => '{',
-                            b'}' => '}',
-                            _ => escaped as char, // Unknown escape, keep as-is
-                        };
-                        result.push(escaped_char);
-                        self.advance(1);
-                    }
-                }
-                _ => {
-                    result.push(ch as char);
+    /// Like [`Self::take_text`], but the run may span lines. Every line break
+    /// is normalized to `\n`.
+    fn take_multiline_text(&mut self, len: usize, result: &mut String) {
+        let end = self.offset + len;
+        while self.offset < end {
+            let rest = &self.source[self.offset..end];
+            match memchr::memchr2(b'\n', b'\r', rest) {
+                Some(line_len) => {
+                    self.take_text(line_len, result);
+                    result.push('\n');
                     self.advance(1);
                 }
+                None => self.take_text(rest.len(), result),
             }
         }
-
-        // Unterminated fstring at EOF
-        let span = self.create_span(start, self.offset - start);
-        self.emit_error(LexerError::UnterminatedString {
-            line: self.line,
-            column: self.column,
-            span,
-        });
     }
 
     fn tokenize_number(&mut self) {
         let start = self.offset;
 
         // Parse integer part
-        while let Some(ch) = self.current_char() {
-            if ch.is_ascii_digit() || ch == b'_' {
-                self.advance(1);
-            } else {
-                break;
-            }
-        }
+        let digits = self.class_run_len(CLASS_NUMBER);
+        self.advance_in_line(digits);
 
         // Parse decimal part
         if let Some(b'.') = self.current_char()
             && let Some(next) = self.peek_char(1)
             && next.is_ascii_digit()
         {
-            self.advance(1); // Skip decimal point
+            self.advance_in_line(1); // Skip decimal point
 
-            while let Some(ch) = self.current_char() {
-                if ch.is_ascii_digit() || ch == b'_' {
-                    self.advance(1);
-                } else {
-                    break;
-                }
-            }
+            let digits = self.class_run_len(CLASS_NUMBER);
+            self.advance_in_line(digits);
         }
 
         let value = unsafe { std::str::from_utf8_unchecked(&self.source[start..self.offset]) };
@@ -748,14 +753,8 @@ impl LexerState {
 
     fn tokenize_identifier_or_keyword(&mut self) {
         let start = self.offset;
-
-        while let Some(ch) = self.current_char() {
-            if ch.is_ascii_alphanumeric() || ch == b'_' {
-                self.advance(1);
-            } else {
-                break;
-            }
-        }
+        let len = self.class_run_len(CLASS_IDENT);
+        self.advance_in_line(len);
 
         let value = unsafe { std::str::from_utf8_unchecked(&self.source[start..self.offset]) };
         let kind = match value {
@@ -796,14 +795,8 @@ impl LexerState {
 
     fn tokenize_unicode_identifier(&mut self) {
         let start = self.offset;
-
-        while let Some(ch) = self.current_char() {
-            if ch.is_ascii_alphanumeric() || ch == b'_' || (ch > 127) {
-                self.advance(1);
-            } else {
-                break;
-            }
-        }
+        let len = self.class_run_len(CLASS_IDENT | CLASS_NON_ASCII);
+        self.advance_in_line(len);
 
         let value = unsafe { std::str::from_utf8_unchecked(&self.source[start..self.offset]) };
         self.emit_token(
@@ -814,14 +807,15 @@ impl LexerState {
     }
 
     fn skip_to_end_of_line(&mut self) {
-        while self.current_char().is_some() {
-            if self.current_newline_len().is_some() {
+        let rest = &self.source[self.offset..];
+        match memchr::memchr2(b'\n', b'\r', rest) {
+            Some(len) => {
+                self.advance_in_line(len);
                 self.emit_newline_token();
-                return;
             }
-            self.advance(1);
+            // EOF reached
+            None => self.advance_in_line(rest.len()),
         }
-        // EOF reached
     }
 
     fn finalize_indentation(&mut self) {
@@ -885,4 +879,12 @@ mod tests {
 
         assert_eq!(newline_span, 2);
     }
+
+    #[test]
+    fn string_bodies_are_copied_verbatim() {
+        let kinds = token_kinds("let s = \"héllo \\\"wörld\\\"\\n\"\nlet t = \"\"\"a\r\nb\"\"\"\n");
+
+        assert!(kinds.contains(&TokenKind::StringLiteral("héllo \"wörld\"\n".to_string())));
+        assert!(kinds.contains(&TokenKind::StringLiteral("a\nb".to_string())));
+    }
 }
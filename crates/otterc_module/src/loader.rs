@@ -2,26 +2,31 @@ use anyhow::{Context, Result};
 use std::collections::HashMap;
 use std::fs;
 use std::path::{Path, PathBuf};
+use std::sync::Arc;
 
 use crate::resolver::ModuleResolver;
 use otterc_ast::nodes::{Program, Statement};
 use otterc_lexer::tokenize;
 use otterc_parser::parse;
+use otterc_symbol::Symbol;
 
 /// Represents a loaded module with its exports
+///
+/// The parsed program is shared, so cloning a module (e.g. out of the
+/// loader cache) is a handle copy rather than a deep copy of the AST.
 #[derive(Debug, Clone)]
 pub struct Module {
     pub path: PathBuf,
-    pub program: Program,
+    pub program: Arc<Program>,
     pub exports: ModuleExports,
 }
 
 /// Tracks what items are exported from a module
 #[derive(Debug, Clone, Default)]
 pub struct ModuleExports {
-    pub functions: Vec<String>,
-    pub constants: Vec<String>,
-    pub types: Vec<String>,
+    pub functions: Vec<Symbol>,
+    pub constants: Vec<Symbol>,
+    pub types: Vec<Symbol>,
 }
 
 impl ModuleExports {
@@ -29,22 +34,25 @@ impl ModuleExports {
         Self::default()
     }
 
-    pub fn add_function(&mut self, name: String) {
-        self.functions.push(name);
+    pub fn add_function(&mut self, name: impl Into<Symbol>) {
+        self.functions.push(name.into());
     }
 
-    pub fn add_constant(&mut self, name: String) {
-        self.constants.push(name);
+    pub fn add_constant(&mut self, name: impl Into<Symbol>) {
+        self.constants.push(name.into());
     }
 
-    pub fn add_type(&mut self, name: String) {
-        self.types.push(name);
+    pub fn add_type(&mut self, name: impl Into<Symbol>) {
+        self.types.push(name.into());
     }
 
     pub fn is_exported(&self, name: &str) -> bool {
-        self.functions.contains(&name.to_string())
-            || self.constants.contains(&name.to_string())
-            || self.types.contains(&name.to_string())
+        // A name that was never interned cannot have been exported.
+        Symbol::lookup(name).is_some_and(|symbol| {
+            self.functions.contains(&symbol)
+                || self.constants.contains(&symbol)
+                || self.types.contains(&symbol)
+        })
     }
 }
 
@@ -71,10 +79,8 @@ impl ModuleLoader {
         }
 
         let module = self.load_file(&resolved_path)?;
-        let path_clone = resolved_path.clone();
-        let module_clone = module.clone();
-        self.cache.insert(path_clone, module);
-        Ok(module_clone)
+        self.cache.insert(resolved_path, module.clone());
+        Ok(module)
     }
 
     /// Load a module from a file path
@@ -102,7 +108,7 @@ impl ModuleLoader {
 
         Ok(Module {
             path: path.to_path_buf(),
-            program,
+            program: Arc::new(program),
             exports,
         })
     }
@@ -115,19 +121,19 @@ impl ModuleLoader {
             match statement.as_ref() {
                 Statement::Function(function) => {
                     if function.as_ref().public {
-                        exports.add_function(function.as_ref().name.clone());
+                        exports.add_function(&function.as_ref().name);
                     }
                 }
                 Statement::Let { name, public, .. } => {
                     if *public {
-                        exports.add_constant(name.as_ref().clone());
+                        exports.add_constant(name.as_ref());
                     }
                 }
                 Statement::Struct { name, public, .. }
                 | Statement::Enum { name, public, .. }
                 | Statement::TypeAlias { name, public, .. } => {
                     if *public {
-                        exports.add_type(name.clone());
+                        exports.add_type(name);
                     }
                 }
                 _ => {}
@@ -168,14 +174,16 @@ impl ModuleLoader {
                 if let Some(item_name) = item {
                     // Re-export specific item
                     let export_name = alias.as_ref().unwrap_or(item_name);
+                    let item = Symbol::intern(item_name);
+                    let source_exports = &source_module_data.exports;
 
                     // Check if the item exists in the source module
-                    if source_module_data.exports.functions.contains(item_name) {
-                        module.exports.add_function(export_name.clone());
-                    } else if source_module_data.exports.constants.contains(item_name) {
-                        module.exports.add_constant(export_name.clone());
-                    } else if source_module_data.exports.types.contains(item_name) {
-                        module.exports.add_type(export_name.clone());
+                    if source_exports.functions.contains(&item) {
+                        module.exports.add_function(export_name);
+                    } else if source_exports.constants.contains(&item) {
+                        module.exports.add_constant(export_name);
+                    } else if source_exports.types.contains(&item) {
+                        module.exports.add_type(export_name);
                     } else {
                         // Item not found in source module exports
                         return Err(anyhow::anyhow!(
@@ -187,13 +195,13 @@ impl ModuleLoader {
                 } else {
                     // Re-export all public items from the module
                     for func in &source_module_data.exports.functions {
-                        module.exports.add_function(func.clone());
+                        module.exports.add_function(*func);
                     }
                     for constant in &source_module_data.exports.constants {
-                        module.exports.add_constant(constant.clone());
+                        module.exports.add_constant(*constant);
                     }
                     for ty in &source_module_data.exports.types {
-                        module.exports.add_type(ty.clone());
+                        module.exports.add_type(*ty);
                     }
                 }
             }
@@ -1,6 +1,7 @@
 use anyhow::Result;
 use std::collections::HashMap;
 use std::path::{Path, PathBuf};
+use std::sync::Arc;
 
 use crate::{Module, ModuleLoader, ModulePath, ModuleResolver};
 use otterc_ast::nodes::{Program, Statement};
@@ -109,20 +110,20 @@ impl ModuleProcessor {
 
     /// Process imports for a specific module file
     fn process_module_imports(&mut self, module_path: &PathBuf) -> Result<Vec<PathBuf>> {
-        // Get module statements without borrowing self mutably
-        let module_statements = {
+        // Share the module's program so `self` can be borrowed mutably below
+        let module_program = {
             let module = self
                 .loaded_modules
                 .get(module_path)
                 .ok_or_else(|| anyhow::anyhow!("module not loaded: {}", module_path.display()))?;
-            module.program.statements.clone()
+            Arc::clone(&module.program)
         };
 
         let mut dependencies = Vec::new();
 
         self.load_default_modules(&mut dependencies)?;
 
-        for statement in &module_statements {
+        for statement in &module_program.statements {
             if let Statement::Use { imports } = statement.as_ref() {
                 for import in imports {
                     let module = &import.as_ref().module;
@@ -298,6 +299,7 @@ impl Default for ModuleProcessor {
 #[cfg(test)]
 mod tests {
     use super::*;
+    use otterc_symbol::Symbol;
     use std::fs;
     use tempfile::TempDir;
 
@@ -391,9 +393,14 @@ mod tests {
             facade_module
                 .exports
                 .functions
-                .contains(&"sine".to_string())
+                .contains(&Symbol::intern("sine"))
+        );
+        assert!(
+            !facade_module
+                .exports
+                .functions
+                .contains(&Symbol::intern("sin"))
         );
-        assert!(!facade_module.exports.functions.contains(&"sin".to_string()));
     }
 
     #[test]
@@ -428,9 +435,14 @@ mod tests {
             facade_module
                 .exports
                 .functions
-                .contains(&"sqrt".to_string())
+                .contains(&Symbol::intern("sqrt"))
+        );
+        assert!(
+            facade_module
+                .exports
+                .functions
+                .contains(&Symbol::intern("sin"))
         );
-        assert!(facade_module.exports.functions.contains(&"sin".to_string()));
     }
 
     #[test]
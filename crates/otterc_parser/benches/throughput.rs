@@ -0,0 +1,74 @@
+//! Parse throughput over the bundled `examples/` and `stdlib/` sources,
+//! comparing the hand-written parser with the legacy combinator grammar.
+//!
+//! Run with `cargo bench -p otterc_parser`.
+
+#![expect(clippy::print_stdout, reason = "Benchmark reports go to stdout")]
+
+use std::fs;
+use std::path::{Path, PathBuf};
+
+use otterc_lexer::{Token, tokenize};
+use otterc_parser::grammar::parse_legacy;
+use otterc_parser::parse;
+use otterc_utils::bench::Benchmark;
+
+const ITERATIONS: usize = 100;
+
+type ParseFn = fn(&[Token]) -> bool;
+
+fn collect_sources(dir: &Path, out: &mut Vec<PathBuf>) {
+    let Ok(entries) = fs::read_dir(dir) else {
+        return;
+    };
+    for entry in entries.flatten() {
+        let path = entry.path();
+        if path.is_dir() {
+            collect_sources(&path, out);
+        } else if path.extension().is_some_and(|ext| ext == "ot") {
+            out.push(path);
+        }
+    }
+}
+
+fn main() {
+    let root = Path::new(env!("CARGO_MANIFEST_DIR")).join("../..");
+    let mut paths = Vec::new();
+    collect_sources(&root.join("examples"), &mut paths);
+    collect_sources(&root.join("stdlib"), &mut paths);
+    paths.sort();
+
+    let mut bytes = 0;
+    let mut streams: Vec<Vec<Token>> = Vec::new();
+    for path in &paths {
+        let Ok(source) = fs::read_to_string(path) else {
+            continue;
+        };
+        if let Ok(tokens) = tokenize(&source) {
+            bytes += source.len();
+            streams.push(tokens);
+        }
+    }
+    if streams.is_empty() {
+        println!("no sources found under {}", root.display());
+        return;
+    }
+
+    let parsers: [(&str, ParseFn); 2] = [
+        ("recursive descent", |tokens| parse(tokens).is_ok()),
+        ("legacy grammar", |tokens| parse_legacy(tokens).is_ok()),
+    ];
+    for (name, parser) in parsers {
+        let result = Benchmark::new(name, ITERATIONS).run(|| {
+            for tokens in &streams {
+                let _ = parser(tokens);
+            }
+        });
+        let mb_per_sec = bytes as f64 / result.median().as_secs_f64() / 1_000_000.0;
+        println!(
+            "{name}: {} files, {bytes} bytes, median {:?}, {mb_per_sec:.1} MB/s",
+            streams.len(),
+            result.median(),
+        );
+    }
+}
@@ -1,3 +1,9 @@
+//! The original chumsky combinator grammar.
+//!
+//! Superseded by the hand-written parser in [`crate::parser`]; it is kept as
+//! the reference implementation for the differential tests and the parse
+//! benchmark.
+
 use chumsky::Stream;
 use chumsky::prelude::*;
 
@@ -8,37 +14,9 @@ use otterc_ast::nodes::{
 
 use otterc_lexer::token::{Token, TokenKind};
 use otterc_span::Span;
-use otterc_utils::errors::{Diagnostic, DiagnosticSeverity};
 use std::ops::Range;
 
-#[derive(Debug, Clone)]
-pub struct ParserError {
-    pub message: String,
-    pub span: Span,
-}
-
-impl ParserError {
-    pub fn to_diagnostic(&self, source_id: &str) -> Diagnostic {
-        let mut diag = Diagnostic::new(
-            DiagnosticSeverity::Error,
-            source_id,
-            self.span,
-            self.message.clone(),
-        );
-
-        // Add suggestions based on error message
-        if self.message.contains("unexpected token") {
-            diag = diag.with_suggestion("Check for missing or extra tokens, or syntax errors")
-                .with_help("Ensure all statements are properly terminated and parentheses/brackets are balanced.");
-        } else if self.message.contains("unexpected end of input") {
-            diag = diag
-                .with_suggestion("Check for missing closing brackets, parentheses, or quotes")
-                .with_help("The parser reached the end of the file while expecting more tokens.");
-        }
-
-        diag
-    }
-}
+use crate::parser::ParserError;
 
 impl From<Simple<TokenKind>> for ParserError {
     fn from(value: Simple<TokenKind>) -> Self {
@@ -53,7 +31,7 @@ impl From<Simple<TokenKind>> for ParserError {
     }
 }
 
-pub fn parse(tokens: &[Token]) -> Result<Program, Vec<ParserError>> {
+pub fn parse_legacy(tokens: &[Token]) -> Result<Program, Vec<ParserError>> {
     let parser = program_parser();
     let eof_span = tokens
         .last()
@@ -1458,59 +1436,3 @@ fn program_parser() -> impl Parser<TokenKind, Program, Error = Simple<TokenKind>
         .then_ignore(just(TokenKind::Eof))
         .map(Program::new)
 }
-
-#[cfg(test)]
-mod tests {
-    #![expect(clippy::panic, reason = "Panicking on test failures is acceptable")]
-
-    use super::*;
-
-    #[test]
-    fn parses_multiple_use_modules() {
-        let source = "use otterc_fmt, math as m\n";
-        let tokens = otterc_lexer::tokenize(source).expect("tokenize use statement");
-        let program = parse(&tokens).expect("parse use statement");
-
-        assert_eq!(program.statements.len(), 1);
-        match &program.statements[0].as_ref() {
-            Statement::Use { imports } => {
-                assert_eq!(imports.len(), 2);
-                assert_eq!(imports[0].as_ref().module, "fmt");
-                assert!(imports[0].as_ref().alias.is_none());
-                assert_eq!(imports[1].as_ref().module, "math");
-                assert_eq!(imports[1].as_ref().alias.as_deref(), Some("m"));
-            }
-            other => panic!("expected use statement, got {:?}", other),
-        }
-    }
-
-    #[test]
-    fn parses_otter_namespace_use() {
-        let source = "use otter:core\n";
-        let tokens = otterc_lexer::tokenize(source).expect("tokenize namespace use");
-        let program = parse(&tokens).expect("parse namespace use");
-
-        assert_eq!(program.statements.len(), 1);
-        match &program.statements[0].as_ref() {
-            Statement::Use { imports } => {
-                assert_eq!(imports.len(), 1);
-                assert_eq!(imports[0].as_ref().module, "otter:core");
-            }
-            other => panic!("expected use statement, got {:?}", other),
-        }
-    }
-
-    #[test]
-    fn parses_core_stdlib_module() {
-        let source = include_str!("../../../stdlib/otter/core.ot");
-        let tokens = otterc_lexer::tokenize(source).expect("tokenize core module");
-        parse(&tokens).expect("parse core module");
-    }
-
-    #[test]
-    fn parses_enum_demo_example() {
-        let source = include_str!("../../../examples/basic/enum_demo.ot");
-        let tokens = otterc_lexer::tokenize(source).expect("tokenize enum demo");
-        parse(&tokens).expect("parse enum demo");
-    }
-}
@@ -1,3 +1,4 @@
 pub mod grammar;
+pub mod parser;
 
-pub use grammar::{ParserError, parse};
+pub use parser::{ParserError, parse};
@@ -0,0 +1,1638 @@
+//! Hand-written recursive-descent parser.
+//!
+//! Statements are parsed by recursive descent and expressions by precedence
+//! climbing (Pratt parsing) over a binding-power table. The parser walks the
+//! token slice directly, so nothing is built per call besides the AST itself.
+//!
+//! The accepted language and the produced `Program`, spans included, are the
+//! same as the original combinator grammar in [`crate::grammar`]. That
+//! grammar is ordered-choice with backtracking, so the few places where it
+//! relies on backtracking (struct initializers vs. calls, comprehensions vs.
+//! literals, assignments vs. expression statements) save and restore the
+//! position here as well. Unlike the combinator grammar, a failing top-level
+//! item does not abort the parse: the error is recorded and parsing resumes
+//! at the next top-level line.
+
+use otterc_ast::nodes::{
+    BinaryOp, Block, EnumVariant, Expr, FStringPart, Function, Literal, MatchArm, Node,
+    NumberLiteral, Param, Pattern, Program, Statement, Type, UnaryOp, UseImport,
+};
+use otterc_lexer::token::{Token, TokenKind};
+use otterc_span::Span;
+use otterc_utils::errors::{Diagnostic, DiagnosticSeverity};
+
+#[derive(Debug, Clone)]
+pub struct ParserError {
+    pub message: String,
+    pub span: Span,
+}
+
+impl ParserError {
+    pub fn to_diagnostic(&self, source_id: &str) -> Diagnostic {
+        let mut diag = Diagnostic::new(
+            DiagnosticSeverity::Error,
+            source_id,
+            self.span,
+            self.message.clone(),
+        );
+
+        // Add suggestions based on error message
+        if self.message.contains("unexpected token") {
+            diag = diag.with_suggestion("Check for missing or extra tokens, or syntax errors")
+                .with_help("Ensure all statements are properly terminated and parentheses/brackets are balanced.");
+        } else if self.message.contains("unexpected end of input") {
+            diag = diag
+                .with_suggestion("Check for missing closing brackets, parentheses, or quotes")
+                .with_help("The parser reached the end of the file while expecting more tokens.");
+        }
+
+        diag
+    }
+}
+
+pub fn parse(tokens: &[Token]) -> Result<Program, Vec<ParserError>> {
+    Parser::new(tokens).program()
+}
+
+/// Binding powers of the infix operators, loosest first. The right operand
+/// of an operator is parsed with `power + 1`, so every level is left
+/// associative; ranges are additionally non-associative.
+const LOGICAL_POWER: u8 = 1;
+const COMPARISON_POWER: u8 = 2;
+const RANGE_POWER: u8 = 3;
+const SUM_POWER: u8 = 4;
+const PRODUCT_POWER: u8 = 5;
+
+#[derive(Clone, Copy)]
+enum Infix {
+    Binary(BinaryOp),
+    Range,
+}
+
+/// Statement forms differ slightly between blocks and match arms.
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum StatementContext {
+    Block,
+    MatchArm,
+}
+
+type PResult<T> = Option<T>;
+
+struct ComprehensionClause {
+    var: String,
+    iterable: Box<Node<Expr>>,
+    condition: Option<Box<Node<Expr>>>,
+}
+
+struct Parser<'t> {
+    tokens: &'t [Token],
+    pos: usize,
+    /// Span reported past the last token.
+    eoi: Span,
+    /// Furthest position at which a token did not match; errors point here.
+    furthest: usize,
+}
+
+impl<'t> Parser<'t> {
+    fn new(tokens: &'t [Token]) -> Self {
+        let end = tokens.last().map(|token| token.span().end()).unwrap_or(0);
+        Self {
+            tokens,
+            pos: 0,
+            eoi: Span::new(end, end + 1),
+            furthest: 0,
+        }
+    }
+
+    fn peek(&self) -> Option<&'t TokenKind> {
+        self.tokens.get(self.pos).map(Token::kind)
+    }
+
+    fn peek_at(&self, ahead: usize) -> Option<&'t TokenKind> {
+        self.tokens.get(self.pos + ahead).map(Token::kind)
+    }
+
+    fn at(&self, kind: &TokenKind) -> bool {
+        self.peek() == Some(kind)
+    }
+
+    fn bump(&mut self) {
+        self.pos += 1;
+    }
+
+    fn mismatch<T>(&mut self) -> PResult<T> {
+        self.furthest = self.furthest.max(self.pos);
+        None
+    }
+
+    fn eat(&mut self, kind: &TokenKind) -> bool {
+        if self.at(kind) {
+            self.bump();
+            true
+        } else {
+            self.furthest = self.furthest.max(self.pos);
+            false
+        }
+    }
+
+    fn expect(&mut self, kind: &TokenKind) -> PResult<()> {
+        self.eat(kind).then_some(())
+    }
+
+    fn token_span(&self, index: usize) -> Span {
+        self.tokens.get(index).map(Token::span).unwrap_or(self.eoi)
+    }
+
+    /// Span from the token at `start` to the last consumed token. When
+    /// nothing was consumed this is the span of the next token.
+    fn span_since(&self, start: usize) -> Span {
+        let first = self.token_span(start);
+        let last = self.token_span(self.pos.saturating_sub(1).max(start));
+        Span::new(first.start(), last.end())
+    }
+
+    /// Run `rule`, rewinding to the starting position if it fails.
+    fn attempt<T>(&mut self, rule: impl FnOnce(&mut Self) -> PResult<T>) -> PResult<T> {
+        let start = self.pos;
+        let result = rule(self);
+        if result.is_none() {
+            self.pos = start;
+        }
+        result
+    }
+
+    /// Zero or more `item`s; a failing attempt is rewound.
+    fn repeat<T>(&mut self, mut item: impl FnMut(&mut Self) -> PResult<T>) -> Vec<T> {
+        let mut items = Vec::new();
+        while let Some(value) = self.attempt(&mut item) {
+            items.push(value);
+        }
+        items
+    }
+
+    /// Comma-separated `item`s with an optional trailing comma.
+    fn comma_separated<T>(&mut self, mut item: impl FnMut(&mut Self) -> PResult<T>) -> Vec<T> {
+        let mut items = Vec::new();
+        let Some(first) = self.attempt(&mut item) else {
+            return items;
+        };
+        items.push(first);
+        loop {
+            let before_comma = self.pos;
+            if !self.eat(&TokenKind::Comma) {
+                break;
+            }
+            match item(self) {
+                Some(value) => items.push(value),
+                None => {
+                    self.pos = before_comma;
+                    break;
+                }
+            }
+        }
+        self.eat(&TokenKind::Comma);
+        items
+    }
+
+    /// `'(' items ')'` with comma-separated items.
+    fn parenthesized<T>(&mut self, item: impl FnMut(&mut Self) -> PResult<T>) -> PResult<Vec<T>> {
+        self.expect(&TokenKind::LParen)?;
+        let items = self.comma_separated(item);
+        self.expect(&TokenKind::RParen)?;
+        Some(items)
+    }
+
+    fn skip_newlines(&mut self) {
+        while self.at(&TokenKind::Newline) {
+            self.bump();
+        }
+    }
+
+    /// One or more newlines.
+    fn newlines(&mut self) -> PResult<()> {
+        self.expect(&TokenKind::Newline)?;
+        self.skip_newlines();
+        Some(())
+    }
+
+    fn program(mut self) -> Result<Program, Vec<ParserError>> {
+        let mut statements = Vec::new();
+        let mut errors = Vec::new();
+
+        self.skip_newlines();
+        loop {
+            match self.peek() {
+                Some(TokenKind::Eof) => break,
+                Some(TokenKind::Newline) => self.skip_newlines(),
+                None => {
+                    errors.push(self.error_at(self.pos));
+                    break;
+                }
+                Some(_) => {
+                    let start = self.pos;
+                    self.furthest = start;
+                    match self.attempt(Self::item) {
+                        Some(statement) => statements.push(statement),
+                        None => {
+                            errors.push(self.error_at(self.furthest));
+                            self.recover();
+                        }
+                    }
+                }
+            }
+        }
+
+        if errors.is_empty() {
+            Ok(Program::new(statements))
+        } else {
+            Err(errors)
+        }
+    }
+
+    fn error_at(&self, index: usize) -> ParserError {
+        match self.tokens.get(index) {
+            Some(token) => ParserError {
+                message: format!("unexpected token: {:?}", token.kind()),
+                span: token.span(),
+            },
+            None => ParserError {
+                message: "unexpected end of input".to_string(),
+                span: self.eoi,
+            },
+        }
+    }
+
+    /// Skip past the item that failed to parse: to the end of its line and
+    /// past any indented body that follows.
+    fn recover(&mut self) {
+        let mut depth = 0usize;
+        loop {
+            match self.peek() {
+                None | Some(TokenKind::Eof) => return,
+                Some(TokenKind::Indent) => depth += 1,
+                Some(TokenKind::Dedent) => {
+                    depth = depth.saturating_sub(1);
+                    if depth == 0 {
+                        self.bump();
+                        return;
+                    }
+                }
+                Some(TokenKind::Newline) if depth == 0 => {
+                    self.skip_newlines();
+                    // A broken header line takes its indented body with it
+                    if !self.at(&TokenKind::Indent) {
+                        return;
+                    }
+                    continue;
+                }
+                Some(_) => {}
+            }
+            self.bump();
+        }
+    }
+
+    fn item(&mut self) -> PResult<Node<Statement>> {
+        let keyword = if self.at(&TokenKind::Pub) {
+            self.peek_at(1)
+        } else {
+            self.peek()
+        };
+        let definition = match keyword {
+            Some(TokenKind::Struct) => self.attempt(Self::struct_def),
+            Some(TokenKind::Enum) => self.attempt(Self::enum_def),
+            Some(TokenKind::Identifier(name)) if name == "type" => {
+                self.attempt(Self::type_alias_def)
+            }
+            Some(TokenKind::Fn) => self.attempt(Self::function_def),
+            _ => None,
+        };
+        definition.or_else(|| self.statement(StatementContext::Block))
+    }
+
+    fn generic_params(&mut self) -> Vec<String> {
+        self.attempt(|p| {
+            p.expect(&TokenKind::Lt)?;
+            let params = p.comma_separated(Self::identifier);
+            p.expect(&TokenKind::Gt)?;
+            Some(params)
+        })
+        .unwrap_or_default()
+    }
+
+    fn params(&mut self) -> Vec<Node<Param>> {
+        self.attempt(|p| p.parenthesized(Self::param))
+            .unwrap_or_default()
+    }
+
+    fn param(&mut self) -> PResult<Node<Param>> {
+        let start = self.pos;
+        let name = self.identifier_node()?;
+        let ty = self.attempt(|p| {
+            p.expect(&TokenKind::Colon)?;
+            p.ty()
+        });
+        let default = self.attempt(|p| {
+            p.expect(&TokenKind::Equals)?;
+            p.expr()
+        });
+        Some(Node::new(
+            Param::new(name, ty, default),
+            self.span_since(start),
+        ))
+    }
+
+    fn return_type(&mut self) -> Option<Node<Type>> {
+        self.attempt(|p| {
+            p.expect(&TokenKind::Arrow)?;
+            p.ty()
+        })
+    }
+
+    fn function_def(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let public = self.eat(&TokenKind::Pub);
+        self.expect(&TokenKind::Fn)?;
+        let name = self.identifier()?;
+        let params = self.params();
+        let ret_ty = self.return_type();
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        let body = self.block(StatementContext::Block)?;
+
+        let function = if public {
+            Function::new_public(name, params, ret_ty, body)
+        } else {
+            Function::new(name, params, ret_ty, body)
+        };
+        let span = self.span_since(start);
+        let statement = Node::new(Statement::Function(Node::new(function, span)), span);
+        self.skip_newlines();
+        Some(statement)
+    }
+
+    //     field: Type
+    //     fn method(self, ...) -> ReturnType:
+    //         ...
+    fn struct_def(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let public = self.eat(&TokenKind::Pub);
+        self.expect(&TokenKind::Struct)?;
+        let name = self.identifier()?;
+        let generics = self.generic_params();
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        self.expect(&TokenKind::Indent)?;
+
+        let mut fields = Vec::new();
+        let mut methods = Vec::new();
+        loop {
+            match self.peek() {
+                Some(TokenKind::Identifier(_)) => match self.attempt(Self::struct_field) {
+                    Some(field) => fields.push(field),
+                    None => break,
+                },
+                Some(TokenKind::Fn) => match self.attempt(Self::struct_method) {
+                    Some(method) => methods.push(method),
+                    None => break,
+                },
+                _ => break,
+            }
+        }
+        self.skip_newlines();
+        self.expect(&TokenKind::Dedent)?;
+        self.skip_newlines();
+
+        Some(Node::new(
+            Statement::Struct {
+                name,
+                fields,
+                methods,
+                public,
+                generics,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn struct_field(&mut self) -> PResult<(String, Node<Type>)> {
+        let name = self.identifier()?;
+        self.expect(&TokenKind::Colon)?;
+        let ty = self.ty()?;
+        self.skip_newlines();
+        Some((name, ty))
+    }
+
+    fn struct_method(&mut self) -> PResult<Node<Function>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Fn)?;
+        let name = self.identifier()?;
+        let mut params = self.params();
+        let ret_ty = self.return_type();
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        let body = self.block(StatementContext::Block)?;
+        let span = self.span_since(start);
+
+        // Methods automatically get 'self' as first parameter if not present
+        if params.is_empty() || params[0].as_ref().name.as_ref() != "self" {
+            let self_span = Span::new(span.start() + name.len() + 1, span.start() + name.len() + 5);
+            let self_type_span = Span::new(self_span.start(), self_span.start());
+            let self_param = Node::new(
+                Param::new(
+                    Node::new("self".to_string(), self_span),
+                    Some(Node::new(Type::Simple("Self".to_string()), self_type_span)),
+                    None,
+                ),
+                self_span,
+            );
+            params.insert(0, self_param);
+        }
+        let method = Node::new(Function::new(name, params, ret_ty, body), span);
+        self.skip_newlines();
+        Some(method)
+    }
+
+    fn enum_def(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let public = self.eat(&TokenKind::Pub);
+        self.expect(&TokenKind::Enum)?;
+        let name = self.identifier()?;
+        let generics = self.generic_params();
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        self.expect(&TokenKind::Indent)?;
+        let variants = self.repeat(Self::enum_variant);
+        if variants.is_empty() {
+            return None;
+        }
+        self.skip_newlines();
+        self.expect(&TokenKind::Dedent)?;
+        self.skip_newlines();
+
+        Some(Node::new(
+            Statement::Enum {
+                name,
+                variants,
+                public,
+                generics,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn enum_variant(&mut self) -> PResult<Node<EnumVariant>> {
+        let start = self.pos;
+        let name = self.variant_name()?;
+        let fields = self.attempt(|p| {
+            p.expect(&TokenKind::Colon)?;
+            p.parenthesized(Self::ty)
+        });
+        self.skip_newlines();
+        Some(Node::new(
+            EnumVariant::new(name, fields.unwrap_or_default()),
+            self.span_since(start),
+        ))
+    }
+
+    // Type alias: type Name<T> = Type
+    fn type_alias_def(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let public = self.eat(&TokenKind::Pub);
+        // Using identifier since "type" isn't a keyword yet
+        match self.peek() {
+            Some(TokenKind::Identifier(name)) if name == "type" => self.bump(),
+            _ => return self.mismatch(),
+        }
+        let name = self.identifier()?;
+        let generics = self.generic_params();
+        self.expect(&TokenKind::Equals)?;
+        let target = self.ty()?;
+        self.skip_newlines();
+
+        Some(Node::new(
+            Statement::TypeAlias {
+                name,
+                target,
+                public,
+                generics,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn block(&mut self, context: StatementContext) -> PResult<Node<Block>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Indent)?;
+        let statements = self.repeat(|p| p.statement(context));
+        if statements.is_empty() {
+            return None;
+        }
+        self.expect(&TokenKind::Dedent)?;
+        Some(Node::new(Block::new(statements), self.span_since(start)))
+    }
+
+    fn statement(&mut self, context: StatementContext) -> PResult<Node<Statement>> {
+        use StatementContext::{Block, MatchArm};
+
+        let statement = match (self.peek(), context) {
+            (Some(TokenKind::Print), _) => self.print_stmt(),
+            (Some(TokenKind::Return), _) => self.return_stmt(),
+            (Some(TokenKind::Let), _) => self.let_stmt(context),
+            (Some(TokenKind::Pub), Block) => self
+                .attempt(|p| p.let_stmt(context))
+                .or_else(|| self.pub_use_stmt()),
+            (Some(TokenKind::Use), Block) => self.use_stmt(),
+            (Some(TokenKind::If), Block) => self.if_stmt(),
+            (Some(TokenKind::For), Block) => self.for_stmt(),
+            (Some(TokenKind::While), Block) => self.while_stmt(),
+            (Some(TokenKind::Break), _) => self.keyword_stmt(Statement::Break),
+            (Some(TokenKind::Continue), _) => self.keyword_stmt(Statement::Continue),
+            (Some(TokenKind::Pass), _) => self.keyword_stmt(Statement::Pass),
+            (Some(TokenKind::Identifier(_)), _) => {
+                let assignment = match context {
+                    // Inside match arms `let` is optional, so `x = 1` declares
+                    Block => self.attempt(Self::compound_assignment_stmt),
+                    MatchArm => self
+                        .attempt(|p| p.let_stmt(context))
+                        .or_else(|| self.attempt(Self::compound_assignment_stmt)),
+                };
+                assignment
+                    .or_else(|| self.attempt(Self::simple_assignment_stmt))
+                    .or_else(|| self.expr_stmt())
+            }
+            _ => self.expr_stmt(),
+        }?;
+        self.skip_newlines();
+        Some(statement)
+    }
+
+    fn keyword_stmt(&mut self, statement: Statement) -> PResult<Node<Statement>> {
+        let span = self.token_span(self.pos);
+        self.bump();
+        Some(Node::new(statement, span))
+    }
+
+    fn expr_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let expr = self.expr()?;
+        Some(Node::new(Statement::Expr(expr), self.span_since(start)))
+    }
+
+    fn print_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Print)?;
+        self.expect(&TokenKind::LParen)?;
+        let arg = self.expr()?;
+        self.expect(&TokenKind::RParen)?;
+
+        let span = self.span_since(start);
+        Some(Node::new(
+            Statement::Expr(Node::new(
+                Expr::Call {
+                    func: Box::new(Node::new(Expr::Identifier("print".to_string()), span)),
+                    args: vec![arg],
+                },
+                span,
+            )),
+            span,
+        ))
+    }
+
+    fn return_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Return)?;
+        let expr = self.attempt(Self::expr);
+        Some(Node::new(Statement::Return(expr), self.span_since(start)))
+    }
+
+    fn let_stmt(&mut self, context: StatementContext) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let public = match context {
+            StatementContext::Block => {
+                let public = self.eat(&TokenKind::Pub);
+                self.expect(&TokenKind::Let)?;
+                public
+            }
+            // Match arms are local scopes
+            StatementContext::MatchArm => {
+                self.eat(&TokenKind::Let);
+                false
+            }
+        };
+        let name = self.identifier_node()?;
+        let ty = self.attempt(|p| {
+            p.expect(&TokenKind::Colon)?;
+            p.ty()
+        });
+        self.expect(&TokenKind::Equals)?;
+        let expr = self.expr()?;
+
+        Some(Node::new(
+            Statement::Let {
+                name,
+                ty,
+                expr,
+                public,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn compound_assignment_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let name = self.identifier_node()?;
+        let op = match self.peek() {
+            Some(TokenKind::PlusEq) => BinaryOp::Add,
+            Some(TokenKind::MinusEq) => BinaryOp::Sub,
+            Some(TokenKind::StarEq) => BinaryOp::Mul,
+            Some(TokenKind::SlashEq) => BinaryOp::Div,
+            _ => return self.mismatch(),
+        };
+        self.bump();
+        let rhs = self.expr()?;
+
+        // Desugar: x += y becomes x = x + y
+        let span = self.span_since(start);
+        let expr = Node::new(
+            Expr::Binary {
+                op,
+                left: Box::new(Node::new(
+                    Expr::Identifier(name.as_ref().clone()),
+                    *name.span(),
+                )),
+                right: Box::new(rhs),
+            },
+            span,
+        );
+        Some(Node::new(Statement::Assignment { name, expr }, span))
+    }
+
+    fn simple_assignment_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let name = self.identifier_node()?;
+        self.expect(&TokenKind::Equals)?;
+        let expr = self.expr()?;
+        Some(Node::new(
+            Statement::Assignment { name, expr },
+            self.span_since(start),
+        ))
+    }
+
+    fn use_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Use)?;
+        let imports = self.comma_separated(Self::use_import);
+        if imports.is_empty() {
+            return None;
+        }
+        Some(Node::new(
+            Statement::Use { imports },
+            self.span_since(start),
+        ))
+    }
+
+    fn use_import(&mut self) -> PResult<Node<UseImport>> {
+        let start = self.pos;
+        let module = self.module_path()?;
+        let alias = self.alias();
+        Some(Node::new(
+            UseImport::new(module, alias),
+            self.span_since(start),
+        ))
+    }
+
+    // pub use statement for re-exports
+    // Syntax: pub use otterc_module.item [as alias]
+    //         pub use otterc_module (re-export all)
+    fn pub_use_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Pub)?;
+        self.expect(&TokenKind::Use)?;
+        let module = self.module_path()?;
+        let item = self.attempt(|p| {
+            p.expect(&TokenKind::Dot)?;
+            p.identifier()
+        });
+        let alias = self.alias();
+        Some(Node::new(
+            Statement::PubUse {
+                module,
+                item,
+                alias,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn alias(&mut self) -> Option<String> {
+        self.attempt(|p| {
+            p.expect(&TokenKind::As)?;
+            p.identifier()
+        })
+    }
+
+    fn module_path(&mut self) -> PResult<String> {
+        let mut module = self.path_segment()?;
+        loop {
+            let before_separator = self.pos;
+            let separator = match self.peek() {
+                Some(TokenKind::Slash) => "/",
+                Some(TokenKind::Colon) => ":",
+                _ => break,
+            };
+            self.bump();
+            match self.path_segment() {
+                Some(segment) => {
+                    module.push_str(separator);
+                    module.push_str(&segment);
+                }
+                None => {
+                    self.pos = before_separator;
+                    break;
+                }
+            }
+        }
+        Some(module)
+    }
+
+    fn path_segment(&mut self) -> PResult<String> {
+        let segment = match self.peek() {
+            Some(TokenKind::Dot) => ".".to_string(),
+            Some(TokenKind::DoubleDot) => "..".to_string(),
+            Some(TokenKind::Identifier(name)) => name.clone(),
+            _ => return self.mismatch(),
+        };
+        self.bump();
+        Some(segment)
+    }
+
+    /// `<keyword> <expr> ':' NEWLINE <block>`, shared by `if`, `elif`, `while`.
+    fn conditional_block(&mut self, keyword: &TokenKind) -> PResult<(Node<Expr>, Node<Block>)> {
+        self.expect(keyword)?;
+        let cond = self.expr()?;
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        let block = self.block(StatementContext::Block)?;
+        Some((cond, block))
+    }
+
+    fn if_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let (cond, then_block) = self.conditional_block(&TokenKind::If)?;
+        let elif_blocks = self.repeat(|p| p.conditional_block(&TokenKind::Elif));
+        let else_block = self.attempt(|p| {
+            p.expect(&TokenKind::Else)?;
+            p.expect(&TokenKind::Colon)?;
+            p.newlines()?;
+            p.block(StatementContext::Block)
+        });
+
+        Some(Node::new(
+            Statement::If {
+                cond,
+                then_block,
+                elif_blocks,
+                else_block,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn for_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        self.expect(&TokenKind::For)?;
+        let var = self.identifier_node()?;
+        self.expect(&TokenKind::In)?;
+        let iterable = self.expr()?;
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        let body = self.block(StatementContext::Block)?;
+
+        Some(Node::new(
+            Statement::For {
+                var,
+                iterable,
+                body,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn while_stmt(&mut self) -> PResult<Node<Statement>> {
+        let start = self.pos;
+        let (cond, body) = self.conditional_block(&TokenKind::While)?;
+        Some(Node::new(
+            Statement::While { cond, body },
+            self.span_since(start),
+        ))
+    }
+
+    fn identifier(&mut self) -> PResult<String> {
+        match self.peek() {
+            Some(TokenKind::Identifier(name)) => {
+                self.bump();
+                Some(name.clone())
+            }
+            _ => self.mismatch(),
+        }
+    }
+
+    fn identifier_node(&mut self) -> PResult<Node<String>> {
+        let span = self.token_span(self.pos);
+        self.identifier().map(|name| Node::new(name, span))
+    }
+
+    /// Member names may also be keywords, e.g. `task.spawn` or `opt.None`.
+    fn identifier_or_keyword(&mut self) -> PResult<String> {
+        let name = match self.peek() {
+            Some(TokenKind::Identifier(name)) => name.clone(),
+            Some(
+                kind @ (TokenKind::Fn
+                | TokenKind::Return
+                | TokenKind::If
+                | TokenKind::Else
+                | TokenKind::Elif
+                | TokenKind::For
+                | TokenKind::While
+                | TokenKind::Break
+                | TokenKind::Continue
+                | TokenKind::Pass
+                | TokenKind::In
+                | TokenKind::Is
+                | TokenKind::Not
+                | TokenKind::Use
+                | TokenKind::As
+                | TokenKind::Await
+                | TokenKind::Spawn
+                | TokenKind::Match
+                | TokenKind::Case
+                | TokenKind::True
+                | TokenKind::False
+                | TokenKind::Print
+                | TokenKind::None),
+            ) => kind.name().to_string(),
+            _ => return self.mismatch(),
+        };
+        self.bump();
+        Some(name)
+    }
+
+    /// Enum variant names may be `None`.
+    fn variant_name(&mut self) -> PResult<String> {
+        if self.eat(&TokenKind::None) {
+            return Some("None".to_string());
+        }
+        self.identifier()
+    }
+
+    fn ty(&mut self) -> PResult<Node<Type>> {
+        let start = self.pos;
+        let base = self.identifier()?;
+        let args = self.attempt(|p| {
+            p.expect(&TokenKind::Lt)?;
+            let args = p.comma_separated(Self::ty);
+            p.expect(&TokenKind::Gt)?;
+            Some(args)
+        });
+        let ty = match args {
+            Some(args) => Type::Generic { base, args },
+            None => Type::Simple(base),
+        };
+        Some(Node::new(ty, self.span_since(start)))
+    }
+
+    fn expr(&mut self) -> PResult<Node<Expr>> {
+        if self.at(&TokenKind::Match)
+            && let Some(expr) = self.attempt(Self::match_expr)
+        {
+            return Some(expr);
+        }
+        self.binary_expr(0).map(|(expr, _)| expr)
+    }
+
+    fn infix_operator(&mut self) -> Option<(Infix, u8)> {
+        let (infix, power) = match self.peek()? {
+            TokenKind::And => (Infix::Binary(BinaryOp::And), LOGICAL_POWER),
+            TokenKind::Or => (Infix::Binary(BinaryOp::Or), LOGICAL_POWER),
+            TokenKind::EqEq => (Infix::Binary(BinaryOp::Eq), COMPARISON_POWER),
+            TokenKind::Neq => (Infix::Binary(BinaryOp::Ne), COMPARISON_POWER),
+            TokenKind::Lt => (Infix::Binary(BinaryOp::Lt), COMPARISON_POWER),
+            TokenKind::Gt => (Infix::Binary(BinaryOp::Gt), COMPARISON_POWER),
+            TokenKind::LtEq => (Infix::Binary(BinaryOp::LtEq), COMPARISON_POWER),
+            TokenKind::GtEq => (Infix::Binary(BinaryOp::GtEq), COMPARISON_POWER),
+            TokenKind::Is => {
+                let op = if self.peek_at(1) == Some(&TokenKind::Not) {
+                    self.bump();
+                    BinaryOp::IsNot
+                } else {
+                    BinaryOp::Is
+                };
+                (Infix::Binary(op), COMPARISON_POWER)
+            }
+            TokenKind::DoubleDot => (Infix::Range, RANGE_POWER),
+            TokenKind::Plus => (Infix::Binary(BinaryOp::Add), SUM_POWER),
+            TokenKind::Minus => (Infix::Binary(BinaryOp::Sub), SUM_POWER),
+            TokenKind::Star => (Infix::Binary(BinaryOp::Mul), PRODUCT_POWER),
+            TokenKind::Slash => (Infix::Binary(BinaryOp::Div), PRODUCT_POWER),
+            TokenKind::Percent => (Infix::Binary(BinaryOp::Mod), PRODUCT_POWER),
+            _ => return None,
+        };
+        self.bump();
+        Some((infix, power))
+    }
+
+    /// Parse operators binding at least as tightly as `min_power`.
+    ///
+    /// Ranges do not chain: once a range has been built, a following `..`
+    /// ends the whole expression. The returned flag reports that case so
+    /// enclosing calls stop too.
+    fn binary_expr(&mut self, min_power: u8) -> PResult<(Node<Expr>, bool)> {
+        let start = self.pos;
+        let mut left = self.unary_expr()?;
+        let mut ranged = false;
+
+        loop {
+            let before_operator = self.pos;
+            let Some((infix, power)) = self.infix_operator() else {
+                break;
+            };
+            let closed_range = matches!(infix, Infix::Range) && ranged;
+            if power < min_power || closed_range {
+                self.pos = before_operator;
+                return Some((left, closed_range));
+            }
+
+            // An operator whose right operand fails is left unconsumed
+            let Some((right, halted)) = self.binary_expr(power + 1) else {
+                self.pos = before_operator;
+                break;
+            };
+            ranged |= halted;
+            left = match infix {
+                Infix::Binary(op) => {
+                    let span = left.span().merge(right.span());
+                    Node::new(
+                        Expr::Binary {
+                            left: Box::new(left),
+                            op,
+                            right: Box::new(right),
+                        },
+                        span,
+                    )
+                }
+                Infix::Range => {
+                    ranged = true;
+                    Node::new(
+                        Expr::Range {
+                            start: Box::new(left),
+                            end: Box::new(right),
+                        },
+                        self.span_since(start),
+                    )
+                }
+            };
+        }
+
+        Some((left, false))
+    }
+
+    fn unary_expr(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        let op = match self.peek() {
+            Some(TokenKind::Minus) => UnaryOp::Neg,
+            Some(TokenKind::Bang | TokenKind::Not) => UnaryOp::Not,
+            _ => return self.postfix_expr(),
+        };
+        self.bump();
+        let Some(expr) = self.postfix_expr() else {
+            self.pos = start;
+            return None;
+        };
+        Some(Node::new(
+            Expr::Unary {
+                op,
+                expr: Box::new(expr),
+            },
+            self.span_since(start),
+        ))
+    }
+
+    /// `await` / `spawn` prefixes or a call chain.
+    fn postfix_expr(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        let wrap = match self.peek() {
+            Some(TokenKind::Await) => Expr::Await,
+            Some(TokenKind::Spawn) => Expr::Spawn,
+            _ => return self.call_expr(),
+        };
+        self.bump();
+        let expr = self.call_expr()?;
+        Some(Node::new(wrap(Box::new(expr)), self.span_since(start)))
+    }
+
+    fn call_expr(&mut self) -> PResult<Node<Expr>> {
+        let mut func = self.member_expr()?;
+        loop {
+            let before_call = self.pos;
+            let Some(args) = self.parenthesized(Self::expr) else {
+                self.pos = before_call;
+                break;
+            };
+            // Calls keep the span of the callee
+            let span = *func.span();
+            func = Node::new(
+                Expr::Call {
+                    func: Box::new(func),
+                    args,
+                },
+                span,
+            );
+        }
+        Some(func)
+    }
+
+    fn member_expr(&mut self) -> PResult<Node<Expr>> {
+        let mut object = self.atom()?;
+        loop {
+            let before_dot = self.pos;
+            if !self.eat(&TokenKind::Dot) {
+                break;
+            }
+            let field_span = self.token_span(self.pos);
+            let Some(field) = self.identifier_or_keyword() else {
+                self.pos = before_dot;
+                break;
+            };
+            let span = object.span().merge(&field_span);
+            object = Node::new(
+                Expr::Member {
+                    object: Box::new(object),
+                    field,
+                },
+                span,
+            );
+        }
+        Some(object)
+    }
+
+    fn atom(&mut self) -> PResult<Node<Expr>> {
+        match self.peek() {
+            Some(TokenKind::LParen) => {
+                if self.peek_at(1) == Some(&TokenKind::RParen) {
+                    return self.literal();
+                }
+                self.bump();
+                let expr = self.expr()?;
+                self.expect(&TokenKind::RParen)?;
+                Some(expr)
+            }
+            Some(TokenKind::Identifier(name)) => {
+                if self.peek_at(1) == Some(&TokenKind::LParen)
+                    && let Some(init) = self.attempt(Self::struct_init)
+                {
+                    return Some(init);
+                }
+                let span = self.token_span(self.pos);
+                self.bump();
+                Some(Node::new(Expr::Identifier(name.clone()), span))
+            }
+            Some(TokenKind::LBracket) => self.list_expr(),
+            Some(TokenKind::LBrace) => self.dict_expr(),
+            _ => self.literal(),
+        }
+    }
+
+    /// `Name(field=value, ...)`
+    fn struct_init(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        let name = self.identifier()?;
+        let fields = self.parenthesized(|p| {
+            let field = p.identifier()?;
+            p.expect(&TokenKind::Equals)?;
+            Some((field, p.expr()?))
+        })?;
+        if fields.is_empty() {
+            return None;
+        }
+        Some(Node::new(
+            Expr::Struct { name, fields },
+            self.span_since(start),
+        ))
+    }
+
+    /// `for var in iterable [if condition]` after a comprehension's element.
+    fn comprehension_clause(&mut self) -> PResult<ComprehensionClause> {
+        self.expect(&TokenKind::For)?;
+        let var = self.identifier()?;
+        self.expect(&TokenKind::In)?;
+        let iterable = self.expr()?;
+        let condition = self.attempt(|p| {
+            p.expect(&TokenKind::If)?;
+            p.expr()
+        });
+        Some(ComprehensionClause {
+            var,
+            iterable: Box::new(iterable),
+            condition: condition.map(Box::new),
+        })
+    }
+
+    /// Array literal or list comprehension. A comprehension's span excludes
+    /// the brackets.
+    fn list_expr(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        self.expect(&TokenKind::LBracket)?;
+        let element_start = self.pos;
+        let mut elements = Vec::new();
+
+        if let Some(first) = self.attempt(Self::expr) {
+            if self.at(&TokenKind::For) {
+                let ComprehensionClause {
+                    var,
+                    iterable,
+                    condition,
+                } = self.comprehension_clause()?;
+                let span = self.span_since(element_start);
+                self.expect(&TokenKind::RBracket)?;
+                return Some(Node::new(
+                    Expr::ListComprehension {
+                        element: Box::new(first),
+                        var,
+                        iterable,
+                        condition,
+                    },
+                    span,
+                ));
+            }
+            elements.push(first);
+            loop {
+                let before_comma = self.pos;
+                if !self.eat(&TokenKind::Comma) {
+                    break;
+                }
+                match self.expr() {
+                    Some(element) => elements.push(element),
+                    None => {
+                        self.pos = before_comma;
+                        break;
+                    }
+                }
+            }
+            self.eat(&TokenKind::Comma);
+        }
+
+        self.expect(&TokenKind::RBracket)?;
+        Some(Node::new(Expr::Array(elements), self.span_since(start)))
+    }
+
+    /// Dictionary literal or dict comprehension. A comprehension's span
+    /// excludes the braces.
+    fn dict_expr(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        self.expect(&TokenKind::LBrace)?;
+        let entry_start = self.pos;
+        let mut entries = Vec::new();
+
+        if let Some((key, value)) = self.attempt(Self::dict_entry) {
+            if self.at(&TokenKind::For) {
+                let ComprehensionClause {
+                    var,
+                    iterable,
+                    condition,
+                } = self.comprehension_clause()?;
+                let span = self.span_since(entry_start);
+                self.expect(&TokenKind::RBrace)?;
+                return Some(Node::new(
+                    Expr::DictComprehension {
+                        key: Box::new(key),
+                        value: Box::new(value),
+                        var,
+                        iterable,
+                        condition,
+                    },
+                    span,
+                ));
+            }
+            entries.push((key, value));
+            loop {
+                let before_comma = self.pos;
+                if !self.eat(&TokenKind::Comma) {
+                    break;
+                }
+                match self.dict_entry() {
+                    Some(entry) => entries.push(entry),
+                    None => {
+                        self.pos = before_comma;
+                        break;
+                    }
+                }
+            }
+            self.eat(&TokenKind::Comma);
+        }
+
+        self.expect(&TokenKind::RBrace)?;
+        Some(Node::new(Expr::Dict(entries), self.span_since(start)))
+    }
+
+    fn dict_entry(&mut self) -> PResult<(Node<Expr>, Node<Expr>)> {
+        let key = self.expr()?;
+        self.expect(&TokenKind::Colon)?;
+        let value = self.expr()?;
+        Some((key, value))
+    }
+
+    fn literal(&mut self) -> PResult<Node<Expr>> {
+        let span = self.token_span(self.pos);
+        let literal = match self.peek() {
+            Some(TokenKind::FString(content)) => {
+                self.bump();
+                return Some(parse_fstring(content, span));
+            }
+            Some(TokenKind::StringLiteral(value)) => Literal::String(value.clone()),
+            Some(TokenKind::Number(value)) => Literal::Number(number_literal(value)),
+            Some(TokenKind::True) => Literal::Bool(true),
+            Some(TokenKind::False) => Literal::Bool(false),
+            Some(TokenKind::None) => Literal::None,
+            Some(TokenKind::LParen) if self.peek_at(1) == Some(&TokenKind::RParen) => {
+                let start = self.pos;
+                self.pos += 2;
+                let span = self.span_since(start);
+                return Some(Node::new(
+                    Expr::Literal(Node::new(Literal::Unit, span)),
+                    span,
+                ));
+            }
+            _ => return self.mismatch(),
+        };
+        self.bump();
+        Some(Node::new(Expr::Literal(Node::new(literal, span)), span))
+    }
+
+    fn match_expr(&mut self) -> PResult<Node<Expr>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Match)?;
+        let (value, _) = self.binary_expr(0)?;
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        self.expect(&TokenKind::Indent)?;
+        let arms = self.repeat(Self::match_arm);
+        if arms.is_empty() {
+            return None;
+        }
+        self.expect(&TokenKind::Dedent)?;
+
+        Some(Node::new(
+            Expr::Match {
+                value: Box::new(value),
+                arms,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn match_arm(&mut self) -> PResult<Node<MatchArm>> {
+        let start = self.pos;
+        self.expect(&TokenKind::Case)?;
+        let pattern = self.pattern()?;
+        self.expect(&TokenKind::Colon)?;
+        self.newlines()?;
+        let body = self.block(StatementContext::MatchArm)?;
+        let arm = Node::new(
+            MatchArm {
+                pattern,
+                guard: None,
+                body,
+            },
+            self.span_since(start),
+        );
+        self.skip_newlines();
+        Some(arm)
+    }
+
+    fn pattern(&mut self) -> PResult<Node<Pattern>> {
+        let start = self.pos;
+        let pattern = match self.peek() {
+            Some(TokenKind::Identifier(name)) if name == "_" => {
+                self.bump();
+                Pattern::Wildcard
+            }
+            Some(TokenKind::Identifier(name)) => {
+                if let Some(pattern) = self
+                    .attempt(Self::enum_variant_pattern)
+                    .or_else(|| self.attempt(Self::struct_pattern))
+                {
+                    return Some(pattern);
+                }
+                self.bump();
+                Pattern::Identifier(name.clone())
+            }
+            Some(TokenKind::LBracket) => {
+                self.bump();
+                let patterns = self.comma_separated(Self::pattern);
+                self.expect(&TokenKind::RBracket)?;
+                let rest = self.attempt(|p| {
+                    p.expect(&TokenKind::DoubleDot)?;
+                    p.identifier()
+                });
+                Pattern::Array { patterns, rest }
+            }
+            _ => match self.literal()?.into_inner() {
+                Expr::Literal(literal) => Pattern::Literal(literal),
+                _ => Pattern::Wildcard, // Fallback
+            },
+        };
+        Some(Node::new(pattern, self.span_since(start)))
+    }
+
+    fn enum_variant_pattern(&mut self) -> PResult<Node<Pattern>> {
+        let start = self.pos;
+        let enum_name = self.identifier()?;
+        self.expect(&TokenKind::Dot)?;
+        let variant = self.variant_name()?;
+        let fields = self
+            .attempt(|p| p.parenthesized(Self::pattern))
+            .unwrap_or_default();
+        Some(Node::new(
+            Pattern::EnumVariant {
+                enum_name,
+                variant,
+                fields,
+            },
+            self.span_since(start),
+        ))
+    }
+
+    fn struct_pattern(&mut self) -> PResult<Node<Pattern>> {
+        let start = self.pos;
+        let name = self.identifier()?;
+        self.expect(&TokenKind::LBrace)?;
+        let fields = self.comma_separated(|p| {
+            let field = p.identifier()?;
+            let pattern = p.attempt(|p| {
+                p.expect(&TokenKind::Colon)?;
+                p.pattern()
+            });
+            Some((field, pattern))
+        });
+        self.expect(&TokenKind::RBrace)?;
+        Some(Node::new(
+            Pattern::Struct { name, fields },
+            self.span_since(start),
+        ))
+    }
+}
+
+fn number_literal(value: &str) -> NumberLiteral {
+    // Remove underscores from the number
+    let clean_value = value.replace('_', "");
+    let is_float_literal = value.contains('.') || value.contains('e') || value.contains('E');
+    // Check if it contains a decimal point or is an integer
+    if clean_value.contains('.') {
+        NumberLiteral::new(clean_value.parse().unwrap_or_default(), true)
+    } else {
+        // Parse as integer
+        match clean_value.parse::<i64>() {
+            Ok(int_val) => NumberLiteral::new(int_val as f64, is_float_literal),
+            Err(_) => NumberLiteral::new(0.0, is_float_literal),
+        }
+    }
+}
+
+fn parse_fstring(content: &str, span: Span) -> Node<Expr> {
+    // Parse f-string by splitting on braces and parsing expressions
+    let mut parts = Vec::new();
+    let mut current_text = String::new();
+    let mut chars = content.chars().enumerate().peekable();
+    let span_start = span.start();
+
+    while let Some((i, ch)) = chars.next() {
+        let span_start = span_start + i;
+        match ch {
+            '{' => {
+                if let Some((_, '{')) = chars.peek() {
+                    // Escaped {{
+                    chars.next();
+                    current_text.push('{');
+                    continue;
+                }
+
+                // Expression start
+                if !current_text.is_empty() {
+                    let s = Span::new(span_start, span_start + current_text.len());
+                    parts.push(Node::new(
+                        FStringPart::Text(std::mem::take(&mut current_text)),
+                        s,
+                    ));
+                }
+
+                // Parse expression until }
+                let mut expr_content = String::new();
+                for (_, ch) in chars.by_ref() {
+                    if ch == '}' {
+                        break;
+                    }
+                    expr_content.push(ch);
+                }
+
+                let trimmed = expr_content.trim();
+                if trimmed.is_empty() {
+                    continue;
+                }
+                // The embedded expression may be followed by anything; only
+                // the expression prefix is used.
+                let expr = otterc_lexer::tokenize(trimmed)
+                    .ok()
+                    .and_then(|tokens| Parser::new(&tokens).expr());
+                let part = match expr {
+                    Some(expr) => {
+                        let s = Span::new(span_start, span_start + expr.span().end());
+                        Node::new(FStringPart::Expr(expr), s)
+                    }
+                    None => {
+                        // Fallback to simple identifier if parsing fails
+                        let s = Span::new(span_start, span_start + trimmed.len());
+                        Node::new(
+                            FStringPart::Expr(Node::new(Expr::Identifier(trimmed.to_string()), s)),
+                            s,
+                        )
+                    }
+                };
+                parts.push(part);
+            }
+            // A doubled `}}` is an escaped brace; a single one is kept as text
+            '}' => {
+                if let Some((_, '}')) = chars.peek() {
+                    chars.next();
+                }
+                current_text.push('}');
+            }
+            _ => current_text.push(ch),
+        }
+    }
+
+    // Add remaining text
+    if !current_text.is_empty() {
+        parts.push(Node::new(FStringPart::Text(current_text), span));
+    }
+
+    // If no expressions found, treat as regular string
+    if parts
+        .iter()
+        .all(|part| matches!(part.as_ref(), FStringPart::Text(_)))
+        && let Some(FStringPart::Text(text)) = parts.first().map(|p| p.as_ref())
+    {
+        return Node::new(
+            Expr::Literal(Node::new(Literal::String(text.clone()), span)),
+            span,
+        );
+    }
+
+    Node::new(Expr::FString { parts }, span)
+}
+
+#[cfg(test)]
+mod tests {
+    #![expect(clippy::panic, reason = "Panicking on test failures is acceptable")]
+
+    use super::*;
+
+    #[test]
+    fn parses_multiple_use_modules() {
+        let source = "use fmt, math as m\n";
+        let tokens = otterc_lexer::tokenize(source).expect("tokenize use statement");
+        let program = parse(&tokens).expect("parse use statement");
+
+        assert_eq!(program.statements.len(), 1);
+        match &program.statements[0].as_ref() {
+            Statement::Use { imports } => {
+                assert_eq!(imports.len(), 2);
+                assert_eq!(imports[0].as_ref().module, "fmt");
+                assert!(imports[0].as_ref().alias.is_none());
+                assert_eq!(imports[1].as_ref().module, "math");
+                assert_eq!(imports[1].as_ref().alias.as_deref(), Some("m"));
+            }
+            other => panic!("expected use statement, got {:?}", other),
+        }
+    }
+
+    #[test]
+    fn parses_otter_namespace_use() {
+        let source = "use otter:core\n";
+        let tokens = otterc_lexer::tokenize(source).expect("tokenize namespace use");
+        let program = parse(&tokens).expect("parse namespace use");
+
+        assert_eq!(program.statements.len(), 1);
+        match &program.statements[0].as_ref() {
+            Statement::Use { imports } => {
+                assert_eq!(imports.len(), 1);
+                assert_eq!(imports[0].as_ref().module, "otter:core");
+            }
+            other => panic!("expected use statement, got {:?}", other),
+        }
+    }
+
+    #[test]
+    fn parses_core_stdlib_module() {
+        let source = include_str!("../../../stdlib/otter/core.ot");
+        let tokens = otterc_lexer::tokenize(source).expect("tokenize core module");
+        parse(&tokens).expect("parse core module");
+    }
+
+    #[test]
+    fn parses_enum_demo_example() {
+        let source = include_str!("../../../examples/basic/enum_demo.ot");
+        let tokens = otterc_lexer::tokenize(source).expect("tokenize enum demo");
+        parse(&tokens).expect("parse enum demo");
+    }
+
+    fn corpus_sources() -> Vec<std::path::PathBuf> {
+        fn collect(dir: &std::path::Path, out: &mut Vec<std::path::PathBuf>) {
+            for entry in std::fs::read_dir(dir)
+                .expect("read corpus directory")
+                .flatten()
+            {
+                let path = entry.path();
+                if path.is_dir() {
+                    collect(&path, out);
+                } else if path.extension().is_some_and(|ext| ext == "ot") {
+                    out.push(path);
+                }
+            }
+        }
+
+        let root = std::path::Path::new(env!("CARGO_MANIFEST_DIR")).join("../..");
+        let mut sources = Vec::new();
+        collect(&root.join("examples"), &mut sources);
+        collect(&root.join("stdlib"), &mut sources);
+        sources.sort();
+        sources
+    }
+
+    /// Both parsers must accept the same inputs and build identical
+    /// programs, spans included (`Node` equality ignores spans, `Debug`
+    /// output does not).
+    fn assert_same_as_legacy(name: &str, source: &str) {
+        let Ok(tokens) = otterc_lexer::tokenize(source) else {
+            return;
+        };
+        match (parse(&tokens), crate::grammar::parse_legacy(&tokens)) {
+            (Ok(new), Ok(legacy)) => {
+                assert_eq!(format!("{new:#?}"), format!("{legacy:#?}"), "{name}");
+            }
+            (Err(_), Err(_)) => {}
+            (new, legacy) => panic!(
+                "{name}: parsers disagree\nnew: {:?}\nlegacy: {:?}",
+                new.map(|_| ()),
+                legacy.map(|_| ())
+            ),
+        }
+    }
+
+    #[test]
+    fn matches_legacy_grammar_on_corpus() {
+        let sources = corpus_sources();
+        assert!(!sources.is_empty());
+        for path in sources {
+            let source = std::fs::read_to_string(&path).expect("read corpus file");
+            assert_same_as_legacy(&path.display().to_string(), &source);
+        }
+    }
+
+    #[test]
+    fn matches_legacy_grammar_on_edge_cases() {
+        let cases = [
+            "let r = a + b .. c * d\n",
+            "let r = a < b .. c < d .. e\n",
+            "let r = a .. b .. c\n",
+            "let r = not a == b and -c.d(e) or f is not None\n",
+            "let r = foo(a)(b).c\n",
+            "let p = Point(x=1, y=2,)\n",
+            "let xs = [x * 2 for x in items if x > 1]\n",
+            "let d = {k: v for k in keys}\n",
+            "let d = {\"a\": 1, \"b\": [], }\n",
+            "let s = f\"{name}: {value + 1} {{literal}}\"\n",
+            "let u = ()\n",
+            "x += 1\ny = x\n",
+            "return\n",
+            "pub use otter:core.thing as t\n",
+            "use ./local/module as m, std\n",
+            "type Pair<T> = map<T, list<T>>\n",
+            "fn f(a: int = 1, b) -> list<int>:\n    if a:\n        pass\n    elif b:\n        break\n    else:\n        continue\n",
+            "enum Option<T>:\n    Some: (T)\n    None\n",
+            "struct P:\n    x: float\n    fn norm() -> float:\n        return self.x\n",
+            "match v:\n    case Result.Ok(x):\n        y = x\n    case [a, b]..rest:\n        print(a)\n    case P{x: 1, y}:\n        pass\n    case _:\n        pass\n",
+            "let broken = (1 +\n",
+        ];
+        for case in cases {
+            assert_same_as_legacy(case, case);
+        }
+    }
+
+    #[test]
+    fn reports_every_broken_item() {
+        let source = "let a = (\nlet b = 1\nfn f(:\n    pass\nlet c = ]\n";
+        let tokens = otterc_lexer::tokenize(source).expect("tokenize");
+        let errors = parse(&tokens).expect_err("source has syntax errors");
+        assert_eq!(errors.len(), 3);
+    }
+}
@@ -140,6 +140,16 @@ pub struct BenchmarkConfig {
 
     /// Maximum duration to run (will stop early if exceeded)
     pub max_duration: Option<Duration>,
+
+    /// Warm up for this long instead of `warmup_iterations` calls. Only used in
+    /// adaptive mode, where the warm-up also estimates the cost of one call.
+    pub warmup_time: Option<Duration>,
+
+    /// Enables adaptive mode: `iterations` samples are spread over roughly this
+    /// much time, each sample timing a batch of calls sized so that fast
+    /// functions are not lost in timer resolution. Samples outside the Tukey
+    /// fences are discarded as outliers.
+    pub measurement_time: Option<Duration>,
 }
 
 impl Default for BenchmarkConfig {
@@ -149,6 +159,8 @@ impl Default for BenchmarkConfig {
             iterations: 100,
             min_duration: None,
             max_duration: None,
+            warmup_time: None,
+            measurement_time: None,
         }
     }
 }
@@ -164,6 +176,22 @@ pub struct BenchmarkResult {
 
     /// Timestamp when benchmark was run
     pub timestamp_ms: u64,
+
+    /// Time per call of every kept sample, in nanoseconds (adaptive mode only)
+    #[serde(default)]
+    pub samples_ns: Vec<f64>,
+
+    /// Number of samples discarded as outliers
+    #[serde(default)]
+    pub outliers: usize,
+
+    /// Calls timed together per sample
+    #[serde(default = "default_batch_size")]
+    pub batch_size: u64,
+}
+
+fn default_batch_size() -> u64 {
+    1
 }
 
 impl BenchmarkResult {
@@ -189,6 +217,12 @@ impl BenchmarkResult {
         )
     }
 
+    /// Calls per second, derived from the mean time per call
+    pub fn throughput(&self) -> f64 {
+        let mean = self.stats.mean.as_secs_f64();
+        if mean > 0.0 { 1.0 / mean } else { 0.0 }
+    }
+
     /// CSV header
     pub fn csv_header() -> String {
         "name,iterations,mean_ns,median_ns,std_dev_ns,min_ns,max_ns,p90_ns,p95_ns,p99_ns"
@@ -229,11 +263,27 @@ impl Benchmark {
         self
     }
 
+    /// Warm up for a fixed time (adaptive mode)
+    pub fn warmup_time(mut self, duration: Duration) -> Self {
+        self.config.warmup_time = Some(duration);
+        self
+    }
+
+    /// Spread the samples over roughly `duration`, switching to adaptive mode
+    pub fn measurement_time(mut self, duration: Duration) -> Self {
+        self.config.measurement_time = Some(duration);
+        self
+    }
+
     /// Run the benchmark
     pub fn run<F>(self, mut f: F) -> BenchmarkResult
     where
         F: FnMut(),
     {
+        if let Some(measurement_time) = self.config.measurement_time {
+            return self.run_adaptive(f, measurement_time);
+        }
+
         // Warmup phase
         for _ in 0..self.config.warmup_iterations {
             f();
@@ -275,6 +325,74 @@ impl Benchmark {
             name: self.name,
             stats,
             timestamp_ms: current_time_ms(),
+            samples_ns: Vec::new(),
+            outliers: 0,
+            batch_size: 1,
+        }
+    }
+
+    fn run_adaptive<F>(self, mut f: F, measurement_time: Duration) -> BenchmarkResult
+    where
+        F: FnMut(),
+    {
+        // Warm up with doubling batches; the total also gives a per-call estimate.
+        let warmup_time = self
+            .config
+            .warmup_time
+            .unwrap_or(Duration::from_millis(300));
+        let warmup_start = Instant::now();
+        let mut calls: u64 = 0;
+        let mut batch: u64 = 1;
+        loop {
+            for _ in 0..batch {
+                f();
+            }
+            calls += batch;
+            if warmup_start.elapsed() >= warmup_time {
+                break;
+            }
+            batch = batch.saturating_mul(2);
+        }
+        let per_call_ns = (warmup_start.elapsed().as_nanos() as f64 / calls as f64).max(1.0);
+
+        let sample_count = self.config.iterations.max(2);
+        let sample_budget_ns = measurement_time.as_nanos() as f64 / sample_count as f64;
+        let batch_size = (sample_budget_ns / per_call_ns).max(1.0) as u64;
+
+        let mut samples = Vec::with_capacity(sample_count);
+        let start_time = Instant::now();
+        for _ in 0..sample_count {
+            let sample_start = Instant::now();
+            for _ in 0..batch_size {
+                f();
+            }
+            samples.push(sample_start.elapsed().as_nanos() as f64 / batch_size as f64);
+
+            if self
+                .config
+                .max_duration
+                .is_some_and(|max_dur| start_time.elapsed() > max_dur)
+            {
+                break;
+            }
+        }
+
+        let total = samples.len();
+        let samples_ns = reject_outliers(samples);
+        let stats = BenchmarkStats::from_durations(
+            samples_ns
+                .iter()
+                .map(|&ns| Duration::from_nanos(ns.round() as u64))
+                .collect(),
+        );
+
+        BenchmarkResult {
+            name: self.name,
+            stats,
+            timestamp_ms: current_time_ms(),
+            outliers: total - samples_ns.len(),
+            samples_ns,
+            batch_size,
         }
     }
 
@@ -319,6 +437,185 @@ pub fn compare_benchmarks(baseline: &BenchmarkResult, current: &BenchmarkResult)
     )
 }
 
+/// Whether a run differs from its baseline
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Verdict {
+    Improved,
+    Regressed,
+    NoChange,
+}
+
+/// Statistical comparison of a run against a baseline
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct Comparison {
+    /// Relative change in mean time per call (`0.05` is 5% slower)
+    pub change: f64,
+
+    /// Two-sided p-value of Welch's t-test on the per-call samples
+    pub p_value: f64,
+
+    pub verdict: Verdict,
+}
+
+/// Compare per-call samples with Welch's t-test. A change is only reported
+/// when it is significant at `alpha` and larger than `noise_threshold`
+/// (relative), so small but real shifts from frequency scaling and the like
+/// do not flag. Returns `None` unless both runs recorded at least two samples.
+pub fn compare_significance(
+    baseline: &BenchmarkResult,
+    current: &BenchmarkResult,
+    alpha: f64,
+    noise_threshold: f64,
+) -> Option<Comparison> {
+    let (base_mean, base_var, base_n) = mean_and_variance(&baseline.samples_ns)?;
+    let (cur_mean, cur_var, cur_n) = mean_and_variance(&current.samples_ns)?;
+    if base_mean <= 0.0 {
+        return None;
+    }
+
+    let change = (cur_mean - base_mean) / base_mean;
+    let base_se = base_var / base_n;
+    let cur_se = cur_var / cur_n;
+    let se = base_se + cur_se;
+    let p_value = if se == 0.0 {
+        if cur_mean == base_mean { 1.0 } else { 0.0 }
+    } else {
+        let t = (cur_mean - base_mean) / se.sqrt();
+        let df = se * se / (base_se * base_se / (base_n - 1.0) + cur_se * cur_se / (cur_n - 1.0));
+        student_t_two_sided_p(t, df)
+    };
+
+    let verdict = if p_value >= alpha || change.abs() < noise_threshold {
+        Verdict::NoChange
+    } else if change < 0.0 {
+        Verdict::Improved
+    } else {
+        Verdict::Regressed
+    };
+
+    Some(Comparison {
+        change,
+        p_value,
+        verdict,
+    })
+}
+
+/// Keep the samples inside the Tukey fences (1.5 IQR beyond the quartiles)
+fn reject_outliers(samples: Vec<f64>) -> Vec<f64> {
+    if samples.len() < 4 {
+        return samples;
+    }
+    let mut sorted = samples.clone();
+    sorted.sort_by(f64::total_cmp);
+    let quantile = |q: f64| {
+        let position = q * (sorted.len() - 1) as f64;
+        let lower = sorted[position.floor() as usize];
+        let upper = sorted[position.ceil() as usize];
+        lower + (upper - lower) * position.fract()
+    };
+    let (q1, q3) = (quantile(0.25), quantile(0.75));
+    let fence = 1.5 * (q3 - q1);
+    let (low, high) = (q1 - fence, q3 + fence);
+    samples
+        .into_iter()
+        .filter(|&sample| sample >= low && sample <= high)
+        .collect()
+}
+
+/// Mean, unbiased variance and count as `f64`, if there are at least two samples
+fn mean_and_variance(samples: &[f64]) -> Option<(f64, f64, f64)> {
+    if samples.len() < 2 {
+        return None;
+    }
+    let n = samples.len() as f64;
+    let mean = samples.iter().sum::<f64>() / n;
+    let variance = samples.iter().map(|x| (x - mean) * (x - mean)).sum::<f64>() / (n - 1.0);
+    Some((mean, variance, n))
+}
+
+/// Two-sided tail probability of Student's t distribution
+fn student_t_two_sided_p(t: f64, df: f64) -> f64 {
+    if !t.is_finite() {
+        return 0.0;
+    }
+    let x = df / (df + t * t);
+    regularized_incomplete_beta(x, df / 2.0, 0.5).clamp(0.0, 1.0)
+}
+
+/// Regularized incomplete beta function I_x(a, b), via its continued fraction
+fn regularized_incomplete_beta(x: f64, a: f64, b: f64) -> f64 {
+    if x <= 0.0 {
+        return 0.0;
+    }
+    if x >= 1.0 {
+        return 1.0;
+    }
+    let front =
+        (ln_gamma(a + b) - ln_gamma(a) - ln_gamma(b) + a * x.ln() + b * (1.0 - x).ln()).exp();
+    // The continued fraction converges quickly only below the mean of the distribution.
+    if x < (a + 1.0) / (a + b + 2.0) {
+        front * beta_continued_fraction(x, a, b) / a
+    } else {
+        1.0 - front * beta_continued_fraction(1.0 - x, b, a) / b
+    }
+}
+
+/// Modified Lentz evaluation of the incomplete beta continued fraction
+fn beta_continued_fraction(x: f64, a: f64, b: f64) -> f64 {
+    const TINY: f64 = 1e-300;
+    const EPSILON: f64 = 1e-14;
+
+    let mut c = 1.0;
+    let mut d = 1.0 - (a + b) * x / (a + 1.0);
+    if d.abs() < TINY {
+        d = TINY;
+    }
+    d = 1.0 / d;
+    let mut result = d;
+
+    for m in 1..300 {
+        let m = f64::from(m);
+        let numerator = m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+        for numerator in [
+            numerator,
+            -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0)),
+        ] {
+            d = 1.0 + numerator * d;
+            if d.abs() < TINY {
+                d = TINY;
+            }
+            c = 1.0 + numerator / c;
+            if c.abs() < TINY {
+                c = TINY;
+            }
+            d = 1.0 / d;
+            result *= d * c;
+        }
+        if (d * c - 1.0).abs() < EPSILON {
+            break;
+        }
+    }
+    result
+}
+
+/// Lanczos approximation of ln Γ(x) for x > 0
+fn ln_gamma(x: f64) -> f64 {
+    const COEFFICIENTS: [f64; 6] = [
+        76.180_091_729_471_46,
+        -86.505_320_329_416_77,
+        24.014_098_240_830_91,
+        -1.231_739_572_450_155,
+        0.001_208_650_973_866_179,
+        -0.000_005_395_239_384_953,
+    ];
+    let tmp = x + 5.5 - (x + 0.5) * (x + 5.5).ln();
+    let mut series = 1.000_000_000_190_015;
+    for (offset, coefficient) in COEFFICIENTS.iter().enumerate() {
+        series += coefficient / (x + 1.0 + offset as f64);
+    }
+    -tmp + (2.506_628_274_631_000_5 * series / x).ln()
+}
+
 /// Calculate percentile from sorted durations
 fn percentile(sorted_durations: &[Duration], p: f64) -> Duration {
     if sorted_durations.is_empty() {
@@ -368,6 +665,66 @@ mod tests {
         assert!(result.stats.mean > Duration::ZERO);
     }
 
+    #[test]
+    fn test_adaptive_run_batches_fast_calls() {
+        let mut counter = 0u64;
+        let result = Benchmark::new("adaptive")
+            .iterations(20)
+            .warmup_time(Duration::from_millis(5))
+            .measurement_time(Duration::from_millis(20))
+            .run(|| counter = std::hint::black_box(counter + 1));
+
+        assert!(result.batch_size > 1);
+        assert_eq!(result.samples_ns.len() + result.outliers, 20);
+        assert!(result.throughput() > 0.0);
+    }
+
+    #[test]
+    fn test_reject_outliers() {
+        let mut samples = vec![10.0, 11.0, 10.5, 9.5, 10.2, 9.8, 10.1];
+        samples.push(500.0);
+        let kept = reject_outliers(samples);
+        assert_eq!(kept.len(), 7);
+        assert!(kept.iter().all(|&sample| sample < 20.0));
+    }
+
+    fn result_with_samples(samples_ns: Vec<f64>) -> BenchmarkResult {
+        BenchmarkResult {
+            name: "bench".to_string(),
+            stats: BenchmarkStats::default(),
+            timestamp_ms: 0,
+            samples_ns,
+            outliers: 0,
+            batch_size: 1,
+        }
+    }
+
+    #[test]
+    fn test_compare_significance() {
+        let base: Vec<f64> = (0..50).map(|i| 100.0 + f64::from(i % 5)).collect();
+        let same: Vec<f64> = (0..50).map(|i| 100.0 + f64::from((i + 2) % 5)).collect();
+        let slower: Vec<f64> = base.iter().map(|x| x * 1.2).collect();
+
+        let baseline = result_with_samples(base);
+        let unchanged =
+            compare_significance(&baseline, &result_with_samples(same), 0.05, 0.02).unwrap();
+        assert_eq!(unchanged.verdict, Verdict::NoChange);
+        assert!(unchanged.p_value > 0.5);
+
+        let regressed =
+            compare_significance(&baseline, &result_with_samples(slower), 0.05, 0.02).unwrap();
+        assert_eq!(regressed.verdict, Verdict::Regressed);
+        assert!(regressed.p_value < 1e-6);
+        assert!((regressed.change - 0.2).abs() < 1e-9);
+    }
+
+    #[test]
+    fn test_student_t_p_value() {
+        // t = 2.228 is the two-sided 5% critical value for 10 degrees of freedom.
+        assert!((student_t_two_sided_p(2.228, 10.0) - 0.05).abs() < 1e-3);
+        assert!((student_t_two_sided_p(0.0, 10.0) - 1.0).abs() < 1e-9);
+    }
+
     #[test]
     fn test_percentile() {
         let durations = vec![
@@ -4,16 +4,24 @@ use std::collections::{HashMap, HashSet};
 use std::sync::Arc;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 
+use crossbeam_deque::{Injector, Steal};
 use parking_lot::RwLock;
 
 use crate::memory::config::GcStrategy;
 use crate::memory::profiler::get_profiler;
+use crate::memory::roots;
 
 /// Trait for garbage collection strategies
 pub trait GcStrategyTrait: Send + Sync {
     /// Run garbage collection
     fn collect(&self) -> GcStats;
 
+    /// Run garbage collection with `roots` as extra roots for this run only
+    fn collect_with_roots(&self, roots: &[usize]) -> GcStats {
+        let _ = roots;
+        self.collect()
+    }
+
     /// Allocate memory
     fn alloc(&self, size: usize) -> Option<*mut u8>;
 
@@ -100,6 +108,9 @@ pub struct MarkSweepGC {
 pub enum ObjectKind {
     Raw,
     CString,
+    /// Enum tagged union `{ i64 tag, [N x i64] payload }`; payload slots are
+    /// scanned conservatively for pointers to other tracked objects.
+    Enum,
 }
 
 #[derive(Debug, Clone)]
@@ -144,13 +155,26 @@ impl MarkSweepGC {
         self.objects.write().remove(&ptr);
     }
 
-    /// Mark phase: mark all reachable objects
-    fn mark(&self) -> HashSet<usize> {
+    /// Objects directly reachable from `ptr`
+    fn children(ptr: usize, info: &ObjectInfo) -> Vec<usize> {
+        let mut children = info.references.clone();
+        if info.kind == ObjectKind::Enum {
+            let slots = info.size / 8;
+            // SAFETY: enum objects are zero-initialised `alloc_traced`
+            // allocations of `info.size` bytes that stay registered until swept.
+            children.extend((1..slots).map(|slot| unsafe { *(ptr as *const usize).add(slot) }));
+        }
+        children
+    }
+
+    /// Mark phase: mark all objects reachable from the registered roots and
+    /// `extra_roots`
+    fn mark(&self, extra_roots: &[usize]) -> HashSet<usize> {
         let mut marked = HashSet::new();
         let roots = self.roots.read().clone();
         let objects = self.objects.read().clone();
 
-        let mut stack: Vec<usize> = roots.iter().copied().collect();
+        let mut stack: Vec<usize> = roots.iter().chain(extra_roots).copied().collect();
 
         while let Some(ptr) = stack.pop() {
             if marked.contains(&ptr) {
@@ -160,7 +184,7 @@ impl MarkSweepGC {
             marked.insert(ptr);
 
             if let Some(info) = objects.get(&ptr) {
-                for &ref_ptr in &info.references {
+                for ref_ptr in Self::children(ptr, info) {
                     if !marked.contains(&ref_ptr) {
                         stack.push(ref_ptr);
                     }
@@ -194,7 +218,7 @@ impl MarkSweepGC {
                 // Actually free the memory
                 unsafe {
                     match info.kind {
-                        ObjectKind::Raw => {
+                        ObjectKind::Raw | ObjectKind::Enum => {
                             let layout = std::alloc::Layout::from_size_align(info.size, 8).unwrap();
                             std::alloc::dealloc(ptr as *mut u8, layout);
                         }
@@ -217,9 +241,13 @@ impl MarkSweepGC {
 
 impl GcStrategyTrait for MarkSweepGC {
     fn collect(&self) -> GcStats {
+        self.collect_with_roots(&[])
+    }
+
+    fn collect_with_roots(&self, roots: &[usize]) -> GcStats {
         let start = std::time::Instant::now();
 
-        let marked = self.mark();
+        let marked = self.mark(roots);
         let mut stats = self.sweep(&marked);
 
         stats.duration_ms = start.elapsed().as_millis() as u64;
@@ -289,7 +317,7 @@ impl GenerationalGC {
         }
 
         // Nursery full, trigger minor GC
-        let _stats = self.collect_minor();
+        let _stats = self.collect_minor(&[]);
 
         // Try again after GC
         if let Some(ptr) = self.nursery.alloc(size, 8) {
@@ -303,7 +331,7 @@ impl GenerationalGC {
     }
 
     /// Minor GC: Collect nursery, promote survivors to old gen
-    fn collect_minor(&self) -> GcStats {
+    fn collect_minor(&self, extra_roots: &[usize]) -> GcStats {
         let start = std::time::Instant::now();
         let mut objects_collected = 0;
         let mut bytes_freed = 0;
@@ -315,7 +343,7 @@ impl GenerationalGC {
 
         // Find reachable objects in nursery
         let mut reachable = HashSet::new();
-        let mut stack: Vec<usize> = roots.iter().copied().collect();
+        let mut stack: Vec<usize> = roots.iter().chain(extra_roots).copied().collect();
 
         while let Some(ptr) = stack.pop() {
             if reachable.contains(&ptr) {
@@ -328,15 +356,13 @@ impl GenerationalGC {
 
                 // Trace children
                 if let Some(info) = nursery_objects.get(&ptr) {
-                    for &ref_ptr in &info.references {
-                        stack.push(ref_ptr);
-                    }
+                    stack.extend(MarkSweepGC::children(ptr, info));
                 }
             } else {
                 // If it's in old gen, we might need to trace into nursery
                 // (This requires write barriers in full impl, simplified here)
                 if let Some(info) = self.old_gen.objects.read().get(&ptr) {
-                    for &ref_ptr in &info.references {
+                    for ref_ptr in MarkSweepGC::children(ptr, info) {
                         if !reachable.contains(&ref_ptr) {
                             stack.push(ref_ptr);
                         }
@@ -395,7 +421,11 @@ impl GenerationalGC {
 impl GcStrategyTrait for GenerationalGC {
     fn collect(&self) -> GcStats {
         // Default to minor GC
-        self.collect_minor()
+        self.collect_minor(&[])
+    }
+
+    fn collect_with_roots(&self, roots: &[usize]) -> GcStats {
+        self.collect_minor(roots)
     }
 
     fn alloc(&self, size: usize) -> Option<*mut u8> {
@@ -426,9 +456,19 @@ impl Default for GenerationalGC {
     }
 }
 
+/// A traced object allocated since the last collection
+struct PendingObject {
+    ptr: usize,
+    size: usize,
+    kind: ObjectKind,
+}
+
 /// GC manager that handles different strategies
 pub struct GcManager {
     strategy: Arc<RwLock<Box<dyn GcStrategyTrait>>>,
+    /// Objects from `alloc_traced`, handed to the strategy when the next
+    /// collection starts so that allocating takes no lock
+    pending: Injector<PendingObject>,
     config: Arc<RwLock<crate::memory::config::GcConfig>>,
     gc_enabled: AtomicBool,
     disabled_bytes: AtomicUsize,
@@ -449,6 +489,7 @@ impl GcManager {
         let disabled_limit = config.disabled_heap_limit;
         Self {
             strategy: Arc::new(RwLock::new(strategy)),
+            pending: Injector::new(),
             config: Arc::new(RwLock::new(config)),
             gc_enabled: AtomicBool::new(true),
             disabled_bytes: AtomicUsize::new(0),
@@ -462,7 +503,21 @@ impl GcManager {
         if !self.is_enabled() {
             return GcStats::default();
         }
-        self.strategy.read().collect()
+        // Without a stack scan live objects cannot be told from garbage.
+        let Some(roots) = roots::conservative_roots() else {
+            return GcStats::default();
+        };
+        let strategy = self.strategy.read();
+        loop {
+            match self.pending.steal() {
+                Steal::Success(object) => {
+                    strategy.register_object(object.ptr, object.size, object.kind);
+                }
+                Steal::Retry => {}
+                Steal::Empty => break,
+            }
+        }
+        strategy.collect_with_roots(&roots)
     }
 
     pub fn alloc(&self, size: usize) -> Option<*mut u8> {
@@ -479,6 +534,31 @@ impl GcManager {
         ptr
     }
 
+    /// Allocate a zeroed object of `kind` outside any moving space for the
+    /// collector to trace and free.
+    ///
+    /// The object is not rooted: it stays alive while its address is on the
+    /// collecting thread's stack, in a runtime list or map, or in another live
+    /// traced object (see `memory::roots`). Allocating takes no lock; the
+    /// object is queued and registered when the next collection starts.
+    pub fn alloc_traced(&self, size: usize, kind: ObjectKind) -> Option<*mut u8> {
+        let layout = std::alloc::Layout::from_size_align(size.max(8), 8).ok()?;
+        // Collect before allocating, so the new object cannot be swept
+        // before its address reaches the caller.
+        self.collect_if_due(layout.size());
+        // SAFETY: the layout has a non-zero size.
+        let ptr = unsafe { std::alloc::alloc_zeroed(layout) };
+        if ptr.is_null() {
+            return None;
+        }
+        self.pending.push(PendingObject {
+            ptr: ptr as usize,
+            size: layout.size(),
+            kind,
+        });
+        Some(ptr)
+    }
+
     pub fn add_root(&self, ptr: usize) {
         self.strategy.read().add_root(ptr);
     }
@@ -492,18 +572,7 @@ impl GcManager {
 
         // Check memory threshold and trigger GC if needed
         if self.is_enabled() {
-            let bytes = self.bytes_since_last_gc.fetch_add(size, Ordering::Relaxed);
-            let threshold = self.gc_threshold.load(Ordering::Relaxed);
-
-            if bytes > threshold {
-                // Reset counter before collecting to avoid multiple threads triggering
-                // Note: This is a simple heuristic, race conditions might cause slight over-triggering or under-counting
-                // but it's fine for this GC implementation.
-                self.bytes_since_last_gc.store(0, Ordering::Relaxed);
-
-                // Trigger collection
-                let _ = self.collect();
-            }
+            self.collect_if_due(size);
 
             // Update profiler
             get_profiler().record_allocation(
@@ -517,6 +586,25 @@ impl GcManager {
         }
     }
 
+    /// Count `size` new bytes and collect once the threshold is passed
+    fn collect_if_due(&self, size: usize) {
+        if !self.is_enabled() {
+            return;
+        }
+        let bytes = self.bytes_since_last_gc.fetch_add(size, Ordering::Relaxed);
+        let threshold = self.gc_threshold.load(Ordering::Relaxed);
+
+        if bytes > threshold {
+            // Reset counter before collecting to avoid multiple threads triggering
+            // Note: This is a simple heuristic, race conditions might cause slight over-triggering or under-counting
+            // but it's fine for this GC implementation.
+            self.bytes_since_last_gc.store(0, Ordering::Relaxed);
+
+            // Trigger collection
+            let _ = self.collect();
+        }
+    }
+
     pub fn set_strategy(&self, strategy: GcStrategy) {
         let new_strategy: Box<dyn GcStrategyTrait> = match strategy {
             GcStrategy::ReferenceCounting => Box::new(RcGC::new()),
@@ -588,3 +676,50 @@ static GLOBAL_GC: once_cell::sync::Lazy<GcManager> = once_cell::sync::Lazy::new(
 pub fn get_gc() -> &'static GcManager {
     &GLOBAL_GC
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::memory::config::GcConfig;
+
+    fn tracked_string(gc: &GcManager, text: &str) -> usize {
+        let s = std::ffi::CString::new(text).unwrap().into_raw() as usize;
+        gc.register_object(s, text.len() + 1, ObjectKind::CString);
+        s
+    }
+
+    #[test]
+    fn traced_enums_on_the_stack_survive_collection() {
+        for strategy in [GcStrategy::MarkSweep, GcStrategy::Generational] {
+            let gc = GcManager::new(GcConfig::new(strategy));
+            let value = gc.alloc_traced(16, ObjectKind::Enum).unwrap() as *mut usize;
+            let payload = tracked_string(&gc, "payload");
+            unsafe {
+                value.write(1);
+                value.add(1).write(payload);
+            }
+
+            assert_eq!(gc.collect().objects_collected, 0, "{strategy:?}");
+            assert!(gc.pending.is_empty(), "{strategy:?}");
+            assert_eq!(unsafe { *std::hint::black_box(value) }, 1, "{strategy:?}");
+            let text = unsafe { std::ffi::CStr::from_ptr(payload as *const _) };
+            assert_eq!(text.to_str().unwrap(), "payload", "{strategy:?}");
+        }
+    }
+
+    #[test]
+    fn unreachable_enums_are_swept_with_their_payload() {
+        let gc = MarkSweepGC::new();
+        let layout = std::alloc::Layout::from_size_align(16, 8).unwrap();
+        let value = unsafe { std::alloc::alloc_zeroed(layout) } as usize;
+        gc.register_object(value, 16, ObjectKind::Enum, Vec::new());
+        let payload = std::ffi::CString::new("payload").unwrap().into_raw() as usize;
+        gc.register_object(payload, 8, ObjectKind::CString, Vec::new());
+        unsafe { (value as *mut usize).add(1).write(payload) };
+
+        assert_eq!(gc.collect_with_roots(&[value]).objects_collected, 0);
+        let stats = gc.collect_with_roots(&[]);
+        assert_eq!(stats.objects_collected, 2);
+        assert_eq!(stats.bytes_freed, 24);
+    }
+}
@@ -9,6 +9,7 @@ pub mod gc;
 pub mod object;
 pub mod profiler;
 pub mod rc;
+mod roots;
 
 pub use config::{GcConfig, GcStrategy};
 pub use gc::{GcStats, GcStrategyTrait, GenerationalGC, MarkSweepGC, RcGC, get_gc};
@@ -0,0 +1,161 @@
+//! Conservative roots for the collector
+//!
+//! Compiled code keeps heap values such as enums as plain `i64` words in
+//! registers, stack slots and runtime lists, and emits no stack maps. At each
+//! collection every word that could be the address of a tracked object is
+//! treated as a root. A word that only looks like an address keeps an object
+//! alive longer than needed, which is safe.
+//!
+//! Only the collecting thread's stack is scanned. A heap value that is held
+//! only by another thread's stack must be stored in a list or map, or rooted
+//! with `gc.add_root`, while a collection can run.
+
+/// Lowest address a tracked object can have
+const MIN_ADDRESS: usize = 4096;
+
+/// Words that may address a tracked object, or `None` when this target
+/// cannot scan its stack
+pub(crate) fn conservative_roots() -> Option<Vec<usize>> {
+    let mut roots = Vec::new();
+    if !scan_stack(&mut roots) {
+        return None;
+    }
+    crate::stdlib::builtins::for_each_stored_int(|word| push_candidate(&mut roots, word as usize));
+    Some(roots)
+}
+
+fn push_candidate(roots: &mut Vec<usize>, word: usize) {
+    if word >= MIN_ADDRESS && word.is_multiple_of(8) {
+        roots.push(word);
+    }
+}
+
+#[cfg(all(
+    any(target_os = "linux", target_os = "macos"),
+    any(target_arch = "x86_64", target_arch = "aarch64")
+))]
+thread_local! {
+    static STACK_TOP: Option<usize> = stack_top();
+}
+
+/// Highest address of the calling thread's stack
+#[cfg(all(
+    target_os = "linux",
+    any(target_arch = "x86_64", target_arch = "aarch64")
+))]
+fn stack_top() -> Option<usize> {
+    let mut attr = std::mem::MaybeUninit::<libc::pthread_attr_t>::uninit();
+    // SAFETY: `attr` is initialised by `pthread_getattr_np` before it is
+    // read, and destroyed once the bounds are copied out.
+    unsafe {
+        if libc::pthread_getattr_np(libc::pthread_self(), attr.as_mut_ptr()) != 0 {
+            return None;
+        }
+        let mut low = std::ptr::null_mut();
+        let mut size = 0;
+        let found = libc::pthread_attr_getstack(attr.as_ptr(), &mut low, &mut size) == 0;
+        libc::pthread_attr_destroy(attr.as_mut_ptr());
+        found.then(|| low as usize + size)
+    }
+}
+
+/// Highest address of the calling thread's stack
+#[cfg(all(
+    target_os = "macos",
+    any(target_arch = "x86_64", target_arch = "aarch64")
+))]
+fn stack_top() -> Option<usize> {
+    // SAFETY: queries the calling thread, which is alive.
+    Some(unsafe { libc::pthread_get_stackaddr_np(libc::pthread_self()) } as usize)
+}
+
+/// Store the callee-saved registers in `registers`, so that values the
+/// callers keep there are seen by the stack scan
+#[inline(always)]
+#[cfg(all(any(target_os = "linux", target_os = "macos"), target_arch = "x86_64"))]
+fn spill_registers(registers: &mut [usize; 12]) {
+    // SAFETY: writes six words into `registers`, which has room for twelve.
+    unsafe {
+        std::arch::asm!(
+            "mov [{0}], rbx",
+            "mov [{0} + 8], rbp",
+            "mov [{0} + 16], r12",
+            "mov [{0} + 24], r13",
+            "mov [{0} + 32], r14",
+            "mov [{0} + 40], r15",
+            in(reg) registers.as_mut_ptr(),
+            options(nostack, preserves_flags),
+        );
+    }
+}
+
+/// Store the callee-saved registers in `registers`, so that values the
+/// callers keep there are seen by the stack scan
+#[inline(always)]
+#[cfg(all(any(target_os = "linux", target_os = "macos"), target_arch = "aarch64"))]
+fn spill_registers(registers: &mut [usize; 12]) {
+    // SAFETY: writes eleven words into `registers`, which has room for twelve.
+    unsafe {
+        std::arch::asm!(
+            "stp x19, x20, [{0}]",
+            "stp x21, x22, [{0}, #16]",
+            "stp x23, x24, [{0}, #32]",
+            "stp x25, x26, [{0}, #48]",
+            "stp x27, x28, [{0}, #64]",
+            "str x29, [{0}, #80]",
+            in(reg) registers.as_mut_ptr(),
+            options(nostack, preserves_flags),
+        );
+    }
+}
+
+/// Push every candidate word between this frame and the top of the stack
+#[inline(never)]
+#[cfg(all(
+    any(target_os = "linux", target_os = "macos"),
+    any(target_arch = "x86_64", target_arch = "aarch64")
+))]
+fn scan_stack(roots: &mut Vec<usize>) -> bool {
+    let Some(top) = STACK_TOP.with(|top| *top) else {
+        return false;
+    };
+    let mut registers = [0; 12];
+    spill_registers(&mut registers);
+    let mut word = std::hint::black_box(registers.as_ptr()) as usize;
+    while word + size_of::<usize>() <= top {
+        // SAFETY: `word` lies between a local of this frame and the top of
+        // this thread's stack, which stays mapped while we run.
+        push_candidate(roots, unsafe {
+            std::ptr::read_volatile(word as *const usize)
+        });
+        word += size_of::<usize>();
+    }
+    true
+}
+
+#[cfg(not(all(
+    any(target_os = "linux", target_os = "macos"),
+    any(target_arch = "x86_64", target_arch = "aarch64")
+)))]
+fn scan_stack(_roots: &mut Vec<usize>) -> bool {
+    false
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn words_on_the_stack_are_roots() {
+        let local = Box::new(7_u64);
+        let address = std::hint::black_box(&*local as *const u64 as usize);
+        let roots = conservative_roots().unwrap();
+        assert!(roots.contains(&address));
+        assert!(
+            roots
+                .iter()
+                .all(|&word| word >= MIN_ADDRESS && word.is_multiple_of(8))
+        );
+        assert_eq!(*std::hint::black_box(local), 7);
+    }
+}
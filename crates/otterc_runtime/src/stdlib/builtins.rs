@@ -1,3 +1,4 @@
+use std::borrow::Cow;
 use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
 use std::panic::{AssertUnwindSafe, catch_unwind};
@@ -6,7 +7,7 @@ use std::sync::atomic::{AtomicU64, Ordering};
 use once_cell::sync::Lazy;
 use parking_lot::RwLock;
 
-use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
+use otterc_symbol::registry::{FfiEffects, FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 // ============================================================================
 // Built-in Collections Registry
@@ -31,9 +32,17 @@ pub enum Value {
     Map(HandleId),
 }
 
-// Runtime Value Handle Registry
-// Instead of encoding type info into bits, we store full-precision values
-// in a registry and return handles with embedded type information
+// Runtime Value Encoding
+// Values crossing into generated code are NaN-boxed into a single u64 so that
+// scalars need no side table: any bit pattern that is not a boxed value is an
+// f64, and boxed values live in the negative quiet-NaN space (which real
+// doubles never occupy, since NaNs are canonicalized on encode).
+//
+//   f64:    the IEEE-754 bits (NaN canonicalized to 0x7ff8_0000_0000_0000)
+//   boxed:  1111_1111_1111_1ttt | 48-bit payload
+//
+// Integers that fit in 48 bits are stored inline; wider ones are boxed on the
+// heap and released by `otter_free_runtime_value`.
 
 #[repr(u8)]
 #[derive(Clone, Copy, Debug, PartialEq)]
@@ -47,84 +56,171 @@ pub enum ValueKind {
     Map = 6,
 }
 
-struct RuntimeValue {
-    value: Value,
+/// Bits shared by every boxed value: sign, exponent and quiet bit all set.
+const BOX_PREFIX: u64 = 0xfff8_0000_0000_0000;
+/// Boxed values carry their tag in the three bits below the prefix.
+const BOX_TAG_SHIFT: u32 = 48;
+const BOX_PAYLOAD_MASK: u64 = (1u64 << BOX_TAG_SHIFT) - 1;
+
+const TAG_UNIT: u64 = 0;
+const TAG_BOOL: u64 = 1;
+/// Integer stored inline as a sign-extended 48-bit payload.
+const TAG_INT: u64 = 2;
+/// Integer too wide for the payload; the payload points to a `Box<i64>`.
+const TAG_BIG_INT: u64 = 3;
+const TAG_STRING: u64 = 4;
+const TAG_LIST: u64 = 5;
+const TAG_MAP: u64 = 6;
+
+const CANONICAL_NAN: u64 = 0x7ff8_0000_0000_0000;
+const INT_PAYLOAD_BITS: u32 = 64 - BOX_TAG_SHIFT;
+
+/// Encoding of `Value::Unit`, also returned when there is no value.
+pub(crate) const ENCODED_UNIT: u64 = BOX_PREFIX | (TAG_UNIT << BOX_TAG_SHIFT);
+
+const fn boxed(tag: u64, payload: u64) -> u64 {
+    BOX_PREFIX | (tag << BOX_TAG_SHIFT) | (payload & BOX_PAYLOAD_MASK)
 }
 
-static RUNTIME_VALUES: Lazy<RwLock<std::collections::HashMap<HandleId, RuntimeValue>>> =
-    Lazy::new(|| RwLock::new(std::collections::HashMap::new()));
+#[inline]
+fn boxed_tag(encoded: u64) -> Option<u64> {
+    (encoded & BOX_PREFIX == BOX_PREFIX).then_some((encoded >> BOX_TAG_SHIFT) & 0b111)
+}
 
-// Encode value handle with type tag in upper 8 bits, handle ID in lower 56 bits
-// This gives us full precision for all types
-const TAG_SHIFT: u32 = 56;
-const HANDLE_MASK: u64 = (1u64 << TAG_SHIFT) - 1;
+#[inline]
+fn inline_int(encoded: u64) -> i64 {
+    ((encoded << INT_PAYLOAD_BITS) as i64) >> INT_PAYLOAD_BITS
+}
 
 pub(crate) fn encode_runtime_value(value: &Value) -> u64 {
-    // For simple scalar values that fit in 56 bits without loss, encode directly
     match value {
-        Value::Unit => (ValueKind::Unit as u64) << TAG_SHIFT,
-        Value::Bool(b) => {
-            let val = if *b { 1u64 } else { 0u64 };
-            ((ValueKind::Bool as u64) << TAG_SHIFT) | val
-        }
-        Value::I64(_i) => {
-            // For I64, we need full 64-bit precision, so use handle
-            let handle_id = next_handle_id();
-            RUNTIME_VALUES.write().insert(
-                handle_id,
-                RuntimeValue {
-                    value: value.clone(),
-                },
-            );
-            ((ValueKind::I64 as u64) << TAG_SHIFT) | (handle_id & HANDLE_MASK)
+        Value::Unit => ENCODED_UNIT,
+        Value::Bool(b) => boxed(TAG_BOOL, u64::from(*b)),
+        Value::I64(i) => {
+            if inline_int(*i as u64) == *i {
+                boxed(TAG_INT, *i as u64)
+            } else {
+                boxed(TAG_BIG_INT, Box::into_raw(Box::new(*i)) as u64)
+            }
         }
-        Value::F64(_f) => {
-            // For F64, we need full 64-bit precision, so use handle
-            let handle_id = next_handle_id();
-            RUNTIME_VALUES.write().insert(
-                handle_id,
-                RuntimeValue {
-                    value: value.clone(),
-                },
-            );
-            ((ValueKind::F64 as u64) << TAG_SHIFT) | (handle_id & HANDLE_MASK)
+        Value::F64(f) => {
+            if f.is_nan() {
+                CANONICAL_NAN
+            } else {
+                f.to_bits()
+            }
         }
         Value::String(s) => {
-            // For strings, store pointer directly with tag
-            let ptr = CString::new(s.clone()).unwrap().into_raw() as u64;
-            ((ValueKind::String as u64) << TAG_SHIFT) | (ptr & HANDLE_MASK)
-        }
-        Value::List(h) | Value::Map(h) => {
-            // Lists and maps already use handles
-            let tag = if matches!(value, Value::List(_)) {
-                ValueKind::List
-            } else {
-                ValueKind::Map
-            };
-            ((tag as u64) << TAG_SHIFT) | (*h & HANDLE_MASK)
+            let ptr = CString::new(s.as_str()).unwrap_or_default().into_raw() as u64;
+            boxed(TAG_STRING, ptr)
         }
+        Value::List(h) => boxed(TAG_LIST, *h),
+        Value::Map(h) => boxed(TAG_MAP, *h),
     }
 }
 
 pub fn decode_value_kind(encoded: u64) -> ValueKind {
-    let tag = (encoded >> TAG_SHIFT) as u8;
-    match tag {
-        1 => ValueKind::Bool,
-        2 => ValueKind::I64,
-        3 => ValueKind::F64,
-        4 => ValueKind::String,
-        5 => ValueKind::List,
-        6 => ValueKind::Map,
-        _ => ValueKind::Unit,
+    match boxed_tag(encoded) {
+        None => ValueKind::F64,
+        Some(TAG_BOOL) => ValueKind::Bool,
+        Some(TAG_INT | TAG_BIG_INT) => ValueKind::I64,
+        Some(TAG_STRING) => ValueKind::String,
+        Some(TAG_LIST) => ValueKind::List,
+        Some(TAG_MAP) => ValueKind::Map,
+        Some(_) => ValueKind::Unit,
     }
 }
 
 pub fn decode_value_handle(encoded: u64) -> u64 {
-    encoded & HANDLE_MASK
+    encoded & BOX_PAYLOAD_MASK
 }
 
 pub struct List {
-    pub items: Vec<Value>,
+    pub items: ListItems,
+}
+
+/// Items of a runtime list. A list whose items are all integers or all
+/// floats keeps them unboxed, so numeric kernels can borrow them as a slice
+/// instead of copying them out. Adding an item of another kind converts the
+/// list to boxed values.
+pub enum ListItems {
+    Values(Vec<Value>),
+    Ints(Vec<i64>),
+    Floats(Vec<f64>),
+}
+
+impl ListItems {
+    /// Picks unboxed storage when every item is an integer, or every item a
+    /// float.
+    pub(crate) fn from_values(values: Vec<Value>) -> Self {
+        if values.is_empty() {
+            return Self::Values(values);
+        }
+        if values.iter().all(|value| matches!(value, Value::I64(_))) {
+            return Self::Ints(values.iter().map(int_of).collect());
+        }
+        if values.iter().all(|value| matches!(value, Value::F64(_))) {
+            return Self::Floats(values.iter().map(float_of).collect());
+        }
+        Self::Values(values)
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        match self {
+            Self::Values(values) => values.len(),
+            Self::Ints(values) => values.len(),
+            Self::Floats(values) => values.len(),
+        }
+    }
+
+    pub(crate) fn capacity(&self) -> usize {
+        match self {
+            Self::Values(values) => values.capacity(),
+            Self::Ints(values) => values.capacity(),
+            Self::Floats(values) => values.capacity(),
+        }
+    }
+
+    /// Applies `read` to the item at `index` without cloning boxed items.
+    pub(crate) fn read<T>(&self, index: usize, read: impl FnOnce(&Value) -> T) -> Option<T> {
+        match self {
+            Self::Values(values) => values.get(index).map(read),
+            Self::Ints(values) => values.get(index).map(|value| read(&Value::I64(*value))),
+            Self::Floats(values) => values.get(index).map(|value| read(&Value::F64(*value))),
+        }
+    }
+
+    pub(crate) fn get(&self, index: usize) -> Option<Value> {
+        self.read(index, Value::clone)
+    }
+
+    pub(crate) fn push(&mut self, value: Value) {
+        match (&mut *self, value) {
+            (Self::Ints(values), Value::I64(value)) => values.push(value),
+            (Self::Floats(values), Value::F64(value)) => values.push(value),
+            (Self::Values(values), Value::I64(value)) if values.is_empty() => {
+                *self = Self::Ints(vec![value]);
+            }
+            (Self::Values(values), Value::F64(value)) if values.is_empty() => {
+                *self = Self::Floats(vec![value]);
+            }
+            (Self::Values(values), value) => values.push(value),
+            (_, value) => {
+                let mut values = self.values().into_owned();
+                values.push(value);
+                *self = Self::Values(values);
+            }
+        }
+    }
+
+    /// The items as boxed values, borrowed when the list already holds them.
+    pub(crate) fn values(&self) -> Cow<'_, [Value]> {
+        match self {
+            Self::Values(values) => Cow::Borrowed(values),
+            Self::Ints(values) => Cow::Owned(values.iter().copied().map(Value::I64).collect()),
+            Self::Floats(values) => Cow::Owned(values.iter().copied().map(Value::F64).collect()),
+        }
+    }
 }
 
 pub static LISTS: Lazy<RwLock<std::collections::HashMap<HandleId, List>>> =
@@ -137,6 +233,32 @@ struct Map {
 static MAPS: Lazy<RwLock<std::collections::HashMap<HandleId, Map>>> =
     Lazy::new(|| RwLock::new(std::collections::HashMap::new()));
 
+/// Calls `visit` with every integer stored in a list or map. Compiled code
+/// stores enum values in containers as integers, so the collector treats each
+/// one as a possible heap address.
+pub(crate) fn for_each_stored_int(mut visit: impl FnMut(i64)) {
+    let int_of_value = |value: &Value| match value {
+        Value::I64(value) => Some(*value),
+        _ => None,
+    };
+    // Recursive reads: a collection may start while this thread reads a list.
+    for list in LISTS.read_recursive().values() {
+        match &list.items {
+            ListItems::Values(values) => {
+                values.iter().filter_map(int_of_value).for_each(&mut visit)
+            }
+            ListItems::Ints(values) => values.iter().copied().for_each(&mut visit),
+            ListItems::Floats(_) => {}
+        }
+    }
+    for map in MAPS.read_recursive().values() {
+        map.items
+            .values()
+            .filter_map(int_of_value)
+            .for_each(&mut visit);
+    }
+}
+
 struct ArrayIterator {
     handle: HandleId,
     index: usize,
@@ -171,6 +293,35 @@ fn value_to_string(value: &Value) -> String {
     }
 }
 
+/// Applies `read` to the item at `index` without cloning it.
+fn read_list_value<T>(handle: HandleId, index: i64, read: impl FnOnce(&Value) -> T) -> Option<T> {
+    let index = usize::try_from(index).ok()?;
+    let lists = LISTS.read();
+    lists
+        .get(&handle)
+        .and_then(|list| list.items.read(index, read))
+}
+
+/// The value `list.get_int` returns for an item.
+fn int_of(value: &Value) -> i64 {
+    match value {
+        Value::I64(i) => *i,
+        Value::F64(f) => *f as i64,
+        Value::Bool(b) => i64::from(*b),
+        _ => 0,
+    }
+}
+
+/// The value `list.get_float` returns for an item.
+fn float_of(value: &Value) -> f64 {
+    match value {
+        Value::F64(f) => *f,
+        Value::I64(i) => *i as f64,
+        Value::Bool(b) => f64::from(u8::from(*b)),
+        _ => 0.0,
+    }
+}
+
 fn list_value(handle: HandleId, index: i64) -> Option<Value> {
     if index < 0 {
         return None;
@@ -178,7 +329,7 @@ fn list_value(handle: HandleId, index: i64) -> Option<Value> {
     let lists = LISTS.read();
     lists
         .get(&handle)
-        .and_then(|list| list.items.get(index as usize).cloned())
+        .and_then(|list| list.items.get(index as usize))
 }
 
 #[unsafe(no_mangle)]
@@ -190,7 +341,7 @@ pub extern "C" fn otter_runtime_list_length(handle: u64) -> i64 {
 pub extern "C" fn otter_runtime_list_get(handle: u64, index: i64) -> u64 {
     list_value(handle, index)
         .map(|value| encode_runtime_value(&value))
-        .unwrap_or(0)
+        .unwrap_or(ENCODED_UNIT)
 }
 
 fn map_value(handle: HandleId, key: &str) -> Option<Value> {
@@ -202,7 +353,12 @@ fn map_value(handle: HandleId, key: &str) -> Option<Value> {
 fn stringify_list_handle(handle: HandleId) -> String {
     let lists = LISTS.read();
     if let Some(list) = lists.get(&handle) {
-        let items = list.items.iter().map(value_to_string).collect::<Vec<_>>();
+        let items = list
+            .items
+            .values()
+            .iter()
+            .map(value_to_string)
+            .collect::<Vec<_>>();
         format!("[{}]", items.join(", "))
     } else {
         "[]".to_string()
@@ -468,36 +624,44 @@ pub unsafe extern "C" fn otter_builtin_delete_map(handle: u64, key: *const c_cha
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_builtin_range_int(start: i64, end: i64) -> u64 {
-    let id = next_handle_id();
-    let mut items = Vec::new();
-
-    if start <= end {
-        for i in start..end {
-            items.push(Value::I64(i));
-        }
-    }
-
-    let list = List { items };
-    LISTS.write().insert(id, list);
-    id
+    let items = if start <= end {
+        (start..end).collect()
+    } else {
+        Vec::new()
+    };
+    list_from_items(ListItems::Ints(items))
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_builtin_range_float(start: f64, end: f64) -> u64 {
-    let id = next_handle_id();
     let mut items = Vec::new();
 
     if start <= end {
         let mut current = start;
         while current < end {
-            items.push(Value::F64(current));
+            items.push(current);
             current += 1.0;
         }
     }
 
-    let list = List { items };
-    LISTS.write().insert(id, list);
-    id
+    list_from_items(ListItems::Floats(items))
+}
+
+/// `range_step(start, end, step)`: every `step`th integer from `start` up to
+/// `end` (down to it for a negative step), excluding `end`. A zero step gives
+/// an empty list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_builtin_range_step_int(start: i64, end: i64, step: i64) -> u64 {
+    let mut items = Vec::new();
+    let mut current = start;
+    while (step > 0 && current < end) || (step < 0 && current > end) {
+        items.push(Value::I64(current));
+        let Some(next) = current.checked_add(step) else {
+            break;
+        };
+        current = next;
+    }
+    list_from_values(items)
 }
 
 // ============================================================================
@@ -513,17 +677,22 @@ pub extern "C" fn otter_builtin_enumerate_list(handle: u64) -> u64 {
     if let Some(list) = lists.get(&handle) {
         let enumerated: Vec<Value> = list
             .items
+            .values()
             .iter()
             .enumerate()
             .map(|(idx, val)| Value::String(format!("{}:{}", idx, value_to_string(val))))
             .collect();
 
-        let new_list = List { items: enumerated };
+        let new_list = List {
+            items: ListItems::Values(enumerated),
+        };
         drop(lists); // Release read lock
         LISTS.write().insert(id, new_list);
     } else {
         // Return empty list if input handle invalid
-        let empty_list = List { items: Vec::new() };
+        let empty_list = List {
+            items: ListItems::Values(Vec::new()),
+        };
         drop(lists);
         LISTS.write().insert(id, empty_list);
     }
@@ -531,15 +700,35 @@ pub extern "C" fn otter_builtin_enumerate_list(handle: u64) -> u64 {
     id
 }
 
+/// The `index:value` string `enumerate` produces for one item, or null past
+/// the end of the list. Loops over `enumerate(xs)` call this instead of
+/// building the whole enumerated list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_builtin_enumerate_item(handle: u64, index: i64) -> *mut c_char {
+    read_list_value(handle, index, |value| {
+        format!("{index}:{}", value_to_string(value))
+    })
+    .and_then(|item| CString::new(item).ok())
+    .map_or(std::ptr::null_mut(), CString::into_raw)
+}
+
 // ============================================================================
 // Helper functions for list/map creation
 // ============================================================================
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_builtin_list_new() -> u64 {
+    list_from_values(Vec::new())
+}
+
+/// Registers a list holding `items` and returns its handle.
+pub(crate) fn list_from_values(items: Vec<Value>) -> u64 {
+    list_from_items(ListItems::from_values(items))
+}
+
+pub(crate) fn list_from_items(items: ListItems) -> u64 {
     let id = next_handle_id();
-    let list = List { items: Vec::new() };
-    LISTS.write().insert(id, list);
+    LISTS.write().insert(id, List { items });
     id
 }
 
@@ -588,34 +777,63 @@ pub unsafe extern "C" fn otter_builtin_map_get(handle: u64, key: *const c_char)
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_builtin_list_get_int(handle: u64, index: i64) -> i64 {
-    match list_value(handle, index) {
-        Some(Value::I64(i)) => i,
-        Some(Value::F64(f)) => f as i64,
-        Some(Value::Bool(b)) => {
-            if b {
-                1
-            } else {
-                0
-            }
-        }
-        _ => 0,
-    }
+    read_list_value(handle, index, int_of).unwrap_or(0)
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_builtin_list_get_float(handle: u64, index: i64) -> f64 {
-    match list_value(handle, index) {
-        Some(Value::F64(f)) => f,
-        Some(Value::I64(i)) => i as f64,
-        Some(Value::Bool(b)) => {
-            if b {
-                1.0
-            } else {
-                0.0
-            }
-        }
-        _ => 0.0,
+    read_list_value(handle, index, float_of).unwrap_or(0.0)
+}
+
+/// Copies items `start..end` of a list into a fresh buffer of raw 64-bit
+/// values. A loop that only reads those items indexes the buffer directly
+/// instead of calling `list.get_int`/`list.get_float` each time. Returns 0
+/// when the list does not exist or the range is empty or not inside it.
+fn list_view(handle: HandleId, start: i64, end: i64, convert: impl Fn(&Value) -> u64) -> u64 {
+    let (Ok(start), Ok(end)) = (usize::try_from(start), usize::try_from(end)) else {
+        return 0;
+    };
+    if start >= end {
+        return 0;
+    }
+    let lists = LISTS.read();
+    let Some(items) = lists
+        .get(&handle)
+        .map(|list| &list.items)
+        .filter(|items| end <= items.len())
+    else {
+        return 0;
+    };
+    let view: Box<[u64]> = (start..end)
+        .filter_map(|index| items.read(index, &convert))
+        .collect();
+    Box::into_raw(view).cast::<u64>() as u64
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_builtin_list_view_int(handle: u64, start: i64, end: i64) -> u64 {
+    list_view(handle, start, end, |value| int_of(value) as u64)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_builtin_list_view_float(handle: u64, start: i64, end: i64) -> u64 {
+    list_view(handle, start, end, |value| float_of(value).to_bits())
+}
+
+/// Frees a buffer from `list.view_int`/`list.view_float`. `len` is the length
+/// of the range it was made for. A 0 view is ignored.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_builtin_list_view_free(view: u64, len: i64) {
+    let Ok(len) = usize::try_from(len) else {
+        return;
+    };
+    if view == 0 || len == 0 {
+        return;
     }
+    let items = std::ptr::slice_from_raw_parts_mut(view as *mut u64, len);
+    // SAFETY: non-zero views come from `list_view`, which leaked a boxed
+    // slice of exactly `len` items.
+    drop(unsafe { Box::from_raw(items) });
 }
 
 #[unsafe(no_mangle)]
@@ -951,10 +1169,10 @@ pub extern "C" fn otter_builtin_iter_next_array(iter_handle: u64) -> u64 {
             iter.index += 1;
             encode_runtime_value(&val)
         } else {
-            0
+            ENCODED_UNIT
         }
     } else {
-        0
+        ENCODED_UNIT
     }
 }
 
@@ -1002,13 +1220,13 @@ pub extern "C" fn otter_builtin_iter_next_string(iter_handle: u64) -> u64 {
                 // Return encoded value instead of raw pointer
                 encode_runtime_value(&Value::String(s))
             } else {
-                0
+                ENCODED_UNIT
             }
         } else {
-            0
+            ENCODED_UNIT
         }
     } else {
-        0
+        ENCODED_UNIT
     }
 }
 
@@ -1365,7 +1583,7 @@ pub unsafe extern "C" fn otter_builtin_stringify_string(s: *const c_char) -> *mu
 pub extern "C" fn otter_builtin_stringify_list(handle: u64) -> *mut c_char {
     let lists = LISTS.read();
     if let Some(list) = lists.get(&handle) {
-        let items: Vec<String> = list.items.iter().map(value_to_string).collect();
+        let items: Vec<String> = list.items.values().iter().map(value_to_string).collect();
         let json = format!("[{}]", items.join(", "));
         CString::new(json)
             .ok()
@@ -1508,19 +1726,22 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "len".into(),
         symbol: "otter_builtin_len_string".into(),
-        signature: FfiSignature::new(vec![FfiType::Str], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::Str], FfiType::I64)
+            .with_effects(FfiEffects::READS_ARGS),
     });
 
     registry.register(FfiFunction {
         name: "len<list>".into(),
         symbol: "otter_builtin_len_list".into(),
-        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64)
+            .with_effects(FfiEffects::READS_RUNTIME),
     });
 
     registry.register(FfiFunction {
         name: "len<map>".into(),
         symbol: "otter_builtin_len_map".into(),
-        signature: FfiSignature::new(vec![FfiType::Map], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::Map], FfiType::I64)
+            .with_effects(FfiEffects::READS_RUNTIME),
     });
 
     // cap() functions
@@ -1600,6 +1821,15 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::List),
     });
 
+    registry.register(FfiFunction {
+        name: "range_step<int>".into(),
+        symbol: "otter_builtin_range_step_int".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::I64, FfiType::I64, FfiType::I64],
+            FfiType::List,
+        ),
+    });
+
     // enumerate() function
     registry.register(FfiFunction {
         name: "enumerate<list>".into(),
@@ -1607,6 +1837,13 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![FfiType::List], FfiType::List),
     });
 
+    registry.register(FfiFunction {
+        name: "enumerate<list>.item".into(),
+        symbol: "otter_builtin_enumerate_item".into(),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES),
+    });
+
     // Helper functions
     registry.register(FfiFunction {
         name: "list.new".into(),
@@ -1617,13 +1854,15 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "runtime.list.length".into(),
         symbol: "otter_runtime_list_length".into(),
-        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64)
+            .with_effects(FfiEffects::READS_RUNTIME),
     });
 
     registry.register(FfiFunction {
         name: "runtime.list.get".into(),
         symbol: "otter_runtime_list_get".into(),
-        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::I64)
+            .with_effects(FfiEffects::UPDATES_RUNTIME),
     });
 
     registry.register(FfiFunction {
@@ -1641,13 +1880,39 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "list.get_int".into(),
         symbol: "otter_builtin_list_get_int".into(),
-        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::I64),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::I64)
+            .with_effects(FfiEffects::READS_RUNTIME),
     });
 
     registry.register(FfiFunction {
         name: "list.get_float".into(),
         symbol: "otter_builtin_list_get_float".into(),
-        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64)
+            .with_effects(FfiEffects::READS_RUNTIME),
+    });
+
+    registry.register(FfiFunction {
+        name: "list.view_int".into(),
+        symbol: "otter_builtin_list_view_int".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::List, FfiType::I64, FfiType::I64],
+            FfiType::Opaque,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "list.view_float".into(),
+        symbol: "otter_builtin_list_view_float".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::List, FfiType::I64, FfiType::I64],
+            FfiType::Opaque,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "list.view_free".into(),
+        symbol: "otter_builtin_list_view_free".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::I64], FfiType::Unit),
     });
 
     registry.register(FfiFunction {
@@ -1880,13 +2145,15 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "stringify<int>".into(),
         symbol: "otter_builtin_stringify_int".into(),
-        signature: FfiSignature::new(vec![FfiType::I64], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::I64], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES),
     });
 
     registry.register(FfiFunction {
         name: "stringify<float>".into(),
         symbol: "otter_builtin_stringify_float".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES),
     });
 
     registry.register(FfiFunction {
@@ -1938,6 +2205,7 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature {
             params: vec![FfiType::I64], // size
             result: FfiType::Opaque,    // ptr
+            effects: FfiEffects::default(),
         },
     });
 
@@ -1947,6 +2215,7 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature {
             params: vec![FfiType::Opaque], // ptr
             result: FfiType::Unit,
+            effects: FfiEffects::default(),
         },
     });
 
@@ -1956,6 +2225,7 @@ fn register_builtin_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature {
             params: vec![FfiType::Opaque], // ptr
             result: FfiType::Unit,
+            effects: FfiEffects::default(),
         },
     });
 
@@ -2115,83 +2385,60 @@ pub extern "C" fn otter_decode_value_handle(encoded: u64) -> u64 {
     decode_value_handle(encoded)
 }
 
-// Type-specific decode functions for full precision
+// Type-specific decode functions. Codegen inlines the common cases (inline
+// integers, doubles, bools and handles) and only calls these for the rest.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_decode_value_as_bool(encoded: u64) -> bool {
-    let kind = decode_value_kind(encoded);
-    let handle = decode_value_handle(encoded);
-
-    match kind {
-        ValueKind::Bool => handle != 0,
-        _ => false,
-    }
+    encoded == boxed(TAG_BOOL, 1)
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_decode_value_as_i64(encoded: u64) -> i64 {
-    let kind = decode_value_kind(encoded);
-    let handle = decode_value_handle(encoded);
-
-    match kind {
-        ValueKind::I64 => {
-            // Look up in registry for full precision
-            let values = RUNTIME_VALUES.read();
-            if let Some(Value::I64(i)) = values.get(&handle).map(|rv| rv.value.clone()) {
-                return i;
-            }
-            0
+    match boxed_tag(encoded) {
+        None => f64::from_bits(encoded) as i64,
+        Some(TAG_INT) => inline_int(encoded),
+        Some(TAG_BIG_INT) => {
+            let ptr = decode_value_handle(encoded) as *const i64;
+            if ptr.is_null() { 0 } else { unsafe { *ptr } }
         }
-        _ => 0,
+        Some(_) => 0,
     }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_decode_value_as_f64(encoded: u64) -> f64 {
-    let kind = decode_value_kind(encoded);
-    let handle = decode_value_handle(encoded);
-
-    match kind {
-        ValueKind::F64 => {
-            // Look up in registry for full precision
-            let values = RUNTIME_VALUES.read();
-            if let Some(Value::F64(f)) = values.get(&handle).map(|rv| rv.value.clone()) {
-                return f;
-            }
-            0.0
-        }
-        _ => 0.0,
+    match boxed_tag(encoded) {
+        None => f64::from_bits(encoded),
+        Some(TAG_INT | TAG_BIG_INT) => otter_decode_value_as_i64(encoded) as f64,
+        Some(_) => 0.0,
     }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_decode_value_as_string(encoded: u64) -> *mut c_char {
-    let kind = decode_value_kind(encoded);
-    let handle = decode_value_handle(encoded);
+    if boxed_tag(encoded) != Some(TAG_STRING) {
+        return std::ptr::null_mut();
+    }
 
-    match kind {
-        ValueKind::String => {
-            // Handle is actually a pointer
-            if handle == 0 {
-                CString::new("")
+    let handle = decode_value_handle(encoded);
+    if handle == 0 {
+        CString::new("")
+            .ok()
+            .map(CString::into_raw)
+            .unwrap_or(std::ptr::null_mut())
+    } else {
+        unsafe {
+            let ptr = handle as *const c_char;
+            // Copy the string since we need to return a new owned pointer
+            if let Ok(cstr) = CStr::from_ptr(ptr).to_str() {
+                CString::new(cstr)
                     .ok()
                     .map(CString::into_raw)
                     .unwrap_or(std::ptr::null_mut())
             } else {
-                unsafe {
-                    let ptr = handle as *const c_char;
-                    // Copy the string since we need to return a new owned pointer
-                    if let Ok(cstr) = CStr::from_ptr(ptr).to_str() {
-                        CString::new(cstr)
-                            .ok()
-                            .map(CString::into_raw)
-                            .unwrap_or(std::ptr::null_mut())
-                    } else {
-                        std::ptr::null_mut()
-                    }
-                }
+                std::ptr::null_mut()
             }
         }
-        _ => std::ptr::null_mut(),
     }
 }
 
@@ -2200,15 +2447,15 @@ pub extern "C" fn otter_decode_value_as_handle(encoded: u64) -> u64 {
     decode_value_handle(encoded)
 }
 
-// Cleanup function to free runtime value handles
+// Releases the heap box behind an integer too wide to store inline. Every
+// other encoding is immediate or refers to storage owned elsewhere.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_free_runtime_value(encoded: u64) {
-    let kind = decode_value_kind(encoded);
-    let handle = decode_value_handle(encoded);
-
-    // Only free registry entries for I64 and F64 which use handles
-    if matches!(kind, ValueKind::I64 | ValueKind::F64) {
-        RUNTIME_VALUES.write().remove(&handle);
+    if boxed_tag(encoded) == Some(TAG_BIG_INT) {
+        let ptr = decode_value_handle(encoded) as *mut i64;
+        if !ptr.is_null() {
+            drop(unsafe { Box::from_raw(ptr) });
+        }
     }
 }
 
@@ -2234,3 +2481,141 @@ inventory::submit! {
         register: register_builtin_symbols,
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn integers_round_trip_inline_and_boxed() {
+        for value in [
+            0,
+            1,
+            -1,
+            (1 << 47) - 1,
+            -(1 << 47),
+            1 << 47,
+            i64::MIN,
+            i64::MAX,
+        ] {
+            let encoded = encode_runtime_value(&Value::I64(value));
+            assert_eq!(decode_value_kind(encoded), ValueKind::I64);
+            assert_eq!(otter_decode_value_as_i64(encoded), value);
+            assert_eq!(otter_decode_value_as_f64(encoded), value as f64);
+            otter_free_runtime_value(encoded);
+        }
+        let small = encode_runtime_value(&Value::I64(-5));
+        assert_eq!(boxed_tag(small), Some(TAG_INT));
+    }
+
+    #[test]
+    fn doubles_are_stored_unboxed() {
+        for value in [
+            0.0,
+            -0.0,
+            1.5,
+            f64::INFINITY,
+            f64::NEG_INFINITY,
+            f64::MIN_POSITIVE,
+        ] {
+            let encoded = encode_runtime_value(&Value::F64(value));
+            assert_eq!(encoded, value.to_bits());
+            assert_eq!(decode_value_kind(encoded), ValueKind::F64);
+            assert_eq!(
+                otter_decode_value_as_f64(encoded).to_bits(),
+                value.to_bits()
+            );
+        }
+        let nan = encode_runtime_value(&Value::F64(f64::from_bits(0xfff8_0000_0000_0001)));
+        assert_eq!(decode_value_kind(nan), ValueKind::F64);
+        assert!(otter_decode_value_as_f64(nan).is_nan());
+    }
+
+    #[test]
+    fn tagged_values_keep_their_kind() {
+        assert_eq!(decode_value_kind(ENCODED_UNIT), ValueKind::Unit);
+        let yes = encode_runtime_value(&Value::Bool(true));
+        assert!(otter_decode_value_as_bool(yes));
+        assert!(!otter_decode_value_as_bool(encode_runtime_value(
+            &Value::Bool(false)
+        )));
+        let list = encode_runtime_value(&Value::List(42));
+        assert_eq!(decode_value_kind(list), ValueKind::List);
+        assert_eq!(otter_decode_value_as_handle(list), 42);
+    }
+
+    #[test]
+    fn list_views_copy_in_range_items() {
+        let list = list_from_values(vec![Value::I64(1), Value::F64(2.5), Value::Bool(true)]);
+
+        let view = otter_builtin_list_view_float(list, 1, 3);
+        assert_ne!(view, 0);
+        // SAFETY: the view holds the two items of `1..3`.
+        let items = unsafe { std::slice::from_raw_parts(view as *const u64, 2) };
+        assert_eq!(f64::from_bits(items[0]), 2.5);
+        assert_eq!(f64::from_bits(items[1]), 1.0);
+        otter_builtin_list_view_free(view, 2);
+
+        let view = otter_builtin_list_view_int(list, 0, 2);
+        // SAFETY: the view holds the two items of `0..2`.
+        let items = unsafe { std::slice::from_raw_parts(view as *const i64, 2) };
+        assert_eq!(items, [1, 2]);
+        otter_builtin_list_view_free(view, 2);
+
+        assert_eq!(otter_builtin_list_view_int(list, -1, 2), 0);
+        assert_eq!(otter_builtin_list_view_int(list, 1, 4), 0);
+        assert_eq!(otter_builtin_list_view_int(list, 2, 2), 0);
+        otter_builtin_list_view_free(0, 2);
+    }
+
+    #[test]
+    fn stepped_ranges_stop_before_end() {
+        let items = |handle| {
+            (0..otter_builtin_len_list(handle))
+                .map(|index| otter_builtin_list_get_int(handle, index))
+                .collect::<Vec<_>>()
+        };
+        assert_eq!(items(otter_builtin_range_step_int(0, 7, 3)), [0, 3, 6]);
+        assert_eq!(items(otter_builtin_range_step_int(5, 0, -2)), [5, 3, 1]);
+        assert!(items(otter_builtin_range_step_int(0, 5, 0)).is_empty());
+        assert_eq!(
+            items(otter_builtin_range_step_int(i64::MAX - 1, i64::MAX, 4)),
+            [i64::MAX - 1]
+        );
+    }
+
+    #[test]
+    fn stored_ints_are_visited() {
+        let ints = list_from_values(vec![Value::I64(11), Value::I64(12)]);
+        let mixed = list_from_values(vec![Value::Bool(true), Value::I64(13)]);
+        let floats = list_from_values(vec![Value::F64(14.0)]);
+        let mut seen = Vec::new();
+        for_each_stored_int(|value| seen.push(value));
+        assert!([11, 12, 13].iter().all(|value| seen.contains(value)));
+        assert_ne!(ints + mixed + floats, 0);
+    }
+
+    #[test]
+    fn numeric_lists_stay_unboxed_until_mixed() {
+        let list = otter_builtin_list_new();
+        otter_builtin_append_list_float(list, 1.5);
+        otter_builtin_append_list_float(list, 2.5);
+        assert!(matches!(
+            LISTS.read().get(&list).map(|list| &list.items),
+            Some(ListItems::Floats(_))
+        ));
+
+        otter_builtin_append_list_int(list, 3);
+        assert!(matches!(
+            LISTS.read().get(&list).map(|list| &list.items),
+            Some(ListItems::Values(_))
+        ));
+        assert!(matches!(list_value(list, 2), Some(Value::I64(3))));
+        assert_eq!(otter_builtin_list_get_float(list, 1), 2.5);
+
+        assert!(matches!(
+            ListItems::from_values(vec![Value::I64(1)]),
+            ListItems::Ints(_)
+        ));
+    }
+}
@@ -1,199 +1,143 @@
-use std::ffi::c_void;
-use std::sync::atomic::{AtomicU64, Ordering};
+//! Enum value helpers
+//!
+//! Codegen lowers enum values to tagged unions laid out as
+//! `{ i64 tag, [N x i64] payload }` in a single GC allocation, with `N` taken
+//! from the enum layout, and reads tags and fields with plain loads. These
+//! helpers expose the same layout to host code; the value is the allocation's
+//! address.
+//!
+//! Heap enum values are ordinary traced GC objects. They are not rooted: the
+//! collector keeps one alive while its address is on the stack, in a list or
+//! map, or in the payload of another live enum, and it scans the payload so
+//! strings and other tracked objects stored in a field stay alive with it.
 
-use once_cell::sync::Lazy;
-use parking_lot::RwLock;
+use std::ffi::c_void;
 
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
-static NEXT_ENUM_HANDLE: AtomicU64 = AtomicU64::new(1);
-
-#[derive(Debug, Clone)]
-enum EnumFieldValue {
-    Int(i64),
-    Float(f64),
-    Bool(bool),
-    Ptr(u64),
-}
-
-#[derive(Debug, Clone)]
-struct EnumObject {
-    tag: i64,
-    fields: Vec<EnumFieldValue>,
-}
-
-static ENUM_OBJECTS: Lazy<RwLock<std::collections::HashMap<u64, EnumObject>>> =
-    Lazy::new(|| RwLock::new(std::collections::HashMap::new()));
-
-fn next_enum_handle() -> u64 {
-    NEXT_ENUM_HANDLE.fetch_add(1, Ordering::SeqCst)
-}
-
-fn with_enum_object<R>(handle: u64, f: impl FnOnce(&EnumObject) -> R) -> Option<R> {
-    ENUM_OBJECTS.read().get(&handle).map(f)
-}
-
-fn with_enum_object_mut<R>(handle: u64, f: impl FnOnce(&mut EnumObject) -> R) -> Option<R> {
-    ENUM_OBJECTS.write().get_mut(&handle).map(f)
-}
-
-fn set_field(handle: u64, index: usize, value: EnumFieldValue) -> bool {
-    with_enum_object_mut(handle, |object| {
-        if index >= object.fields.len() {
-            return false;
-        }
-        object.fields[index] = value;
-        true
-    })
-    .unwrap_or(false)
-}
+use crate::memory::gc::{ObjectKind, get_gc};
 
-fn ptr_to_u64(ptr: *mut c_void) -> u64 {
-    ptr as usize as u64
-}
+const SLOT_SIZE: i64 = 8;
 
-fn u64_to_ptr(value: u64) -> *mut c_void {
-    value as usize as *mut c_void
+fn slot(handle: u64, index: i64) -> Option<*mut u64> {
+    if handle == 0 || index < 0 {
+        return None;
+    }
+    Some((handle as usize as *mut u64).wrapping_add(1 + index as usize))
 }
 
-/// # Safety
-/// The caller must ensure `field_count` is non-negative and the returned handle is managed via
-/// the enum runtime helpers.
+/// Allocate a zeroed enum value with room for the tag and `field_count`
+/// payload slots. Returns 0 on failure.
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_enum_create(tag: i64, field_count: i64) -> u64 {
+pub extern "C" fn otter_enum_alloc(field_count: i64) -> u64 {
     if field_count < 0 {
         return 0;
     }
-
-    let handle = next_enum_handle();
-    let fields = vec![EnumFieldValue::Int(0); field_count as usize];
-    ENUM_OBJECTS
-        .write()
-        .insert(handle, EnumObject { tag, fields });
-    handle
+    let size = SLOT_SIZE as usize * (1 + field_count as usize);
+    get_gc()
+        .alloc_traced(size, ObjectKind::Enum)
+        .map_or(0, |ptr| ptr as usize as u64)
 }
 
 /// # Safety
-/// `handle` must be a valid enum handle obtained from `otter_enum_create`.
+/// The caller must ensure `field_count` is non-negative and covers every field the value will
+/// hold.
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_enum_get_tag(handle: u64) -> i64 {
-    with_enum_object(handle, |object| object.tag).unwrap_or(-1)
+pub unsafe extern "C" fn otter_enum_create(tag: i64, field_count: i64) -> u64 {
+    let handle = otter_enum_alloc(field_count);
+    if handle != 0 {
+        unsafe { (handle as usize as *mut u64).write(tag as u64) };
+    }
+    handle
 }
 
 /// # Safety
-/// `handle` must be a valid enum handle obtained from `otter_enum_create`.
+/// `handle` must be a valid enum value created by codegen or `otter_enum_create`.
 #[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_enum_get_field_count(handle: u64) -> i64 {
-    with_enum_object(handle, |object| object.fields.len() as i64).unwrap_or(0)
+pub unsafe extern "C" fn otter_enum_get_tag(handle: u64) -> i64 {
+    if handle == 0 {
+        return -1;
+    }
+    unsafe { *(handle as usize as *const i64) }
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_set_i64(handle: u64, index: i64, value: i64) -> bool {
-    if index < 0 {
-        return false;
-    }
-    set_field(handle, index as usize, EnumFieldValue::Int(value))
+    slot(handle, index).is_some_and(|ptr| {
+        unsafe { ptr.write(value as u64) };
+        true
+    })
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_set_f64(handle: u64, index: i64, value: f64) -> bool {
-    if index < 0 {
-        return false;
-    }
-    set_field(handle, index as usize, EnumFieldValue::Float(value))
+    slot(handle, index).is_some_and(|ptr| {
+        unsafe { ptr.write(value.to_bits()) };
+        true
+    })
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_set_bool(handle: u64, index: i64, value: bool) -> bool {
-    if index < 0 {
-        return false;
-    }
-    set_field(handle, index as usize, EnumFieldValue::Bool(value))
+    slot(handle, index).is_some_and(|ptr| {
+        unsafe { ptr.write(u64::from(value)) };
+        true
+    })
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_set_ptr(handle: u64, index: i64, value: *mut c_void) -> bool {
-    if index < 0 {
-        return false;
-    }
-    set_field(
-        handle,
-        index as usize,
-        EnumFieldValue::Ptr(ptr_to_u64(value)),
-    )
+    slot(handle, index).is_some_and(|ptr| {
+        unsafe { ptr.write(value as usize as u64) };
+        true
+    })
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_get_i64(handle: u64, index: i64) -> i64 {
-    if index < 0 {
-        return 0;
-    }
-    with_enum_object(handle, |object| match object.fields.get(index as usize) {
-        Some(EnumFieldValue::Int(value)) => *value,
-        Some(EnumFieldValue::Bool(value)) => *value as i64,
-        Some(EnumFieldValue::Ptr(value)) => *value as i64,
-        _ => 0,
-    })
-    .unwrap_or(0)
+    slot(handle, index).map_or(0, |ptr| unsafe { ptr.read() as i64 })
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_get_f64(handle: u64, index: i64) -> f64 {
-    if index < 0 {
-        return 0.0;
-    }
-    with_enum_object(handle, |object| match object.fields.get(index as usize) {
-        Some(EnumFieldValue::Float(value)) => *value,
-        Some(EnumFieldValue::Int(value)) => *value as f64,
-        _ => 0.0,
-    })
-    .unwrap_or(0.0)
+    slot(handle, index).map_or(0.0, |ptr| f64::from_bits(unsafe { ptr.read() }))
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_get_bool(handle: u64, index: i64) -> bool {
-    if index < 0 {
-        return false;
-    }
-    with_enum_object(handle, |object| match object.fields.get(index as usize) {
-        Some(EnumFieldValue::Bool(value)) => *value,
-        Some(EnumFieldValue::Int(value)) => *value != 0,
-        _ => false,
-    })
-    .unwrap_or(false)
+    slot(handle, index).is_some_and(|ptr| unsafe { ptr.read() } != 0)
 }
 
 /// # Safety
 /// `handle` must refer to a valid enum and `index` must target an existing field for that variant.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_enum_get_ptr(handle: u64, index: i64) -> *mut c_void {
-    if index < 0 {
-        return std::ptr::null_mut();
-    }
-    with_enum_object(handle, |object| match object.fields.get(index as usize) {
-        Some(EnumFieldValue::Ptr(value)) => u64_to_ptr(*value),
-        Some(EnumFieldValue::Int(value)) => u64_to_ptr(*value as u64),
-        _ => std::ptr::null_mut(),
+    slot(handle, index).map_or(std::ptr::null_mut(), |ptr| unsafe {
+        ptr.read() as usize as *mut c_void
     })
-    .unwrap_or(std::ptr::null_mut())
 }
 
 fn register_enum_functions(registry: &SymbolRegistry) {
     registry.register_many([
+        FfiFunction {
+            name: "runtime.enum.alloc".into(),
+            symbol: "otter_enum_alloc".into(),
+            signature: FfiSignature::new(vec![FfiType::I64], FfiType::I64),
+        },
         FfiFunction {
             name: "runtime.enum.create".into(),
             symbol: "otter_enum_create".into(),
@@ -209,11 +153,6 @@ fn register_enum_functions(registry: &SymbolRegistry) {
             symbol: "otter_enum_get_tag".into(),
             signature: FfiSignature::new(vec![FfiType::I64], FfiType::I64),
         },
-        FfiFunction {
-            name: "runtime.enum.field_count".into(),
-            symbol: "otter_enum_get_field_count".into(),
-            signature: FfiSignature::new(vec![FfiType::I64], FfiType::I64),
-        },
         FfiFunction {
             name: "runtime.enum.set_i64".into(),
             symbol: "otter_enum_set_i64".into(),
@@ -276,3 +215,36 @@ inventory::submit! {
         register: register_enum_functions,
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn enum_values_round_trip_tag_and_fields() {
+        unsafe {
+            let value = otter_enum_create(2, 3);
+            assert_ne!(value, 0);
+            assert_eq!(otter_enum_get_tag(value), 2);
+            assert_eq!(otter_enum_get_i64(value, 2), 0);
+
+            assert!(otter_enum_set_i64(value, 0, -7));
+            assert!(otter_enum_set_f64(value, 1, 2.5));
+            assert!(otter_enum_set_bool(value, 2, true));
+            assert_eq!(otter_enum_get_i64(value, 0), -7);
+            assert_eq!(otter_enum_get_f64(value, 1), 2.5);
+            assert!(otter_enum_get_bool(value, 2));
+            assert_eq!(otter_enum_get_tag(value), 2);
+        }
+    }
+
+    #[test]
+    fn invalid_enum_requests_are_rejected() {
+        assert_eq!(otter_enum_alloc(-1), 0);
+        unsafe {
+            assert_eq!(otter_enum_get_tag(0), -1);
+            assert!(!otter_enum_set_i64(0, 0, 1));
+            assert!(!otter_enum_set_i64(otter_enum_create(0, 1), -1, 1));
+        }
+    }
+}
@@ -340,7 +340,7 @@ pub unsafe extern "C" fn otter_iter_array(
     let lists = LISTS.read();
     let values = lists
         .get(&handle_id)
-        .map(|list| list.items.clone())
+        .map(|list| list.items.values().into_owned())
         .unwrap_or_default();
 
     let iter = Box::new(OtterArrayIterator { values, index: 0 });
@@ -367,7 +367,7 @@ pub unsafe extern "C" fn otter_iter_has_next_array(iter: *mut OtterArrayIterator
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_iter_next_array(iter: *mut OtterArrayIterator) -> u64 {
     if iter.is_null() {
-        return 0;
+        return builtins::ENCODED_UNIT;
     }
     let iter_ref = unsafe { &mut *iter };
     if iter_ref.index < iter_ref.values.len() {
@@ -375,7 +375,7 @@ pub unsafe extern "C" fn otter_iter_next_array(iter: *mut OtterArrayIterator) ->
         iter_ref.index += 1;
         builtins::encode_runtime_value(&value)
     } else {
-        0
+        builtins::ENCODED_UNIT
     }
 }
 
@@ -435,7 +435,7 @@ pub unsafe extern "C" fn otter_iter_has_next_string(iter: *mut OtterStringIterat
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn otter_iter_next_string(iter: *mut OtterStringIterator) -> u64 {
     if iter.is_null() {
-        return 0;
+        return builtins::ENCODED_UNIT;
     }
     let iter_ref = unsafe { &mut *iter };
     if iter_ref.index < iter_ref.chars.len() {
@@ -443,7 +443,7 @@ pub unsafe extern "C" fn otter_iter_next_string(iter: *mut OtterStringIterator)
         iter_ref.index += 1;
         builtins::encode_runtime_value(&Value::String(char_value))
     } else {
-        0
+        builtins::ENCODED_UNIT
     }
 }
 
@@ -1,4 +1,5 @@
-use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
+use crate::stdlib::rand::{Xoshiro256PlusPlus, with_task_rng};
+use otterc_symbol::registry::{FfiEffects, FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_math_abs(value: f64) -> f64 {
@@ -71,14 +72,22 @@ pub extern "C" fn otter_std_math_clamp(value: f64, min: f64, max: f64) -> f64 {
     }
 }
 
+/// IEEE `minNum`: a NaN operand is ignored, matching `llvm.minnum`.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_math_min(a: f64, b: f64) -> f64 {
-    if a < b { a } else { b }
+    a.min(b)
 }
 
+/// IEEE `maxNum`: a NaN operand is ignored, matching `llvm.maxnum`.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_math_max(a: f64, b: f64) -> f64 {
-    if a > b { a } else { b }
+    a.max(b)
+}
+
+/// `a * b + c` with a single rounding.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_fma(a: f64, b: f64, c: f64) -> f64 {
+    libm::fma(a, b, c)
 }
 
 #[unsafe(no_mangle)]
@@ -93,13 +102,7 @@ pub extern "C" fn otter_std_math_lerp(a: f64, b: f64, t: f64) -> f64 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_math_randf() -> f64 {
-    // Use simple pseudo-random (for deterministic, use rand module)
-    use std::time::SystemTime;
-    let nanos = SystemTime::now()
-        .duration_since(std::time::UNIX_EPOCH)
-        .unwrap()
-        .subsec_nanos() as f64;
-    (nanos % 1000000.0) / 1000000.0
+    with_task_rng(Xoshiro256PlusPlus::next_f64)
 }
 
 #[unsafe(no_mangle)]
@@ -107,199 +110,148 @@ pub extern "C" fn otter_std_math_randi(max: i64) -> i64 {
     if max <= 0 {
         return 0;
     }
-    use std::time::SystemTime;
-    let nanos = SystemTime::now()
-        .duration_since(std::time::UNIX_EPOCH)
-        .unwrap()
-        .subsec_nanos() as i64;
-    nanos % max
-}
-
-/// returns the mean of the contents in a slice
-///
-/// # Safety
-///
-/// this function dereferences a raw pointer
-#[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_std_math_mean(arr: *const f64, len: i64) -> f64 {
-    if arr.is_null() || len <= 0 {
-        return 0.0;
-    }
-
-    unsafe {
-        let slice = std::slice::from_raw_parts(arr, len as usize);
-        let sum: f64 = slice.iter().sum();
-        sum / (len as f64)
-    }
-}
-
-/// gets the population standard deviation of the elements in a slice
-///
-/// # Safety
-///
-/// this function dereferences a raw pointer
-#[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_std_math_std(arr: *const f64, len: i64) -> f64 {
-    if arr.is_null() || len <= 0 {
-        return 0.0;
-    }
-
-    unsafe {
-        let slice = std::slice::from_raw_parts(arr, len as usize);
-        let mean: f64 = slice.iter().sum::<f64>() / (len as f64);
-        let variance: f64 = slice.iter().map(|x| (x - mean).powi(2)).sum::<f64>() / (len as f64);
-        libm::sqrt(variance)
-    }
-}
-
-/// sums all of the elements in a slice
-///
-/// # Safety
-///
-/// this function dereferences a raw pointer
-#[unsafe(no_mangle)]
-pub unsafe extern "C" fn otter_std_math_sum(arr: *const f64, len: i64) -> f64 {
-    if arr.is_null() || len <= 0 {
-        return 0.0;
-    }
-
-    unsafe {
-        let slice = std::slice::from_raw_parts(arr, len as usize);
-        slice.iter().sum()
-    }
+    with_task_rng(|rng| rng.next_in_range(0, max))
 }
 
 fn register_std_math_symbols(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "math.abs".into(),
         symbol: "otter_std_math_abs".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.sqrt".into(),
         symbol: "otter_std_math_sqrt".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.pow".into(),
         symbol: "otter_std_math_pow".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.exp".into(),
         symbol: "otter_std_math_exp".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.log".into(),
         symbol: "otter_std_math_log".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.sin".into(),
         symbol: "otter_std_math_sin".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.cos".into(),
         symbol: "otter_std_math_cos".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.tan".into(),
         symbol: "otter_std_math_tan".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.atan2".into(),
         symbol: "otter_std_math_atan2".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.floor".into(),
         symbol: "otter_std_math_floor".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.ceil".into(),
         symbol: "otter_std_math_ceil".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.round".into(),
         symbol: "otter_std_math_round".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.clamp".into(),
         symbol: "otter_std_math_clamp".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.min".into(),
         symbol: "otter_std_math_min".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.max".into(),
         symbol: "otter_std_math_max".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.fma".into(),
+        symbol: "otter_std_math_fma".into(),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.hypot".into(),
         symbol: "otter_std_math_hypot".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.lerp".into(),
         symbol: "otter_std_math_lerp".into(),
-        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64, FfiType::F64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::F64, FfiType::F64, FfiType::F64], FfiType::F64)
+            .with_effects(FfiEffects::PURE),
     });
 
     registry.register(FfiFunction {
         name: "math.randf".into(),
         symbol: "otter_std_math_randf".into(),
-        signature: FfiSignature::new(vec![], FfiType::F64),
+        signature: FfiSignature::new(vec![], FfiType::F64)
+            .with_effects(FfiEffects::UPDATES_RUNTIME),
     });
 
     registry.register(FfiFunction {
         name: "math.randi".into(),
         symbol: "otter_std_math_randi".into(),
-        signature: FfiSignature::new(vec![FfiType::I64], FfiType::I64),
-    });
-
-    registry.register(FfiFunction {
-        name: "math.mean".into(),
-        symbol: "otter_std_math_mean".into(),
-        signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::I64], FfiType::F64),
-    });
-
-    registry.register(FfiFunction {
-        name: "math.std".into(),
-        symbol: "otter_std_math_std".into(),
-        signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::I64], FfiType::F64),
-    });
-
-    registry.register(FfiFunction {
-        name: "math.sum".into(),
-        symbol: "otter_std_math_sum".into(),
-        signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::I64], FfiType::F64),
+        signature: FfiSignature::new(vec![FfiType::I64], FfiType::I64)
+            .with_effects(FfiEffects::UPDATES_RUNTIME),
     });
 }
 
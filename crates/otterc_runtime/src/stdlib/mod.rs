@@ -15,4 +15,5 @@ pub mod sys;
 pub mod task;
 pub mod test;
 pub mod time;
+pub mod vecmath;
 pub mod yaml;
@@ -1,63 +1,186 @@
 use std::ffi::CString;
 use std::os::raw::c_char;
+use std::sync::atomic::{AtomicU64, Ordering};
 
 use once_cell::sync::Lazy;
-use parking_lot::Mutex;
 
+use crate::stdlib::builtins::{ListItems, list_from_items};
+use crate::task::{TaskLocalKey, current_task_id};
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 // ============================================================================
 // Random Number Generator
-// Using a simple LCG-based PRNG for deterministic seeding
+// Per-task xoshiro256++ streams derived from one process-wide seed
 // ============================================================================
 
-struct RngState {
-    seed: u64,
+/// xoshiro256++ (Blackman & Vigna): 256 bits of state, period 2^256 - 1.
+#[derive(Clone, Copy)]
+pub(crate) struct Xoshiro256PlusPlus {
+    s: [u64; 4],
 }
 
-static RNG_STATE: Lazy<Mutex<RngState>> = Lazy::new(|| {
-    Mutex::new(RngState {
-        seed: std::time::SystemTime::now()
+impl Xoshiro256PlusPlus {
+    /// Expands a 64-bit seed with SplitMix64, as recommended by the authors.
+    fn from_seed(seed: u64) -> Self {
+        let mut state = seed;
+        Self {
+            s: [
+                splitmix64(&mut state),
+                splitmix64(&mut state),
+                splitmix64(&mut state),
+                splitmix64(&mut state),
+            ],
+        }
+    }
+
+    pub(crate) fn next_u64(&mut self) -> u64 {
+        let [s0, s1, s2, s3] = self.s;
+        let result = s0.wrapping_add(s3).rotate_left(23).wrapping_add(s0);
+        let t = s1 << 17;
+        let s2 = s2 ^ s0;
+        let s3 = s3 ^ s1;
+        self.s = [s0 ^ s3, s1 ^ s2, s2 ^ t, s3.rotate_left(45)];
+        result
+    }
+
+    /// Uniform float in `[0, 1)` from the top 53 bits.
+    pub(crate) fn next_f64(&mut self) -> f64 {
+        unit_f64(self.next_u64())
+    }
+
+    /// Uniform integer in `[min, max)`; returns `min` for an empty range.
+    pub(crate) fn next_in_range(&mut self, min: i64, max: i64) -> i64 {
+        if min >= max {
+            return min;
+        }
+        let span = max.wrapping_sub(min) as u64;
+        let offset = ((u128::from(self.next_u64()) * u128::from(span)) >> 64) as u64;
+        min.wrapping_add(offset as i64)
+    }
+}
+
+fn splitmix64(state: &mut u64) -> u64 {
+    *state = state.wrapping_add(0x9e37_79b9_7f4a_7c15);
+    let mut z = *state;
+    z = (z ^ (z >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+    z = (z ^ (z >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+    z ^ (z >> 31)
+}
+
+fn unit_f64(bits: u64) -> f64 {
+    (bits >> 11) as f64 * (1.0 / (1u64 << 53) as f64)
+}
+
+/// Seed every stream is derived from; `rand.seed` replaces it.
+static BASE_SEED: Lazy<AtomicU64> = Lazy::new(|| {
+    AtomicU64::new(
+        std::time::SystemTime::now()
             .duration_since(std::time::UNIX_EPOCH)
-            .unwrap()
-            .as_nanos() as u64,
-    })
+            .map_or(0, |elapsed| elapsed.as_nanos() as u64),
+    )
 });
+/// Bumped by `rand.seed`. A stream derived under an older generation is
+/// re-derived from the new seed on its next draw.
+static SEED_GENERATION: AtomicU64 = AtomicU64::new(0);
 
-// Linear Congruential Generator
-fn lcg_next(seed: &mut u64) -> u64 {
-    // LCG parameters (from Numerical Recipes)
-    *seed = seed.wrapping_mul(1664525u64).wrapping_add(1013904223u64);
-    *seed
+/// Stream ids of threads outside any task have the top bit set, so they never
+/// collide with task ids.
+const THREAD_STREAM_BIT: u64 = 1 << 63;
+static NEXT_THREAD_STREAM: AtomicU64 = AtomicU64::new(0);
+
+thread_local! {
+    static THREAD_STREAM: u64 = THREAD_STREAM_BIT | NEXT_THREAD_STREAM.fetch_add(1, Ordering::Relaxed);
 }
 
-#[unsafe(no_mangle)]
-pub extern "C" fn otter_std_rand_seed(n: i64) {
-    let mut state = RNG_STATE.lock();
-    state.seed = n as u64;
+/// A generator together with the seed generation it was derived under.
+struct Stream {
+    generation: u64,
+    rng: Xoshiro256PlusPlus,
 }
 
-#[unsafe(no_mangle)]
-pub extern "C" fn otter_std_rand_int(min: i64, max: i64) -> i64 {
-    let mut state = RNG_STATE.lock();
-    let next = lcg_next(&mut state.seed);
+/// Each task's stream lives in its task-local storage, so it follows the task
+/// across workers and survives other tasks running on the same thread.
+/// Outside tasks the storage belongs to the thread.
+static STREAM: TaskLocalKey<Stream> = TaskLocalKey::new();
+
+/// Stable id of the caller's stream: the running task's id, or a per-thread
+/// id outside tasks. Task ids follow spawn order, so a program that spawns
+/// deterministically sees the same sequence in every task on every run.
+fn stream_id() -> u64 {
+    current_task_id().map_or_else(|| THREAD_STREAM.with(|id| *id), |task| task.raw())
+}
+
+fn stream_rng(base: u64, stream: u64) -> Xoshiro256PlusPlus {
+    Xoshiro256PlusPlus::from_seed(base ^ stream.wrapping_mul(0x9e37_79b9_7f4a_7c15))
+}
 
-    if min >= max {
-        return min;
+fn derive_stream(generation: u64) -> Stream {
+    Stream {
+        generation,
+        rng: stream_rng(BASE_SEED.load(Ordering::Acquire), stream_id()),
     }
+}
+
+/// Runs `f` with the calling task's generator; no shared state is written.
+pub(crate) fn with_task_rng<R>(f: impl FnOnce(&mut Xoshiro256PlusPlus) -> R) -> R {
+    let generation = SEED_GENERATION.load(Ordering::Acquire);
+    STREAM.with_mut_or_init(
+        || derive_stream(generation),
+        |stream| {
+            if stream.generation != generation {
+                *stream = derive_stream(generation);
+            }
+            f(&mut stream.rng)
+        },
+    )
+}
 
-    let range = (max - min) as u64;
+/// Fills `out` with uniform floats in `[0, 1)`. The raw bits are drawn first
+/// and converted in a separate pass so the conversion loop vectorises.
+fn fill_unit_floats(out: &mut [f64]) {
+    let mut bits = vec![0u64; out.len()];
+    with_task_rng(|rng| {
+        for slot in &mut bits {
+            *slot = rng.next_u64();
+        }
+    });
+    for (value, raw) in out.iter_mut().zip(&bits) {
+        *value = unit_f64(*raw);
+    }
+}
 
-    min + (next % range) as i64
+/// Reseeds every stream from `n`. Each task, and each thread outside a task,
+/// re-derives its stream from `n` and its stream id on its next draw.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_rand_seed(n: i64) {
+    BASE_SEED.store(n as u64, Ordering::Release);
+    SEED_GENERATION.fetch_add(1, Ordering::AcqRel);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_rand_int(min: i64, max: i64) -> i64 {
+    with_task_rng(|rng| rng.next_in_range(min, max))
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_rand_float() -> f64 {
-    let mut state = RNG_STATE.lock();
-    let next = lcg_next(&mut state.seed);
+    with_task_rng(Xoshiro256PlusPlus::next_f64)
+}
+
+/// New list of `n` uniform floats in `[0, 1)`.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_rand_floats(n: i64) -> u64 {
+    let mut values = vec![0.0; n.max(0) as usize];
+    fill_unit_floats(&mut values);
+    list_from_items(ListItems::Floats(values))
+}
 
-    // Convert to float in [0.0, 1.0)
-    (next as f64) / (u64::MAX as f64)
+/// New list of `n` uniform integers in `[min, max)`.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_rand_ints(n: i64, min: i64, max: i64) -> u64 {
+    let values: Vec<i64> =
+        with_task_rng(|rng| (0..n.max(0)).map(|_| rng.next_in_range(min, max)).collect());
+    list_from_items(ListItems::Ints(values))
 }
 
 #[unsafe(no_mangle)]
@@ -66,13 +189,7 @@ pub extern "C" fn otter_std_rand_bytes(n: i64) -> *mut c_char {
         return std::ptr::null_mut();
     }
 
-    let mut state = RNG_STATE.lock();
-    let mut bytes = Vec::with_capacity(n as usize);
-
-    for _ in 0..n {
-        let next = lcg_next(&mut state.seed);
-        bytes.push((next & 0xFF) as u8);
-    }
+    let bytes: Vec<u8> = with_task_rng(|rng| (0..n).map(|_| rng.next_u64() as u8).collect());
 
     // Convert bytes to hex string
     let hex_string: String = bytes.iter().map(|b| format!("{:02x}", b)).collect();
@@ -85,14 +202,12 @@ pub extern "C" fn otter_std_rand_bytes(n: i64) -> *mut c_char {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_std_rand_uuid() -> *mut c_char {
-    let mut state = RNG_STATE.lock();
-
     // Generate UUID v4 format: xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx
-    let mut uuid_bytes = Vec::new();
-    for _ in 0..16 {
-        let next = lcg_next(&mut state.seed);
-        uuid_bytes.push((next & 0xFF) as u8);
-    }
+    let mut uuid_bytes = [0u8; 16];
+    with_task_rng(|rng| {
+        uuid_bytes[..8].copy_from_slice(&rng.next_u64().to_le_bytes());
+        uuid_bytes[8..].copy_from_slice(&rng.next_u64().to_le_bytes());
+    });
 
     // Set version (4) and variant bits
     uuid_bytes[6] = (uuid_bytes[6] & 0x0F) | 0x40; // Version 4
@@ -144,6 +259,21 @@ fn register_std_rand_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![], FfiType::F64),
     });
 
+    registry.register(FfiFunction {
+        name: "rand.floats".into(),
+        symbol: "otter_std_rand_floats".into(),
+        signature: FfiSignature::new(vec![FfiType::I64], FfiType::List),
+    });
+
+    registry.register(FfiFunction {
+        name: "rand.ints".into(),
+        symbol: "otter_std_rand_ints".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::I64, FfiType::I64, FfiType::I64],
+            FfiType::List,
+        ),
+    });
+
     registry.register(FfiFunction {
         name: "rand.bytes".into(),
         symbol: "otter_std_rand_bytes".into(),
@@ -164,3 +294,96 @@ inventory::submit! {
         register: register_std_rand_symbols,
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::task::Task;
+    use std::sync::{Mutex, mpsc};
+
+    /// `rand.seed` is process-wide, so tests that seed run one at a time.
+    static SEED_LOCK: Mutex<()> = Mutex::new(());
+
+    #[test]
+    fn seeding_makes_the_sequence_reproducible() {
+        let _guard = SEED_LOCK.lock().unwrap();
+        otter_std_rand_seed(42);
+        let first: Vec<i64> = (0..8).map(|_| otter_std_rand_int(0, 1000)).collect();
+        otter_std_rand_seed(42);
+        let second: Vec<i64> = (0..8).map(|_| otter_std_rand_int(0, 1000)).collect();
+        assert_eq!(first, second);
+    }
+
+    #[test]
+    fn threads_draw_from_distinct_streams() {
+        let _guard = SEED_LOCK.lock().unwrap();
+        otter_std_rand_seed(7);
+        let here = with_task_rng(Xoshiro256PlusPlus::next_u64);
+        let there = std::thread::spawn(|| with_task_rng(Xoshiro256PlusPlus::next_u64))
+            .join()
+            .unwrap();
+        assert_ne!(here, there);
+    }
+
+    #[test]
+    fn seeding_reaches_threads_that_already_drew() {
+        let _guard = SEED_LOCK.lock().unwrap();
+        let (drew, drew_rx) = mpsc::channel();
+        let (seeded, seeded_rx) = mpsc::channel();
+        let worker = std::thread::spawn(move || {
+            with_task_rng(Xoshiro256PlusPlus::next_u64);
+            drew.send(()).unwrap();
+            seeded_rx.recv().unwrap();
+            let drawn = with_task_rng(Xoshiro256PlusPlus::next_u64);
+            assert_eq!(drawn, stream_rng(99, stream_id()).next_u64());
+        });
+        drew_rx.recv().unwrap();
+        otter_std_rand_seed(99);
+        seeded.send(()).unwrap();
+        worker.join().unwrap();
+    }
+
+    #[test]
+    fn task_streams_follow_the_task_id() {
+        let _guard = SEED_LOCK.lock().unwrap();
+        otter_std_rand_seed(5);
+        Task::new(
+            None,
+            Box::new(|| {
+                let id = current_task_id().unwrap().raw();
+                let first = with_task_rng(Xoshiro256PlusPlus::next_u64);
+                // A task run nested on the same thread draws from its own
+                // stream and leaves this one where it was.
+                Task::new(
+                    None,
+                    Box::new(|| {
+                        with_task_rng(Xoshiro256PlusPlus::next_u64);
+                    }),
+                )
+                .run();
+                let second = with_task_rng(Xoshiro256PlusPlus::next_u64);
+
+                let mut expected = stream_rng(5, id);
+                assert_eq!(first, expected.next_u64());
+                assert_eq!(second, expected.next_u64());
+            }),
+        )
+        .run();
+    }
+
+    #[test]
+    fn values_stay_in_range() {
+        let mut rng = Xoshiro256PlusPlus::from_seed(1);
+        for _ in 0..10_000 {
+            let value = rng.next_in_range(-5, 5);
+            assert!((-5..5).contains(&value));
+            let unit = rng.next_f64();
+            assert!((0.0..1.0).contains(&unit));
+        }
+        assert_eq!(rng.next_in_range(3, 3), 3);
+
+        let mut buffer = [2.0; 37];
+        fill_unit_floats(&mut buffer);
+        assert!(buffer.iter().all(|value| (0.0..1.0).contains(value)));
+    }
+}
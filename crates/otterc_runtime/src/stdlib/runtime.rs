@@ -16,7 +16,7 @@ use otterc_config::VERSION;
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 #[cfg(feature = "task-runtime")]
-use crate::task::{TaskMetricsSnapshot, TaskRuntimeMetrics, WorkerState};
+use crate::task::{LatencySnapshot, TaskMetricsSnapshot, TaskRuntimeMetrics, WorkerState};
 
 // ============================================================================
 // Runtime Statistics Tracking
@@ -250,13 +250,20 @@ pub extern "C" fn otter_runtime_tasks() -> *mut c_char {
             .collect();
 
         let json = format!(
-            "{{\"tasks\":{{\"spawned\":{},\"completed\":{},\"waiting\":{}}},\"channels\":{{\"registered\":{},\"waiting\":{},\"backlog\":{}}},\"workers\":{{\"total\":{},\"active\":{}}},\"worker_details\":[{}]}}",
+            "{{\"tasks\":{{\"spawned\":{},\"completed\":{},\"waiting\":{}}},\"channels\":{{\"registered\":{},\"waiting\":{},\"backlog\":{}}},\"groups\":{{\"created\":{},\"active\":{},\"tasks\":{},\"cancelled\":{},\"failed\":{}}},\"latency\":{{\"queue_wait\":{},\"run_time\":{}}},\"workers\":{{\"total\":{},\"active\":{}}},\"worker_details\":[{}]}}",
             snapshot.tasks_spawned,
             snapshot.tasks_completed,
             snapshot.tasks_waiting,
             snapshot.channels_registered,
             snapshot.channel_waiters,
             snapshot.channel_backlog,
+            snapshot.groups_created,
+            snapshot.groups_active,
+            snapshot.group_tasks,
+            snapshot.group_tasks_cancelled,
+            snapshot.group_tasks_failed,
+            latency_json(&snapshot.queue_wait),
+            latency_json(&snapshot.run_time),
             snapshot.total_workers,
             snapshot.active_workers,
             worker_json.join(",")
@@ -275,6 +282,20 @@ pub extern "C" fn otter_runtime_tasks() -> *mut c_char {
     }
 }
 
+/// Summary of a latency histogram as a JSON object, in nanoseconds.
+#[cfg(feature = "task-runtime")]
+fn latency_json(latency: &LatencySnapshot) -> String {
+    format!(
+        "{{\"count\":{},\"mean_ns\":{},\"p50_ns\":{},\"p90_ns\":{},\"p99_ns\":{},\"max_ns\":{}}}",
+        latency.count,
+        latency.mean_nanos(),
+        latency.percentile_nanos(0.5),
+        latency.percentile_nanos(0.9),
+        latency.percentile_nanos(0.99),
+        latency.max_nanos
+    )
+}
+
 /// Get OtterLang runtime version
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_runtime_version() -> *mut c_char {
@@ -334,13 +355,19 @@ pub fn emit_task_metrics_report() {
     if let Some(metrics) = task_metrics_clone() {
         let snapshot = metrics.snapshot();
         println!(
-            "[tasks] spawned={}, completed={}, waiting={}, channels={}, channel_waiters={}, channel_backlog={}",
+            "[tasks] spawned={}, completed={}, waiting={}, channels={}, channel_waiters={}, channel_backlog={}, groups={}, group_tasks={}, group_cancelled={}, group_failed={}, queue_wait_p99={}ns, run_time_p99={}ns",
             snapshot.tasks_spawned,
             snapshot.tasks_completed,
             snapshot.tasks_waiting,
             snapshot.channels_registered,
             snapshot.channel_waiters,
-            snapshot.channel_backlog
+            snapshot.channel_backlog,
+            snapshot.groups_created,
+            snapshot.group_tasks,
+            snapshot.group_tasks_cancelled,
+            snapshot.group_tasks_failed,
+            snapshot.queue_wait.percentile_nanos(0.99),
+            snapshot.run_time.percentile_nanos(0.99)
         );
     }
 }
@@ -351,13 +378,18 @@ fn task_metrics_field() -> Option<String> {
     guard.as_ref().map(|metrics| {
         let snapshot: TaskMetricsSnapshot = metrics.snapshot();
         format!(
-            "\"tasks\":{{\"spawned\":{},\"completed\":{},\"waiting\":{}}},\"channels\":{{\"registered\":{},\"waiting\":{},\"backlog\":{}}},\"workers\":{{\"total\":{},\"active\":{}}}",
+            "\"tasks\":{{\"spawned\":{},\"completed\":{},\"waiting\":{}}},\"channels\":{{\"registered\":{},\"waiting\":{},\"backlog\":{}}},\"groups\":{{\"created\":{},\"active\":{},\"tasks\":{},\"cancelled\":{},\"failed\":{}}},\"workers\":{{\"total\":{},\"active\":{}}}",
             snapshot.tasks_spawned,
             snapshot.tasks_completed,
             snapshot.tasks_waiting,
             snapshot.channels_registered,
             snapshot.channel_waiters,
             snapshot.channel_backlog,
+            snapshot.groups_created,
+            snapshot.groups_active,
+            snapshot.group_tasks,
+            snapshot.group_tasks_cancelled,
+            snapshot.group_tasks_failed,
             snapshot.total_workers,
             snapshot.active_workers
         )
@@ -1,55 +1,88 @@
-use std::cell::RefCell;
-use std::collections::{HashMap, HashSet};
-use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
-use std::sync::{Arc, Once};
-use std::thread;
-
-use once_cell::sync::Lazy;
-use parking_lot::{Mutex, RwLock};
+//! Synchronisation primitives for `std.sync`.
+//!
+//! Every primitive is a heap object and its handle is the object's address,
+//! so operations go straight to the object without a registry lookup. An
+//! object lives until its `sync.*_free` function is called; nothing tracks
+//! handles, so the caller must free each one once, after its last use.
+//!
+//! Atomic integers are a bare `AtomicI64`, which lets codegen lower
+//! `sync.atomic_*` calls to native atomic instructions; the functions here
+//! remain for the JIT and for callers that go through the FFI. Like them, the
+//! inline lowering treats a `0` handle as no object.
+
+use std::sync::Once;
+use std::sync::atomic::{AtomicI64, AtomicU64, AtomicUsize, Ordering};
+
+use parking_lot::lock_api::RawMutex as _;
+use parking_lot::{Condvar, Mutex, RawMutex};
 
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
-thread_local! {
-    static THREAD_LOCKS: RefCell<HashSet<u64>> = RefCell::new(HashSet::new());
-}
+use crate::error::{ErrorStack, OtError};
+use crate::task::current_task_id;
 
-/// Handle IDs for opaque types
-type HandleId = u64;
+/// Owner ids of code running outside any task have the top bit set, so they
+/// never collide with task ids.
+const THREAD_OWNER_BIT: u64 = 1 << 63;
 
-static NEXT_HANDLE_ID: AtomicU64 = AtomicU64::new(1);
+static NEXT_THREAD_OWNER: AtomicU64 = AtomicU64::new(1);
 
-fn next_handle_id() -> HandleId {
-    NEXT_HANDLE_ID.fetch_add(1, Ordering::SeqCst)
+thread_local! {
+    /// Owner id of this thread when it is not running a task.
+    static THREAD_OWNER: u64 = THREAD_OWNER_BIT | NEXT_THREAD_OWNER.fetch_add(1, Ordering::Relaxed);
 }
 
-struct MutexHandle {
-    _id: HandleId,
-    inner: Arc<Mutex<()>>,
+/// Spins on a wait group before falling back to the condition variable.
+const WAIT_SPIN_LIMIT: usize = 64;
+
+struct SyncMutex {
+    /// Parking-lot raw mutex: a single atomic word on the fast path, with
+    /// contended threads parked on the futex-backed parking lot.
+    raw: RawMutex,
+    /// Owner id of the holder, or 0 while the mutex is free. Only the holder
+    /// writes it, so comparing it with the caller's own id needs no ordering.
+    owner: AtomicU64,
+    /// Re-entry depth; only the holder touches it.
+    depth: AtomicUsize,
+    acquisitions: AtomicU64,
+    contentions: AtomicU64,
 }
 
 struct WaitGroup {
-    _id: HandleId,
-    count: Arc<AtomicUsize>,
+    count: AtomicI64,
+    lock: Mutex<()>,
+    zero: Condvar,
+}
+
+fn into_handle<T>(object: T) -> u64 {
+    Box::into_raw(Box::new(object)) as u64
 }
 
-struct AtomicInt {
-    _id: HandleId,
-    value: Arc<AtomicU64>,
+/// Identity that owns a mutex: the running task, or the thread outside tasks.
+///
+/// Tasks rather than threads own mutexes because a worker can run several
+/// tasks on one stack while it helps with a `join`; keying by thread would let
+/// a nested task walk straight into a mutex its suspended parent holds.
+fn lock_owner() -> u64 {
+    current_task_id().map_or_else(|| THREAD_OWNER.with(|owner| *owner), |task| task.raw())
 }
 
-struct OnceHandle {
-    _id: HandleId,
-    inner: Arc<Once>,
+/// Borrows the object behind a handle, treating `0` as no object.
+fn object<'a, T>(handle: u64) -> Option<&'a T> {
+    // SAFETY: non-zero handles are only produced by `into_handle` for the
+    // matching type, and callers do not use a handle after freeing it.
+    unsafe { (handle as *const T).as_ref() }
 }
 
-static MUTEXES: Lazy<RwLock<HashMap<HandleId, MutexHandle>>> =
-    Lazy::new(|| RwLock::new(HashMap::new()));
-static WAIT_GROUPS: Lazy<RwLock<HashMap<HandleId, WaitGroup>>> =
-    Lazy::new(|| RwLock::new(HashMap::new()));
-static ATOMICS: Lazy<RwLock<HashMap<HandleId, AtomicInt>>> =
-    Lazy::new(|| RwLock::new(HashMap::new()));
-static ONCE_HANDLES: Lazy<RwLock<HashMap<HandleId, OnceHandle>>> =
-    Lazy::new(|| RwLock::new(HashMap::new()));
+/// Drops the object behind a handle, treating `0` as no object.
+fn free_handle<T>(handle: u64) {
+    if handle == 0 {
+        return;
+    }
+    // SAFETY: non-zero handles come from `into_handle` for the matching type,
+    // and each one is freed once, after its last use.
+    drop(unsafe { Box::from_raw(handle as *mut T) });
+}
 
 // ============================================================================
 // Mutex Operations
@@ -57,32 +90,76 @@ static ONCE_HANDLES: Lazy<RwLock<HashMap<HandleId, OnceHandle>>> =
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_mutex() -> u64 {
-    let id = next_handle_id();
-    let mutex = MutexHandle {
-        _id: id,
-        inner: Arc::new(Mutex::new(())),
-    };
-
-    MUTEXES.write().insert(id, mutex);
-    id
+    into_handle(SyncMutex {
+        raw: RawMutex::INIT,
+        owner: AtomicU64::new(0),
+        depth: AtomicUsize::new(0),
+        acquisitions: AtomicU64::new(0),
+        contentions: AtomicU64::new(0),
+    })
 }
 
+/// Acquires the mutex and keeps it held until the matching
+/// `otter_sync_unlock`. Re-locking from the owning task nests; another task
+/// blocks, even when it runs on the same worker thread.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_lock(handle: u64) {
-    let mutexes = MUTEXES.read();
-    if let Some(mutex) = mutexes.get(&handle) {
-        let _guard = mutex.inner.lock();
-        THREAD_LOCKS.with(|locks| {
-            locks.borrow_mut().insert(handle);
-        });
+    let Some(mutex) = object::<SyncMutex>(handle) else {
+        return;
+    };
+    let owner = lock_owner();
+    if mutex.owner.load(Ordering::Relaxed) == owner {
+        mutex.depth.fetch_add(1, Ordering::Relaxed);
+        return;
     }
+
+    if !mutex.raw.try_lock() {
+        mutex.contentions.fetch_add(1, Ordering::Relaxed);
+        mutex.raw.lock();
+    }
+    mutex.acquisitions.fetch_add(1, Ordering::Relaxed);
+    mutex.owner.store(owner, Ordering::Relaxed);
+    mutex.depth.store(1, Ordering::Relaxed);
 }
 
+/// Releases one level of a mutex held by the calling task. Unlocking a mutex
+/// the caller does not hold leaves it untouched and raises a runtime error.
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_unlock(handle: u64) {
-    THREAD_LOCKS.with(|locks| {
-        locks.borrow_mut().remove(&handle);
-    });
+    let Some(mutex) = object::<SyncMutex>(handle) else {
+        return;
+    };
+    if mutex.owner.load(Ordering::Relaxed) != lock_owner() {
+        ErrorStack::raise(OtError::new(
+            "sync.unlock: mutex is not held by the current task",
+        ));
+        return;
+    }
+    if mutex.depth.fetch_sub(1, Ordering::Relaxed) == 1 {
+        mutex.owner.store(0, Ordering::Relaxed);
+        // SAFETY: `owner` shows the caller acquired the mutex.
+        unsafe {
+            mutex.raw.unlock();
+        }
+    }
+}
+
+/// Number of `lock` calls that found the mutex already held.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_mutex_contentions(handle: u64) -> i64 {
+    object::<SyncMutex>(handle).map_or(0, |mutex| mutex.contentions.load(Ordering::Relaxed) as i64)
+}
+
+/// Number of times the mutex has been acquired.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_mutex_acquisitions(handle: u64) -> i64 {
+    object::<SyncMutex>(handle).map_or(0, |mutex| mutex.acquisitions.load(Ordering::Relaxed) as i64)
+}
+
+/// Frees a mutex. It must not be held or waited on.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_mutex_free(handle: u64) {
+    free_handle::<SyncMutex>(handle);
 }
 
 // ============================================================================
@@ -91,119 +168,107 @@ pub extern "C" fn otter_sync_unlock(handle: u64) {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_waitgroup() -> u64 {
-    let id = next_handle_id();
-    let wg = WaitGroup {
-        _id: id,
-        count: Arc::new(AtomicUsize::new(0)),
-    };
-
-    WAIT_GROUPS.write().insert(id, wg);
-    id
+    into_handle(WaitGroup {
+        count: AtomicI64::new(0),
+        lock: Mutex::new(()),
+        zero: Condvar::new(),
+    })
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_waitgroup_add(handle: u64, delta: i64) {
-    let wait_groups = WAIT_GROUPS.read();
-    if let Some(wg) = wait_groups.get(&handle) {
-        if delta > 0 {
-            wg.count.fetch_add(delta as usize, Ordering::SeqCst);
-        } else if delta < 0 {
-            wg.count.fetch_sub((-delta) as usize, Ordering::SeqCst);
+    if let Some(wg) = object::<WaitGroup>(handle) {
+        let previous = wg.count.fetch_add(delta, Ordering::AcqRel);
+        if previous + delta <= 0 && previous > 0 {
+            let _guard = wg.lock.lock();
+            wg.zero.notify_all();
         }
     }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_waitgroup_done(handle: u64) {
-    let wait_groups = WAIT_GROUPS.read();
-    if let Some(wg) = wait_groups.get(&handle) {
-        let prev = wg.count.fetch_sub(1, Ordering::SeqCst);
-        if prev == 1 {
-            // No-op for now; future versions may notify waiters explicitly.
-        }
-    }
+    otter_sync_waitgroup_add(handle, -1);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_waitgroup_wait(handle: u64) {
-    let wait_groups = WAIT_GROUPS.read();
-    if let Some(wg) = wait_groups.get(&handle) {
-        while wg.count.load(Ordering::SeqCst) > 0 {
-            thread::yield_now();
+    let Some(wg) = object::<WaitGroup>(handle) else {
+        return;
+    };
+    for _ in 0..WAIT_SPIN_LIMIT {
+        if wg.count.load(Ordering::Acquire) <= 0 {
+            return;
         }
+        std::hint::spin_loop();
+    }
+    let mut guard = wg.lock.lock();
+    while wg.count.load(Ordering::Acquire) > 0 {
+        wg.zero.wait(&mut guard);
     }
 }
 
+/// Frees a wait group. No task may still be waiting on it.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_waitgroup_free(handle: u64) {
+    free_handle::<WaitGroup>(handle);
+}
+
 // ============================================================================
 // Atomic Operations
 // ============================================================================
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_atomic_int(initial: i64) -> u64 {
-    let id = next_handle_id();
-    let atomic = AtomicInt {
-        _id: id,
-        value: Arc::new(AtomicU64::new(initial as u64)),
-    };
-
-    ATOMICS.write().insert(id, atomic);
-    id
+    into_handle(AtomicI64::new(initial))
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_atomic_add(handle: u64, delta: i64) -> i64 {
-    let atomics = ATOMICS.read();
-    if let Some(atomic) = atomics.get(&handle) {
-        atomic.value.fetch_add(delta as u64, Ordering::SeqCst) as i64
-    } else {
-        0
-    }
+    object::<AtomicI64>(handle).map_or(0, |atomic| atomic.fetch_add(delta, Ordering::SeqCst))
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_atomic_get(handle: u64) -> i64 {
-    let atomics = ATOMICS.read();
-    if let Some(atomic) = atomics.get(&handle) {
-        atomic.value.load(Ordering::SeqCst) as i64
-    } else {
-        0
-    }
+    object::<AtomicI64>(handle).map_or(0, |atomic| atomic.load(Ordering::SeqCst))
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_atomic_set(handle: u64, value: i64) {
-    let atomics = ATOMICS.read();
-    if let Some(atomic) = atomics.get(&handle) {
-        atomic.value.store(value as u64, Ordering::SeqCst);
+    if let Some(atomic) = object::<AtomicI64>(handle) {
+        atomic.store(value, Ordering::SeqCst);
     }
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_atomic_free(handle: u64) {
+    free_handle::<AtomicI64>(handle);
+}
+
 // ============================================================================
 // Once Operations
 // ============================================================================
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_once() -> u64 {
-    let id = next_handle_id();
-    let once_handle = OnceHandle {
-        _id: id,
-        inner: Arc::new(Once::new()),
-    };
-
-    ONCE_HANDLES.write().insert(id, once_handle);
-    id
+    into_handle(Once::new())
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn otter_sync_once_call(handle: u64, callback: extern "C" fn()) {
-    let once_handles = ONCE_HANDLES.read();
-    if let Some(once_handle) = once_handles.get(&handle) {
-        once_handle.inner.call_once(|| {
+    if let Some(once) = object::<Once>(handle) {
+        once.call_once(|| {
             callback();
         });
     }
 }
 
+/// Frees a once cell. No `once_call` on it may still be running.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_sync_once_free(handle: u64) {
+    free_handle::<Once>(handle);
+}
+
 // ============================================================================
 // Symbol Registration
 // ============================================================================
@@ -227,6 +292,24 @@ fn register_std_sync_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
     });
 
+    registry.register(FfiFunction {
+        name: "sync.mutex_contentions".into(),
+        symbol: "otter_sync_mutex_contentions".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "sync.mutex_acquisitions".into(),
+        symbol: "otter_sync_mutex_acquisitions".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "sync.mutex_free".into(),
+        symbol: "otter_sync_mutex_free".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
     registry.register(FfiFunction {
         name: "sync.waitgroup".into(),
         symbol: "otter_sync_waitgroup".into(),
@@ -251,6 +334,12 @@ fn register_std_sync_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
     });
 
+    registry.register(FfiFunction {
+        name: "sync.waitgroup_free".into(),
+        symbol: "otter_sync_waitgroup_free".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
     registry.register(FfiFunction {
         name: "sync.atomic_int".into(),
         symbol: "otter_sync_atomic_int".into(),
@@ -275,6 +364,12 @@ fn register_std_sync_symbols(registry: &SymbolRegistry) {
         signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::I64], FfiType::Unit),
     });
 
+    registry.register(FfiFunction {
+        name: "sync.atomic_free".into(),
+        symbol: "otter_sync_atomic_free".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
     registry.register(FfiFunction {
         name: "sync.once".into(),
         symbol: "otter_sync_once".into(),
@@ -286,6 +381,12 @@ fn register_std_sync_symbols(registry: &SymbolRegistry) {
         symbol: "otter_sync_once_call".into(),
         signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::Opaque], FfiType::Unit),
     });
+
+    registry.register(FfiFunction {
+        name: "sync.once_free".into(),
+        symbol: "otter_sync_once_free".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
 }
 
 inventory::submit! {
@@ -295,3 +396,143 @@ inventory::submit! {
         register: register_std_sync_symbols,
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::task::Task;
+    use std::sync::Arc;
+    use std::sync::atomic::AtomicBool;
+    use std::thread;
+
+    #[test]
+    fn lock_stays_held_until_unlock() {
+        let handle = otter_sync_mutex();
+        otter_sync_lock(handle);
+
+        let acquired = Arc::new(AtomicBool::new(false));
+        let waiter = {
+            let acquired = Arc::clone(&acquired);
+            thread::spawn(move || {
+                otter_sync_lock(handle);
+                acquired.store(true, Ordering::SeqCst);
+                otter_sync_unlock(handle);
+            })
+        };
+
+        thread::sleep(std::time::Duration::from_millis(50));
+        assert!(!acquired.load(Ordering::SeqCst));
+        otter_sync_unlock(handle);
+        waiter.join().unwrap();
+        assert!(acquired.load(Ordering::SeqCst));
+        assert_eq!(otter_sync_mutex_acquisitions(handle), 2);
+        assert_eq!(otter_sync_mutex_contentions(handle), 1);
+    }
+
+    #[test]
+    fn lock_nests_on_the_owning_thread() {
+        let handle = otter_sync_mutex();
+        otter_sync_lock(handle);
+        otter_sync_lock(handle);
+        otter_sync_unlock(handle);
+        assert!(object::<SyncMutex>(handle).unwrap().raw.is_locked());
+        otter_sync_unlock(handle);
+        assert!(!object::<SyncMutex>(handle).unwrap().raw.is_locked());
+    }
+
+    #[test]
+    fn unlock_by_another_thread_is_an_error() {
+        let handle = otter_sync_mutex();
+        otter_sync_lock(handle);
+        thread::spawn(move || {
+            otter_sync_unlock(handle);
+            assert!(ErrorStack::clear().is_some());
+        })
+        .join()
+        .unwrap();
+        assert!(object::<SyncMutex>(handle).unwrap().raw.is_locked());
+        otter_sync_unlock(handle);
+        assert!(ErrorStack::clear().is_none());
+        assert!(!object::<SyncMutex>(handle).unwrap().raw.is_locked());
+    }
+
+    #[test]
+    fn tasks_on_one_thread_do_not_share_ownership() {
+        let handle = otter_sync_mutex();
+        Task::new(
+            None,
+            Box::new(move || {
+                otter_sync_lock(handle);
+                // A task run inside this one, as a worker helping with a
+                // join would, is not the owner.
+                Task::new(
+                    None,
+                    Box::new(move || {
+                        otter_sync_unlock(handle);
+                        assert!(ErrorStack::clear().is_some());
+                    }),
+                )
+                .run();
+                assert!(object::<SyncMutex>(handle).unwrap().raw.is_locked());
+
+                // The outer task is still the owner once the nested run ends.
+                otter_sync_lock(handle);
+                otter_sync_unlock(handle);
+                otter_sync_unlock(handle);
+                assert!(ErrorStack::clear().is_none());
+            }),
+        )
+        .run();
+        assert!(!object::<SyncMutex>(handle).unwrap().raw.is_locked());
+    }
+
+    #[test]
+    fn atomic_handle_addresses_the_counter() {
+        let handle = otter_sync_atomic_int(5);
+        assert_eq!(otter_sync_atomic_add(handle, 3), 5);
+        let raw = handle as *const AtomicI64;
+        // SAFETY: atomic handles are the address of a live `AtomicI64`.
+        assert_eq!(unsafe { (*raw).load(Ordering::SeqCst) }, 8);
+        otter_sync_atomic_set(handle, -1);
+        assert_eq!(otter_sync_atomic_get(handle), -1);
+        otter_sync_atomic_free(handle);
+    }
+
+    #[test]
+    fn waitgroup_wait_returns_after_done() {
+        let handle = otter_sync_waitgroup();
+        otter_sync_waitgroup_add(handle, 4);
+        let workers: Vec<_> = (0..4)
+            .map(|_| thread::spawn(move || otter_sync_waitgroup_done(handle)))
+            .collect();
+        otter_sync_waitgroup_wait(handle);
+        for worker in workers {
+            worker.join().unwrap();
+        }
+        assert_eq!(
+            object::<WaitGroup>(handle)
+                .unwrap()
+                .count
+                .load(Ordering::SeqCst),
+            0
+        );
+        otter_sync_waitgroup_free(handle);
+    }
+
+    #[test]
+    fn freed_handles_and_zero_are_accepted() {
+        let mutex = otter_sync_mutex();
+        otter_sync_lock(mutex);
+        otter_sync_unlock(mutex);
+        otter_sync_mutex_free(mutex);
+        otter_sync_waitgroup_free(otter_sync_waitgroup());
+        otter_sync_atomic_free(otter_sync_atomic_int(1));
+        otter_sync_once_free(otter_sync_once());
+
+        otter_sync_mutex_free(0);
+        otter_sync_waitgroup_free(0);
+        otter_sync_atomic_free(0);
+        otter_sync_once_free(0);
+        assert_eq!(otter_sync_atomic_get(0), 0);
+    }
+}
@@ -12,10 +12,12 @@ use once_cell::sync::Lazy;
 use parking_lot::Condvar;
 use parking_lot::Mutex;
 
+use crate::error::{ErrorStack, OtError};
 #[cfg(feature = "task-runtime")]
 use crate::stdlib::runtime::task_metrics_clone;
 use crate::stdlib::runtime::{decrement_active_tasks, increment_active_tasks};
-use crate::task::{JoinHandle, TaskChannel, TaskRuntimeMetrics, runtime};
+use crate::stdlib::vecmath::{Numbers, snapshot};
+use crate::task::{JoinHandle, TaskChannel, TaskGroup, TaskRuntimeMetrics, runtime};
 use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 type HandleId = u64;
@@ -173,6 +175,203 @@ fn create_condvar_waker(pair: Arc<(Mutex<bool>, Condvar)>) -> Waker {
     unsafe { Waker::from_raw(RawWaker::new(pair_ptr as *const (), &VTABLE)) }
 }
 
+static TASK_GROUPS: Lazy<Mutex<HashMap<HandleId, Arc<TaskGroup>>>> =
+    Lazy::new(|| Mutex::new(HashMap::new()));
+
+/// Keeps `runtime.gos` accurate for group children, which may be dropped
+/// unrun when their group is cancelled.
+struct ActiveTaskGuard;
+
+impl ActiveTaskGuard {
+    fn new() -> Self {
+        increment_active_tasks();
+        Self
+    }
+}
+
+impl Drop for ActiveTaskGuard {
+    fn drop(&mut self) {
+        decrement_active_tasks();
+    }
+}
+
+fn task_group(handle: u64) -> Option<Arc<TaskGroup>> {
+    TASK_GROUPS.lock().get(&handle).cloned()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_new() -> u64 {
+    let group = runtime().scheduler().group();
+    let id = next_handle_id();
+    TASK_GROUPS.lock().insert(id, Arc::new(group));
+    id
+}
+
+/// Spawns `callback` into the group and returns its index within the
+/// group, or -1 for an unknown handle.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_spawn(handle: u64, callback: TaskCallback) -> i64 {
+    let Some(group) = task_group(handle) else {
+        return -1;
+    };
+    let active = ActiveTaskGuard::new();
+    let index = group.spawn(move || {
+        let _active = active;
+        callback();
+    });
+    index as i64
+}
+
+/// Waits for every child. Raises an error instead when called from one of
+/// the group's own children, which would wait for itself forever.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_wait(handle: u64) {
+    let Some(group) = task_group(handle) else {
+        return;
+    };
+    if group.is_current_child() {
+        ErrorStack::raise(OtError::new(
+            "task.group_wait: a child cannot wait for its own group",
+        ));
+        return;
+    }
+    group.wait();
+}
+
+/// Waits for the first child to finish and returns its index, or -1 when
+/// the group is empty or unknown.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_wait_any(handle: u64) -> i64 {
+    task_group(handle)
+        .and_then(|group| group.wait_any())
+        .map_or(-1, |index| index as i64)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_cancel(handle: u64) {
+    if let Some(group) = task_group(handle) {
+        group.cancel();
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_pending(handle: u64) -> i64 {
+    task_group(handle).map_or(0, |group| group.pending() as i64)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_failed(handle: u64) -> i64 {
+    task_group(handle).map_or(0, |group| group.failed() as i64)
+}
+
+/// Releases the group handle. Children that have not started are cancelled
+/// and the call returns once the rest have finished. A child closing its own
+/// group would wait for itself, so that raises an error and keeps the handle.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_group_close(handle: u64) {
+    let mut groups = TASK_GROUPS.lock();
+    if groups
+        .get(&handle)
+        .is_some_and(|group| group.is_current_child())
+    {
+        drop(groups);
+        ErrorStack::raise(OtError::new(
+            "task.group_close: a child cannot close its own group",
+        ));
+        return;
+    }
+    let group = groups.remove(&handle);
+    drop(groups);
+    drop(group);
+}
+
+type FloatMapFn = extern "C" fn(f64) -> f64;
+type IntMapFn = extern "C" fn(i64) -> i64;
+type FloatPredicate = extern "C" fn(f64) -> bool;
+type IntPredicate = extern "C" fn(i64) -> bool;
+type FloatReduceFn = extern "C" fn(f64, f64) -> f64;
+type IntReduceFn = extern "C" fn(i64, i64) -> i64;
+type IndexFn = extern "C" fn(i64);
+
+fn list_of_floats(values: Vec<f64>) -> u64 {
+    Numbers::Float(values).into_list()
+}
+
+fn list_of_ints(values: Vec<i64>) -> u64 {
+    Numbers::Int(values).into_list()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_map_float(list: u64, func: FloatMapFn) -> u64 {
+    let values = snapshot(list, usize::MAX).into_floats();
+    list_of_floats(runtime().scheduler().par_map(&values, |&value| func(value)))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_map_int(list: u64, func: IntMapFn) -> u64 {
+    let values = snapshot(list, usize::MAX).into_ints();
+    list_of_ints(runtime().scheduler().par_map(&values, |&value| func(value)))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_filter_float(list: u64, pred: FloatPredicate) -> u64 {
+    let values = snapshot(list, usize::MAX).into_floats();
+    list_of_floats(
+        runtime()
+            .scheduler()
+            .par_filter(&values, |&value| pred(value)),
+    )
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_filter_int(list: u64, pred: IntPredicate) -> u64 {
+    let values = snapshot(list, usize::MAX).into_ints();
+    list_of_ints(
+        runtime()
+            .scheduler()
+            .par_filter(&values, |&value| pred(value)),
+    )
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_reduce_float(
+    list: u64,
+    identity: f64,
+    func: FloatReduceFn,
+) -> f64 {
+    let values = snapshot(list, usize::MAX).into_floats();
+    runtime().scheduler().par_reduce(&values, identity, func)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_reduce_int(list: u64, identity: i64, func: IntReduceFn) -> i64 {
+    let values = snapshot(list, usize::MAX).into_ints();
+    runtime().scheduler().par_reduce(&values, identity, func)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_for(count: i64, func: IndexFn) {
+    let count = usize::try_from(count).unwrap_or(0);
+    runtime()
+        .scheduler()
+        .par_for(count, |index| func(index as i64));
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_task_par_sort(list: u64) -> u64 {
+    let scheduler = runtime().scheduler();
+    match snapshot(list, usize::MAX) {
+        Numbers::Int(mut values) => {
+            scheduler.par_sort_by(&mut values, Ord::cmp);
+            list_of_ints(values)
+        }
+        Numbers::Float(mut values) => {
+            scheduler.par_sort_by(&mut values, f64::total_cmp);
+            list_of_floats(values)
+        }
+    }
+}
+
 #[derive(Debug)]
 struct ChannelWrapper<T> {
     channel: TaskChannel<T>,
@@ -621,6 +820,146 @@ fn register_std_task_symbols(registry: &SymbolRegistry) {
         symbol: "otter_task_recv_string".into(),
         signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Str),
     });
+
+    registry.register(FfiFunction {
+        name: "task.group_new".into(),
+        symbol: "otter_task_group_new".into(),
+        signature: FfiSignature::new(vec![], FfiType::Opaque),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_spawn".into(),
+        symbol: "otter_task_group_spawn".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque, FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_wait".into(),
+        symbol: "otter_task_group_wait".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_wait_any".into(),
+        symbol: "otter_task_group_wait_any".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_cancel".into(),
+        symbol: "otter_task_group_cancel".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_pending".into(),
+        symbol: "otter_task_group_pending".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_failed".into(),
+        symbol: "otter_task_group_failed".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.group_close".into(),
+        symbol: "otter_task_group_close".into(),
+        signature: FfiSignature::new(vec![FfiType::Opaque], FfiType::Unit),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_map_float".into(),
+        symbol: "otter_task_par_map_float".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::function(vec![FfiType::F64], FfiType::F64),
+            ],
+            FfiType::List,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_map_int".into(),
+        symbol: "otter_task_par_map_int".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::function(vec![FfiType::I64], FfiType::I64),
+            ],
+            FfiType::List,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_filter_float".into(),
+        symbol: "otter_task_par_filter_float".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::function(vec![FfiType::F64], FfiType::Bool),
+            ],
+            FfiType::List,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_filter_int".into(),
+        symbol: "otter_task_par_filter_int".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::function(vec![FfiType::I64], FfiType::Bool),
+            ],
+            FfiType::List,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_reduce_float".into(),
+        symbol: "otter_task_par_reduce_float".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::F64,
+                FfiType::function(vec![FfiType::F64, FfiType::F64], FfiType::F64),
+            ],
+            FfiType::F64,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_reduce_int".into(),
+        symbol: "otter_task_par_reduce_int".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::List,
+                FfiType::I64,
+                FfiType::function(vec![FfiType::I64, FfiType::I64], FfiType::I64),
+            ],
+            FfiType::I64,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_for".into(),
+        symbol: "otter_task_par_for".into(),
+        signature: FfiSignature::new(
+            vec![
+                FfiType::I64,
+                FfiType::function(vec![FfiType::I64], FfiType::Unit),
+            ],
+            FfiType::Unit,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "task.par_sort".into(),
+        symbol: "otter_task_par_sort".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::List),
+    });
 }
 
 inventory::submit! {
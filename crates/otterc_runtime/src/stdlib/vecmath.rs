@@ -0,0 +1,612 @@
+//! Array kernels for `std.math` over numeric lists.
+//!
+//! Lists of floats are stored unboxed, and the reductions borrow them in
+//! place as a slice under the list table's read lock; lists of integers or
+//! mixed values are converted into a buffer first. Entry points that build a
+//! new list, or that call back into compiled code, take a copy instead of
+//! holding the lock. The kernels are
+//! plain loops over fixed-width lanes that LLVM vectorises. On x86_64 every
+//! kernel is compiled a second time with AVX2 and FMA enabled, and that copy
+//! is chosen at runtime when the CPU supports it. Sums use blocked pairwise
+//! summation, so the rounding error grows with `log n` instead of `n`.
+
+use std::borrow::Cow;
+use std::collections::HashMap;
+
+use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
+
+use crate::stdlib::builtins::{LISTS, List, ListItems, Value, list_from_items};
+
+/// Independent accumulators per block; wide enough for two AVX2 registers.
+const LANES: usize = 8;
+/// Elements summed directly before partial sums are combined pairwise.
+const BLOCK: usize = 256;
+
+#[inline(always)]
+fn reduce_lanes(acc: [f64; LANES]) -> f64 {
+    ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]))
+}
+
+#[inline(always)]
+fn block_sum(block: &[f64]) -> f64 {
+    let mut acc = [0.0; LANES];
+    let chunks = block.chunks_exact(LANES);
+    let tail = chunks.remainder();
+    for chunk in chunks {
+        for lane in 0..LANES {
+            acc[lane] += chunk[lane];
+        }
+    }
+    tail.iter()
+        .fold(reduce_lanes(acc), |total, value| total + value)
+}
+
+#[inline(always)]
+fn block_dot(a: &[f64], b: &[f64]) -> f64 {
+    let mut acc = [0.0; LANES];
+    let a_chunks = a.chunks_exact(LANES);
+    let b_chunks = b.chunks_exact(LANES);
+    let tail = a_chunks.remainder().iter().zip(b_chunks.remainder());
+    for (x, y) in a_chunks.zip(b_chunks) {
+        for lane in 0..LANES {
+            acc[lane] += x[lane] * y[lane];
+        }
+    }
+    tail.fold(reduce_lanes(acc), |total, (x, y)| total + x * y)
+}
+
+#[inline(always)]
+fn block_squared_deviation(block: &[f64], mean: f64) -> f64 {
+    let mut acc = [0.0; LANES];
+    let chunks = block.chunks_exact(LANES);
+    let tail = chunks.remainder();
+    for chunk in chunks {
+        for lane in 0..LANES {
+            let delta = chunk[lane] - mean;
+            acc[lane] += delta * delta;
+        }
+    }
+    tail.iter().fold(reduce_lanes(acc), |total, value| {
+        total + (value - mean) * (value - mean)
+    })
+}
+
+/// Combines per-block partial sums as a balanced binary tree.
+#[inline(always)]
+fn pairwise(mut partials: Vec<f64>) -> f64 {
+    while partials.len() > 1 {
+        partials = partials.chunks(2).map(|pair| pair.iter().sum()).collect();
+    }
+    partials.first().copied().unwrap_or(0.0)
+}
+
+#[inline(always)]
+fn fold_lanes(values: &[f64], init: f64, op: impl Fn(f64, f64) -> f64) -> f64 {
+    let mut acc = [init; LANES];
+    let chunks = values.chunks_exact(LANES);
+    let tail = chunks.remainder();
+    for chunk in chunks {
+        for lane in 0..LANES {
+            acc[lane] = op(acc[lane], chunk[lane]);
+        }
+    }
+    let folded = acc.into_iter().fold(init, &op);
+    tail.iter().fold(folded, |total, value| op(total, *value))
+}
+
+/// Defines each kernel once and emits a portable copy, an AVX2 copy on
+/// x86_64, and a dispatcher that picks between them at runtime.
+macro_rules! kernels {
+    ($(fn $name:ident($($arg:ident: $ty:ty),*) -> $ret:ty $body:block)*) => {
+        mod portable {
+            use super::*;
+            $(pub(super) fn $name($($arg: $ty),*) -> $ret $body)*
+        }
+
+        #[cfg(target_arch = "x86_64")]
+        mod avx2 {
+            use super::*;
+            $(
+                #[target_feature(enable = "avx2,fma")]
+                pub(super) unsafe fn $name($($arg: $ty),*) -> $ret $body
+            )*
+        }
+
+        $(
+            fn $name($($arg: $ty),*) -> $ret {
+                #[cfg(target_arch = "x86_64")]
+                {
+                    if std::is_x86_feature_detected!("avx2") && std::is_x86_feature_detected!("fma") {
+                        // SAFETY: the CPU supports every feature the AVX2 copy enables.
+                        return unsafe { avx2::$name($($arg),*) };
+                    }
+                }
+                portable::$name($($arg),*)
+            }
+        )*
+    };
+}
+
+kernels! {
+    fn sum(values: &[f64]) -> f64 {
+        pairwise(values.chunks(BLOCK).map(block_sum).collect())
+    }
+
+    fn dot(a: &[f64], b: &[f64]) -> f64 {
+        let len = a.len().min(b.len());
+        let (a, b) = (&a[..len], &b[..len]);
+        pairwise(a.chunks(BLOCK).zip(b.chunks(BLOCK)).map(|(x, y)| block_dot(x, y)).collect())
+    }
+
+    fn squared_deviation(values: &[f64], mean: f64) -> f64 {
+        pairwise(
+            values
+                .chunks(BLOCK)
+                .map(|block| block_squared_deviation(block, mean))
+                .collect(),
+        )
+    }
+
+    fn axpy(alpha: f64, x: &[f64], y: &[f64]) -> Vec<f64> {
+        x.iter().zip(y).map(|(x, y)| alpha * x + y).collect()
+    }
+
+    fn min(values: &[f64]) -> f64 {
+        fold_lanes(values, f64::INFINITY, f64::min)
+    }
+
+    fn max(values: &[f64]) -> f64 {
+        fold_lanes(values, f64::NEG_INFINITY, f64::max)
+    }
+}
+
+/// A list's numbers, kept as integers when every element is one.
+pub(crate) enum Numbers {
+    Int(Vec<i64>),
+    Float(Vec<f64>),
+}
+
+impl Numbers {
+    pub(crate) fn into_floats(self) -> Vec<f64> {
+        match self {
+            Numbers::Int(values) => values.into_iter().map(|value| value as f64).collect(),
+            Numbers::Float(values) => values,
+        }
+    }
+
+    /// Integer view of the numbers; floats are truncated toward zero.
+    pub(crate) fn into_ints(self) -> Vec<i64> {
+        match self {
+            Numbers::Int(values) => values,
+            Numbers::Float(values) => values.into_iter().map(|value| value as i64).collect(),
+        }
+    }
+
+    pub(crate) fn into_list(self) -> u64 {
+        match self {
+            Numbers::Int(values) => list_from_items(ListItems::Ints(values)),
+            Numbers::Float(values) => list_from_items(ListItems::Floats(values)),
+        }
+    }
+}
+
+/// A boxed item as a number; non-numeric items read as NaN so that
+/// positions stay aligned.
+fn number_of(item: &Value) -> f64 {
+    match item {
+        Value::F64(value) => *value,
+        Value::I64(value) => *value as f64,
+        Value::Bool(value) => f64::from(u8::from(*value)),
+        _ => f64::NAN,
+    }
+}
+
+/// Copies up to `limit` numbers out of a list, for callers that must not
+/// hold the list table's lock while they work on them.
+pub(crate) fn snapshot(handle: u64, limit: usize) -> Numbers {
+    let lists = LISTS.read();
+    let Some(list) = lists.get(&handle) else {
+        return Numbers::Float(Vec::new());
+    };
+    match &list.items {
+        ListItems::Ints(values) => Numbers::Int(values[..values.len().min(limit)].to_vec()),
+        ListItems::Floats(values) => Numbers::Float(values[..values.len().min(limit)].to_vec()),
+        ListItems::Values(items) => {
+            let items = &items[..items.len().min(limit)];
+            if items.iter().all(|item| matches!(item, Value::I64(_))) {
+                return Numbers::Int(
+                    items
+                        .iter()
+                        .map(|item| match item {
+                            Value::I64(value) => *value,
+                            _ => 0,
+                        })
+                        .collect(),
+                );
+            }
+            Numbers::Float(items.iter().map(number_of).collect())
+        }
+    }
+}
+
+/// Up to `limit` numbers of a list as floats: borrowed from a float list,
+/// converted from any other.
+fn float_slice(lists: &HashMap<u64, List>, handle: u64, limit: usize) -> Cow<'_, [f64]> {
+    let Some(list) = lists.get(&handle) else {
+        return Cow::Borrowed(&[]);
+    };
+    match &list.items {
+        ListItems::Floats(values) => Cow::Borrowed(&values[..values.len().min(limit)]),
+        ListItems::Ints(values) => Cow::Owned(
+            values
+                .iter()
+                .take(limit)
+                .map(|value| *value as f64)
+                .collect(),
+        ),
+        ListItems::Values(items) => Cow::Owned(items.iter().take(limit).map(number_of).collect()),
+    }
+}
+
+/// Runs `kernel` on up to `limit` numbers of a list, holding the read lock
+/// so float lists need no copy. `kernel` must not touch the list table.
+fn with_floats<T>(handle: u64, limit: usize, kernel: impl FnOnce(&[f64]) -> T) -> T {
+    let lists = LISTS.read();
+    kernel(&float_slice(&lists, handle, limit))
+}
+
+/// [`with_floats`] for two lists, read under one lock.
+fn with_float_pair<T>(a: u64, b: u64, kernel: impl FnOnce(&[f64], &[f64]) -> T) -> T {
+    let lists = LISTS.read();
+    kernel(
+        &float_slice(&lists, a, usize::MAX),
+        &float_slice(&lists, b, usize::MAX),
+    )
+}
+
+/// Clamps an Otter length argument; negative lengths select nothing.
+fn limit(len: i64) -> usize {
+    usize::try_from(len).unwrap_or(0)
+}
+
+fn mean_of(values: &[f64]) -> f64 {
+    if values.is_empty() {
+        return 0.0;
+    }
+    sum(values) / values.len() as f64
+}
+
+fn std_of(values: &[f64]) -> f64 {
+    if values.is_empty() {
+        return 0.0;
+    }
+    let mean = mean_of(values);
+    libm::sqrt(squared_deviation(values, mean) / values.len() as f64)
+}
+
+/// Borrows a raw `f64` buffer, treating null or non-positive lengths as empty.
+///
+/// # Safety
+///
+/// `arr` must be valid for reads of `len` doubles when non-null.
+unsafe fn raw_slice<'a>(arr: *const f64, len: i64) -> &'a [f64] {
+    if arr.is_null() || len <= 0 {
+        return &[];
+    }
+    // SAFETY: guaranteed by the caller.
+    unsafe { std::slice::from_raw_parts(arr, len as usize) }
+}
+
+// ============================================================================
+// Raw buffer entry points
+// ============================================================================
+
+/// returns the mean of the contents in a slice
+///
+/// # Safety
+///
+/// this function dereferences a raw pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn otter_std_math_mean(arr: *const f64, len: i64) -> f64 {
+    mean_of(unsafe { raw_slice(arr, len) })
+}
+
+/// gets the population standard deviation of the elements in a slice
+///
+/// # Safety
+///
+/// this function dereferences a raw pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn otter_std_math_std(arr: *const f64, len: i64) -> f64 {
+    std_of(unsafe { raw_slice(arr, len) })
+}
+
+/// sums all of the elements in a slice
+///
+/// # Safety
+///
+/// this function dereferences a raw pointer
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn otter_std_math_sum(arr: *const f64, len: i64) -> f64 {
+    sum(unsafe { raw_slice(arr, len) })
+}
+
+// ============================================================================
+// List entry points
+// ============================================================================
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_list_mean(list: u64, len: i64) -> f64 {
+    with_floats(list, limit(len), mean_of)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_list_std(list: u64, len: i64) -> f64 {
+    with_floats(list, limit(len), std_of)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_list_sum(list: u64, len: i64) -> f64 {
+    with_floats(list, limit(len), sum)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_dot(a: u64, b: u64) -> f64 {
+    with_float_pair(a, b, dot)
+}
+
+/// `alpha * x + y` elementwise, truncated to the shorter list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_axpy(alpha: f64, x: u64, y: u64) -> u64 {
+    // The result is built after the read lock is released.
+    let values = with_float_pair(x, y, |x, y| axpy(alpha, x, y));
+    Numbers::Float(values).into_list()
+}
+
+/// Smallest element; `inf` for an empty list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_list_min(list: u64) -> f64 {
+    with_floats(list, usize::MAX, min)
+}
+
+/// Largest element; `-inf` for an empty list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_list_max(list: u64) -> f64 {
+    with_floats(list, usize::MAX, max)
+}
+
+/// Index of the first smallest element, or -1 for an empty list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_argmin(list: u64) -> i64 {
+    with_floats(list, usize::MAX, |values| {
+        let target = min(values);
+        values
+            .iter()
+            .position(|value| *value == target)
+            .map_or(-1, |index| index as i64)
+    })
+}
+
+/// Index of the first largest element, or -1 for an empty list.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_argmax(list: u64) -> i64 {
+    with_floats(list, usize::MAX, |values| {
+        let target = max(values);
+        values
+            .iter()
+            .position(|value| *value == target)
+            .map_or(-1, |index| index as i64)
+    })
+}
+
+/// Running totals; integer lists stay integer.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_cumsum(list: u64) -> u64 {
+    match snapshot(list, usize::MAX) {
+        Numbers::Int(mut values) => {
+            let mut total = 0i64;
+            for value in &mut values {
+                total = total.wrapping_add(*value);
+                *value = total;
+            }
+            Numbers::Int(values).into_list()
+        }
+        Numbers::Float(mut values) => {
+            let mut total = 0.0;
+            for value in &mut values {
+                total += *value;
+                *value = total;
+            }
+            Numbers::Float(values).into_list()
+        }
+    }
+}
+
+/// Sorted copy of a list; floats use IEEE total order, so NaNs sort last.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_sorted(list: u64) -> u64 {
+    match snapshot(list, usize::MAX) {
+        Numbers::Int(mut values) => {
+            values.sort_unstable();
+            Numbers::Int(values).into_list()
+        }
+        Numbers::Float(mut values) => {
+            values.sort_unstable_by(f64::total_cmp);
+            Numbers::Float(values).into_list()
+        }
+    }
+}
+
+/// Counts of values in `bins` equal-width buckets over `[lo, hi]`. Values
+/// outside the range and NaNs are ignored.
+#[unsafe(no_mangle)]
+pub extern "C" fn otter_std_math_histogram(list: u64, bins: i64, lo: f64, hi: f64) -> u64 {
+    let bins = limit(bins);
+    let mut counts = vec![0i64; bins];
+    if bins > 0 && hi > lo {
+        let scale = bins as f64 / (hi - lo);
+        with_floats(list, usize::MAX, |values| {
+            for &value in values {
+                if (lo..=hi).contains(&value) {
+                    let bucket = (((value - lo) * scale) as usize).min(bins - 1);
+                    counts[bucket] += 1;
+                }
+            }
+        });
+    }
+    Numbers::Int(counts).into_list()
+}
+
+fn register_std_math_vector_symbols(registry: &SymbolRegistry) {
+    registry.register(FfiFunction {
+        name: "math.mean".into(),
+        symbol: "otter_std_math_list_mean".into(),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.std".into(),
+        symbol: "otter_std_math_list_std".into(),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.sum".into(),
+        symbol: "otter_std_math_list_sum".into(),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::I64], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.dot".into(),
+        symbol: "otter_std_math_dot".into(),
+        signature: FfiSignature::new(vec![FfiType::List, FfiType::List], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.axpy".into(),
+        symbol: "otter_std_math_axpy".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::F64, FfiType::List, FfiType::List],
+            FfiType::List,
+        ),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.list_min".into(),
+        symbol: "otter_std_math_list_min".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.list_max".into(),
+        symbol: "otter_std_math_list_max".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::F64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.argmin".into(),
+        symbol: "otter_std_math_argmin".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.argmax".into(),
+        symbol: "otter_std_math_argmax".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::I64),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.cumsum".into(),
+        symbol: "otter_std_math_cumsum".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::List),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.sorted".into(),
+        symbol: "otter_std_math_sorted".into(),
+        signature: FfiSignature::new(vec![FfiType::List], FfiType::List),
+    });
+
+    registry.register(FfiFunction {
+        name: "math.histogram".into(),
+        symbol: "otter_std_math_histogram".into(),
+        signature: FfiSignature::new(
+            vec![FfiType::List, FfiType::I64, FfiType::F64, FfiType::F64],
+            FfiType::List,
+        ),
+    });
+}
+
+inventory::submit! {
+    otterc_ffi::SymbolProvider {
+        namespace: "math",
+        autoload: false,
+        register: register_std_math_vector_symbols,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::stdlib::builtins::list_from_values;
+
+    #[test]
+    fn pairwise_sum_matches_exact_total() {
+        let values: Vec<f64> = (1..=10_000).map(f64::from).collect();
+        assert_eq!(sum(&values), 50_005_000.0);
+        assert_eq!(sum(&[]), 0.0);
+        assert_eq!(portable::sum(&values), sum(&values));
+    }
+
+    #[test]
+    fn dot_and_extrema_cover_the_tail() {
+        let a: Vec<f64> = (0..19).map(f64::from).collect();
+        let b = vec![2.0; 19];
+        assert_eq!(dot(&a, &b), 342.0);
+        assert_eq!(min(&a), 0.0);
+        assert_eq!(max(&a), 18.0);
+        assert_eq!(axpy(2.0, &a[..3], &b[..3]), vec![2.0, 4.0, 6.0]);
+    }
+
+    #[test]
+    fn std_is_population_deviation() {
+        let values = [2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0];
+        assert_eq!(mean_of(&values), 5.0);
+        assert_eq!(std_of(&values), 2.0);
+    }
+
+    #[test]
+    fn list_kernels_keep_integer_lists_integer() {
+        let list = list_from_values(vec![Value::I64(3), Value::I64(1), Value::I64(2)]);
+        let sorted = otter_std_math_sorted(list);
+        let cumsum = otter_std_math_cumsum(sorted);
+        let lists = LISTS.read();
+        let items: Vec<i64> = lists[&cumsum]
+            .items
+            .values()
+            .iter()
+            .filter_map(|item| match item {
+                Value::I64(value) => Some(*value),
+                _ => None,
+            })
+            .collect();
+        assert_eq!(items, vec![1, 3, 6]);
+        drop(lists);
+        assert_eq!(otter_std_math_argmax(list), 0);
+        assert_eq!(otter_std_math_list_sum(list, 2), 4.0);
+    }
+
+    #[test]
+    fn float_lists_are_borrowed_in_place() {
+        let list = list_from_values(vec![Value::F64(1.0), Value::F64(2.5), Value::F64(-4.0)]);
+        let stored = match &LISTS.read()[&list].items {
+            ListItems::Floats(values) => values.as_ptr(),
+            _ => std::ptr::null(),
+        };
+        assert!(!stored.is_null());
+        assert_eq!(with_floats(list, usize::MAX, <[f64]>::as_ptr), stored);
+        assert_eq!(otter_std_math_list_sum(list, 2), 3.5);
+        assert_eq!(otter_std_math_argmin(list), 2);
+        assert_eq!(otter_std_math_dot(list, list), 23.25);
+    }
+}
@@ -2,7 +2,7 @@ use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
 
 use crate::memory::gc::{ObjectKind, get_gc};
-use otterc_symbol::registry::{FfiFunction, FfiSignature, FfiType, SymbolRegistry};
+use otterc_symbol::registry::{FfiEffects, FfiFunction, FfiSignature, FfiType, SymbolRegistry};
 
 /// Format a float value to string
 #[unsafe(no_mangle)]
@@ -181,25 +181,29 @@ fn register_string_functions(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "std.strings.format_float".into(),
         symbol: "otter_format_float".into(),
-        signature: FfiSignature::new(vec![FfiType::F64], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::F64], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES_TRACKED),
     });
 
     registry.register(FfiFunction {
         name: "std.strings.format_int".into(),
         symbol: "otter_format_int".into(),
-        signature: FfiSignature::new(vec![FfiType::I64], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::I64], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES_TRACKED),
     });
 
     registry.register(FfiFunction {
         name: "std.strings.format_bool".into(),
         symbol: "otter_format_bool".into(),
-        signature: FfiSignature::new(vec![FfiType::Bool], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::Bool], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES_TRACKED),
     });
 
     registry.register(FfiFunction {
         name: "std.strings.concat".into(),
         symbol: "otter_str_concat".into(),
-        signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES_TRACKED),
     });
 
     registry.register(FfiFunction {
@@ -211,19 +215,22 @@ fn register_string_functions(registry: &SymbolRegistry) {
     registry.register(FfiFunction {
         name: "std.strings.validate_utf8".into(),
         symbol: "otter_validate_utf8".into(),
-        signature: FfiSignature::new(vec![FfiType::Str], FfiType::I32),
+        signature: FfiSignature::new(vec![FfiType::Str], FfiType::I32)
+            .with_effects(FfiEffects::READS_ARGS),
     });
 
     registry.register(FfiFunction {
         name: "std.strings.from_literal".into(),
         symbol: "otter_string_from_literal".into(),
-        signature: FfiSignature::new(vec![FfiType::Str], FfiType::Str),
+        signature: FfiSignature::new(vec![FfiType::Str], FfiType::Str)
+            .with_effects(FfiEffects::ALLOCATES_TRACKED),
     });
 
     registry.register(FfiFunction {
         name: "std.strings.equal".into(),
         symbol: "otter_string_equal".into(),
-        signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::I32),
+        signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::I32)
+            .with_effects(FfiEffects::READS_ARGS),
     });
 }
 
@@ -0,0 +1,337 @@
+//! Structured task groups.
+//!
+//! A [`TaskGroup`] owns the children spawned through it. All children share
+//! the group's cancellation token, so cancelling the group is a single store.
+//! Completion is tracked by one atomic counter of outstanding children: the
+//! child that brings it to zero performs the wakeup `wait` is blocked on,
+//! rather than the waiter joining every child in turn. Dropping a group
+//! cancels whatever has not started and waits for the rest, so no child
+//! outlives the scope that created it.
+//!
+//! A child that panics counts as failed; the panic stays inside the child
+//! and does not take the worker thread down with it.
+
+use parking_lot::{Condvar, Mutex};
+use std::cell::Cell;
+use std::panic::{AssertUnwindSafe, catch_unwind};
+use std::sync::Arc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use super::metrics::TaskRuntimeMetrics;
+use super::scheduler::TaskScheduler;
+use super::task_impl::CancellationToken;
+
+/// Marker stored in `first` until a child finishes.
+const NONE_FINISHED: usize = usize::MAX;
+
+thread_local! {
+    /// Address of the `GroupState` whose child is running on this thread, or
+    /// zero. Lets a group notice that it is being waited on by its own child.
+    static CURRENT_GROUP: Cell<usize> = const { Cell::new(0) };
+}
+
+#[derive(Debug)]
+pub struct TaskGroup {
+    scheduler: TaskScheduler,
+    state: Arc<GroupState>,
+}
+
+#[derive(Debug)]
+struct GroupState {
+    token: CancellationToken,
+    /// Children spawned so far; the next child's index.
+    spawned: AtomicUsize,
+    /// Children that have not finished yet.
+    pending: AtomicUsize,
+    /// Index of the first child to finish.
+    first: AtomicUsize,
+    /// Children whose body panicked.
+    failed: AtomicUsize,
+    lock: Mutex<()>,
+    condvar: Condvar,
+    metrics: Arc<TaskRuntimeMetrics>,
+}
+
+impl GroupState {
+    fn finish(&self, index: usize, progress: ChildProgress) {
+        match progress {
+            ChildProgress::Queued => self.metrics.record_group_task_cancelled(),
+            ChildProgress::Failed => {
+                self.failed.fetch_add(1, Ordering::Relaxed);
+                self.metrics.record_group_task_failed();
+            }
+            ChildProgress::Finished => {}
+        }
+        let first = self
+            .first
+            .compare_exchange(NONE_FINISHED, index, Ordering::AcqRel, Ordering::Acquire)
+            .is_ok();
+        let last = self.pending.fetch_sub(1, Ordering::AcqRel) == 1;
+        if first || last {
+            // Taking the lock orders the notification after any waiter's
+            // check of the counters.
+            let _guard = self.lock.lock();
+            self.condvar.notify_all();
+        }
+    }
+
+    fn wait_for(&self, done: impl Fn() -> bool) {
+        let mut guard = self.lock.lock();
+        while !done() {
+            self.condvar.wait(&mut guard);
+        }
+    }
+
+    fn is_idle(&self) -> bool {
+        self.pending.load(Ordering::Acquire) == 0
+    }
+}
+
+/// How far a child got before its guard was dropped.
+#[derive(Clone, Copy)]
+enum ChildProgress {
+    /// Discarded unrun after the group was cancelled.
+    Queued,
+    Finished,
+    /// The body panicked.
+    Failed,
+}
+
+/// Reports a child's completion when dropped, which happens both after the
+/// child runs and when the scheduler discards it unrun after cancellation.
+struct ChildGuard {
+    state: Arc<GroupState>,
+    index: usize,
+    progress: ChildProgress,
+}
+
+impl Drop for ChildGuard {
+    fn drop(&mut self) {
+        self.state.finish(self.index, self.progress);
+    }
+}
+
+impl TaskGroup {
+    pub fn new(scheduler: TaskScheduler) -> Self {
+        let metrics = scheduler.metrics();
+        metrics.record_group_created();
+        Self {
+            scheduler,
+            state: Arc::new(GroupState {
+                token: CancellationToken::new(),
+                spawned: AtomicUsize::new(0),
+                pending: AtomicUsize::new(0),
+                first: AtomicUsize::new(NONE_FINISHED),
+                failed: AtomicUsize::new(0),
+                lock: Mutex::new(()),
+                condvar: Condvar::new(),
+                metrics,
+            }),
+        }
+    }
+
+    /// Spawns a child and returns its index within the group. Children
+    /// spawned after the group is cancelled never run.
+    pub fn spawn<F>(&self, func: F) -> usize
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        let index = self.state.spawned.fetch_add(1, Ordering::Relaxed);
+        self.state.pending.fetch_add(1, Ordering::AcqRel);
+        self.state.metrics.record_group_task();
+        let guard = ChildGuard {
+            state: Arc::clone(&self.state),
+            index,
+            progress: ChildProgress::Queued,
+        };
+        let group = self.id();
+        self.scheduler.spawn_with_token(
+            Some("task.group".into()),
+            self.state.token.clone(),
+            move || {
+                // Rebind so the closure owns the whole guard, not just
+                // `progress`.
+                let mut guard = guard;
+                let outer = CURRENT_GROUP.with(|current| current.replace(group));
+                let result = catch_unwind(AssertUnwindSafe(func));
+                CURRENT_GROUP.with(|current| current.set(outer));
+                guard.progress = match result {
+                    Ok(()) => ChildProgress::Finished,
+                    Err(_) => ChildProgress::Failed,
+                };
+            },
+        );
+        index
+    }
+
+    fn id(&self) -> usize {
+        Arc::as_ptr(&self.state) as usize
+    }
+
+    /// Whether the caller is running as one of this group's children. Such a
+    /// caller must not wait for the group, since it would wait for itself.
+    pub fn is_current_child(&self) -> bool {
+        CURRENT_GROUP.with(Cell::get) == self.id()
+    }
+
+    /// Blocks until every child spawned so far has finished. The caller
+    /// blocks even on a worker thread, like `JoinHandle::join`: children are
+    /// ordinary tasks and may block themselves, so they are never run inline.
+    pub fn wait(&self) {
+        self.state.wait_for(|| self.state.is_idle());
+    }
+
+    /// Blocks until any child finishes and returns its index, or `None` if
+    /// the group has no children.
+    pub fn wait_any(&self) -> Option<usize> {
+        if self.state.spawned.load(Ordering::Acquire) == 0 {
+            return None;
+        }
+        self.state
+            .wait_for(|| self.state.first.load(Ordering::Acquire) != NONE_FINISHED);
+        Some(self.state.first.load(Ordering::Acquire))
+    }
+
+    /// Cancels every child that has not started yet, including ones spawned
+    /// later. Running children observe it through `is_cancelled`.
+    pub fn cancel(&self) {
+        self.state.token.cancel();
+    }
+
+    pub fn is_cancelled(&self) -> bool {
+        self.state.token.is_cancelled()
+    }
+
+    /// Number of children that have not finished.
+    pub fn pending(&self) -> usize {
+        self.state.pending.load(Ordering::Acquire)
+    }
+
+    /// Number of children whose body panicked.
+    pub fn failed(&self) -> usize {
+        self.state.failed.load(Ordering::Acquire)
+    }
+}
+
+impl Drop for TaskGroup {
+    fn drop(&mut self) {
+        if !self.state.is_idle() {
+            self.cancel();
+            // A child holding the last handle cannot wait for itself; the
+            // other children still report to the shared state as they finish.
+            if !self.is_current_child() {
+                self.wait();
+            }
+        }
+        self.state.metrics.record_group_closed();
+    }
+}
+
+impl TaskScheduler {
+    /// Creates an empty task group whose children run on this scheduler.
+    pub fn group(&self) -> TaskGroup {
+        TaskGroup::new(self.clone())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::task::SchedulerConfig;
+    use std::sync::atomic::AtomicBool;
+    use std::time::Duration;
+
+    #[test]
+    fn wait_covers_every_child() {
+        let scheduler = TaskScheduler::new(SchedulerConfig::default());
+        let group = scheduler.group();
+        let done = Arc::new(AtomicUsize::new(0));
+        for _ in 0..64 {
+            let done = Arc::clone(&done);
+            group.spawn(move || {
+                done.fetch_add(1, Ordering::Relaxed);
+            });
+        }
+        group.wait();
+        assert_eq!(done.load(Ordering::Relaxed), 64);
+        assert_eq!(group.pending(), 0);
+        assert_eq!(scheduler.metrics().snapshot().group_tasks, 64);
+    }
+
+    #[test]
+    fn wait_any_returns_first_finisher_and_cancel_skips_the_rest() {
+        let scheduler = TaskScheduler::new(SchedulerConfig { max_workers: 2 });
+        let group = scheduler.group();
+        let started = Arc::new(AtomicBool::new(false));
+        let release = Arc::new(AtomicBool::new(false));
+        let (running, blocker) = (Arc::clone(&started), Arc::clone(&release));
+        group.spawn(move || {
+            running.store(true, Ordering::Release);
+            while !blocker.load(Ordering::Acquire) {
+                std::thread::sleep(Duration::from_millis(1));
+            }
+        });
+        while !started.load(Ordering::Acquire) {
+            std::thread::sleep(Duration::from_millis(1));
+        }
+        let ran = Arc::new(AtomicBool::new(false));
+        let flag = Arc::clone(&ran);
+        group.cancel();
+        group.spawn(move || flag.store(true, Ordering::Release));
+        assert_eq!(group.wait_any(), Some(1));
+        release.store(true, Ordering::Release);
+        group.wait();
+        assert!(!ran.load(Ordering::Acquire));
+        assert_eq!(scheduler.metrics().snapshot().group_tasks_cancelled, 1);
+    }
+
+    #[test]
+    fn panicking_child_counts_as_failed_not_cancelled() {
+        let scheduler = TaskScheduler::new(SchedulerConfig { max_workers: 1 });
+        let group = scheduler.group();
+        // `resume_unwind` panics without running the panic hook.
+        group.spawn(|| std::panic::resume_unwind(Box::new("child failed")));
+        group.wait();
+        // The single worker survived the panic and still runs children.
+        let done = Arc::new(AtomicBool::new(false));
+        let flag = Arc::clone(&done);
+        group.spawn(move || flag.store(true, Ordering::Release));
+        group.wait();
+
+        assert!(done.load(Ordering::Acquire));
+        assert_eq!(group.failed(), 1);
+        let snapshot = scheduler.metrics().snapshot();
+        assert_eq!(snapshot.group_tasks_failed, 1);
+        assert_eq!(snapshot.group_tasks_cancelled, 0);
+    }
+
+    #[test]
+    fn children_know_their_group_and_may_drop_its_last_handle() {
+        let scheduler = TaskScheduler::new(SchedulerConfig { max_workers: 2 });
+        let group = Arc::new(scheduler.group());
+        let other = scheduler.group();
+        assert!(!group.is_current_child());
+
+        let (sender, receiver) = std::sync::mpsc::channel();
+        let (handle, owner_dropped) = (Arc::clone(&group), Arc::new(AtomicBool::new(false)));
+        let released = Arc::clone(&owner_dropped);
+        let outsider = Arc::new(other);
+        let probe = Arc::clone(&outsider);
+        group.spawn(move || {
+            let own = handle.is_current_child();
+            let foreign = probe.is_current_child();
+            while !released.load(Ordering::Acquire) {
+                std::thread::sleep(Duration::from_millis(1));
+            }
+            // Dropping the last handle from inside must not wait for itself.
+            drop(handle);
+            sender.send((own, foreign)).unwrap();
+        });
+        drop(group);
+        owner_dropped.store(true, Ordering::Release);
+
+        let (own, foreign) = receiver.recv_timeout(Duration::from_secs(5)).unwrap();
+        assert!(own);
+        assert!(!foreign);
+    }
+}
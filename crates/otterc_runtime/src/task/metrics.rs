@@ -1,7 +1,20 @@
+//! Task runtime metrics.
+//!
+//! Counters that only workers update live in a cache-line-padded
+//! [`WorkerCounters`] per worker. Each worker writes its own block with
+//! relaxed stores and no other thread writes it, so recording a task costs no
+//! contended cache traffic. Totals are summed only when [`snapshot`] is
+//! called. Events that can come from any thread (spawns from outside the
+//! pool, channel activity, task groups) stay as shared atomics.
+//!
+//! [`snapshot`]: TaskRuntimeMetrics::snapshot
+
+use crossbeam_utils::CachePadded;
 use parking_lot::RwLock;
 use std::cmp::max;
 use std::sync::Arc;
-use std::sync::atomic::{AtomicI64, AtomicU64, Ordering};
+use std::sync::atomic::{AtomicI64, AtomicU8, AtomicU64, AtomicUsize, Ordering};
+use std::time::Duration;
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum WorkerState {
@@ -10,6 +23,16 @@ pub enum WorkerState {
     Parked,
 }
 
+impl WorkerState {
+    fn from_u8(raw: u8) -> Self {
+        match raw {
+            1 => WorkerState::Busy,
+            2 => WorkerState::Parked,
+            _ => WorkerState::Idle,
+        }
+    }
+}
+
 #[derive(Debug, Clone)]
 pub struct WorkerInfo {
     pub id: usize,
@@ -18,17 +41,174 @@ pub struct WorkerInfo {
     pub tasks_processed: u64,
 }
 
+/// Sub-buckets per power of two; values are kept to within 1/8 (12.5%).
+const SUB_BUCKET_BITS: u32 = 3;
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+/// Enough buckets to cover every `u64` nanosecond value.
+const HISTOGRAM_BUCKETS: usize = (64 - SUB_BUCKET_BITS as usize + 1) * SUB_BUCKETS;
+
+/// Bucket holding `value`. Values below `SUB_BUCKETS` get a bucket each;
+/// above that every power of two is split into `SUB_BUCKETS` equal parts.
+fn bucket_index(value: u64) -> usize {
+    if value < SUB_BUCKETS as u64 {
+        return value as usize;
+    }
+    let shift = 63 - value.leading_zeros() - SUB_BUCKET_BITS;
+    let sub = (value >> shift) as usize & (SUB_BUCKETS - 1);
+    (shift as usize + 1) * SUB_BUCKETS + sub
+}
+
+/// Smallest value that falls into bucket `index`.
+fn bucket_floor(index: usize) -> u64 {
+    if index < SUB_BUCKETS {
+        return index as u64;
+    }
+    let shift = index / SUB_BUCKETS - 1;
+    ((SUB_BUCKETS + index % SUB_BUCKETS) as u64) << shift
+}
+
+/// Log-linear (HDR-style) histogram of nanosecond durations.
+#[derive(Debug)]
+pub struct LatencyHistogram {
+    buckets: Box<[AtomicU64]>,
+    sum: AtomicU64,
+    max: AtomicU64,
+}
+
+impl LatencyHistogram {
+    pub fn new() -> Self {
+        Self {
+            buckets: (0..HISTOGRAM_BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            sum: AtomicU64::new(0),
+            max: AtomicU64::new(0),
+        }
+    }
+
+    pub fn record(&self, duration: Duration) {
+        let nanos = u64::try_from(duration.as_nanos()).unwrap_or(u64::MAX);
+        self.buckets[bucket_index(nanos)].fetch_add(1, Ordering::Relaxed);
+        self.sum.fetch_add(nanos, Ordering::Relaxed);
+        self.max.fetch_max(nanos, Ordering::Relaxed);
+    }
+
+    fn accumulate(&self, into: &mut LatencySnapshot) {
+        for (total, bucket) in into.buckets.iter_mut().zip(self.buckets.iter()) {
+            let count = bucket.load(Ordering::Relaxed);
+            *total += count;
+            into.count += count;
+        }
+        into.sum_nanos = into
+            .sum_nanos
+            .saturating_add(self.sum.load(Ordering::Relaxed));
+        into.max_nanos = into.max_nanos.max(self.max.load(Ordering::Relaxed));
+    }
+}
+
+impl Default for LatencyHistogram {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Aggregated contents of one or more [`LatencyHistogram`]s.
+#[derive(Debug, Clone)]
+pub struct LatencySnapshot {
+    buckets: Vec<u64>,
+    pub count: u64,
+    pub sum_nanos: u64,
+    pub max_nanos: u64,
+}
+
+impl LatencySnapshot {
+    fn empty() -> Self {
+        Self {
+            buckets: vec![0; HISTOGRAM_BUCKETS],
+            count: 0,
+            sum_nanos: 0,
+            max_nanos: 0,
+        }
+    }
+
+    pub fn mean_nanos(&self) -> u64 {
+        self.sum_nanos.checked_div(self.count).unwrap_or(0)
+    }
+
+    /// Value at quantile `q` in `[0, 1]`, reported as the lower bound of the
+    /// bucket that holds it and capped at the observed maximum.
+    pub fn percentile_nanos(&self, q: f64) -> u64 {
+        if self.count == 0 {
+            return 0;
+        }
+        let rank = ((q.clamp(0.0, 1.0) * self.count as f64).ceil() as u64).max(1);
+        let mut seen = 0;
+        for (index, count) in self.buckets.iter().enumerate() {
+            seen += count;
+            if seen >= rank {
+                return bucket_floor(index).min(self.max_nanos);
+            }
+        }
+        self.max_nanos
+    }
+}
+
+/// Counters owned by one worker thread.
+#[derive(Debug, Default)]
+pub struct WorkerCounters {
+    state: AtomicU8,
+    queue_depth: AtomicUsize,
+    tasks_processed: AtomicU64,
+    spawned: AtomicU64,
+    completed: AtomicU64,
+    queue_wait: LatencyHistogram,
+    run_time: LatencyHistogram,
+}
+
+impl WorkerCounters {
+    pub fn update(&self, state: WorkerState, queue_depth: usize) {
+        self.state.store(state as u8, Ordering::Relaxed);
+        self.queue_depth.store(queue_depth, Ordering::Relaxed);
+    }
+
+    pub fn record_spawn(&self) {
+        self.spawned.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records a task that ran after waiting `queue_wait` to be picked up.
+    pub fn record_task(&self, queue_wait: Duration, run_time: Duration) {
+        self.tasks_processed.fetch_add(1, Ordering::Relaxed);
+        self.queue_wait.record(queue_wait);
+        self.run_time.record(run_time);
+    }
+
+    pub fn record_completion(&self) {
+        self.completed.fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn info(&self, id: usize) -> WorkerInfo {
+        WorkerInfo {
+            id,
+            state: WorkerState::from_u8(self.state.load(Ordering::Relaxed)),
+            queue_depth: self.queue_depth.load(Ordering::Relaxed),
+            tasks_processed: self.tasks_processed.load(Ordering::Relaxed),
+        }
+    }
+}
+
 #[derive(Debug, Default)]
 pub struct TaskRuntimeMetrics {
     spawned: AtomicU64,
     completed: AtomicU64,
-    waiting: AtomicI64,
     channels: AtomicU64,
     channel_waiters: AtomicI64,
     channel_backlog: AtomicI64,
-    worker_infos: RwLock<Vec<WorkerInfo>>,
+    workers: RwLock<Vec<Arc<CachePadded<WorkerCounters>>>>,
     active_workers: AtomicU64,
     total_workers: AtomicU64,
+    groups_created: AtomicU64,
+    groups_active: AtomicI64,
+    group_tasks: AtomicU64,
+    group_tasks_cancelled: AtomicU64,
+    group_tasks_failed: AtomicU64,
 }
 
 impl TaskRuntimeMetrics {
@@ -36,20 +216,27 @@ impl TaskRuntimeMetrics {
         Arc::new(Self::default())
     }
 
+    /// Counter block for worker `index`, created on first request. Workers
+    /// fetch it once at startup and then write to it directly.
+    pub fn worker(&self, index: usize) -> Arc<CachePadded<WorkerCounters>> {
+        if let Some(counters) = self.workers.read().get(index) {
+            return Arc::clone(counters);
+        }
+        let mut workers = self.workers.write();
+        while workers.len() <= index {
+            workers.push(Arc::default());
+        }
+        Arc::clone(&workers[index])
+    }
+
+    /// Records a spawn from a thread that is not a worker.
     pub fn record_spawn(&self) {
         self.spawned.fetch_add(1, Ordering::Relaxed);
-        self.waiting.fetch_add(1, Ordering::Relaxed);
     }
 
+    /// Records a completion from a thread that is not a worker.
     pub fn record_completion(&self) {
         self.completed.fetch_add(1, Ordering::Relaxed);
-        self.waiting.fetch_sub(1, Ordering::Relaxed);
-    }
-
-    pub fn record_waiting_delta(&self, delta: i64) {
-        if delta != 0 {
-            self.waiting.fetch_add(delta, Ordering::Relaxed);
-        }
     }
 
     pub fn register_channel(&self) {
@@ -68,50 +255,65 @@ impl TaskRuntimeMetrics {
         }
     }
 
+    pub fn record_group_created(&self) {
+        self.groups_created.fetch_add(1, Ordering::Relaxed);
+        self.groups_active.fetch_add(1, Ordering::Relaxed);
+    }
+
+    pub fn record_group_closed(&self) {
+        self.groups_active.fetch_sub(1, Ordering::Relaxed);
+    }
+
+    pub fn record_group_task(&self) {
+        self.group_tasks.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// A group child that was cancelled before it started running.
+    pub fn record_group_task_cancelled(&self) {
+        self.group_tasks_cancelled.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// A group child whose body panicked.
+    pub fn record_group_task_failed(&self) {
+        self.group_tasks_failed.fetch_add(1, Ordering::Relaxed);
+    }
+
     pub fn snapshot(&self) -> TaskMetricsSnapshot {
-        let worker_infos = self.worker_infos.read().clone();
+        let mut spawned = self.spawned.load(Ordering::Relaxed);
+        let mut completed = self.completed.load(Ordering::Relaxed);
+        let mut queue_wait = LatencySnapshot::empty();
+        let mut run_time = LatencySnapshot::empty();
+        let workers = self.workers.read();
+        let mut worker_infos = Vec::with_capacity(workers.len());
+        for (id, counters) in workers.iter().enumerate() {
+            spawned += counters.spawned.load(Ordering::Relaxed);
+            completed += counters.completed.load(Ordering::Relaxed);
+            counters.queue_wait.accumulate(&mut queue_wait);
+            counters.run_time.accumulate(&mut run_time);
+            worker_infos.push(counters.info(id));
+        }
+        drop(workers);
+
         TaskMetricsSnapshot {
-            tasks_spawned: self.spawned.load(Ordering::Relaxed),
-            tasks_completed: self.completed.load(Ordering::Relaxed),
-            tasks_waiting: max(self.waiting.load(Ordering::Relaxed), 0) as u64,
+            tasks_spawned: spawned,
+            tasks_completed: completed,
+            tasks_waiting: spawned.saturating_sub(completed),
             channels_registered: self.channels.load(Ordering::Relaxed),
             channel_waiters: max(self.channel_waiters.load(Ordering::Relaxed), 0) as u64,
             channel_backlog: max(self.channel_backlog.load(Ordering::Relaxed), 0) as u64,
             active_workers: self.active_workers.load(Ordering::Relaxed),
             total_workers: self.total_workers.load(Ordering::Relaxed),
+            groups_created: self.groups_created.load(Ordering::Relaxed),
+            groups_active: max(self.groups_active.load(Ordering::Relaxed), 0) as u64,
+            group_tasks: self.group_tasks.load(Ordering::Relaxed),
+            group_tasks_cancelled: self.group_tasks_cancelled.load(Ordering::Relaxed),
+            group_tasks_failed: self.group_tasks_failed.load(Ordering::Relaxed),
+            queue_wait,
+            run_time,
             worker_infos,
         }
     }
 
-    pub fn update_worker_info(&self, worker_id: usize, state: WorkerState, queue_depth: usize) {
-        let mut infos = self.worker_infos.write();
-        let current_len = infos.len();
-        if worker_id < current_len {
-            infos[worker_id].state = state;
-            infos[worker_id].queue_depth = queue_depth;
-        } else {
-            // Grow vector if needed
-            while infos.len() <= worker_id {
-                let new_id = infos.len();
-                infos.push(WorkerInfo {
-                    id: new_id,
-                    state: WorkerState::Idle,
-                    queue_depth: 0,
-                    tasks_processed: 0,
-                });
-            }
-            infos[worker_id].state = state;
-            infos[worker_id].queue_depth = queue_depth;
-        }
-    }
-
-    pub fn record_worker_task(&self, worker_id: usize) {
-        let mut infos = self.worker_infos.write();
-        if worker_id < infos.len() {
-            infos[worker_id].tasks_processed += 1;
-        }
-    }
-
     pub fn set_total_workers(&self, count: usize) {
         self.total_workers.store(count as u64, Ordering::Relaxed);
     }
@@ -121,11 +323,20 @@ impl TaskRuntimeMetrics {
     }
 
     pub fn get_worker_infos(&self) -> Vec<WorkerInfo> {
-        self.worker_infos.read().clone()
+        self.workers
+            .read()
+            .iter()
+            .enumerate()
+            .map(|(id, counters)| counters.info(id))
+            .collect()
     }
 
     pub fn get_total_queue_depth(&self) -> usize {
-        self.worker_infos.read().iter().map(|w| w.queue_depth).sum()
+        self.workers
+            .read()
+            .iter()
+            .map(|counters| counters.queue_depth.load(Ordering::Relaxed))
+            .sum()
     }
 }
 
@@ -139,5 +350,59 @@ pub struct TaskMetricsSnapshot {
     pub channel_backlog: u64,
     pub active_workers: u64,
     pub total_workers: u64,
+    pub groups_created: u64,
+    pub groups_active: u64,
+    pub group_tasks: u64,
+    pub group_tasks_cancelled: u64,
+    pub group_tasks_failed: u64,
+    /// Time from task creation until a worker starts running it.
+    pub queue_wait: LatencySnapshot,
+    /// Time spent running task bodies.
+    pub run_time: LatencySnapshot,
     pub worker_infos: Vec<WorkerInfo>,
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn buckets_are_monotonic_and_tight() {
+        let mut previous = 0;
+        for value in (0..20_000u64).chain([1 << 40, u64::MAX]) {
+            let index = bucket_index(value);
+            assert!(index >= previous);
+            assert!(index < HISTOGRAM_BUCKETS);
+            let floor = bucket_floor(index);
+            assert!(floor <= value);
+            assert!(value - floor <= value / SUB_BUCKETS as u64);
+            previous = index;
+        }
+    }
+
+    #[test]
+    fn snapshot_aggregates_workers() {
+        let metrics = TaskRuntimeMetrics::new();
+        metrics.record_spawn();
+        for index in 0..4 {
+            let worker = metrics.worker(index);
+            worker.record_spawn();
+            worker.record_task(
+                Duration::from_micros(10),
+                Duration::from_micros(100 * (index as u64 + 1)),
+            );
+            worker.record_completion();
+        }
+
+        let snapshot = metrics.snapshot();
+        assert_eq!(snapshot.tasks_spawned, 5);
+        assert_eq!(snapshot.tasks_completed, 4);
+        assert_eq!(snapshot.tasks_waiting, 1);
+        assert_eq!(snapshot.worker_infos.len(), 4);
+        assert_eq!(snapshot.run_time.count, 4);
+        assert_eq!(snapshot.run_time.max_nanos, 400_000);
+        let median = snapshot.run_time.percentile_nanos(0.5);
+        assert!((175_000..=200_000).contains(&median));
+        assert_eq!(snapshot.queue_wait.mean_nanos(), 10_000);
+    }
+}
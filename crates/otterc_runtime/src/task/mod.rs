@@ -4,20 +4,26 @@
 //! used by the standard library FFI bindings.
 
 mod channel;
+mod group;
 mod metrics;
+mod parallel;
 mod scheduler;
 mod task_impl;
 mod timer;
 mod tls;
 
 pub use channel::{SelectResult, TaskChannel, TaskMailBox, select2, select2_async};
-pub use metrics::{TaskMetricsSnapshot, TaskRuntimeMetrics, WorkerInfo, WorkerState};
+pub use group::TaskGroup;
+pub use metrics::{
+    LatencyHistogram, LatencySnapshot, TaskMetricsSnapshot, TaskRuntimeMetrics, WorkerCounters,
+    WorkerInfo, WorkerState,
+};
 pub use scheduler::{SchedulerConfig, TaskScheduler};
-pub use task_impl::{CancellationToken, JoinFuture, JoinHandle, Task, TaskFn, TaskId, TaskState};
-pub use timer::TimerWheel;
-pub use tls::{
-    TaskLocalRegistry, TaskLocalStorage, cleanup_task_local_storage, get_task_local_storage,
+pub use task_impl::{
+    CancellationToken, JoinFuture, JoinHandle, Task, TaskFn, TaskId, TaskState, current_task_id,
 };
+pub use timer::TimerWheel;
+pub use tls::{TaskLocalKey, TaskLocalStorage};
 
 use std::sync::Once;
 
@@ -0,0 +1,352 @@
+//! Data-parallel collection operations built on [`TaskScheduler::join`].
+//!
+//! Every operation splits its input in half recursively until a piece is no
+//! larger than the grain size, pushing the upper half where idle workers can
+//! steal it while the caller works through the lower half. The grain adapts
+//! to the input: about [`PIECES_PER_WORKER`] pieces per worker, but never
+//! fewer than [`MIN_GRAIN`] elements, so short inputs stay sequential and do
+//! not pay for task overhead.
+
+use std::cmp::Ordering;
+use std::mem::MaybeUninit;
+use std::ops::Range;
+
+use super::scheduler::TaskScheduler;
+
+/// Smallest piece worth handing to another worker.
+const MIN_GRAIN: usize = 1024;
+/// Pieces created per worker, leaving slack for uneven work.
+const PIECES_PER_WORKER: usize = 8;
+
+impl TaskScheduler {
+    /// Number of elements each leaf task processes for an input of `len`.
+    pub fn grain_size(&self, len: usize) -> usize {
+        let pieces = self.get_worker_count().max(1) * PIECES_PER_WORKER;
+        (len / pieces).max(MIN_GRAIN)
+    }
+
+    /// Calls `func` with every index in `0..len`, in no particular order.
+    pub fn par_for<F>(&self, len: usize, func: F)
+    where
+        F: Fn(usize) + Sync,
+    {
+        let grain = self.grain_size(len);
+        self.install(|| self.for_range(0..len, grain, &func));
+    }
+
+    /// Applies `func` to every element, preserving order.
+    pub fn par_map<T, U, F>(&self, input: &[T], func: F) -> Vec<U>
+    where
+        T: Sync,
+        U: Send,
+        F: Fn(&T) -> U + Sync,
+    {
+        let len = input.len();
+        let grain = self.grain_size(len);
+        let mut output = Vec::with_capacity(len);
+        let slots = &mut output.spare_capacity_mut()[..len];
+        self.install(|| self.map_into(input, slots, grain, &func));
+        // SAFETY: `map_into` wrote every one of the first `len` slots; a
+        // panic would have propagated before reaching this point.
+        unsafe {
+            output.set_len(len);
+        }
+        output
+    }
+
+    /// Keeps the elements for which `pred` holds, preserving order.
+    pub fn par_filter<T, F>(&self, input: &[T], pred: F) -> Vec<T>
+    where
+        T: Clone + Send + Sync,
+        F: Fn(&T) -> bool + Sync,
+    {
+        self.par_fold(
+            input,
+            |chunk| chunk.iter().filter(|item| pred(item)).cloned().collect(),
+            |mut left: Vec<T>, mut right| {
+                left.append(&mut right);
+                left
+            },
+        )
+    }
+
+    /// Combines all elements with `op`, starting every piece from
+    /// `identity`. `op` must be associative and `identity` neutral for it;
+    /// the grouping of operations is unspecified.
+    pub fn par_reduce<T, F>(&self, input: &[T], identity: T, op: F) -> T
+    where
+        T: Copy + Send + Sync,
+        F: Fn(T, T) -> T + Sync,
+    {
+        self.par_fold(
+            input,
+            |chunk| chunk.iter().fold(identity, |acc, &item| op(acc, item)),
+            &op,
+        )
+    }
+
+    /// Folds each piece with `leaf` and merges neighbouring results with
+    /// `combine`, left before right.
+    pub fn par_fold<T, R, L, C>(&self, input: &[T], leaf: L, combine: C) -> R
+    where
+        T: Sync,
+        R: Send,
+        L: Fn(&[T]) -> R + Sync,
+        C: Fn(R, R) -> R + Sync,
+    {
+        let grain = self.grain_size(input.len());
+        self.install(|| self.fold_slice(input, grain, &leaf, &combine))
+    }
+
+    /// Stable parallel merge sort.
+    pub fn par_sort_by<T, C>(&self, data: &mut [T], compare: C)
+    where
+        T: Copy + Send + Sync,
+        C: Fn(&T, &T) -> Ordering + Sync,
+    {
+        let grain = self.grain_size(data.len());
+        if data.len() <= grain {
+            data.sort_by(compare);
+            return;
+        }
+        let mut scratch = data.to_vec();
+        self.install(|| self.sort_slice(data, &mut scratch, grain, &compare));
+    }
+
+    fn for_range<F>(&self, range: Range<usize>, grain: usize, func: &F)
+    where
+        F: Fn(usize) + Sync,
+    {
+        if range.len() <= grain {
+            range.for_each(func);
+            return;
+        }
+        let mid = range.start + range.len() / 2;
+        self.join(
+            || self.for_range(range.start..mid, grain, func),
+            || self.for_range(mid..range.end, grain, func),
+        );
+    }
+
+    fn map_into<T, U, F>(&self, input: &[T], output: &mut [MaybeUninit<U>], grain: usize, func: &F)
+    where
+        T: Sync,
+        U: Send,
+        F: Fn(&T) -> U + Sync,
+    {
+        if input.len() <= grain {
+            for (slot, item) in output.iter_mut().zip(input) {
+                slot.write(func(item));
+            }
+            return;
+        }
+        let mid = input.len() / 2;
+        let (input_left, input_right) = input.split_at(mid);
+        let (output_left, output_right) = output.split_at_mut(mid);
+        self.join(
+            || self.map_into(input_left, output_left, grain, func),
+            || self.map_into(input_right, output_right, grain, func),
+        );
+    }
+
+    fn fold_slice<T, R, L, C>(&self, input: &[T], grain: usize, leaf: &L, combine: &C) -> R
+    where
+        T: Sync,
+        R: Send,
+        L: Fn(&[T]) -> R + Sync,
+        C: Fn(R, R) -> R + Sync,
+    {
+        if input.len() <= grain {
+            return leaf(input);
+        }
+        let (left, right) = input.split_at(input.len() / 2);
+        let (left, right) = self.join(
+            || self.fold_slice(left, grain, leaf, combine),
+            || self.fold_slice(right, grain, leaf, combine),
+        );
+        combine(left, right)
+    }
+
+    /// Sorts `data`, using `scratch` (a copy of the same length) as the
+    /// merge buffer.
+    fn sort_slice<T, C>(&self, data: &mut [T], scratch: &mut [T], grain: usize, compare: &C)
+    where
+        T: Copy + Send + Sync,
+        C: Fn(&T, &T) -> Ordering + Sync,
+    {
+        if data.len() <= grain {
+            data.sort_by(compare);
+            return;
+        }
+        let mid = data.len() / 2;
+        {
+            let (data_left, data_right) = data.split_at_mut(mid);
+            let (scratch_left, scratch_right) = scratch.split_at_mut(mid);
+            self.join(
+                || self.sort_slice(data_left, scratch_left, grain, compare),
+                || self.sort_slice(data_right, scratch_right, grain, compare),
+            );
+        }
+        let (left, right) = data.split_at(mid);
+        self.merge_into(left, right, scratch, grain, compare);
+        data.copy_from_slice(scratch);
+    }
+
+    /// Merges two sorted runs into `output`. Large merges are split at the
+    /// median of the longer run so both halves can proceed in parallel.
+    fn merge_into<T, C>(&self, left: &[T], right: &[T], output: &mut [T], grain: usize, compare: &C)
+    where
+        T: Copy + Send + Sync,
+        C: Fn(&T, &T) -> Ordering + Sync,
+    {
+        if left.len() + right.len() <= grain {
+            merge_sequential(left, right, output, compare);
+            return;
+        }
+        // Equal elements from `left` must stay ahead of those from `right`.
+        let (left_mid, right_mid) = if left.len() >= right.len() {
+            let mid = left.len() / 2;
+            let pivot = &left[mid];
+            (
+                mid,
+                right.partition_point(|item| compare(item, pivot) == Ordering::Less),
+            )
+        } else {
+            let mid = right.len() / 2;
+            let pivot = &right[mid];
+            (
+                left.partition_point(|item| compare(item, pivot) != Ordering::Greater),
+                mid,
+            )
+        };
+        let (left_low, left_high) = left.split_at(left_mid);
+        let (right_low, right_high) = right.split_at(right_mid);
+        let (output_low, output_high) = output.split_at_mut(left_mid + right_mid);
+        self.join(
+            || self.merge_into(left_low, right_low, output_low, grain, compare),
+            || self.merge_into(left_high, right_high, output_high, grain, compare),
+        );
+    }
+}
+
+fn merge_sequential<T, C>(left: &[T], right: &[T], output: &mut [T], compare: &C)
+where
+    T: Copy,
+    C: Fn(&T, &T) -> Ordering,
+{
+    let (mut i, mut j) = (0, 0);
+    for slot in output.iter_mut() {
+        let take_left = j == right.len()
+            || (i < left.len() && compare(&left[i], &right[j]) != Ordering::Greater);
+        if take_left {
+            *slot = left[i];
+            i += 1;
+        } else {
+            *slot = right[j];
+            j += 1;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::task::SchedulerConfig;
+    use std::sync::atomic::{AtomicUsize, Ordering as AtomicOrdering};
+
+    fn scheduler() -> TaskScheduler {
+        TaskScheduler::new(SchedulerConfig::default())
+    }
+
+    #[test]
+    fn map_filter_reduce_match_sequential() {
+        let scheduler = scheduler();
+        let input: Vec<i64> = (0..100_000).collect();
+
+        let doubled = scheduler.par_map(&input, |value| value * 2);
+        assert_eq!(
+            doubled,
+            input.iter().map(|value| value * 2).collect::<Vec<_>>()
+        );
+
+        let even = scheduler.par_filter(&input, |value| value % 2 == 0);
+        assert_eq!(
+            even,
+            input
+                .iter()
+                .copied()
+                .filter(|value| value % 2 == 0)
+                .collect::<Vec<_>>()
+        );
+
+        let sum = scheduler.par_reduce(&input, 0, |a, b| a + b);
+        assert_eq!(sum, input.iter().sum::<i64>());
+    }
+
+    #[test]
+    fn par_for_visits_every_index_once() {
+        let scheduler = scheduler();
+        let hits: Vec<AtomicUsize> = (0..50_000).map(|_| AtomicUsize::new(0)).collect();
+        scheduler.par_for(hits.len(), |index| {
+            hits[index].fetch_add(1, AtomicOrdering::Relaxed);
+        });
+        assert!(
+            hits.iter()
+                .all(|hit| hit.load(AtomicOrdering::Relaxed) == 1)
+        );
+    }
+
+    #[test]
+    fn sort_is_stable() {
+        let scheduler = scheduler();
+        let mut data: Vec<(u32, usize)> = (0..60_000)
+            .map(|index| (((index * 7919) % 97) as u32, index))
+            .collect();
+        let mut expected = data.clone();
+        expected.sort_by_key(|&(key, _)| key);
+        scheduler.par_sort_by(&mut data, |a, b| a.0.cmp(&b.0));
+        assert_eq!(data, expected);
+    }
+
+    #[test]
+    fn join_helper_never_runs_spawned_tasks() {
+        use std::sync::Arc;
+        use std::sync::atomic::AtomicBool;
+        use std::thread;
+        use std::time::Duration;
+
+        let scheduler = TaskScheduler::new(SchedulerConfig { max_workers: 2 });
+        let joining = Arc::new(AtomicBool::new(false));
+        let ran_inside_join = Arc::new(AtomicBool::new(false));
+        let b_started = AtomicBool::new(false);
+
+        scheduler.install(|| {
+            let joiner = thread::current().id();
+            joining.store(true, AtomicOrdering::SeqCst);
+            scheduler.join(
+                || {
+                    while !b_started.load(AtomicOrdering::SeqCst) {
+                        thread::yield_now();
+                    }
+                },
+                || {
+                    b_started.store(true, AtomicOrdering::SeqCst);
+                    // Queue a spawned task while the joiner is helping, and
+                    // keep this worker busy so only the joiner could take it.
+                    let joining = Arc::clone(&joining);
+                    let ran_inside_join = Arc::clone(&ran_inside_join);
+                    scheduler.spawn_fn(None, move || {
+                        if joining.load(AtomicOrdering::SeqCst) && thread::current().id() == joiner
+                        {
+                            ran_inside_join.store(true, AtomicOrdering::SeqCst);
+                        }
+                    });
+                    thread::sleep(Duration::from_millis(100));
+                },
+            );
+            joining.store(false, AtomicOrdering::SeqCst);
+        });
+
+        assert!(!ran_inside_join.load(AtomicOrdering::SeqCst));
+    }
+}
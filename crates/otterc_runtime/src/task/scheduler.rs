@@ -1,14 +1,16 @@
 use crossbeam_deque::{Injector, Steal, Stealer, Worker};
 use crossbeam_utils::Backoff;
+use parking_lot::Mutex;
+use std::cell::Cell;
+use std::panic::{AssertUnwindSafe, catch_unwind, resume_unwind};
 use std::sync::Arc;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use std::thread;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
-use super::metrics::{TaskRuntimeMetrics, WorkerState};
-use super::task_impl::{JoinHandle, Task, TaskFn};
+use super::metrics::{TaskRuntimeMetrics, WorkerCounters, WorkerState};
+use super::task_impl::{CancellationToken, JoinHandle, Task, TaskFn};
 use super::timer::TimerWheel;
-use super::tls::cleanup_task_local_storage;
 
 #[derive(Debug, Clone, Copy)]
 pub struct SchedulerConfig {
@@ -42,6 +44,104 @@ pub struct TaskScheduler {
     core: Arc<SchedulerCore>,
 }
 
+/// The scheduler state a worker thread exposes to code it runs, so that
+/// `join` can push onto the worker's job deque and help while it waits.
+#[derive(Clone, Copy)]
+struct WorkerContext {
+    core: *const SchedulerCore,
+    jobs: *const Worker<Task>,
+    job_stealers: *const Vec<Stealer<Task>>,
+    counters: *const WorkerCounters,
+}
+
+impl WorkerContext {
+    /// # Safety
+    ///
+    /// Must only be called on the worker thread that installed the context,
+    /// while its worker loop is running.
+    unsafe fn parts(
+        &self,
+    ) -> (
+        &SchedulerCore,
+        &Worker<Task>,
+        &[Stealer<Task>],
+        &WorkerCounters,
+    ) {
+        // SAFETY: guaranteed by the caller.
+        unsafe {
+            (
+                &*self.core,
+                &*self.jobs,
+                &*self.job_stealers,
+                &*self.counters,
+            )
+        }
+    }
+}
+
+thread_local! {
+    static CURRENT_WORKER: Cell<Option<WorkerContext>> = const { Cell::new(None) };
+}
+
+/// A closure and its result slot, owned by the frame that waits for it.
+struct StackJob<F, R> {
+    func: Mutex<Option<F>>,
+    result: Mutex<Option<thread::Result<R>>>,
+}
+
+impl<F: FnOnce() -> R, R> StackJob<F, R> {
+    fn new(func: F) -> Self {
+        Self {
+            func: Mutex::new(Some(func)),
+            result: Mutex::new(None),
+        }
+    }
+
+    /// Entry point for the type-erased task.
+    ///
+    /// # Safety
+    ///
+    /// `addr` must point to a live `StackJob<F, R>`.
+    unsafe fn execute(addr: usize) {
+        // SAFETY: guaranteed by the caller.
+        let job = unsafe { &*(addr as *const Self) };
+        if let Some(func) = job.func.lock().take() {
+            *job.result.lock() = Some(catch_unwind(AssertUnwindSafe(func)));
+        }
+    }
+
+    /// Wraps the job in a task. The caller must not let the job go out of
+    /// scope before the task's join state completes.
+    fn as_task(&self) -> Task
+    where
+        F: Send,
+        R: Send,
+    {
+        erased_task(Self::execute, self as *const Self as usize)
+    }
+
+    fn into_result(self) -> R {
+        match self.result.into_inner() {
+            Some(Ok(value)) => value,
+            Some(Err(payload)) => resume_unwind(payload),
+            None => unreachable!("job completed without running"),
+        }
+    }
+}
+
+/// Builds a `'static` task around a job address. Kept non-generic so the
+/// closure does not inherit the job's lifetimes.
+fn erased_task(execute: unsafe fn(usize), addr: usize) -> Task {
+    Task::new(
+        None,
+        Box::new(move || {
+            // SAFETY: `join` and `install` keep the job alive until this
+            // task's join state completes.
+            unsafe { execute(addr) }
+        }) as TaskFn,
+    )
+}
+
 impl TaskScheduler {
     pub fn new(config: SchedulerConfig) -> Self {
         let metrics = TaskRuntimeMetrics::new();
@@ -49,14 +149,20 @@ impl TaskScheduler {
         let timer_wheel = Arc::new(TimerWheel::new());
         let mut workers = Vec::with_capacity(config.max_workers);
         let mut stealer_store = Vec::with_capacity(config.max_workers);
+        let mut job_stealer_store = Vec::with_capacity(config.max_workers);
 
         for _ in 0..config.max_workers {
             let worker = Worker::new_fifo();
+            // Fork-join jobs run newest-first on their own worker, while
+            // thieves take the oldest, largest pieces.
+            let jobs = Worker::new_lifo();
             stealer_store.push(worker.stealer());
-            workers.push(worker);
+            job_stealer_store.push(jobs.stealer());
+            workers.push((worker, jobs));
         }
 
         let stealers = Arc::new(stealer_store);
+        let job_stealers = Arc::new(job_stealer_store);
 
         let core = Arc::new(SchedulerCore {
             injector,
@@ -85,12 +191,21 @@ impl TaskScheduler {
             .spawn(move || timer_processor_loop(timer_core))
             .expect("failed to spawn timer processor");
 
-        for (index, worker) in workers.into_iter().enumerate() {
+        for (index, (worker, jobs)) in workers.into_iter().enumerate() {
             let core = Arc::clone(&core);
             let stealers = Arc::clone(&stealers);
+            let job_stealers = Arc::clone(&job_stealers);
             thread::Builder::new()
                 .name(format!("otter-task-worker-{}", index))
-                .spawn(move || worker_loop(core, stealers, worker, index))
+                .spawn(move || {
+                    let queues = WorkerQueues {
+                        local: worker,
+                        jobs,
+                        stealers: others(&stealers, index),
+                        job_stealers: others(&job_stealers, index),
+                    };
+                    worker_loop(core, queues, index);
+                })
                 .expect("failed to spawn task worker");
         }
 
@@ -112,11 +227,96 @@ impl TaskScheduler {
         let task = Task::new(name, Box::new(func) as TaskFn);
         let cancellation_token = task.cancellation_token().clone();
         let join = JoinHandle::new(task.id(), task.join_state(), cancellation_token);
-        self.core.metrics.record_spawn();
+        self.record_spawn();
         self.core.injector.push(task);
         join
     }
 
+    /// Spawns a task that observes `token` instead of a fresh cancellation
+    /// token, so several tasks can be cancelled together.
+    pub fn spawn_with_token<F>(&self, name: Option<String>, token: CancellationToken, func: F)
+    where
+        F: FnOnce() + Send + 'static,
+    {
+        let task = Task::with_cancellation_token(name, Box::new(func) as TaskFn, token);
+        self.record_spawn();
+        self.core.injector.push(task);
+    }
+
+    /// Runs `func` on one of this scheduler's workers and blocks until it
+    /// returns. Called from a worker, it simply runs `func` inline.
+    pub fn install<F, R>(&self, func: F) -> R
+    where
+        F: FnOnce() -> R + Send,
+        R: Send,
+    {
+        if self.current_worker().is_some() {
+            return func();
+        }
+        let job = StackJob::new(func);
+        let task = job.as_task();
+        let state = task.join_state();
+        self.record_spawn();
+        self.core.injector.push(task);
+        state.wait_blocking();
+        job.into_result()
+    }
+
+    /// Runs `a` and `b` potentially in parallel and returns both results.
+    ///
+    /// `b` is pushed onto the calling worker's job deque where idle workers
+    /// can steal it, and `a` runs inline. While `b` is outstanding the caller
+    /// runs other fork-join jobs instead of blocking, but never spawned
+    /// tasks, which may block or hold task-owned locks. Panics in either
+    /// closure propagate to the caller once both have finished.
+    pub fn join<A, B, RA, RB>(&self, a: A, b: B) -> (RA, RB)
+    where
+        A: FnOnce() -> RA + Send,
+        B: FnOnce() -> RB + Send,
+        RA: Send,
+        RB: Send,
+    {
+        let Some(worker) = self.current_worker() else {
+            return self.install(|| self.join(a, b));
+        };
+
+        let job = StackJob::new(b);
+        let task = job.as_task();
+        let state = task.join_state();
+        self.record_spawn();
+        // SAFETY: `current_worker` only returns contexts of the running
+        // worker loop, which outlives every task it executes.
+        let (_, jobs, _, _) = unsafe { worker.parts() };
+        jobs.push(task);
+
+        let result_a = catch_unwind(AssertUnwindSafe(a));
+        help_until(worker, || state.is_complete());
+
+        let result_b = job.into_result();
+        match result_a {
+            Ok(value) => (value, result_b),
+            Err(payload) => resume_unwind(payload),
+        }
+    }
+
+    /// Counts a spawn against the calling worker when there is one, and
+    /// against the shared counter for spawns from outside the pool.
+    fn record_spawn(&self) {
+        match self.current_worker() {
+            // SAFETY: see `join`.
+            Some(worker) => unsafe { worker.parts() }.3.record_spawn(),
+            None => self.core.metrics.record_spawn(),
+        }
+    }
+
+    /// The calling thread's worker context, if it is one of this
+    /// scheduler's workers.
+    fn current_worker(&self) -> Option<WorkerContext> {
+        CURRENT_WORKER
+            .get()
+            .filter(|worker| std::ptr::eq(worker.core, Arc::as_ptr(&self.core)))
+    }
+
     pub fn get_worker_count(&self) -> usize {
         self.core.worker_count.load(Ordering::Relaxed)
     }
@@ -129,23 +329,99 @@ impl TaskScheduler {
     }
 }
 
-fn worker_loop(
-    core: Arc<SchedulerCore>,
-    stealers: Arc<Vec<Stealer<Task>>>,
+/// A worker's queues. Spawned tasks go through `local` and the injector;
+/// `jobs` holds only the halves `join` forks off, so helping with a join can
+/// never pick up a spawned task.
+struct WorkerQueues {
     local: Worker<Task>,
-    index: usize,
-) {
-    let stealers: Vec<_> = stealers
+    jobs: Worker<Task>,
+    /// Other workers' `local` deques.
+    stealers: Vec<Stealer<Task>>,
+    /// Other workers' `jobs` deques.
+    job_stealers: Vec<Stealer<Task>>,
+}
+
+/// Every stealer but the worker's own.
+fn others(stealers: &[Stealer<Task>], index: usize) -> Vec<Stealer<Task>> {
+    stealers
         .iter()
         .enumerate()
-        .filter_map(|(i, stealer)| {
-            if i != index {
-                Some(stealer.clone())
-            } else {
-                None
+        .filter(|&(i, _)| i != index)
+        .map(|(_, stealer)| stealer.clone())
+        .collect()
+}
+
+/// Runs fork-join jobs on the calling worker until `done` holds: its own job
+/// deque first, then jobs stolen from other workers.
+fn help_until(worker: WorkerContext, done: impl Fn() -> bool) {
+    // SAFETY: `worker` came from `current_worker`; see `join`.
+    let (_, jobs, job_stealers, counters) = unsafe { worker.parts() };
+    let backoff = Backoff::new();
+    while !done() {
+        match next_job(jobs, job_stealers) {
+            Steal::Success(task) => {
+                run_task(counters, task);
+                backoff.reset();
             }
-        })
-        .collect();
+            Steal::Retry | Steal::Empty => backoff.snooze(),
+        }
+    }
+}
+
+fn next_job(jobs: &Worker<Task>, job_stealers: &[Stealer<Task>]) -> Steal<Task> {
+    if let Some(task) = jobs.pop() {
+        return Steal::Success(task);
+    }
+    steal_from(job_stealers)
+}
+
+fn steal_from(stealers: &[Stealer<Task>]) -> Steal<Task> {
+    for stealer in stealers {
+        match stealer.steal() {
+            Steal::Empty => continue,
+            found => return found,
+        }
+    }
+    Steal::Empty
+}
+
+/// Finds the next task for an idle worker: its own queues first, then jobs
+/// other workers forked (someone is waiting on those), then the global
+/// injector, then the other workers' spawned tasks.
+fn next_task(core: &SchedulerCore, queues: &WorkerQueues) -> Steal<Task> {
+    if let Some(task) = queues.jobs.pop().or_else(|| queues.local.pop()) {
+        return Steal::Success(task);
+    }
+    match steal_from(&queues.job_stealers) {
+        Steal::Empty => {}
+        found => return found,
+    }
+    match core.injector.steal_batch_and_pop(&queues.local) {
+        Steal::Empty => {}
+        found => return found,
+    }
+    steal_from(&queues.stealers)
+}
+
+fn run_task(counters: &WorkerCounters, task: Task) {
+    // Skip cancelled tasks
+    if !task.is_cancelled() {
+        let queue_wait = task.created_at().elapsed();
+        let started = Instant::now();
+        task.run();
+        counters.record_task(queue_wait, started.elapsed());
+    }
+    counters.record_completion();
+}
+
+fn worker_loop(core: Arc<SchedulerCore>, queues: WorkerQueues, index: usize) {
+    let counters = core.metrics.worker(index);
+    CURRENT_WORKER.set(Some(WorkerContext {
+        core: Arc::as_ptr(&core),
+        jobs: &queues.jobs,
+        job_stealers: &queues.job_stealers,
+        counters: &**counters,
+    }));
     let backoff = Backoff::new();
     let mut consecutive_idle = 0;
 
@@ -154,42 +430,14 @@ fn worker_loop(
             break;
         }
 
-        let queue_depth = local.len();
-        core.metrics
-            .update_worker_info(index, WorkerState::Busy, queue_depth);
-
-        if let Some(task) = local.pop() {
-            backoff.reset();
-            consecutive_idle = 0;
-            // Skip cancelled tasks
-            let task_id = task.id();
-            if task.is_cancelled() {
-                core.metrics.record_completion();
-                cleanup_task_local_storage(task_id);
-                continue;
-            }
-            task.run();
-            core.metrics.record_completion();
-            core.metrics.record_worker_task(index);
-            cleanup_task_local_storage(task_id);
-            continue;
-        }
+        let queue_depth = queues.local.len() + queues.jobs.len();
+        counters.update(WorkerState::Busy, queue_depth);
 
-        match core.injector.steal_batch_and_pop(&local) {
+        match next_task(&core, &queues) {
             Steal::Success(task) => {
                 backoff.reset();
                 consecutive_idle = 0;
-                // Skip cancelled tasks
-                let task_id = task.id();
-                if task.is_cancelled() {
-                    core.metrics.record_completion();
-                    cleanup_task_local_storage(task_id);
-                    continue;
-                }
-                task.run();
-                core.metrics.record_completion();
-                core.metrics.record_worker_task(index);
-                cleanup_task_local_storage(task_id);
+                run_task(&counters, task);
                 continue;
             }
             Steal::Retry => {
@@ -199,47 +447,13 @@ fn worker_loop(
             Steal::Empty => {}
         }
 
-        let mut stolen = None;
-        for stealer in &stealers {
-            match stealer.steal() {
-                Steal::Success(task) => {
-                    stolen = Some(task);
-                    break;
-                }
-                Steal::Retry => {
-                    stolen = None;
-                    break;
-                }
-                Steal::Empty => continue,
-            }
-        }
-
-        if let Some(task) = stolen {
-            backoff.reset();
-            consecutive_idle = 0;
-            // Skip cancelled tasks
-            let task_id = task.id();
-            if task.is_cancelled() {
-                core.metrics.record_completion();
-                cleanup_task_local_storage(task_id);
-                continue;
-            }
-            task.run();
-            core.metrics.record_completion();
-            core.metrics.record_worker_task(index);
-            cleanup_task_local_storage(task_id);
-            continue;
-        }
-
         // Nothing to do
         consecutive_idle += 1;
-        let queue_depth = local.len();
+        let queue_depth = queues.local.len() + queues.jobs.len();
         if consecutive_idle > 10 {
-            core.metrics
-                .update_worker_info(index, WorkerState::Idle, queue_depth);
+            counters.update(WorkerState::Idle, queue_depth);
         } else {
-            core.metrics
-                .update_worker_info(index, WorkerState::Parked, queue_depth);
+            counters.update(WorkerState::Parked, queue_depth);
         }
 
         // Check for timer wakeups and yield slightly.
@@ -251,6 +465,8 @@ fn worker_loop(
             backoff.snooze();
         }
     }
+
+    CURRENT_WORKER.set(None);
 }
 
 fn autoscaler_loop(core: Arc<SchedulerCore>) {
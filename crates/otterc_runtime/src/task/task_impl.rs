@@ -1,7 +1,11 @@
 use parking_lot::{Condvar, Mutex};
+use std::cell::Cell;
 use std::sync::Arc;
 use std::sync::atomic::{AtomicU64, Ordering};
 use std::task::Waker;
+use std::time::Instant;
+
+use super::tls::{self, TaskLocalStorage};
 
 /// Unique identifier assigned to each task at creation time.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -23,6 +27,17 @@ fn next_task_id() -> TaskId {
     TaskId::new(NEXT_TASK_ID.fetch_add(1, Ordering::Relaxed))
 }
 
+thread_local! {
+    /// Task whose body is running on this thread. A worker that runs another
+    /// task while helping with a `join` switches this for the nested run.
+    static CURRENT_TASK: Cell<Option<TaskId>> = const { Cell::new(None) };
+}
+
+/// The task running on the calling thread, or `None` outside any task.
+pub fn current_task_id() -> Option<TaskId> {
+    CURRENT_TASK.with(Cell::get)
+}
+
 pub type TaskFn = Box<dyn FnOnce() + Send + 'static>;
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -127,17 +142,30 @@ pub struct Task {
     func: Option<TaskFn>,
     join: Arc<JoinState>,
     cancellation_token: CancellationToken,
+    locals: TaskLocalStorage,
+    created_at: Instant,
 }
 
 impl Task {
     pub fn new(name: Option<String>, func: TaskFn) -> Self {
+        Self::with_cancellation_token(name, func, CancellationToken::new())
+    }
+
+    /// Creates a task that shares an existing cancellation token.
+    pub fn with_cancellation_token(
+        name: Option<String>,
+        func: TaskFn,
+        cancellation_token: CancellationToken,
+    ) -> Self {
         Self {
             id: next_task_id(),
             name,
             state: TaskState::Ready,
             func: Some(func),
             join: JoinState::new(),
-            cancellation_token: CancellationToken::new(),
+            cancellation_token,
+            locals: TaskLocalStorage::default(),
+            created_at: Instant::now(),
         }
     }
 
@@ -145,6 +173,11 @@ impl Task {
         self.id
     }
 
+    /// When the task was created, which is when it became runnable.
+    pub fn created_at(&self) -> Instant {
+        self.created_at
+    }
+
     pub fn name(&self) -> Option<&str> {
         self.name.as_deref()
     }
@@ -186,6 +219,7 @@ impl Task {
         // Run the function, but check for cancellation periodically
         // Note: For cooperative cancellation, tasks should check cancellation_token themselves
         if let Some(func) = self.func.take() {
+            let _scope = RunScope::enter(self.id, &mut self.locals);
             func();
         }
 
@@ -199,6 +233,34 @@ impl Task {
     }
 }
 
+/// Makes a task's storage and id current while its body runs. Dropping it
+/// puts the outer ones back, also when the body unwinds, so a panic caught
+/// further up does not leave the thread running as the dead task.
+struct RunScope<'a> {
+    locals: &'a mut TaskLocalStorage,
+    outer_locals: TaskLocalStorage,
+    outer_task: Option<TaskId>,
+}
+
+impl<'a> RunScope<'a> {
+    fn enter(id: TaskId, locals: &'a mut TaskLocalStorage) -> Self {
+        let outer_locals = tls::swap_current(std::mem::take(locals));
+        let outer_task = CURRENT_TASK.with(|current| current.replace(Some(id)));
+        Self {
+            locals,
+            outer_locals,
+            outer_task,
+        }
+    }
+}
+
+impl Drop for RunScope<'_> {
+    fn drop(&mut self) {
+        CURRENT_TASK.with(|current| current.set(self.outer_task));
+        *self.locals = tls::swap_current(std::mem::take(&mut self.outer_locals));
+    }
+}
+
 pub struct JoinHandle {
     task_id: TaskId,
     state: Arc<JoinState>,
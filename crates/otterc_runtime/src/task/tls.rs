@@ -2,145 +2,283 @@
 //!
 //! Provides task-local storage similar to thread-local storage, where each task
 //! has its own isolated storage space.
+//!
+//! Storage lives inside the [`Task`](super::Task) itself and is empty until a
+//! task first writes a value, so tasks that never use it pay nothing to create
+//! or drop it. While a task runs, its storage is swapped into a thread-local
+//! slot, which keeps every access free of locks and of any global lookup.
+//! Values are addressed by [`TaskLocalKey`]s, each of which owns a fixed slot
+//! index in the storage.
+
+use std::any::Any;
+use std::cell::RefCell;
+use std::fmt;
+use std::marker::PhantomData;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Slot value of a key that has not been used yet.
+const UNASSIGNED: usize = usize::MAX;
 
-use parking_lot::Mutex;
-use std::any::{Any, TypeId};
-use std::collections::HashMap;
-use std::sync::Arc;
+/// Next free slot index.
+static NEXT_SLOT: AtomicUsize = AtomicUsize::new(0);
 
-use super::task_impl::TaskId;
+thread_local! {
+    /// Storage of the task running on this thread. Outside any task it acts
+    /// as the thread's own storage.
+    static CURRENT: RefCell<TaskLocalStorage> = RefCell::new(TaskLocalStorage::default());
+}
 
-/// Task-local storage container.
-#[derive(Debug, Clone)]
+/// Per-task storage, indexed by key slot.
+#[derive(Default)]
 pub struct TaskLocalStorage {
-    storage: Arc<Mutex<HashMap<TypeId, Box<dyn Any + Send + Sync>>>>,
+    slots: Vec<Option<Box<dyn Any + Send>>>,
 }
 
 impl TaskLocalStorage {
-    pub fn new() -> Self {
+    /// Whether the task has stored anything yet.
+    pub fn is_empty(&self) -> bool {
+        self.slots.is_empty()
+    }
+}
+
+impl fmt::Debug for TaskLocalStorage {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("TaskLocalStorage")
+            .field("slots", &self.slots.len())
+            .finish()
+    }
+}
+
+/// Makes `storage` the current task's storage and returns the storage it
+/// replaces. The scheduler calls this around each task body; nested task runs
+/// (for example while a worker helps with a `join`) restore the outer task's
+/// storage on the way out.
+pub(crate) fn swap_current(storage: TaskLocalStorage) -> TaskLocalStorage {
+    CURRENT.with(|current| std::mem::replace(&mut *current.borrow_mut(), storage))
+}
+
+/// A typed key into task-local storage.
+///
+/// Keys are declared as statics:
+///
+/// ```ignore
+/// static REQUEST_ID: TaskLocalKey<u64> = TaskLocalKey::new();
+/// REQUEST_ID.set(42);
+/// ```
+///
+/// Each key claims its slot index on first use and keeps it for the life of
+/// the process, so later accesses index straight into the storage.
+pub struct TaskLocalKey<T> {
+    slot: AtomicUsize,
+    _marker: PhantomData<fn() -> T>,
+}
+
+impl<T: Send + 'static> TaskLocalKey<T> {
+    pub const fn new() -> Self {
         Self {
-            storage: Arc::new(Mutex::new(HashMap::new())),
+            slot: AtomicUsize::new(UNASSIGNED),
+            _marker: PhantomData,
         }
     }
 
-    /// Set a value in task-local storage.
-    pub fn set<T: Send + Sync + 'static>(&self, value: T) {
-        let mut storage = self.storage.lock();
-        storage.insert(TypeId::of::<T>(), Box::new(value));
+    fn slot(&self) -> usize {
+        let slot = self.slot.load(Ordering::Relaxed);
+        if slot != UNASSIGNED {
+            return slot;
+        }
+        let claimed = NEXT_SLOT.fetch_add(1, Ordering::Relaxed);
+        match self
+            .slot
+            .compare_exchange(UNASSIGNED, claimed, Ordering::Relaxed, Ordering::Relaxed)
+        {
+            Ok(_) => claimed,
+            Err(existing) => existing,
+        }
     }
 
-    /// Get a value from task-local storage.
-    pub fn get<T>(&self) -> Option<T>
-    where
-        T: Clone + Send + Sync + 'static,
-    {
-        let storage = self.storage.lock();
-        storage
-            .get(&TypeId::of::<T>())
-            .and_then(|boxed| boxed.downcast_ref::<T>())
-            .cloned()
+    /// Stores `value` for the current task, replacing any previous value.
+    pub fn set(&self, value: T) {
+        let slot = self.slot();
+        CURRENT.with(|current| {
+            let mut storage = current.borrow_mut();
+            if storage.slots.len() <= slot {
+                storage.slots.resize_with(slot + 1, || None);
+            }
+            storage.slots[slot] = Some(Box::new(value));
+        });
     }
 
-    /// Get a reference to a value in task-local storage (without cloning).
-    /// Get a reference to a value in task-local storage (without cloning).
-    pub fn get_ref<T>(&self) -> Option<parking_lot::MappedMutexGuard<'_, T>>
-    where
-        T: 'static + Send + Sync,
-    {
-        let storage = self.storage.lock();
-        parking_lot::MutexGuard::try_map(storage, |s| {
-            s.get_mut(&TypeId::of::<T>())
-                .and_then(|boxed| boxed.downcast_mut::<T>())
+    /// Calls `func` with the current task's value. `func` must not access
+    /// task-local storage itself.
+    pub fn with<R>(&self, func: impl FnOnce(Option<&T>) -> R) -> R {
+        let slot = self.slot();
+        CURRENT.with(|current| {
+            let storage = current.borrow();
+            let value = storage
+                .slots
+                .get(slot)
+                .and_then(Option::as_ref)
+                .and_then(|boxed| boxed.downcast_ref::<T>());
+            func(value)
         })
-        .ok()
     }
 
-    /// Remove a value from task-local storage.
-    pub fn remove<T: Send + Sync + 'static>(&self) -> Option<T> {
-        let mut storage = self.storage.lock();
-        storage
-            .remove(&TypeId::of::<T>())
-            .and_then(|boxed| boxed.downcast::<T>().ok())
-            .map(|boxed| *boxed)
+    /// Calls `func` with a mutable reference to the current task's value,
+    /// storing `init()` first if the task has none. Neither closure may
+    /// access task-local storage itself.
+    pub fn with_mut_or_init<R>(
+        &self,
+        init: impl FnOnce() -> T,
+        func: impl FnOnce(&mut T) -> R,
+    ) -> R {
+        let slot = self.slot();
+        CURRENT.with(|current| {
+            let mut storage = current.borrow_mut();
+            if storage.slots.len() <= slot {
+                storage.slots.resize_with(slot + 1, || None);
+            }
+            let entry = &mut storage.slots[slot];
+            if let Some(value) = entry.as_mut().and_then(|boxed| boxed.downcast_mut::<T>()) {
+                return func(value);
+            }
+            let mut value = Box::new(init());
+            let result = func(&mut value);
+            *entry = Some(value);
+            result
+        })
+    }
+
+    /// Returns a copy of the current task's value.
+    pub fn get(&self) -> Option<T>
+    where
+        T: Clone,
+    {
+        self.with(|value| value.cloned())
     }
 
-    /// Clear all task-local storage.
-    pub fn clear(&self) {
-        let mut storage = self.storage.lock();
-        storage.clear();
+    /// Removes and returns the current task's value.
+    pub fn take(&self) -> Option<T> {
+        let slot = self.slot();
+        CURRENT.with(|current| {
+            current
+                .borrow_mut()
+                .slots
+                .get_mut(slot)
+                .and_then(Option::take)
+                .and_then(|boxed| boxed.downcast::<T>().ok())
+                .map(|boxed| *boxed)
+        })
     }
 
-    /// Check if a value exists in task-local storage.
-    pub fn contains<T: Send + Sync + 'static>(&self) -> bool {
-        let storage = self.storage.lock();
-        storage.contains_key(&TypeId::of::<T>())
+    /// Whether the current task has a value for this key.
+    pub fn is_set(&self) -> bool {
+        self.with(|value| value.is_some())
     }
 }
 
-impl Default for TaskLocalStorage {
+impl<T: Send + 'static> Default for TaskLocalKey<T> {
     fn default() -> Self {
         Self::new()
     }
 }
 
-/// Global registry mapping task IDs to their task-local storage.
-#[derive(Debug)]
-pub struct TaskLocalRegistry {
-    registry: Arc<Mutex<HashMap<TaskId, TaskLocalStorage>>>,
+impl<T> fmt::Debug for TaskLocalKey<T> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("TaskLocalKey")
+            .field("slot", &self.slot.load(Ordering::Relaxed))
+            .finish()
+    }
 }
 
-impl TaskLocalRegistry {
-    pub fn new() -> Self {
-        Self {
-            registry: Arc::new(Mutex::new(HashMap::new())),
-        }
-    }
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::task::{Task, current_task_id};
+    use std::panic::{catch_unwind, resume_unwind};
+    use std::sync::{Arc, Mutex};
 
-    /// Get or create task-local storage for a task.
-    pub fn get_or_create(&self, task_id: TaskId) -> TaskLocalStorage {
-        let mut registry = self.registry.lock();
-        registry.entry(task_id).or_default().clone()
-    }
+    static COUNTER: TaskLocalKey<u64> = TaskLocalKey::new();
+    static LABEL: TaskLocalKey<String> = TaskLocalKey::new();
 
-    /// Get task-local storage for a task, if it exists.
-    pub fn get(&self, task_id: TaskId) -> Option<TaskLocalStorage> {
-        let registry = self.registry.lock();
-        registry.get(&task_id).cloned()
-    }
+    #[test]
+    fn values_stay_with_their_task() {
+        let seen = Arc::new(Mutex::new(Vec::new()));
 
-    /// Remove task-local storage for a task.
-    pub fn remove(&self, task_id: TaskId) {
-        let mut registry = self.registry.lock();
-        registry.remove(&task_id);
-    }
+        let first_seen = Arc::clone(&seen);
+        Task::new(
+            None,
+            Box::new(move || {
+                COUNTER.set(1);
+                LABEL.set("first".into());
+                first_seen.lock().unwrap().push(COUNTER.get());
+            }),
+        )
+        .run();
 
-    /// Clear all task-local storage.
-    pub fn clear(&self) {
-        let mut registry = self.registry.lock();
-        registry.clear();
-    }
-}
+        let second_seen = Arc::clone(&seen);
+        Task::new(
+            None,
+            Box::new(move || {
+                second_seen.lock().unwrap().push(COUNTER.get());
+                assert!(!LABEL.is_set());
+            }),
+        )
+        .run();
 
-impl Default for TaskLocalRegistry {
-    fn default() -> Self {
-        Self::new()
+        assert_eq!(*seen.lock().unwrap(), vec![Some(1), None]);
     }
-}
 
-/// Global task-local storage registry.
-static TASK_LOCAL_REGISTRY: once_cell::sync::Lazy<TaskLocalRegistry> =
-    once_cell::sync::Lazy::new(TaskLocalRegistry::new);
+    #[test]
+    fn with_mut_or_init_updates_in_place() {
+        Task::new(
+            None,
+            Box::new(|| {
+                for expected in 1..=3 {
+                    let seen = COUNTER.with_mut_or_init(
+                        || 0,
+                        |value| {
+                            *value += 1;
+                            *value
+                        },
+                    );
+                    assert_eq!(seen, expected);
+                }
+                assert_eq!(COUNTER.get(), Some(3));
+            }),
+        )
+        .run();
+    }
 
-/// Get task-local storage for the current task.
-///
-/// # Safety
-/// This function requires that the current task ID is available through some mechanism.
-/// In practice, this would be set by the scheduler when running a task.
-pub fn get_task_local_storage(task_id: TaskId) -> TaskLocalStorage {
-    TASK_LOCAL_REGISTRY.get_or_create(task_id)
-}
+    #[test]
+    fn nested_runs_restore_the_outer_task() {
+        Task::new(
+            None,
+            Box::new(|| {
+                COUNTER.set(7);
+                Task::new(None, Box::new(|| COUNTER.set(8))).run();
+                assert_eq!(COUNTER.get(), Some(7));
+                assert_eq!(COUNTER.take(), Some(7));
+                assert_eq!(COUNTER.get(), None);
+            }),
+        )
+        .run();
+    }
 
-/// Remove task-local storage for a task.
-pub fn cleanup_task_local_storage(task_id: TaskId) {
-    TASK_LOCAL_REGISTRY.remove(task_id);
+    #[test]
+    fn panicking_task_restores_the_outer_storage() {
+        COUNTER.set(5);
+        let outcome = catch_unwind(|| {
+            Task::new(
+                None,
+                Box::new(|| {
+                    COUNTER.set(6);
+                    resume_unwind(Box::new(()));
+                }),
+            )
+            .run();
+        });
+        assert!(outcome.is_err());
+        assert_eq!(COUNTER.take(), Some(5));
+        assert_eq!(current_task_id(), None);
+    }
 }
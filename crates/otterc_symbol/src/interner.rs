@@ -0,0 +1,232 @@
+//! Global string interner for identifiers.
+//!
+//! Each distinct name is copied once into an append-only arena that lives for
+//! the rest of the process and is afterwards referred to by a `Copy`
+//! [`Symbol`]. Comparing or hashing symbols is an integer operation, and
+//! resolving one back to text neither allocates nor takes a lock: the text of
+//! every symbol sits in an append-only table that readers index directly.
+//!
+//! Module exports and the type checker's `TypeContext` tables are keyed by
+//! symbols. AST nodes still carry `String` names, which are interned where
+//! they enter those tables.
+
+use std::fmt;
+use std::sync::OnceLock;
+
+use ahash::AHashMap;
+use once_cell::sync::Lazy;
+use parking_lot::RwLock;
+
+/// Size of each arena chunk; longer names get a chunk of their own.
+const ARENA_CHUNK_SIZE: usize = 64 * 1024;
+
+/// Entries in the first bucket of [`SYMBOL_TEXT`], as a power of two. Each
+/// later bucket is twice the size of the one before.
+const FIRST_BUCKET_BITS: u32 = 5;
+
+/// Enough buckets for every `u32` symbol.
+const BUCKETS: usize = (u32::BITS - FIRST_BUCKET_BITS + 1) as usize;
+
+static GLOBAL_INTERNER: Lazy<RwLock<Interner>> = Lazy::new(|| RwLock::new(Interner::default()));
+
+/// Text of each symbol, indexed by [`bucket_slot`]. Buckets are allocated
+/// and slots filled by the interner under its write lock, and never change
+/// afterwards.
+static SYMBOL_TEXT: [OnceLock<Box<[OnceLock<&'static str>]>>; BUCKETS] =
+    [const { OnceLock::new() }; BUCKETS];
+
+/// Bucket and slot of symbol `index` in [`SYMBOL_TEXT`].
+fn bucket_slot(index: u32) -> (usize, usize) {
+    let position = u64::from(index) + (1 << FIRST_BUCKET_BITS);
+    let bucket = position.ilog2() - FIRST_BUCKET_BITS;
+    let slot = position - (1 << (bucket + FIRST_BUCKET_BITS));
+    (bucket as usize, slot as usize)
+}
+
+/// An interned string. Two symbols are equal iff their text is equal.
+#[derive(Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct Symbol(u32);
+
+impl Symbol {
+    /// Intern `name`, returning the existing symbol if it was seen before.
+    pub fn intern(name: &str) -> Self {
+        if let Some(symbol) = GLOBAL_INTERNER.read().lookup(name) {
+            return symbol;
+        }
+        GLOBAL_INTERNER.write().intern(name)
+    }
+
+    /// Look up a name without interning it.
+    pub fn lookup(name: &str) -> Option<Self> {
+        GLOBAL_INTERNER.read().lookup(name)
+    }
+
+    pub fn as_str(self) -> &'static str {
+        let (bucket, slot) = bucket_slot(self.0);
+        SYMBOL_TEXT[bucket]
+            .get()
+            .and_then(|slots| slots[slot].get())
+            .copied()
+            .expect("symbols are only created after their text is stored")
+    }
+
+    pub fn as_u32(self) -> u32 {
+        self.0
+    }
+}
+
+impl fmt::Debug for Symbol {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "Symbol({:?})", self.as_str())
+    }
+}
+
+impl fmt::Display for Symbol {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(self.as_str())
+    }
+}
+
+impl From<&str> for Symbol {
+    fn from(name: &str) -> Self {
+        Self::intern(name)
+    }
+}
+
+impl From<&String> for Symbol {
+    fn from(name: &String) -> Self {
+        Self::intern(name)
+    }
+}
+
+impl PartialEq<str> for Symbol {
+    fn eq(&self, other: &str) -> bool {
+        self.as_str() == other
+    }
+}
+
+impl PartialEq<&str> for Symbol {
+    fn eq(&self, other: &&str) -> bool {
+        self.as_str() == *other
+    }
+}
+
+#[derive(Default)]
+struct Interner {
+    ids: AHashMap<&'static str, Symbol>,
+    /// Number of symbols interned so far.
+    len: u32,
+    arena: StringArena,
+}
+
+impl Interner {
+    fn lookup(&self, name: &str) -> Option<Symbol> {
+        self.ids.get(name).copied()
+    }
+
+    fn intern(&mut self, name: &str) -> Symbol {
+        // Another thread may have interned it between the read and write lock.
+        if let Some(symbol) = self.lookup(name) {
+            return symbol;
+        }
+        let text = self.arena.alloc(name);
+        let symbol = Symbol(self.len);
+        self.len = self.len.checked_add(1).expect("more than u32::MAX symbols");
+        let (bucket, slot) = bucket_slot(symbol.0);
+        let slots = SYMBOL_TEXT[bucket].get_or_init(|| {
+            (0..1usize << (bucket as u32 + FIRST_BUCKET_BITS))
+                .map(|_| OnceLock::new())
+                .collect()
+        });
+        // Only the writer holding the lock fills slots, each exactly once.
+        let _ = slots[slot].set(text);
+        self.ids.insert(text, symbol);
+        symbol
+    }
+}
+
+/// Bump allocator for interned text. Chunks are leaked on purpose: interned
+/// names are valid for the lifetime of the process.
+#[derive(Default)]
+struct StringArena {
+    free: &'static mut [u8],
+}
+
+impl StringArena {
+    fn alloc(&mut self, text: &str) -> &'static str {
+        if self.free.len() < text.len() {
+            let size = ARENA_CHUNK_SIZE.max(text.len());
+            self.free = Box::leak(vec![0u8; size].into_boxed_slice());
+        }
+        let free = std::mem::take(&mut self.free);
+        let (slot, rest) = free.split_at_mut(text.len());
+        self.free = rest;
+        slot.copy_from_slice(text.as_bytes());
+        std::str::from_utf8(slot).expect("interned bytes are copied from a str")
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn interning_is_idempotent() {
+        let a = Symbol::intern("interner_test_alpha");
+        let b = Symbol::intern("interner_test_alpha");
+        let c = Symbol::intern("interner_test_beta");
+        assert_eq!(a, b);
+        assert_ne!(a, c);
+        assert_eq!(a.as_str(), "interner_test_alpha");
+        assert_eq!(c, "interner_test_beta");
+        assert_eq!(Symbol::lookup("interner_test_beta"), Some(c));
+        assert_eq!(Symbol::lookup("interner_test_never_interned"), None);
+    }
+
+    #[test]
+    fn symbols_map_to_consecutive_table_slots() {
+        assert_eq!(bucket_slot(0), (0, 0));
+        assert_eq!(bucket_slot(31), (0, 31));
+        assert_eq!(bucket_slot(32), (1, 0));
+        assert_eq!(bucket_slot(95), (1, 63));
+        assert_eq!(bucket_slot(96), (2, 0));
+        let (bucket, slot) = bucket_slot(u32::MAX);
+        assert_eq!(bucket, BUCKETS - 1);
+        assert!(slot < 1 << (bucket as u32 + FIRST_BUCKET_BITS));
+    }
+
+    #[test]
+    fn symbols_resolve_from_other_threads() {
+        let symbols: Vec<Symbol> = std::thread::scope(|scope| {
+            let handles: Vec<_> = (0..4)
+                .map(|thread| {
+                    scope.spawn(move || {
+                        (0..200)
+                            .map(|i| Symbol::intern(&format!("interner_test_{}", i % 100 + thread)))
+                            .collect::<Vec<_>>()
+                    })
+                })
+                .collect();
+            handles
+                .into_iter()
+                .flat_map(|handle| handle.join().unwrap_or_default())
+                .collect()
+        });
+        assert_eq!(symbols.len(), 800);
+        for symbol in symbols {
+            assert_eq!(Symbol::intern(symbol.as_str()), symbol);
+            assert!(symbol.as_str().starts_with("interner_test_"));
+        }
+    }
+
+    #[test]
+    fn names_larger_than_a_chunk_get_their_own() {
+        let long = "x".repeat(ARENA_CHUNK_SIZE + 1);
+        let symbol = Symbol::intern(&long);
+        assert_eq!(symbol.as_str(), long);
+        assert_eq!(
+            Symbol::intern("interner_test_after_long").as_str(),
+            "interner_test_after_long"
+        );
+    }
+}
@@ -1 +1,4 @@
+pub mod interner;
 pub mod registry;
+
+pub use interner::Symbol;
@@ -2,7 +2,7 @@ use std::collections::HashSet;
 use std::fmt;
 
 use abi_stable::StableAbi;
-use abi_stable::std_types::RVec;
+use abi_stable::std_types::{RBox, RVec};
 use ahash::AHashMap;
 use once_cell::sync::Lazy;
 use parking_lot::RwLock;
@@ -19,8 +19,25 @@ pub enum FfiType {
     Opaque,
     List,
     Map,
-    Struct { fields: RVec<FfiType> },
+    Struct {
+        fields: RVec<FfiType>,
+    },
     Tuple(RVec<FfiType>),
+    /// Address of a compiled Otter function the callee calls back into with
+    /// this exact signature. Passed as an `i64`.
+    Function {
+        params: RVec<FfiType>,
+        result: RBox<FfiType>,
+    },
+}
+
+impl FfiType {
+    pub fn function(params: Vec<FfiType>, result: FfiType) -> Self {
+        FfiType::Function {
+            params: params.into(),
+            result: RBox::new(result),
+        }
+    }
 }
 
 impl fmt::Display for FfiType {
@@ -55,20 +72,153 @@ impl fmt::Display for FfiType {
                 }
                 write!(f, ")")
             }
+            FfiType::Function { params, result } => {
+                write!(f, "fn(")?;
+                for (idx, param) in params.iter().enumerate() {
+                    if idx > 0 {
+                        write!(f, ", ")?;
+                    }
+                    write!(f, "{}", param)?;
+                }
+                write!(f, ") -> {}", result)
+            }
         }
     }
 }
 
+/// How a function may access one kind of memory.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum FfiAccess {
+    None,
+    Read,
+    Write,
+    ReadWrite,
+}
+
+/// Memory a function may access, split the way LLVM's `memory` attribute
+/// splits it.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub struct FfiMemory {
+    /// Memory reached through pointer arguments.
+    pub args: FfiAccess,
+    /// State private to the runtime (allocator, GC, list and map tables,
+    /// thread-local generators) that compiled code never touches directly.
+    pub runtime: FfiAccess,
+    /// Everything else, including globals and stack slots of compiled code.
+    pub other: FfiAccess,
+}
+
+impl FfiMemory {
+    pub const ANY: Self = Self {
+        args: FfiAccess::ReadWrite,
+        runtime: FfiAccess::ReadWrite,
+        other: FfiAccess::ReadWrite,
+    };
+    pub const NONE: Self = Self {
+        args: FfiAccess::None,
+        runtime: FfiAccess::None,
+        other: FfiAccess::None,
+    };
+}
+
+impl Default for FfiMemory {
+    fn default() -> Self {
+        Self::ANY
+    }
+}
+
+/// What a function does besides computing its result. Codegen turns this
+/// into attributes on the declaration so LLVM can hoist, merge and vectorize
+/// around calls. The default claims nothing; every flag is a promise the
+/// implementation must keep.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq, Hash)]
+pub struct FfiEffects {
+    pub memory: FfiMemory,
+    /// Always returns: no infinite loops and no process exit.
+    pub will_return: bool,
+    /// A pointer result is a fresh allocation nothing else points to.
+    pub noalias_result: bool,
+    /// Pointer arguments are never null.
+    pub nonnull_args: bool,
+}
+
+impl FfiEffects {
+    /// The result depends on the arguments alone.
+    pub const PURE: Self = Self {
+        memory: FfiMemory::NONE,
+        will_return: true,
+        noalias_result: false,
+        nonnull_args: false,
+    };
+
+    /// Only reads memory behind its pointer arguments.
+    pub const READS_ARGS: Self = Self {
+        memory: FfiMemory {
+            args: FfiAccess::Read,
+            ..FfiMemory::NONE
+        },
+        ..Self::PURE
+    };
+
+    /// Only reads runtime state, such as a list's length. Calls may be merged
+    /// or hoisted out of loops that do not otherwise call into the runtime,
+    /// so this is no way to watch for changes made by other tasks.
+    pub const READS_RUNTIME: Self = Self {
+        memory: FfiMemory {
+            runtime: FfiAccess::Read,
+            ..FfiMemory::NONE
+        },
+        ..Self::PURE
+    };
+
+    /// Only updates runtime state, such as a random number generator or an
+    /// allocation that is not returned as a pointer.
+    pub const UPDATES_RUNTIME: Self = Self {
+        memory: FfiMemory {
+            runtime: FfiAccess::ReadWrite,
+            ..FfiMemory::NONE
+        },
+        ..Self::PURE
+    };
+
+    /// Returns a fresh allocation and touches nothing but runtime state.
+    pub const ALLOCATES: Self = Self {
+        noalias_result: true,
+        ..Self::UPDATES_RUNTIME
+    };
+
+    /// Returns a fresh allocation registered with the GC. Registering may run
+    /// a collection, which reads any memory that can hold references.
+    pub const ALLOCATES_TRACKED: Self = Self {
+        memory: FfiMemory {
+            args: FfiAccess::Read,
+            runtime: FfiAccess::ReadWrite,
+            other: FfiAccess::Read,
+        },
+        ..Self::ALLOCATES
+    };
+}
+
 #[repr(C)]
 #[derive(Clone, Debug)]
 pub struct FfiSignature {
     pub params: Vec<FfiType>,
     pub result: FfiType,
+    pub effects: FfiEffects,
 }
 
 impl FfiSignature {
     pub fn new(params: Vec<FfiType>, result: FfiType) -> Self {
-        Self { params, result }
+        Self {
+            params,
+            result,
+            effects: FfiEffects::default(),
+        }
+    }
+
+    pub fn with_effects(mut self, effects: FfiEffects) -> Self {
+        self.effects = effects;
+        self
     }
 }
 
@@ -10,6 +10,7 @@ use otterc_ast::nodes::{
 };
 use otterc_config::LanguageFeatureFlags;
 use otterc_span::Span;
+use otterc_symbol::Symbol;
 use otterc_symbol::registry::{FfiType, SymbolRegistry};
 
 /// Type checker that validates and infers types in OtterLang programs
@@ -21,8 +22,8 @@ pub struct TypeChecker {
     expr_types_by_span: HashMap<Span, TypeInfo>,
     expr_spans: HashMap<usize, Span>,
     comprehension_var_types: HashMap<Span, TypeInfo>,
-    method_comprehension_spans: HashMap<String, Vec<Span>>,
-    method_expr_ids: HashMap<String, Vec<usize>>,
+    method_comprehension_spans: HashMap<Symbol, Vec<Span>>,
+    method_expr_ids: HashMap<Symbol, Vec<usize>>,
     features: LanguageFeatureFlags,
     /// Current function's return type (if inside a function)
     current_function_return_type: Option<TypeInfo>,
@@ -130,26 +131,22 @@ impl TypeChecker {
         Self::register_builtins(&mut context);
 
         // Common type aliases (language-level names to internal types)
-        context.define_type_alias("float".to_string(), TypeInfo::F64, true);
-        context.define_type_alias("int".to_string(), TypeInfo::I32, true);
-        context.define_type_alias("number".to_string(), TypeInfo::F64, true);
-        context.define_type_alias("None".to_string(), TypeInfo::Unit, true);
-        context.define_type_alias("unit".to_string(), TypeInfo::Unit, true);
+        context.define_type_alias("float", TypeInfo::F64, true);
+        context.define_type_alias("int", TypeInfo::I32, true);
+        context.define_type_alias("number", TypeInfo::F64, true);
+        context.define_type_alias("None", TypeInfo::Unit, true);
+        context.define_type_alias("unit", TypeInfo::Unit, true);
+        context.define_type_alias("list", TypeInfo::List(Box::new(TypeInfo::Unknown)), true);
         context.define_type_alias(
-            "list".to_string(),
-            TypeInfo::List(Box::new(TypeInfo::Unknown)),
-            true,
-        );
-        context.define_type_alias(
-            "dict".to_string(),
+            "dict",
             TypeInfo::Dict {
                 key: Box::new(TypeInfo::Unknown),
                 value: Box::new(TypeInfo::Unknown),
             },
             true,
         );
-        context.define_type_alias("Error".to_string(), TypeInfo::Error, true);
-        context.define_type_alias("string".to_string(), TypeInfo::Str, true);
+        context.define_type_alias("Error", TypeInfo::Error, true);
+        context.define_type_alias("string", TypeInfo::Str, true);
 
         Self {
             errors: Vec::new(),
@@ -174,8 +171,8 @@ impl TypeChecker {
     /// Register all built-in functions in the type context
     fn register_builtins(context: &mut TypeContext) {
         // print function
-        context.functions.insert(
-            "print".to_string(),
+        context.insert_function(
+            "print",
             TypeInfo::Function {
                 params: vec![TypeInfo::Str],
                 param_defaults: vec![false],
@@ -184,8 +181,8 @@ impl TypeChecker {
         );
 
         // println function
-        context.functions.insert(
-            "println".to_string(),
+        context.insert_function(
+            "println",
             TypeInfo::Function {
                 params: vec![TypeInfo::Str],
                 param_defaults: vec![false],
@@ -193,8 +190,8 @@ impl TypeChecker {
             },
         );
 
-        context.functions.insert(
-            "str".to_string(),
+        context.insert_function(
+            "str",
             TypeInfo::Function {
                 params: vec![TypeInfo::Unknown],
                 param_defaults: vec![false],
@@ -203,8 +200,8 @@ impl TypeChecker {
         );
 
         // len functions (accepts string, list, map, etc.)
-        context.functions.insert(
-            "len".to_string(),
+        context.insert_function(
+            "len",
             TypeInfo::Function {
                 params: vec![TypeInfo::Unknown],
                 param_defaults: vec![false],
@@ -213,8 +210,8 @@ impl TypeChecker {
         );
 
         // cap function
-        context.functions.insert(
-            "cap".to_string(),
+        context.insert_function(
+            "cap",
             TypeInfo::Function {
                 params: vec![TypeInfo::Str],
                 param_defaults: vec![false],
@@ -223,14 +220,44 @@ impl TypeChecker {
         );
 
         // panic function
-        context.functions.insert(
-            "panic".to_string(),
+        context.insert_function(
+            "panic",
             TypeInfo::Function {
                 params: vec![TypeInfo::Str],
                 param_defaults: vec![false],
                 return_type: Box::new(TypeInfo::Unit),
             },
         );
+
+        // Range builtins. As a `for` loop's iterable they run as counted
+        // loops; anywhere else they build a list.
+        for (name, params, element) in [
+            ("range", vec![TypeInfo::I64, TypeInfo::I64], TypeInfo::I64),
+            (
+                "range_float",
+                vec![TypeInfo::F64, TypeInfo::F64],
+                TypeInfo::F64,
+            ),
+            (
+                "range_step",
+                vec![TypeInfo::I64, TypeInfo::I64, TypeInfo::I64],
+                TypeInfo::I64,
+            ),
+            (
+                "enumerate",
+                vec![TypeInfo::List(Box::new(TypeInfo::Unknown))],
+                TypeInfo::Str,
+            ),
+        ] {
+            context.insert_function(
+                name,
+                TypeInfo::Function {
+                    param_defaults: vec![false; params.len()],
+                    params,
+                    return_type: Box::new(TypeInfo::List(Box::new(element))),
+                },
+            );
+        }
     }
 
     /// Type check a program
@@ -243,9 +270,7 @@ impl TypeChecker {
         for statement in &program.statements {
             if let Statement::Function(function) = statement.as_ref() {
                 let sig = self.infer_function_signature(function);
-                self.context
-                    .functions
-                    .insert(function.as_ref().name.clone(), sig);
+                self.context.insert_function(&function.as_ref().name, sig);
             }
         }
 
@@ -308,15 +333,16 @@ impl TypeChecker {
         let mut spans = Vec::new();
         let mut expr_ids = Vec::new();
         self.collect_metadata_in_block(body, &mut spans, &mut expr_ids);
+        let method_name = Symbol::intern(method_name);
         if !spans.is_empty() {
             self.method_comprehension_spans
-                .entry(method_name.to_string())
+                .entry(method_name)
                 .or_default()
                 .extend(spans);
         }
         if !expr_ids.is_empty() {
             self.method_expr_ids
-                .entry(method_name.to_string())
+                .entry(method_name)
                 .or_default()
                 .extend(expr_ids);
         }
@@ -519,14 +545,17 @@ impl TypeChecker {
         if inferred.is_empty() {
             return;
         }
-        if let Some(spans) = self.method_comprehension_spans.get(method_name) {
+        let Some(method_name) = Symbol::lookup(method_name) else {
+            return;
+        };
+        if let Some(spans) = self.method_comprehension_spans.get(&method_name) {
             for span in spans {
                 if let Some(ty) = self.comprehension_var_types.get_mut(span) {
                     *ty = ty.substitute(inferred);
                 }
             }
         }
-        if let Some(expr_ids) = self.method_expr_ids.get(method_name) {
+        if let Some(expr_ids) = self.method_expr_ids.get(&method_name) {
             for id in expr_ids {
                 if let Some(ty) = self.expr_types.get_mut(id) {
                     *ty = ty.substitute(inferred);
@@ -674,7 +703,7 @@ impl TypeChecker {
             .clone()
             .unwrap_or_else(|| module_name.clone());
         self.context
-            .insert_variable(alias, TypeInfo::Module(module_name));
+            .insert_variable(&alias, TypeInfo::Module(module_name));
     }
 
     fn canonical_module_name(module: &str) -> Option<String> {
@@ -767,7 +796,7 @@ impl TypeChecker {
 
                     // Push generic parameters to context for method type checking
                     for generic in generics {
-                        self.context.push_generic(generic.clone());
+                        self.context.push_generic(generic);
                     }
 
                     for method in methods {
@@ -780,7 +809,7 @@ impl TypeChecker {
                             method_node.as_ref().body.as_ref(),
                         );
                         let sig = self.infer_function_signature(&method_node);
-                        self.context.insert_function(method_name.clone(), sig);
+                        self.context.insert_function(&method_name, sig);
                     }
 
                     // Pop generic parameters
@@ -795,7 +824,7 @@ impl TypeChecker {
                     ..
                 } => {
                     let ty = self.context.type_from_annotation(target);
-                    self.context.define_type_alias(name.clone(), ty, *public);
+                    self.context.define_type_alias(name, ty, *public);
                 }
                 Statement::Enum {
                     name,
@@ -835,14 +864,11 @@ impl TypeChecker {
             } else {
                 TypeInfo::Unknown
             };
-            fn_context.insert_variable(param.as_ref().name.as_ref().clone(), param_type);
+            fn_context.insert_variable(param.as_ref().name.as_ref(), param_type);
         }
 
         // Copy function signatures to inner context
-        for (name, sig) in &self.context.functions {
-            fn_context.functions.insert(name.clone(), sig.clone());
-        }
-
+        fn_context.functions = self.context.functions.clone();
         fn_context.structs = self.context.structs.clone();
         fn_context.type_aliases = self.context.type_aliases.clone();
         fn_context.enums = self.context.enums.clone();
@@ -877,7 +903,7 @@ impl TypeChecker {
 
         // Push generic parameters to context
         for param in &generic_params {
-            self.context.push_generic(param.clone());
+            self.context.push_generic(param);
         }
 
         // Type check function body
@@ -1183,7 +1209,7 @@ impl TypeChecker {
         match pattern.as_ref() {
             Pattern::Identifier(name) => {
                 // Simple identifier pattern binds the whole value
-                self.context.insert_variable(name.clone(), ty.clone());
+                self.context.insert_variable(name, ty.clone());
             }
             Pattern::EnumVariant {
                 enum_name,
@@ -1259,8 +1285,7 @@ impl TypeChecker {
                                 self.bind_pattern_variables(pattern, field_type);
                             } else {
                                 // No nested pattern, bind the field name directly
-                                self.context
-                                    .insert_variable(field_name.clone(), field_type.clone());
+                                self.context.insert_variable(field_name, field_type.clone());
                             }
                         }
                     }
@@ -1273,7 +1298,7 @@ impl TypeChecker {
                     }
                     if let Some(rest_var) = rest {
                         // Rest pattern gets the list type
-                        self.context.insert_variable(rest_var.clone(), ty.clone());
+                        self.context.insert_variable(rest_var, ty.clone());
                     }
                 }
             }
@@ -1513,11 +1538,9 @@ impl TypeChecker {
                             .with_span(*span),
                         );
                     }
-                    self.context
-                        .insert_variable(name.as_ref().clone(), annotated_type);
+                    self.context.insert_variable(name.as_ref(), annotated_type);
                 } else {
-                    self.context
-                        .insert_variable(name.as_ref().clone(), expr_type);
+                    self.context.insert_variable(name.as_ref(), expr_type);
                 }
                 Ok(TypeInfo::Unit)
             }
@@ -1609,12 +1632,11 @@ impl TypeChecker {
                 };
 
                 let previous = self.context.remove_variable(var.as_ref());
-                self.context
-                    .insert_variable(var.as_ref().clone(), element_type);
+                self.context.insert_variable(var.as_ref(), element_type);
                 self.check_block(body)?;
                 match previous {
                     Some(prev) => {
-                        self.context.insert_variable(var.as_ref().clone(), prev);
+                        self.context.insert_variable(var.as_ref(), prev);
                     }
                     None => {
                         self.context.remove_variable(var.as_ref());
@@ -1739,6 +1761,8 @@ impl TypeChecker {
                 Expr::Identifier(name) => {
                     if let Some(var_type) = self.context.get_variable(name) {
                         Ok(var_type.clone())
+                    } else if let Some(func_type) = self.context.get_function(name) {
+                        Ok(func_type.clone())
                     } else {
                         if self.registry.is_some_and(|r| r.has_module(name)) {
                             self.errors.push(
@@ -1754,7 +1778,11 @@ impl TypeChecker {
                             .with_span(*span);
 
                         // Try to find a suggestion
-                        let candidates = self.context.variables.keys().cloned();
+                        let candidates = self
+                            .context
+                            .variables
+                            .keys()
+                            .map(|name| name.as_str().to_string());
                         if let Some(closest) =
                             otterc_utils::suggest::find_best_match(name, candidates)
                         {
@@ -2505,8 +2533,7 @@ impl TypeChecker {
                     };
 
                     let previous = self.context.remove_variable(var);
-                    self.context
-                        .insert_variable(var.clone(), element_iter_type.clone());
+                    self.context.insert_variable(var, element_iter_type.clone());
 
                     if let Some(cond_expr) = condition {
                         let cond_type = self.infer_expr_type(cond_expr)?;
@@ -2528,7 +2555,7 @@ impl TypeChecker {
 
                     match previous {
                         Some(prev) => {
-                            self.context.insert_variable(var.clone(), prev);
+                            self.context.insert_variable(var, prev);
                         }
                         None => {
                             self.context.remove_variable(var);
@@ -2559,8 +2586,7 @@ impl TypeChecker {
                     };
 
                     let previous = self.context.remove_variable(var);
-                    self.context
-                        .insert_variable(var.clone(), element_iter_type.clone());
+                    self.context.insert_variable(var, element_iter_type.clone());
 
                     if let Some(cond_expr) = condition {
                         let cond_type = self.infer_expr_type(cond_expr)?;
@@ -2593,7 +2619,7 @@ impl TypeChecker {
 
                     match previous {
                         Some(prev) => {
-                            self.context.insert_variable(var.clone(), prev);
+                            self.context.insert_variable(var, prev);
                         }
                         None => {
                             self.context.remove_variable(var);
@@ -2872,8 +2898,7 @@ impl TypeChecker {
         for statement in &program.statements {
             match statement.as_ref() {
                 Statement::Function(function) if function.as_ref().public => {
-                    if let Some(sig) = self.context.functions.get(&function.as_ref().name).cloned()
-                    {
+                    if let Some(sig) = self.context.get_function(&function.as_ref().name).cloned() {
                         exports
                             .functions
                             .insert(function.as_ref().name.clone(), sig);
@@ -2911,16 +2936,16 @@ impl TypeChecker {
         }
 
         self.context
-            .insert_variable(alias.to_string(), TypeInfo::Module(exports.module.clone()));
+            .insert_variable(alias, TypeInfo::Module(exports.module.clone()));
 
         for (name, ty) in &exports.functions {
             let qualified = format!("{}.{}", exports.module, name);
-            self.context.insert_function(qualified, ty.clone());
+            self.context.insert_function(&qualified, ty.clone());
         }
 
         for (name, ty) in &exports.variables {
             let qualified = format!("{}.{}", exports.module, name);
-            self.context.insert_variable(qualified, ty.clone());
+            self.context.insert_variable(&qualified, ty.clone());
         }
 
         for def in exports.structs.values() {
@@ -2932,7 +2957,9 @@ impl TypeChecker {
         }
 
         for (name, ty) in &exports.type_aliases {
-            self.context.type_aliases.insert(name.clone(), ty.clone());
+            self.context
+                .type_aliases
+                .insert(Symbol::intern(name), ty.clone());
         }
     }
 
@@ -3010,6 +3037,11 @@ fn ffi_type_to_typeinfo(ft: &FfiType) -> TypeInfo {
             value: Box::new(TypeInfo::Unknown),
         },
         FfiType::Struct { .. } | FfiType::Tuple(_) => TypeInfo::Unknown,
+        FfiType::Function { params, result } => TypeInfo::Function {
+            params: params.iter().map(ffi_type_to_typeinfo).collect(),
+            param_defaults: vec![false; params.len()],
+            return_type: Box::new(ffi_type_to_typeinfo(result)),
+        },
     }
 }
 
@@ -3072,4 +3104,151 @@ mod tests {
         let ty = checker.infer_expr_type(&expr).unwrap();
         assert_eq!(ty, TypeInfo::F64);
     }
+
+    #[test]
+    fn test_range_builtins_return_typed_lists() {
+        let mut checker = TypeChecker::new();
+        let int = |value: f64| {
+            Node::new(
+                Expr::Literal(Node::new(
+                    Literal::Number(NumberLiteral::new(value, false)),
+                    Span::new(0, 0),
+                )),
+                Span::new(0, 0),
+            )
+        };
+
+        let expr = Node::new(
+            Expr::Call {
+                func: Box::new(Node::new(
+                    Expr::Identifier("range_step".to_string()),
+                    Span::new(0, 0),
+                )),
+                args: vec![int(0.0), int(10.0), int(2.0)],
+            },
+            Span::new(0, 0),
+        );
+        let ty = checker.infer_expr_type(&expr).unwrap();
+        assert_eq!(ty, TypeInfo::List(Box::new(TypeInfo::I64)));
+    }
+
+    #[test]
+    fn callbacks_must_match_the_ffi_signature_exactly() {
+        use otterc_symbol::registry::{FfiFunction, FfiSignature};
+
+        let registry: &'static SymbolRegistry = Box::leak(Box::new(SymbolRegistry::new()));
+        registry.register(FfiFunction {
+            name: "task.par_map_float".into(),
+            symbol: "otter_task_par_map_float".into(),
+            signature: FfiSignature::new(
+                vec![
+                    FfiType::List,
+                    FfiType::function(vec![FfiType::F64], FfiType::F64),
+                ],
+                FfiType::List,
+            ),
+        });
+        let function = |params: Vec<TypeInfo>, return_type: TypeInfo| TypeInfo::Function {
+            param_defaults: vec![false; params.len()],
+            params,
+            return_type: Box::new(return_type),
+        };
+        let identifier =
+            |name: &str| Node::new(Expr::Identifier(name.to_string()), Span::new(0, 0));
+        let call = |callback: &str| {
+            Node::new(
+                Expr::Call {
+                    func: Box::new(Node::new(
+                        Expr::Member {
+                            object: Box::new(identifier("task")),
+                            field: "par_map_float".to_string(),
+                        },
+                        Span::new(0, 0),
+                    )),
+                    args: vec![identifier("values"), identifier(callback)],
+                },
+                Span::new(0, 0),
+            )
+        };
+
+        let mut checker = TypeChecker::new().with_registry(registry);
+        checker
+            .context
+            .insert_variable("task".into(), TypeInfo::Module("task".into()));
+        checker
+            .context
+            .insert_variable("values".into(), TypeInfo::List(Box::new(TypeInfo::F64)));
+        checker.context.insert_function(
+            "square".into(),
+            function(vec![TypeInfo::F64], TypeInfo::F64),
+        );
+        checker
+            .context
+            .insert_function("twice".into(), function(vec![TypeInfo::I64], TypeInfo::I64));
+        checker.context.insert_function(
+            "untyped".into(),
+            function(vec![TypeInfo::Unknown], TypeInfo::F64),
+        );
+
+        checker.infer_expr_type(&call("square")).unwrap();
+        assert!(checker.errors().is_empty());
+
+        // An int callback would read its argument from the wrong register.
+        checker.infer_expr_type(&call("twice")).unwrap();
+        checker.infer_expr_type(&call("untyped")).unwrap();
+        assert_eq!(checker.errors().len(), 2);
+        assert!(
+            checker.errors()[0]
+                .message
+                .contains("expected fn(f64) -> f64, got fn(i64) -> i64")
+        );
+    }
+
+    #[test]
+    fn fn_annotations_take_the_result_last() {
+        let simple = |name: &str| Node::new(Type::Simple(name.to_string()), Span::new(0, 0));
+        let annotation = Type::Generic {
+            base: "Fn".to_string(),
+            args: vec![simple("int"), simple("float"), simple("bool")],
+        };
+        assert_eq!(
+            TypeInfo::from(&annotation),
+            TypeInfo::Function {
+                params: vec![TypeInfo::I64, TypeInfo::F64],
+                param_defaults: vec![false, false],
+                return_type: Box::new(TypeInfo::Bool),
+            }
+        );
+
+        let procedure = TypeInfo::from(&Type::Generic {
+            base: "Fn".to_string(),
+            args: vec![simple("int"), simple("unit")],
+        });
+        let unannotated_result = TypeInfo::Function {
+            params: vec![TypeInfo::I64],
+            param_defaults: vec![false],
+            return_type: Box::new(TypeInfo::Unknown),
+        };
+        assert!(unannotated_result.is_compatible_with(&procedure));
+        assert!(!procedure.is_compatible_with(&unannotated_result));
+    }
+
+    #[test]
+    fn context_lookups_do_not_intern_unknown_names() {
+        let mut context = TypeContext::new();
+        context.insert_variable("declared_in_context", TypeInfo::I64);
+        assert_eq!(
+            context.get_variable("declared_in_context"),
+            Some(&TypeInfo::I64)
+        );
+
+        assert!(
+            context
+                .get_variable("looked_up_but_never_declared")
+                .is_none()
+        );
+        assert!(context.get_struct("looked_up_but_never_declared").is_none());
+        assert!(!context.is_generic("looked_up_but_never_declared"));
+        assert!(Symbol::lookup("looked_up_but_never_declared").is_none());
+    }
 }
@@ -0,0 +1,755 @@
+//! Workspace-wide symbol index.
+//!
+//! Maps interned symbol names to their definitions and to a postings list of
+//! every reference across the modules of a workspace. Each module's
+//! contribution is tracked separately so that re-indexing a changed module
+//! only touches the symbols it mentions, and the whole index can be persisted
+//! so tools can answer navigation queries before re-parsing anything.
+
+use std::collections::{HashMap, HashSet};
+use std::fs;
+use std::path::Path;
+
+use anyhow::{Context, Result, bail};
+use serde::{Deserialize, Serialize};
+
+use otterc_ast::nodes::{Block, Expr, FStringPart, Function, Node, Pattern, Program, Statement};
+use otterc_span::Span;
+
+/// Bumped whenever the on-disk layout changes; older snapshots are ignored.
+const SNAPSHOT_VERSION: u32 = 1;
+
+/// Interned symbol name inside a [`WorkspaceIndex`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Serialize, Deserialize)]
+pub struct SymbolId(u32);
+
+/// Interned module name inside a [`WorkspaceIndex`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Serialize, Deserialize)]
+pub struct ModuleId(u32);
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub enum IndexedSymbolKind {
+    Function,
+    Method,
+    Struct,
+    Enum,
+    TypeAlias,
+    Variable,
+}
+
+/// A byte range inside one module of the workspace.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub struct SymbolLocation {
+    pub module: ModuleId,
+    pub start: usize,
+    pub end: usize,
+}
+
+impl SymbolLocation {
+    pub fn span(&self) -> Span {
+        Span::new(self.start, self.end)
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub struct SymbolDefinition {
+    pub kind: IndexedSymbolKind,
+    pub location: SymbolLocation,
+    pub public: bool,
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+struct ModuleEntry {
+    name: String,
+    /// Content hash of the source the entry was built from, if known.
+    fingerprint: Option<u64>,
+    /// Symbols this module contributed definitions or references to.
+    symbols: Vec<SymbolId>,
+}
+
+#[derive(Deserialize)]
+struct Snapshot {
+    version: u32,
+    index: WorkspaceIndex,
+}
+
+#[derive(Serialize)]
+struct SnapshotRef<'a> {
+    version: u32,
+    index: &'a WorkspaceIndex,
+}
+
+/// Definitions and references of every top-level symbol in a workspace.
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
+pub struct WorkspaceIndex {
+    names: Vec<String>,
+    modules: Vec<ModuleEntry>,
+    /// Indexed by `SymbolId`.
+    definitions: Vec<Vec<SymbolDefinition>>,
+    /// Indexed by `SymbolId`.
+    postings: Vec<Vec<SymbolLocation>>,
+    #[serde(skip)]
+    name_ids: HashMap<String, SymbolId>,
+    #[serde(skip)]
+    module_ids: HashMap<String, ModuleId>,
+}
+
+impl WorkspaceIndex {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Load a snapshot written by [`WorkspaceIndex::save`].
+    pub fn load(path: &Path) -> Result<Self> {
+        let data = fs::read(path)
+            .with_context(|| format!("failed to read index snapshot {}", path.display()))?;
+        let snapshot: Snapshot = serde_json::from_slice(&data)
+            .with_context(|| format!("failed to parse index snapshot {}", path.display()))?;
+        if snapshot.version != SNAPSHOT_VERSION {
+            bail!(
+                "index snapshot {} has version {}, expected {}",
+                path.display(),
+                snapshot.version,
+                SNAPSHOT_VERSION
+            );
+        }
+
+        let mut index = snapshot.index;
+        index.name_ids = index
+            .names
+            .iter()
+            .enumerate()
+            .map(|(id, name)| (name.clone(), SymbolId(id as u32)))
+            .collect();
+        index.module_ids = index
+            .modules
+            .iter()
+            .enumerate()
+            .map(|(id, module)| (module.name.clone(), ModuleId(id as u32)))
+            .collect();
+        Ok(index)
+    }
+
+    /// Persist the index, replacing any previous snapshot atomically.
+    pub fn save(&self, path: &Path) -> Result<()> {
+        if let Some(parent) = path.parent() {
+            fs::create_dir_all(parent)?;
+        }
+        let snapshot = SnapshotRef {
+            version: SNAPSHOT_VERSION,
+            index: self,
+        };
+        let data = serde_json::to_vec(&snapshot)?;
+        let tmp_path = path.with_extension("tmp");
+        fs::write(&tmp_path, data)?;
+        fs::rename(&tmp_path, path)
+            .with_context(|| format!("failed to write index snapshot {}", path.display()))?;
+        Ok(())
+    }
+
+    pub fn symbol(&self, name: &str) -> Option<SymbolId> {
+        self.name_ids.get(name).copied()
+    }
+
+    pub fn symbol_name(&self, id: SymbolId) -> &str {
+        &self.names[id.0 as usize]
+    }
+
+    pub fn module(&self, name: &str) -> Option<ModuleId> {
+        self.module_ids.get(name).copied()
+    }
+
+    pub fn module_name(&self, id: ModuleId) -> &str {
+        &self.modules[id.0 as usize].name
+    }
+
+    pub fn definitions(&self, name: &str) -> &[SymbolDefinition] {
+        self.symbol(name)
+            .map(|id| self.definitions[id.0 as usize].as_slice())
+            .unwrap_or(&[])
+    }
+
+    pub fn references(&self, name: &str) -> &[SymbolLocation] {
+        self.symbol(name)
+            .map(|id| self.postings[id.0 as usize].as_slice())
+            .unwrap_or(&[])
+    }
+
+    /// All symbol names that currently have at least one definition.
+    pub fn defined_symbols(&self) -> impl Iterator<Item = (&str, &[SymbolDefinition])> {
+        self.names
+            .iter()
+            .zip(&self.definitions)
+            .filter(|(_, defs)| !defs.is_empty())
+            .map(|(name, defs)| (name.as_str(), defs.as_slice()))
+    }
+
+    /// Whether the module was indexed from source with the given content hash.
+    pub fn is_current(&self, module: &str, fingerprint: u64) -> bool {
+        self.module(module)
+            .is_some_and(|id| self.modules[id.0 as usize].fingerprint == Some(fingerprint))
+    }
+
+    pub fn set_fingerprint(&mut self, module: &str, fingerprint: u64) {
+        let id = self.intern_module(module);
+        self.modules[id.0 as usize].fingerprint = Some(fingerprint);
+    }
+
+    /// Replace everything the index knows about `module` with the contents of `program`.
+    pub fn index_module(&mut self, module: &str, program: &Program) {
+        let module = self.intern_module(module);
+        self.clear_module(module);
+
+        let mut builder = IndexBuilder {
+            index: self,
+            module,
+            touched: Vec::new(),
+            scopes: Vec::new(),
+        };
+        builder.top_level(&program.statements);
+
+        let mut touched = builder.touched;
+        touched.sort_unstable_by_key(|id| id.0);
+        touched.dedup();
+        let entry = &mut self.modules[module.0 as usize];
+        entry.symbols = touched;
+        entry.fingerprint = None;
+    }
+
+    /// Drop every definition and reference contributed by `module`.
+    pub fn remove_module(&mut self, module: &str) {
+        if let Some(id) = self.module(module) {
+            self.clear_module(id);
+            self.modules[id.0 as usize].fingerprint = None;
+        }
+    }
+
+    fn clear_module(&mut self, module: ModuleId) {
+        let symbols = std::mem::take(&mut self.modules[module.0 as usize].symbols);
+        for symbol in symbols {
+            self.definitions[symbol.0 as usize].retain(|def| def.location.module != module);
+            self.postings[symbol.0 as usize].retain(|loc| loc.module != module);
+        }
+    }
+
+    fn intern(&mut self, name: &str) -> SymbolId {
+        if let Some(id) = self.name_ids.get(name) {
+            return *id;
+        }
+        let id = SymbolId(self.names.len() as u32);
+        self.names.push(name.to_string());
+        self.definitions.push(Vec::new());
+        self.postings.push(Vec::new());
+        self.name_ids.insert(name.to_string(), id);
+        id
+    }
+
+    fn intern_module(&mut self, name: &str) -> ModuleId {
+        if let Some(id) = self.module_ids.get(name) {
+            return *id;
+        }
+        let id = ModuleId(self.modules.len() as u32);
+        self.modules.push(ModuleEntry {
+            name: name.to_string(),
+            fingerprint: None,
+            symbols: Vec::new(),
+        });
+        self.module_ids.insert(name.to_string(), id);
+        id
+    }
+}
+
+struct IndexBuilder<'a> {
+    index: &'a mut WorkspaceIndex,
+    module: ModuleId,
+    touched: Vec<SymbolId>,
+    /// Names bound by parameters, `let`s, loops and patterns in the
+    /// enclosing functions and blocks, innermost last. Identifiers found here
+    /// are locals and are not indexed.
+    scopes: Vec<HashSet<String>>,
+}
+
+impl IndexBuilder<'_> {
+    fn location(&self, span: Span) -> SymbolLocation {
+        SymbolLocation {
+            module: self.module,
+            start: span.start(),
+            end: span.end(),
+        }
+    }
+
+    fn define(&mut self, name: &str, kind: IndexedSymbolKind, span: Span, public: bool) {
+        let id = self.index.intern(name);
+        let location = self.location(span);
+        self.index.definitions[id.0 as usize].push(SymbolDefinition {
+            kind,
+            location,
+            public,
+        });
+        self.touched.push(id);
+    }
+
+    /// Records a use of `name` unless it resolves to a local binding.
+    fn reference(&mut self, name: &str, span: Span) {
+        if self.is_local(name) {
+            return;
+        }
+        self.reference_global(name, span);
+    }
+
+    /// Records a use of `name` that can only mean a module-level item: a
+    /// type, or a field or method after `.`.
+    fn reference_global(&mut self, name: &str, span: Span) {
+        let id = self.index.intern(name);
+        let location = self.location(span);
+        self.index.postings[id.0 as usize].push(location);
+        self.touched.push(id);
+    }
+
+    fn is_local(&self, name: &str) -> bool {
+        self.scopes.iter().any(|scope| scope.contains(name))
+    }
+
+    fn bind(&mut self, name: &str) {
+        if let Some(scope) = self.scopes.last_mut() {
+            scope.insert(name.to_string());
+        }
+    }
+
+    fn scoped(&mut self, bindings: &[&str], visit: impl FnOnce(&mut Self)) {
+        self.scopes
+            .push(bindings.iter().map(|name| (*name).to_string()).collect());
+        visit(self);
+        self.scopes.pop();
+    }
+
+    /// Only module-level items are definitions; locals stay per-document.
+    fn top_level(&mut self, statements: &[Node<Statement>]) {
+        for stmt in statements {
+            let span = *stmt.span();
+            match stmt.as_ref() {
+                Statement::Let {
+                    name, expr, public, ..
+                } => {
+                    self.define(
+                        name.as_ref(),
+                        IndexedSymbolKind::Variable,
+                        *name.span(),
+                        *public,
+                    );
+                    self.expr(expr);
+                }
+                Statement::Function(func) => {
+                    let function = func.as_ref();
+                    self.define(
+                        &function.name,
+                        IndexedSymbolKind::Function,
+                        *func.span(),
+                        function.public,
+                    );
+                    self.function(function);
+                }
+                Statement::Struct {
+                    name,
+                    methods,
+                    public,
+                    ..
+                } => {
+                    self.define(name, IndexedSymbolKind::Struct, span, *public);
+                    for method in methods {
+                        self.define(
+                            &method.as_ref().name,
+                            IndexedSymbolKind::Method,
+                            *method.span(),
+                            *public,
+                        );
+                        self.function(method.as_ref());
+                    }
+                }
+                Statement::Enum { name, public, .. } => {
+                    self.define(name, IndexedSymbolKind::Enum, span, *public);
+                }
+                Statement::TypeAlias { name, public, .. } => {
+                    self.define(name, IndexedSymbolKind::TypeAlias, span, *public);
+                }
+                _ => self.statement(stmt),
+            }
+        }
+    }
+
+    fn function(&mut self, function: &Function) {
+        for param in &function.params {
+            if let Some(default) = &param.as_ref().default {
+                self.expr(default);
+            }
+        }
+        let params: Vec<&str> = function
+            .params
+            .iter()
+            .map(|param| param.as_ref().name.as_ref().as_str())
+            .collect();
+        self.scoped(&params, |builder| builder.block(function.body.as_ref()));
+    }
+
+    fn block(&mut self, block: &Block) {
+        self.scoped(&[], |builder| {
+            for stmt in &block.statements {
+                builder.statement(stmt);
+            }
+        });
+    }
+
+    fn statement(&mut self, stmt: &Node<Statement>) {
+        match stmt.as_ref() {
+            Statement::Let { name, expr, .. } => {
+                self.expr(expr);
+                self.bind(name.as_ref());
+            }
+            Statement::Expr(expr) => self.expr(expr),
+            Statement::Assignment { name, expr } => {
+                self.reference(name.as_ref(), *name.span());
+                self.expr(expr);
+            }
+            Statement::Return(value) => {
+                if let Some(expr) = value {
+                    self.expr(expr);
+                }
+            }
+            Statement::If {
+                cond,
+                then_block,
+                elif_blocks,
+                else_block,
+            } => {
+                self.expr(cond);
+                self.block(then_block.as_ref());
+                for (cond, block) in elif_blocks {
+                    self.expr(cond);
+                    self.block(block.as_ref());
+                }
+                if let Some(block) = else_block {
+                    self.block(block.as_ref());
+                }
+            }
+            Statement::For {
+                var,
+                iterable,
+                body,
+            } => {
+                self.expr(iterable);
+                self.scoped(&[var.as_ref()], |builder| builder.block(body.as_ref()));
+            }
+            Statement::While { cond, body } => {
+                self.expr(cond);
+                self.block(body.as_ref());
+            }
+            Statement::Function(func) => {
+                self.bind(&func.as_ref().name);
+                self.function(func.as_ref());
+            }
+            Statement::Struct { methods, .. } => {
+                for method in methods {
+                    self.function(method.as_ref());
+                }
+            }
+            Statement::Block(block) => self.block(block.as_ref()),
+            Statement::Break
+            | Statement::Continue
+            | Statement::Pass
+            | Statement::Enum { .. }
+            | Statement::TypeAlias { .. }
+            | Statement::Use { .. }
+            | Statement::PubUse { .. } => {}
+        }
+    }
+
+    fn expr(&mut self, expr: &Node<Expr>) {
+        let span = *expr.span();
+        match expr.as_ref() {
+            Expr::Identifier(name) => self.reference(name, span),
+            Expr::Member { object, field } => {
+                self.expr(object);
+                // The field name is the tail of the member expression.
+                let start = span.end().saturating_sub(field.len()).max(span.start());
+                self.reference_global(field, Span::new(start, span.end()));
+            }
+            Expr::Call { func, args } => {
+                self.expr(func);
+                for arg in args {
+                    self.expr(arg);
+                }
+            }
+            Expr::Binary { left, right, .. }
+            | Expr::Range {
+                start: left,
+                end: right,
+            } => {
+                self.expr(left);
+                self.expr(right);
+            }
+            Expr::Unary { expr, .. } | Expr::Await(expr) | Expr::Spawn(expr) => self.expr(expr),
+            Expr::If {
+                cond,
+                then_branch,
+                else_branch,
+            } => {
+                self.expr(cond);
+                self.expr(then_branch);
+                if let Some(else_branch) = else_branch {
+                    self.expr(else_branch);
+                }
+            }
+            Expr::Match { value, arms } => {
+                self.expr(value);
+                for arm in arms {
+                    let arm = arm.as_ref();
+                    self.scoped(&[], |builder| {
+                        builder.pattern(&arm.pattern);
+                        if let Some(guard) = &arm.guard {
+                            builder.expr(guard);
+                        }
+                        builder.block(arm.body.as_ref());
+                    });
+                }
+            }
+            Expr::Array(elements) => {
+                for element in elements {
+                    self.expr(element);
+                }
+            }
+            Expr::Dict(pairs) => {
+                for (key, value) in pairs {
+                    self.expr(key);
+                    self.expr(value);
+                }
+            }
+            Expr::ListComprehension {
+                element,
+                var,
+                iterable,
+                condition,
+            } => {
+                self.expr(iterable);
+                self.scoped(&[var], |builder| {
+                    builder.expr(element);
+                    if let Some(condition) = condition {
+                        builder.expr(condition);
+                    }
+                });
+            }
+            Expr::DictComprehension {
+                key,
+                value,
+                var,
+                iterable,
+                condition,
+            } => {
+                self.expr(iterable);
+                self.scoped(&[var], |builder| {
+                    builder.expr(key);
+                    builder.expr(value);
+                    if let Some(condition) = condition {
+                        builder.expr(condition);
+                    }
+                });
+            }
+            Expr::FString { parts } => {
+                for part in parts {
+                    if let FStringPart::Expr(expr) = part.as_ref() {
+                        self.expr(expr);
+                    }
+                }
+            }
+            Expr::Struct { name, fields } => {
+                let end = (span.start() + name.len()).min(span.end());
+                self.reference_global(name, Span::new(span.start(), end));
+                for (_, value) in fields {
+                    self.expr(value);
+                }
+            }
+            Expr::Literal(_) => {}
+        }
+    }
+
+    fn pattern(&mut self, pattern: &Node<Pattern>) {
+        let span = *pattern.span();
+        match pattern.as_ref() {
+            Pattern::EnumVariant {
+                enum_name, fields, ..
+            } => {
+                let end = (span.start() + enum_name.len()).min(span.end());
+                self.reference_global(enum_name, Span::new(span.start(), end));
+                for field in fields {
+                    self.pattern(field);
+                }
+            }
+            Pattern::Struct { name, fields } => {
+                let end = (span.start() + name.len()).min(span.end());
+                self.reference_global(name, Span::new(span.start(), end));
+                for (field, nested) in fields {
+                    match nested {
+                        Some(nested) => self.pattern(nested),
+                        // `Point { x }` binds `x`.
+                        None => self.bind(field),
+                    }
+                }
+            }
+            Pattern::Array { patterns, rest } => {
+                for nested in patterns {
+                    self.pattern(nested);
+                }
+                if let Some(rest) = rest {
+                    self.bind(rest);
+                }
+            }
+            Pattern::Identifier(name) => self.bind(name),
+            Pattern::Wildcard | Pattern::Literal(_) => {}
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use otterc_ast::nodes::{Literal, Param};
+
+    fn span(start: usize, end: usize) -> Span {
+        Span::new(start, end)
+    }
+
+    fn function(name: &str, body: Vec<Node<Statement>>) -> Node<Statement> {
+        function_with_params(name, &[], body)
+    }
+
+    fn function_with_params(
+        name: &str,
+        params: &[&str],
+        body: Vec<Node<Statement>>,
+    ) -> Node<Statement> {
+        let params = params
+            .iter()
+            .map(|param| {
+                Node::new(
+                    Param::new(Node::new((*param).to_string(), span(0, 0)), None, None),
+                    span(0, 0),
+                )
+            })
+            .collect();
+        let mut func = Function::new(name, params, None, Node::new(Block::new(body), span(0, 0)));
+        func.public = true;
+        Node::new(
+            Statement::Function(Node::new(func, span(0, 10))),
+            span(0, 10),
+        )
+    }
+
+    fn call(name: &str, at: usize) -> Node<Statement> {
+        Node::new(
+            Statement::Expr(Node::new(
+                Expr::Call {
+                    func: Box::new(Node::new(
+                        Expr::Identifier(name.to_string()),
+                        span(at, at + name.len()),
+                    )),
+                    args: Vec::new(),
+                },
+                span(at, at + name.len() + 2),
+            )),
+            span(at, at + name.len() + 2),
+        )
+    }
+
+    #[test]
+    fn reindexing_a_module_replaces_its_entries() {
+        let mut index = WorkspaceIndex::new();
+        index.index_module("math", &Program::new(vec![function("square", Vec::new())]));
+        index.index_module(
+            "app",
+            &Program::new(vec![function("main", vec![call("square", 20)])]),
+        );
+
+        assert_eq!(index.definitions("square").len(), 1);
+        let refs = index.references("square");
+        assert_eq!(refs.len(), 1);
+        assert_eq!(index.module_name(refs[0].module), "app");
+        assert_eq!(refs[0].span(), span(20, 26));
+
+        index.index_module("app", &Program::new(vec![function("main", Vec::new())]));
+        assert!(index.references("square").is_empty());
+        assert_eq!(index.definitions("main").len(), 1);
+
+        index.remove_module("math");
+        assert!(index.definitions("square").is_empty());
+    }
+
+    fn let_unit(name: &str) -> Node<Statement> {
+        Node::new(
+            Statement::Let {
+                name: Node::new(name.to_string(), span(0, 0)),
+                expr: Node::new(
+                    Expr::Literal(Node::new(Literal::Unit, span(0, 0))),
+                    span(0, 0),
+                ),
+                ty: None,
+                public: false,
+            },
+            span(0, 0),
+        )
+    }
+
+    #[test]
+    fn locals_shadowing_a_global_are_not_references() {
+        let mut index = WorkspaceIndex::new();
+        index.index_module("math", &Program::new(vec![function("square", Vec::new())]));
+        index.index_module(
+            "app",
+            &Program::new(vec![
+                function_with_params("by_param", &["square"], vec![call("square", 10)]),
+                function("by_let", vec![let_unit("square"), call("square", 20)]),
+                // The `let` is scoped to its block; the call after it is global.
+                function(
+                    "by_block",
+                    vec![
+                        Node::new(
+                            Statement::Block(Node::new(
+                                Block::new(vec![let_unit("square"), call("square", 30)]),
+                                span(0, 0),
+                            )),
+                            span(0, 0),
+                        ),
+                        call("square", 40),
+                    ],
+                ),
+                function("global", vec![call("square", 50)]),
+            ]),
+        );
+
+        let starts: Vec<usize> = index
+            .references("square")
+            .iter()
+            .map(|location| location.start)
+            .collect();
+        assert_eq!(starts, [40, 50]);
+    }
+
+    #[test]
+    fn snapshot_round_trip_preserves_lookups() {
+        let mut index = WorkspaceIndex::new();
+        index.index_module(
+            "app",
+            &Program::new(vec![function("main", vec![call("helper", 12)])]),
+        );
+        index.set_fingerprint("app", 42);
+
+        let path =
+            std::env::temp_dir().join(format!("otter-workspace-index-{}.json", std::process::id()));
+        index.save(&path).expect("save snapshot");
+        let loaded = WorkspaceIndex::load(&path).expect("load snapshot");
+        let _ = fs::remove_file(&path);
+
+        assert!(loaded.is_current("app", 42));
+        assert!(!loaded.is_current("app", 7));
+        assert_eq!(loaded.definitions("main").len(), 1);
+        assert_eq!(loaded.references("helper").len(), 1);
+    }
+}
@@ -4,10 +4,12 @@
 
 pub mod checker;
 pub mod diagnostics;
+pub mod index;
 pub mod types;
 pub mod workspace;
 
 pub use checker::{ModuleExports, TypeChecker};
 pub use diagnostics::from_type_errors as diagnostics_from_type_errors;
+pub use index::{IndexedSymbolKind, SymbolDefinition, SymbolLocation, WorkspaceIndex};
 pub use types::{EnumLayout, TypeContext, TypeError, TypeInfo};
 pub use workspace::{ModuleDependency, ModuleRecord, TypecheckWorkspace};
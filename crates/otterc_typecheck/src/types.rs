@@ -2,6 +2,7 @@ use std::collections::HashMap;
 
 use otterc_ast::nodes::{EnumVariant, Node, Type};
 use otterc_span::Span;
+use otterc_symbol::Symbol;
 
 use otterc_config::LanguageFeatureFlags;
 
@@ -266,7 +267,10 @@ impl TypeInfo {
                 },
             ) => other.is_compatible_with(alias),
 
-            // Function types must match signature
+            // Function values are code addresses called with the expected
+            // signature, so parameters and results must have the same machine
+            // type: no numeric promotion and no unannotated parameters. A
+            // caller that expects no result ignores whatever is returned.
             (
                 TypeInfo::Function {
                     params: p1,
@@ -280,18 +284,26 @@ impl TypeInfo {
                 },
             ) => {
                 p1.len() == p2.len()
-                    && d1.len() == d2.len()
+                    && d1 == d2
                     && p1
                         .iter()
                         .zip(p2.iter())
-                        .all(|(t1, t2)| t1.is_compatible_with(t2))
-                    && d1.iter().zip(d2.iter()).all(|(a, b)| a == b)
-                    && r1.is_compatible_with(r2)
+                        .all(|(t1, t2)| t1.is_same_signature_type(t2))
+                    && (**r2 == TypeInfo::Unit || r1.is_same_signature_type(r2))
             }
             _ => false,
         }
     }
 
+    /// Whether two types in a function signature are interchangeable across
+    /// an indirect call.
+    fn is_same_signature_type(&self, other: &TypeInfo) -> bool {
+        !matches!(self, TypeInfo::Unknown | TypeInfo::Error)
+            && !matches!(other, TypeInfo::Unknown | TypeInfo::Error)
+            && self.is_compatible_with(other)
+            && other.is_compatible_with(self)
+    }
+
     /// Get a display name for the type
     pub fn display_name(&self) -> String {
         match self {
@@ -409,6 +421,19 @@ impl From<&Type> for TypeInfo {
                         value: Box::new(value),
                     }
                 }
+                // `Fn<A, B, R>` is a function taking `A` and `B` and returning
+                // `R`; the last argument is always the result.
+                "Fn" => {
+                    let (return_type, params) = match args.split_last() {
+                        Some((result, params)) => (TypeInfo::from(result), params),
+                        None => (TypeInfo::Unit, &[][..]),
+                    };
+                    TypeInfo::Function {
+                        params: params.iter().map(TypeInfo::from).collect(),
+                        param_defaults: vec![false; params.len()],
+                        return_type: Box::new(return_type),
+                    }
+                }
                 _ => TypeInfo::Generic {
                     base: base.clone(),
                     args: args.iter().map(|t| t.into()).collect(),
@@ -509,20 +534,24 @@ impl std::fmt::Display for TypeError {
 impl std::error::Error for TypeError {}
 
 /// Context for type checking
+///
+/// Names are interned, so copying the context into each function body and
+/// saving scopes copies integer keys rather than strings. The accessors take
+/// `&str` and look names up without interning them.
 #[derive(Debug, Clone)]
 pub struct TypeContext {
     /// Variables and their types
-    pub variables: HashMap<String, TypeInfo>,
+    pub variables: HashMap<Symbol, TypeInfo>,
     /// Functions and their signatures
-    pub functions: HashMap<String, TypeInfo>,
+    pub functions: HashMap<Symbol, TypeInfo>,
     /// Generic type parameters in scope
-    pub generic_params: Vec<String>,
+    pub generic_params: Vec<Symbol>,
     /// Struct definitions: name -> definition
-    pub structs: HashMap<String, StructDefinition>,
+    pub structs: HashMap<Symbol, StructDefinition>,
     /// Type aliases: name -> actual type
-    pub type_aliases: HashMap<String, TypeInfo>,
+    pub type_aliases: HashMap<Symbol, TypeInfo>,
     /// Enum definitions available in the current module
-    pub enums: HashMap<String, EnumDefinition>,
+    pub enums: HashMap<Symbol, EnumDefinition>,
     /// Active language feature flags
     pub features: LanguageFeatureFlags,
 }
@@ -544,33 +573,33 @@ impl TypeContext {
         }
     }
 
-    pub fn with_function(mut self, name: String, ty: TypeInfo) -> Self {
-        self.functions.insert(name, ty);
+    pub fn with_function(mut self, name: &str, ty: TypeInfo) -> Self {
+        self.insert_function(name, ty);
         self
     }
 
-    pub fn insert_function(&mut self, name: String, ty: TypeInfo) {
-        self.functions.insert(name, ty);
+    pub fn insert_function(&mut self, name: &str, ty: TypeInfo) {
+        self.functions.insert(Symbol::intern(name), ty);
     }
 
-    pub fn insert_variable(&mut self, name: String, ty: TypeInfo) {
-        self.variables.insert(name, ty);
+    pub fn insert_variable(&mut self, name: &str, ty: TypeInfo) {
+        self.variables.insert(Symbol::intern(name), ty);
     }
 
     pub fn get_variable(&self, name: &str) -> Option<&TypeInfo> {
-        self.variables.get(name)
+        self.variables.get(&Symbol::lookup(name)?)
     }
 
     pub fn remove_variable(&mut self, name: &str) -> Option<TypeInfo> {
-        self.variables.remove(name)
+        self.variables.remove(&Symbol::lookup(name)?)
     }
 
     pub fn get_function(&self, name: &str) -> Option<&TypeInfo> {
-        self.functions.get(name)
+        self.functions.get(&Symbol::lookup(name)?)
     }
 
-    pub fn push_generic(&mut self, param: String) {
-        self.generic_params.push(param);
+    pub fn push_generic(&mut self, param: &str) {
+        self.generic_params.push(Symbol::intern(param));
     }
 
     pub fn pop_generic(&mut self) {
@@ -578,45 +607,46 @@ impl TypeContext {
     }
 
     pub fn is_generic(&self, name: &str) -> bool {
-        self.generic_params.contains(&name.to_string())
+        Symbol::lookup(name).is_some_and(|name| self.generic_params.contains(&name))
     }
 
     pub fn define_struct(&mut self, definition: StructDefinition) {
-        self.structs.insert(definition.name.clone(), definition);
+        self.structs
+            .insert(Symbol::intern(&definition.name), definition);
     }
 
     pub fn get_struct(&self, name: &str) -> Option<&StructDefinition> {
-        self.structs.get(name)
+        self.structs.get(&Symbol::lookup(name)?)
     }
 
-    pub fn define_type_alias(&mut self, name: String, ty: TypeInfo, is_public: bool) {
+    pub fn define_type_alias(&mut self, name: &str, ty: TypeInfo, is_public: bool) {
         let stored_type = if self.features.newtype_aliases {
             TypeInfo::Alias {
-                name: name.clone(),
+                name: name.to_string(),
                 underlying: Box::new(ty),
                 is_public,
             }
         } else {
             ty
         };
-        self.type_aliases.insert(name, stored_type);
+        self.type_aliases.insert(Symbol::intern(name), stored_type);
     }
 
     pub fn resolve_type_alias(&self, name: &str) -> Option<&TypeInfo> {
-        self.type_aliases.get(name)
+        self.type_aliases.get(&Symbol::lookup(name)?)
     }
 
     pub fn define_enum(&mut self, definition: EnumDefinition) {
-        self.enums.insert(definition.name.clone(), definition);
+        self.enums
+            .insert(Symbol::intern(&definition.name), definition);
     }
 
     pub fn get_enum(&self, name: &str) -> Option<&EnumDefinition> {
-        self.enums.get(name)
+        self.enums.get(&Symbol::lookup(name)?)
     }
 
     pub fn enum_variant(&self, enum_name: &str, variant: &str) -> Option<&EnumVariant> {
-        self.enums
-            .get(enum_name)
+        self.get_enum(enum_name)
             .and_then(|definition| definition.variants.iter().find(|v| v.name == variant))
     }
 
@@ -637,9 +667,9 @@ impl TypeContext {
                     })
                     .collect();
                 (
-                    name.clone(),
+                    name.as_str().to_string(),
                     EnumLayout {
-                        name: name.clone(),
+                        name: name.as_str().to_string(),
                         generics: definition.generics.clone(),
                         variants: definition
                             .variants
@@ -654,7 +684,7 @@ impl TypeContext {
     }
 
     pub fn build_enum_type(&self, name: &str, args: Vec<TypeInfo>) -> Option<TypeInfo> {
-        let definition = self.enums.get(name)?;
+        let definition = self.get_enum(name)?;
         let mut normalized_args = if args.is_empty() {
             vec![TypeInfo::Unknown; definition.generics.len()]
         } else if args.len() < definition.generics.len() {
@@ -712,7 +742,7 @@ impl TypeContext {
         match ty {
             TypeInfo::Generic { base, args } => {
                 if args.is_empty()
-                    && let Some(struct_def) = self.structs.get(&base)
+                    && let Some(struct_def) = self.get_struct(&base)
                 {
                     return TypeInfo::Struct {
                         name: struct_def.name.clone(),
@@ -3,6 +3,7 @@ use std::collections::{HashMap, HashSet};
 use anyhow::Result;
 
 use crate::checker::{ModuleExports, TypeChecker};
+use crate::index::WorkspaceIndex;
 use crate::types::{EnumLayout, TypeError, TypeInfo};
 use otterc_ast::nodes::{Program, Statement};
 use otterc_config::LanguageFeatureFlags;
@@ -31,6 +32,7 @@ pub struct TypecheckWorkspace {
     features: LanguageFeatureFlags,
     registry: Option<&'static SymbolRegistry>,
     modules: HashMap<String, ModuleRecord>,
+    index: WorkspaceIndex,
 }
 
 impl TypecheckWorkspace {
@@ -43,6 +45,7 @@ impl TypecheckWorkspace {
             features,
             registry: None,
             modules: HashMap::new(),
+            index: WorkspaceIndex::new(),
         }
     }
 
@@ -51,6 +54,12 @@ impl TypecheckWorkspace {
         self
     }
 
+    /// Seed the symbol index, e.g. from a snapshot saved by a previous session.
+    pub fn with_index(mut self, index: WorkspaceIndex) -> Self {
+        self.index = index;
+        self
+    }
+
     pub fn analyze_module(
         &mut self,
         module: impl Into<String>,
@@ -79,6 +88,7 @@ impl TypecheckWorkspace {
         let diagnostics = checker.errors().to_vec();
         let enum_layouts = checker.enum_layouts();
         let (expr_types, span_types, comprehension_types) = checker.into_type_maps();
+        self.index.index_module(&module_id, &program);
 
         let record = ModuleRecord {
             program,
@@ -112,6 +122,21 @@ impl TypecheckWorkspace {
         self.modules.keys()
     }
 
+    /// Workspace-wide definitions and references, kept in sync by `analyze_module`.
+    pub fn index(&self) -> &WorkspaceIndex {
+        &self.index
+    }
+
+    pub fn index_mut(&mut self) -> &mut WorkspaceIndex {
+        &mut self.index
+    }
+
+    /// Forget a module that was deleted from the workspace.
+    pub fn remove_module(&mut self, name: &str) -> Option<ModuleRecord> {
+        self.index.remove_module(name);
+        self.modules.remove(name)
+    }
+
     pub fn diagnostics(&self, name: &str) -> Option<&[TypeError]> {
         self.modules
             .get(name)
@@ -263,5 +288,16 @@ mod tests {
         let record = workspace.module("app").unwrap();
         assert!(record.diagnostics.is_empty());
         assert!(record.exports.functions.contains_key("main"));
+
+        let index = workspace.index();
+        let definition = index.definitions("add_one");
+        assert_eq!(definition.len(), 1);
+        assert_eq!(index.module_name(definition[0].location.module), "math");
+        assert!(
+            index
+                .references("add_one")
+                .iter()
+                .any(|location| index.module_name(location.module) == "app")
+        );
     }
 }
@@ -19,6 +19,7 @@ const TASK_RUNTIME_ENABLED: bool = cfg!(feature = "task-runtime");
 use otterc_cache::{CacheBuildOptions, CacheEntry, CacheManager, CacheMetadata, CompilationInputs};
 use otterc_codegen::{BuildArtifact, build_executable};
 use otterc_config::{CodegenOptLevel, CodegenOptions, LanguageFeatureFlags, TargetTriple, VERSION};
+use otterc_ffi::rust_stubgen::json_dispatch_symbol;
 use otterc_ffi::{BridgeSymbolRegistry, FunctionSpec, TypeSpec};
 use otterc_lexer::{LexerError, tokenize};
 use otterc_module::ModuleProcessor;
@@ -58,6 +59,18 @@ pub struct OtterCli {
     /// Enable release mode (O3 + LTO) when building binaries.
     release: bool,
 
+    #[arg(long, global = true, value_name = "level")]
+    /// Optimization level for generated code (0, 1, 2, 3, s or z); overrides the level implied by --release.
+    opt_level: Option<CodegenOptLevel>,
+
+    #[arg(long, global = true, value_name = "cost")]
+    /// Override the inliner's cost threshold (LLVM default is 225; higher inlines more).
+    inline_threshold: Option<u32>,
+
+    #[arg(long, global = true)]
+    /// Link `use rust:` bridge crates statically with cross-language LTO (needs clang and lld).
+    static_bridges: bool,
+
     #[arg(long, global = true)]
     /// Enable the experimental async task runtime when executing programs.
     tasks: bool,
@@ -123,6 +136,8 @@ pub enum Command {
         path: PathBuf,
         #[arg(short, long)]
         output: Option<PathBuf>,
+        #[command(flatten)]
+        pgo: PgoArgs,
     },
     /// Checks the source file for errors without generating code.
     #[command(alias = "c")]
@@ -132,6 +147,9 @@ pub enum Command {
         /// Files to format (defaults to all .ot files in current directory)
         #[arg(default_value = ".")]
         paths: Vec<PathBuf>,
+        /// Report the first unformatted file and exit with an error instead of rewriting
+        #[arg(long)]
+        check: bool,
     },
     /// Profile OtterLang programs (memory or performance)
     Profile {
@@ -140,20 +158,48 @@ pub enum Command {
     },
     /// Run tests in OtterLang source files
     #[command(alias = "t")]
-    Test {
-        /// Test files or directories to run (defaults to current directory)
-        #[arg(default_value = ".")]
-        paths: Vec<PathBuf>,
-        /// Run tests in parallel
-        #[arg(short, long)]
-        parallel: bool,
-        /// Show output from passing tests
-        #[arg(short, long)]
-        verbose: bool,
-        /// Update snapshots instead of comparing
-        #[arg(long)]
-        update_snapshots: bool,
-    },
+    Test(TestArgs),
+    /// Run `bench_*` functions and compare them against a saved baseline
+    Bench(crate::tools::bench::BenchArgs),
+}
+
+/// Profile-guided optimization options for `otter build`.
+#[derive(clap::Args, Debug)]
+pub struct PgoArgs {
+    /// Build an instrumented binary, run it to record a profile, then rebuild optimized with that profile
+    #[arg(long, conflicts_with = "pgo_profile")]
+    pgo: bool,
+    /// Optimize with an existing `.profdata` profile instead of recording one
+    #[arg(long, value_name = "FILE")]
+    pgo_profile: Option<PathBuf>,
+    /// Argument passed to the program during the --pgo training run (repeatable)
+    #[arg(long = "pgo-arg", value_name = "ARG", allow_hyphen_values = true)]
+    pgo_args: Vec<String>,
+}
+
+#[derive(clap::Args, Debug)]
+pub struct TestArgs {
+    /// Test files or directories to run (defaults to current directory)
+    #[arg(default_value = ".")]
+    paths: Vec<PathBuf>,
+    /// Run tests in parallel
+    #[arg(short, long)]
+    parallel: bool,
+    /// Number of tests to run at once (implies --parallel; defaults to the CPU count)
+    #[arg(short, long)]
+    jobs: Option<usize>,
+    /// Only run the i-th of n deterministic slices of the suite, e.g. `--shard 2/4`
+    #[arg(long, value_name = "I/N")]
+    shard: Option<crate::test::Shard>,
+    /// Fail any test that runs longer than this many seconds
+    #[arg(long, value_name = "SECS")]
+    timeout: Option<f64>,
+    /// Show output from passing tests
+    #[arg(short, long)]
+    verbose: bool,
+    /// Update snapshots instead of comparing
+    #[arg(long)]
+    update_snapshots: bool,
 }
 
 pub fn run() -> Result<()> {
@@ -165,18 +211,14 @@ pub fn run() -> Result<()> {
 
     match &cli.command {
         Command::Run { path } => handle_run(&cli, path),
-        Command::Build { path, output } => handle_build(&cli, path, output.clone()),
+        Command::Build { path, output, pgo } => handle_build(&cli, path, output.clone(), pgo),
         Command::Check { path } => handle_check(&cli, path),
-        Command::Fmt { paths } => handle_fmt(paths),
+        Command::Fmt { paths, check } => crate::tools::fmt::run(paths, *check),
         Command::Profile { subcommand } => {
             crate::tools::profiler::run_profiler_subcommand(subcommand)
         }
-        Command::Test {
-            paths,
-            parallel,
-            verbose,
-            update_snapshots,
-        } => handle_test(&cli, paths, *parallel, *verbose, *update_snapshots),
+        Command::Test(args) => handle_test(&cli, args),
+        Command::Bench(args) => crate::tools::bench::run(args),
     }
 }
 
@@ -303,10 +345,9 @@ fn handle_run(cli: &OtterCli, path: &Path) -> Result<()> {
     Ok(())
 }
 
-fn handle_build(cli: &OtterCli, path: &Path, output: Option<PathBuf>) -> Result<()> {
-    let settings = CompilationSettings::from_cli(cli)?;
+fn handle_build(cli: &OtterCli, path: &Path, output: Option<PathBuf>, pgo: &PgoArgs) -> Result<()> {
+    let mut settings = CompilationSettings::from_cli(cli)?;
     let source = read_source(path)?;
-    let stage = compile_pipeline(path, &source, &settings)?;
 
     let output_path = resolve_output_path(path, output);
     if let Some(parent) = output_path.parent() {
@@ -314,6 +355,24 @@ fn handle_build(cli: &OtterCli, path: &Path, output: Option<PathBuf>) -> Result<
             .with_context(|| format!("failed to create output directory {}", parent.display()))?;
     }
 
+    let profile = match &pgo.pgo_profile {
+        Some(profile) => Some(profile.clone()),
+        None if pgo.pgo => Some(train_pgo_profile(
+            path,
+            &source,
+            &settings,
+            &output_path,
+            &pgo.pgo_args,
+        )?),
+        None => None,
+    };
+    if let Some(profile) = profile {
+        settings.enable_pgo = true;
+        settings.pgo_profile_file = Some(profile);
+    }
+
+    let stage = compile_pipeline(path, &source, &settings)?;
+
     let cached_binary = match &stage.result {
         CompilationResult::CacheHit(entry) => &entry.binary_path,
         CompilationResult::Compiled { artifact, .. } => &artifact.binary,
@@ -357,6 +416,77 @@ fn handle_build(cli: &OtterCli, path: &Path, output: Option<PathBuf>) -> Result<
     Ok(())
 }
 
+/// Builds an instrumented binary, runs it once with `args` and merges the raw
+/// profiles it writes into `<output>.pgo/merged.profdata`.
+fn train_pgo_profile(
+    path: &Path,
+    source: &str,
+    settings: &CompilationSettings,
+    output_path: &Path,
+    args: &[String],
+) -> Result<PathBuf> {
+    let mut instrumented = settings.clone();
+    instrumented.enable_pgo = true;
+    instrumented.pgo_profile_file = None;
+    let stage = compile_pipeline(path, source, &instrumented)?;
+    let binary = match &stage.result {
+        CompilationResult::Compiled { artifact, .. } => artifact.binary.clone(),
+        CompilationResult::CacheHit(_) | CompilationResult::Checked => {
+            unreachable!("instrumented builds bypass the cache")
+        }
+    };
+
+    let profile_dir = output_path.with_extension("pgo");
+    if profile_dir.exists() {
+        fs::remove_dir_all(&profile_dir)
+            .with_context(|| format!("failed to clear {}", profile_dir.display()))?;
+    }
+    fs::create_dir_all(&profile_dir)
+        .with_context(|| format!("failed to create {}", profile_dir.display()))?;
+
+    println!("{} {}", "Training".green().bold(), path.display());
+    let mut command = ProcessCommand::new(&binary);
+    command
+        .args(args)
+        .env("LLVM_PROFILE_FILE", profile_dir.join("otter-%p.profraw"));
+    settings.apply_runtime_env(&mut command);
+    let status = command
+        .status()
+        .with_context(|| format!("failed to execute {}", binary.display()))?;
+    if !status.success() {
+        bail!("PGO training run failed with {status}");
+    }
+
+    let raw_profiles: Vec<PathBuf> = fs::read_dir(&profile_dir)?
+        .filter_map(Result::ok)
+        .map(|entry| entry.path())
+        .filter(|file| file.extension().is_some_and(|ext| ext == "profraw"))
+        .collect();
+    if raw_profiles.is_empty() {
+        bail!(
+            "PGO training run wrote no profile to {}",
+            profile_dir.display()
+        );
+    }
+
+    let merged = profile_dir.join("merged.profdata");
+    let profdata = std::env::var("LLVM_PROFDATA").unwrap_or_else(|_| "llvm-profdata".into());
+    let status = ProcessCommand::new(&profdata)
+        .arg("merge")
+        .arg("-o")
+        .arg(&merged)
+        .args(&raw_profiles)
+        .status()
+        .with_context(|| {
+            format!("failed to run {profdata}; set LLVM_PROFDATA to the llvm-profdata binary")
+        })?;
+    if !status.success() {
+        bail!("{profdata} merge failed with {status}");
+    }
+
+    Ok(merged)
+}
+
 fn handle_check(cli: &OtterCli, path: &Path) -> Result<()> {
     let mut settings = CompilationSettings::from_cli(cli)?;
     settings.check_only = true;
@@ -600,6 +730,11 @@ pub struct CompilationSettings {
     time: bool,
     profile: bool,
     release: bool,
+    opt_level: Option<CodegenOptLevel>,
+    inline_threshold: Option<u32>,
+    enable_pgo: bool,
+    pgo_profile_file: Option<PathBuf>,
+    static_bridges: bool,
     tasks: bool,
     tasks_debug: bool,
     tasks_trace: bool,
@@ -688,6 +823,11 @@ impl CompilationSettings {
             time: cli.time,
             profile: cli.profile,
             release: cli.release,
+            opt_level: cli.opt_level,
+            inline_threshold: cli.inline_threshold,
+            enable_pgo: false,
+            pgo_profile_file: None,
+            static_bridges: cli.static_bridges,
             tasks: cli.tasks,
             tasks_debug: cli.tasks_debug,
             tasks_trace: cli.tasks_trace,
@@ -703,8 +843,30 @@ impl CompilationSettings {
         })
     }
 
-    fn allow_cache(&self) -> bool {
-        !(self.dump_tokens || self.dump_ast || self.dump_ir || self.no_cache || self.check_only)
+    pub(crate) fn allow_cache(&self) -> bool {
+        !(self.dump_tokens
+            || self.dump_ast
+            || self.dump_ir
+            || self.no_cache
+            || self.check_only
+            || self.enable_pgo)
+    }
+
+    /// Hash of the settings that can change a test's outcome, mixed into the
+    /// passing-test cache fingerprints.
+    pub(crate) fn result_cache_salt(&self) -> u64 {
+        use std::hash::{DefaultHasher, Hash, Hasher};
+
+        let mut hasher = DefaultHasher::new();
+        (self.release, self.static_bridges, self.debug, &self.target).hash(&mut hasher);
+        (
+            self.opt_level.map(CodegenOptLevel::suffix),
+            self.inline_threshold,
+        )
+            .hash(&mut hasher);
+        (self.tasks, self.tasks_debug, self.tasks_trace).hash(&mut hasher);
+        format!("{:?}", self.language_features).hash(&mut hasher);
+        hasher.finish()
     }
 
     pub fn apply_runtime_env(&self, command: &mut std::process::Command) {
@@ -732,9 +894,20 @@ impl CompilationSettings {
             release: self.release,
             lto: self.release,
             emit_ir: self.dump_ir,
+            opt_level: self.resolved_opt_level().suffix().to_string(),
+            inline_threshold: self.inline_threshold,
         }
     }
 
+    /// The explicit `--opt-level`, or the default for the build profile.
+    fn resolved_opt_level(&self) -> CodegenOptLevel {
+        self.opt_level.unwrap_or(if self.release {
+            CodegenOptLevel::Aggressive
+        } else {
+            CodegenOptLevel::Default
+        })
+    }
+
     fn codegen_options(&self) -> CodegenOptions {
         let target = self.target.as_ref().and_then(|t| {
             TargetTriple::parse(t)
@@ -746,15 +919,12 @@ impl CompilationSettings {
 
         CodegenOptions {
             emit_ir: self.dump_ir,
-            opt_level: if self.release {
-                CodegenOptLevel::Aggressive
-            } else {
-                CodegenOptLevel::Default
-            },
+            opt_level: self.resolved_opt_level(),
             enable_lto: self.release,
-            enable_pgo: false,
-            pgo_profile_file: None,
-            inline_threshold: None,
+            enable_pgo: self.enable_pgo,
+            pgo_profile_file: self.pgo_profile_file.clone(),
+            inline_threshold: self.inline_threshold,
+            static_bridges: self.static_bridges,
             target,
         }
     }
@@ -835,7 +1005,7 @@ fn canonical_or(path: &Path) -> PathBuf {
     path.canonicalize().unwrap_or_else(|_| path.to_path_buf())
 }
 
-fn find_stdlib_dir() -> Result<PathBuf> {
+pub(crate) fn find_stdlib_dir() -> Result<PathBuf> {
     // Try environment variable first
     if let Ok(dir) = std::env::var("OTTER_STDLIB_DIR") {
         let path = PathBuf::from(dir);
@@ -914,73 +1084,6 @@ fn print_timings(stage: &CompilationStage) {
     println!("  {:20} {:8.2}ms", "Total", total.as_secs_f64() * 1000.0);
 }
 
-fn handle_fmt(paths: &[PathBuf]) -> Result<()> {
-    use glob::glob;
-    use otterc_fmt::Formatter;
-    use otterc_lexer::tokenize;
-    use otterc_parser::parse;
-
-    println!("Formatting OtterLang files...");
-
-    let formatter = Formatter::new();
-    let mut formatted_count = 0;
-
-    // Collect all .ot files
-    let mut files = Vec::new();
-    if paths.is_empty() || (paths.len() == 1 && paths[0].to_str() == Some(".")) {
-        // Default: format all .ot files in current directory recursively
-        for path in (glob("**/*.ot")?).flatten() {
-            files.push(path);
-        }
-    } else {
-        for path in paths {
-            if path.is_dir() {
-                for p in (glob(&format!("{}/**/*.ot", path.display()))?).flatten() {
-                    files.push(p);
-                }
-            } else if path.extension().is_some_and(|ext| ext == "ot") {
-                files.push(path.clone());
-            }
-        }
-    }
-
-    for file_path in files {
-        let source = fs::read_to_string(&file_path)
-            .with_context(|| format!("failed to read {}", file_path.display()))?;
-
-        #[expect(
-            clippy::map_err_ignore,
-            reason = "TODO: Use the provided error when reporting"
-        )]
-        let tokens = tokenize(&source)
-            .map_err(|_| anyhow::anyhow!("failed to tokenize {}", file_path.display()))?;
-
-        #[expect(
-            clippy::map_err_ignore,
-            reason = "TODO: Use the provided error when reporting"
-        )]
-        let program = parse(&tokens)
-            .map_err(|_| anyhow::anyhow!("failed to parse {}", file_path.display()))?;
-
-        let formatted = formatter.format_program(&program);
-
-        if formatted != source {
-            fs::write(&file_path, formatted)
-                .with_context(|| format!("failed to write {}", file_path.display()))?;
-            println!("  {}", file_path.display());
-            formatted_count += 1;
-        }
-    }
-
-    if formatted_count == 0 {
-        println!("All files are already formatted");
-    } else {
-        println!("\nFormatted {} file(s)", formatted_count);
-    }
-
-    Ok(())
-}
-
 fn print_profile(metadata: &CacheMetadata) {
     println!("\nProfile:");
     println!("  Binary: {}", metadata.binary_path.display());
@@ -1009,53 +1112,53 @@ fn emit_parser_errors(source_id: &str, source: &str, errors: &[ParserError]) {
     emit_diagnostics(&diagnostics, source);
 }
 
-fn handle_test(
-    cli: &OtterCli,
-    paths: &[PathBuf],
-    parallel: bool,
-    verbose: bool,
-    update_snapshots: bool,
-) -> Result<()> {
+fn handle_test(cli: &OtterCli, args: &TestArgs) -> Result<()> {
     use crate::test::{TestDiscovery, TestReporter, TestRunner};
-    use rayon::prelude::*;
 
     let settings = CompilationSettings::from_cli(cli)?;
     let mut discovery = TestDiscovery::new();
-    discovery.discover_files(paths)?;
+    discovery.discover_files(&args.paths)?;
 
-    let tests = discovery.discover_all_tests()?;
+    let mut tests = discovery.discover_all_tests()?;
+    if let Some(shard) = &args.shard {
+        tests = shard.select(tests);
+    }
 
     if tests.is_empty() {
         println!("No tests found");
         return Ok(());
     }
 
-    println!("Running {} test(s)...\n", tests.len());
+    match &args.shard {
+        Some(shard) => println!(
+            "Running {} test(s) (shard {}/{})...\n",
+            tests.len(),
+            shard.index,
+            shard.count
+        ),
+        None => println!("Running {} test(s)...\n", tests.len()),
+    }
 
-    let runner = TestRunner::new(settings, update_snapshots);
-    let mut reporter = TestReporter::new(verbose);
+    let jobs = match args.jobs {
+        Some(jobs) => jobs,
+        None if args.parallel => std::thread::available_parallelism().map_or(1, usize::from),
+        None => 1,
+    };
+    let timeout = match args.timeout {
+        Some(secs) if secs.is_finite() && secs > 0.0 => Some(Duration::from_secs_f64(secs)),
+        Some(secs) => bail!("--timeout must be a positive number of seconds, got {secs}"),
+        None => None,
+    };
 
-    if parallel {
-        // Run tests in parallel
-        let results: Vec<_> = tests
-            .par_iter()
-            .map(|test| {
-                let result = runner.run_test(test);
-                (test.clone(), result)
-            })
-            .collect();
+    let result_cache = settings.allow_cache();
+    let runner = TestRunner::new(settings, args.update_snapshots)
+        .with_timeout(timeout)
+        .with_result_cache(result_cache);
+    let mut reporter = TestReporter::new(args.verbose);
 
-        for (test, result) in results {
-            reporter.print_result(&test, &result);
-            reporter.record_result(test, result);
-        }
-    } else {
-        // Run tests sequentially
-        for test in tests {
-            let result = runner.run_test(&test);
-            reporter.print_result(&test, &result);
-            reporter.record_result(test, result);
-        }
+    for (test, result) in runner.run_all(tests, jobs)? {
+        reporter.print_result(&test, &result);
+        reporter.record_result(test, result);
     }
 
     reporter.print_summary();
@@ -1171,14 +1274,14 @@ fn register_bridge_functions_for_typecheck(
 
     registry.register(FfiFunction {
         name: format!("{crate_name}.__call_json"),
-        symbol: "otter_call_json".into(),
+        symbol: json_dispatch_symbol(crate_name),
         signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str),
     });
 
     for alias in aliases {
         registry.register(FfiFunction {
             name: format!("{alias}.__call_json"),
-            symbol: "otter_call_json".into(),
+            symbol: json_dispatch_symbol(crate_name),
             signature: FfiSignature::new(vec![FfiType::Str, FfiType::Str], FfiType::Str),
         });
     }
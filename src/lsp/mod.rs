@@ -1,5 +1,8 @@
 use std::collections::{BTreeSet, HashMap};
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
 use std::sync::Arc;
+use std::time::Duration;
 
 use tokio::sync::RwLock;
 use tower_lsp::jsonrpc::Result;
@@ -11,7 +14,7 @@ use otterc_lexer::{LexerError, Token, tokenize};
 use otterc_parser::parse;
 use otterc_span::Span;
 use otterc_symbol::registry::SymbolRegistry;
-use otterc_typecheck::{self, TypeChecker};
+use otterc_typecheck::{self, SymbolLocation, TypeChecker, WorkspaceIndex};
 use otterc_utils::errors::{
     Diagnostic as OtterDiagnostic, DiagnosticSeverity as OtterDiagSeverity,
 };
@@ -261,13 +264,148 @@ impl SymbolTable {
     }
 }
 
+/// How long to wait after the last keystroke before re-analysing a document.
+const ANALYSIS_DEBOUNCE: Duration = Duration::from_millis(75);
+
+/// An open document kept in sync through incremental `didChange` edits.
+///
+/// Line start offsets are maintained alongside the text so that LSP positions
+/// can be resolved with a binary search instead of rescanning the whole file.
+#[derive(Debug, Clone)]
+struct TextDocument {
+    version: i32,
+    text: String,
+    line_starts: Vec<usize>,
+}
+
+impl TextDocument {
+    fn new(version: i32, text: String) -> Self {
+        let mut line_starts = vec![0];
+        line_starts.extend(text.match_indices('\n').map(|(idx, _)| idx + 1));
+        Self {
+            version,
+            text,
+            line_starts,
+        }
+    }
+
+    /// Apply a single content change. Changes without a range replace the
+    /// whole document, as the protocol requires.
+    fn apply_change(&mut self, change: TextDocumentContentChangeEvent) {
+        let Some(range) = change.range else {
+            *self = Self::new(self.version, change.text);
+            return;
+        };
+
+        let start = self.offset(range.start);
+        let end = self.offset(range.end).max(start);
+        self.text.replace_range(start..end, &change.text);
+
+        // Line starts inside the replaced region are dropped, the ones
+        // introduced by the inserted text are spliced in, and everything
+        // after the edit is shifted by the length difference.
+        let first = self.line_starts.partition_point(|&line| line <= start);
+        let last = self.line_starts.partition_point(|&line| line <= end);
+        let inserted: Vec<usize> = change
+            .text
+            .match_indices('\n')
+            .map(|(idx, _)| start + idx + 1)
+            .collect();
+        let inserted_len = inserted.len();
+        self.line_starts.splice(first..last, inserted);
+        let removed = end - start;
+        for line in &mut self.line_starts[first + inserted_len..] {
+            *line = *line + change.text.len() - removed;
+        }
+    }
+
+    fn position(&self, offset: usize) -> Position {
+        let offset = offset.min(self.text.len());
+        let line = self.line_starts.partition_point(|&start| start <= offset) - 1;
+        let line_start = self.line_starts[line];
+        let character = self
+            .text
+            .get(line_start..offset)
+            .map(|prefix| prefix.chars().map(char::len_utf16).sum())
+            .unwrap_or(offset - line_start);
+        Position {
+            line: line as u32,
+            character: character as u32,
+        }
+    }
+
+    fn offset(&self, position: Position) -> usize {
+        let Some(&line_start) = self.line_starts.get(position.line as usize) else {
+            return self.text.len();
+        };
+        let line_end = self
+            .line_starts
+            .get(position.line as usize + 1)
+            .map(|next| next - 1)
+            .unwrap_or(self.text.len());
+        // Characters are counted in UTF-16 code units, the protocol's
+        // default position encoding.
+        let mut units = 0;
+        for (idx, ch) in self.text[line_start..line_end].char_indices() {
+            if units >= position.character as usize {
+                return line_start + idx;
+            }
+            units += ch.len_utf16();
+        }
+        line_end
+    }
+
+    fn range(&self, span: Span) -> Range {
+        Range {
+            start: self.position(span.start()),
+            end: self.position(span.end()),
+        }
+    }
+
+    fn content_hash(&self) -> u64 {
+        let mut hasher = DefaultHasher::new();
+        self.text.hash(&mut hasher);
+        hasher.finish()
+    }
+}
+
+/// Result of analysing one snapshot of a document. Request handlers share it
+/// through an `Arc`, so hover or completion never clone the symbol table.
+#[derive(Debug)]
+struct DocumentAnalysis {
+    document: TextDocument,
+    content_hash: u64,
+    diagnostics: Vec<Diagnostic>,
+    symbols: SymbolTable,
+}
+
+impl DocumentAnalysis {
+    /// Analyse a snapshot, also handing back the parsed program (if any) so
+    /// the caller can feed it to the workspace index.
+    fn compute(document: TextDocument) -> (Self, Option<Program>) {
+        let content_hash = document.content_hash();
+        let (diagnostics, symbols, program) = compute_lsp_diagnostics_and_symbols(&document);
+        let analysis = Self {
+            document,
+            content_hash,
+            diagnostics,
+            symbols,
+        };
+        (analysis, program)
+    }
+}
+
 #[derive(Default, Debug)]
 struct DocumentStore {
-    documents: HashMap<Url, String>,
-    symbol_tables: HashMap<Url, SymbolTable>,
+    documents: HashMap<Url, TextDocument>,
+    analyses: HashMap<Url, Arc<DocumentAnalysis>>,
+    /// Top-level definitions and references of every `.ot` file under the
+    /// workspace root, keyed by file path.
+    index: WorkspaceIndex,
+    workspace_root: Option<PathBuf>,
 }
 
-#[derive(Debug)]
+#[derive(Debug, Clone)]
 pub struct Backend {
     client: Client,
     state: Arc<RwLock<DocumentStore>>,
@@ -281,18 +419,46 @@ impl Backend {
         }
     }
 
-    async fn upsert_document(&self, uri: Url, text: String) {
+    async fn open_document(&self, uri: Url, version: i32, text: String) {
         {
             let mut state = self.state.write().await;
-            state.documents.insert(uri.clone(), text);
+            state
+                .documents
+                .insert(uri.clone(), TextDocument::new(version, text));
         }
-        self.publish_diagnostics(uri).await;
+        self.publish_diagnostics(uri, version).await;
+    }
+
+    async fn change_document(
+        &self,
+        uri: Url,
+        version: i32,
+        changes: Vec<TextDocumentContentChangeEvent>,
+    ) {
+        {
+            let mut state = self.state.write().await;
+            let Some(document) = state.documents.get_mut(&uri) else {
+                return;
+            };
+            for change in changes {
+                document.apply_change(change);
+            }
+            document.version = version;
+        }
+
+        // Only the last edit in a burst of typing gets analysed.
+        let backend = self.clone();
+        tokio::spawn(async move {
+            tokio::time::sleep(ANALYSIS_DEBOUNCE).await;
+            backend.publish_diagnostics(uri, version).await;
+        });
     }
 
     async fn remove_document(&self, uri: &Url) {
         {
             let mut state = self.state.write().await;
             state.documents.remove(uri);
+            state.analyses.remove(uri);
         }
         let _ = self
             .client
@@ -300,42 +466,180 @@ impl Backend {
             .await;
     }
 
-    async fn publish_diagnostics(&self, uri: Url) {
-        let text = {
+    async fn publish_diagnostics(&self, uri: Url, version: i32) {
+        let document = {
             let state = self.state.read().await;
-            state.documents.get(&uri).cloned()
+            match state.documents.get(&uri) {
+                Some(document) if document.version == version => document.clone(),
+                _ => return,
+            }
         };
 
-        if let Some(text) = text {
-            let (diagnostics, symbol_table) = compute_lsp_diagnostics_and_symbols(&text);
+        // Edits that round-trip back to the analysed text (undo, or a save
+        // without changes) keep the existing results.
+        let unchanged = {
+            let state = self.state.read().await;
+            state
+                .analyses
+                .get(&uri)
+                .is_some_and(|cached| cached.content_hash == document.content_hash())
+        };
+        if unchanged {
+            return;
+        }
 
-            // Store the symbol table
-            {
-                let mut state = self.state.write().await;
-                state.symbol_tables.insert(uri.clone(), symbol_table);
+        let Ok((analysis, program)) =
+            tokio::task::spawn_blocking(move || DocumentAnalysis::compute(document)).await
+        else {
+            return;
+        };
+
+        let diagnostics = analysis.diagnostics.clone();
+        {
+            let mut state = self.state.write().await;
+            let is_current = state
+                .documents
+                .get(&uri)
+                .is_some_and(|document| document.version == version);
+            if !is_current {
+                return;
+            }
+            if let (Some(program), Some(module)) = (program, module_key(&uri)) {
+                state.index.index_module(&module, &program);
+                state.index.set_fingerprint(&module, analysis.content_hash);
             }
+            state.analyses.insert(uri.clone(), Arc::new(analysis));
+        }
+
+        let _ = self
+            .client
+            .publish_diagnostics(uri, diagnostics, Some(version))
+            .await;
+    }
 
-            let _ = self
-                .client
-                .publish_diagnostics(uri, diagnostics, None)
-                .await;
+    async fn analysis(&self, uri: &Url) -> Option<Arc<DocumentAnalysis>> {
+        let state = self.state.read().await;
+        state.analyses.get(uri).cloned()
+    }
+
+    /// Re-index workspace files whose content no longer matches the snapshot
+    /// loaded at startup. Open documents are skipped: their in-memory text is
+    /// indexed by the regular analysis path.
+    async fn refresh_workspace_index(&self) {
+        let Some(root) = self.state.read().await.workspace_root.clone() else {
+            return;
+        };
+
+        let Ok(sources) = tokio::task::spawn_blocking(move || workspace_sources(&root)).await
+        else {
+            return;
+        };
+        let stale: Vec<(String, u64, String)> = {
+            let state = self.state.read().await;
+            sources
+                .into_iter()
+                .filter(|(module, hash, _)| !state.index.is_current(module, *hash))
+                .collect()
+        };
+        if stale.is_empty() {
+            return;
         }
+
+        let Ok(parsed) = tokio::task::spawn_blocking(move || {
+            stale
+                .into_iter()
+                .map(|(module, hash, text)| {
+                    let program = tokenize(&text).ok().and_then(|tokens| parse(&tokens).ok());
+                    (module, hash, program)
+                })
+                .collect::<Vec<_>>()
+        })
+        .await
+        else {
+            return;
+        };
+
+        let mut state = self.state.write().await;
+        let open: Vec<String> = state.documents.keys().filter_map(module_key).collect();
+        for (module, hash, program) in parsed {
+            if open.contains(&module) {
+                continue;
+            }
+            match program {
+                Some(program) => state.index.index_module(&module, &program),
+                None => state.index.remove_module(&module),
+            }
+            state.index.set_fingerprint(&module, hash);
+        }
+        save_index_snapshot(&state);
+    }
+
+    /// Resolve index locations to LSP locations, reading files that are not
+    /// open in the editor to map byte offsets to positions.
+    async fn index_locations(&self, locations: Vec<(String, Span)>) -> Vec<Location> {
+        let mut documents: HashMap<String, Option<Arc<DocumentAnalysis>>> = HashMap::new();
+        let mut on_disk: HashMap<String, Option<TextDocument>> = HashMap::new();
+        let mut resolved = Vec::new();
+
+        for (module, span) in locations {
+            let Ok(uri) = Url::from_file_path(&module) else {
+                continue;
+            };
+            if !documents.contains_key(&module) {
+                let analysis = self.analysis(&uri).await;
+                documents.insert(module.clone(), analysis);
+            }
+            let range = match documents.get(&module).and_then(Option::as_ref) {
+                Some(analysis) => analysis.document.range(span),
+                None => {
+                    let document = on_disk.entry(module.clone()).or_insert_with(|| {
+                        std::fs::read_to_string(&module)
+                            .ok()
+                            .map(|text| TextDocument::new(0, text))
+                    });
+                    match document {
+                        Some(document) => document.range(span),
+                        None => continue,
+                    }
+                }
+            };
+            resolved.push(Location { uri, range });
+        }
+
+        resolved
     }
 
     #[expect(dead_code, reason = "Work in progress")]
     async fn document_text(&self, uri: &Url) -> Option<String> {
         let state = self.state.read().await;
-        state.documents.get(uri).cloned()
+        state
+            .documents
+            .get(uri)
+            .map(|document| document.text.clone())
     }
 }
 
 #[tower_lsp::async_trait]
 impl LanguageServer for Backend {
-    async fn initialize(&self, _: InitializeParams) -> Result<InitializeResult> {
+    async fn initialize(&self, params: InitializeParams) -> Result<InitializeResult> {
+        let workspace_root = params
+            .workspace_folders
+            .as_ref()
+            .and_then(|folders| folders.first())
+            .and_then(|folder| folder.uri.to_file_path().ok());
+        if let Some(root) = workspace_root {
+            let index = index_snapshot_path(&root)
+                .and_then(|path| WorkspaceIndex::load(&path).ok())
+                .unwrap_or_default();
+            let mut state = self.state.write().await;
+            state.index = index;
+            state.workspace_root = Some(root);
+        }
+
         Ok(InitializeResult {
             capabilities: ServerCapabilities {
                 text_document_sync: Some(TextDocumentSyncCapability::Kind(
-                    TextDocumentSyncKind::FULL,
+                    TextDocumentSyncKind::INCREMENTAL,
                 )),
                 hover_provider: Some(HoverProviderCapability::Simple(true)),
                 completion_provider: Some(CompletionOptions {
@@ -394,18 +698,29 @@ impl LanguageServer for Backend {
         self.client
             .log_message(MessageType::INFO, "otterlang-lsp initialized")
             .await;
+
+        let backend = self.clone();
+        tokio::spawn(async move {
+            backend.refresh_workspace_index().await;
+        });
     }
 
     async fn did_open(&self, params: DidOpenTextDocumentParams) {
-        self.upsert_document(params.text_document.uri, params.text_document.text)
-            .await;
+        self.open_document(
+            params.text_document.uri,
+            params.text_document.version,
+            params.text_document.text,
+        )
+        .await;
     }
 
     async fn did_change(&self, params: DidChangeTextDocumentParams) {
-        if let Some(change) = params.content_changes.into_iter().last() {
-            self.upsert_document(params.text_document.uri, change.text)
-                .await;
-        }
+        self.change_document(
+            params.text_document.uri,
+            params.text_document.version,
+            params.content_changes,
+        )
+        .await;
     }
 
     async fn did_close(&self, params: DidCloseTextDocumentParams) {
@@ -413,6 +728,7 @@ impl LanguageServer for Backend {
     }
 
     async fn shutdown(&self) -> Result<()> {
+        save_index_snapshot(&*self.state.read().await);
         Ok(())
     }
 
@@ -423,25 +739,40 @@ impl LanguageServer for Backend {
         let uri = params.text_document_position_params.text_document.uri;
         let position = params.text_document_position_params.position;
 
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
+        let Some(analysis) = self.analysis(&uri).await else {
+            return Ok(None);
+        };
+        let Some(var_name) = word_at_position(&analysis.document.text, position) else {
+            return Ok(None);
         };
 
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table)
-            && let Some(var_name) = word_at_position(&text, position)
-            && let Some(symbol_info) = symbol_table.find_definition(&var_name)
-        {
-            let range = span_to_range(symbol_info.span, &text);
+        if let Some(symbol_info) = analysis.symbols.find_definition(&var_name) {
+            let range = analysis.document.range(symbol_info.span);
             return Ok(Some(GotoDefinitionResponse::Scalar(Location {
                 uri: uri.clone(),
                 range,
             })));
         }
 
-        Ok(None)
+        // Not defined in this document: fall back to the workspace index.
+        let definitions = {
+            let state = self.state.read().await;
+            state
+                .index
+                .definitions(&var_name)
+                .iter()
+                .map(|def| index_entry(&state.index, &def.location))
+                .collect::<Vec<_>>()
+        };
+        let locations = self.index_locations(definitions).await;
+        Ok(match locations.len() {
+            0 => None,
+            1 => locations
+                .into_iter()
+                .next()
+                .map(GotoDefinitionResponse::Scalar),
+            _ => Some(GotoDefinitionResponse::Array(locations)),
+        })
     }
 
     async fn goto_type_definition(
@@ -464,34 +795,43 @@ impl LanguageServer for Backend {
         let uri = params.text_document_position.text_document.uri;
         let position = params.text_document_position.position;
 
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table)
-            && let Some(var_name) = word_at_position(&text, position)
+        if let Some(analysis) = self.analysis(&uri).await
+            && let Some(var_name) = word_at_position(&analysis.document.text, position)
         {
             let mut locations = Vec::new();
 
             // Add definition
-            if let Some(symbol_info) = symbol_table.find_definition(&var_name) {
+            if let Some(symbol_info) = analysis.symbols.find_definition(&var_name) {
                 locations.push(Location {
                     uri: uri.clone(),
-                    range: span_to_range(symbol_info.span, &text),
+                    range: analysis.document.range(symbol_info.span),
                 });
             }
 
             // Add all references
-            for span in symbol_table.find_references(&var_name) {
+            for span in analysis.symbols.find_references(&var_name) {
                 locations.push(Location {
                     uri: uri.clone(),
-                    range: span_to_range(*span, &text),
+                    range: analysis.document.range(*span),
                 });
             }
 
+            // Add definitions and references from other workspace files
+            let current = module_key(&uri);
+            let elsewhere = {
+                let state = self.state.read().await;
+                let index = &state.index;
+                index
+                    .definitions(&var_name)
+                    .iter()
+                    .map(|def| &def.location)
+                    .chain(index.references(&var_name))
+                    .map(|location| index_entry(index, location))
+                    .filter(|(module, _)| Some(module) != current.as_ref())
+                    .collect::<Vec<_>>()
+            };
+            locations.extend(self.index_locations(elsewhere).await);
+
             return Ok(Some(locations));
         }
 
@@ -503,16 +843,9 @@ impl LanguageServer for Backend {
         params: DocumentSymbolParams,
     ) -> Result<Option<DocumentSymbolResponse>> {
         let uri = params.text_document.uri;
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table) {
+        if let Some(analysis) = self.analysis(&uri).await {
             let mut symbols = Vec::new();
-            for (name, info) in symbol_table.all_symbols() {
+            for (name, info) in analysis.symbols.all_symbols() {
                 let kind = match info.kind {
                     SymbolKind::Function => tower_lsp::lsp_types::SymbolKind::FUNCTION,
                     SymbolKind::Variable | SymbolKind::Parameter => {
@@ -531,8 +864,8 @@ impl LanguageServer for Backend {
                     name: name.clone(),
                     detail: info.ty.clone(),
                     kind,
-                    range: span_to_range(info.span, &text),
-                    selection_range: span_to_range(info.span, &text),
+                    range: analysis.document.range(info.span),
+                    selection_range: analysis.document.range(info.span),
                     children: None,
                     deprecated: None,
                     tags: None,
@@ -553,39 +886,35 @@ impl LanguageServer for Backend {
         let mut results = Vec::new();
 
         let state = self.state.read().await;
-        for (uri, symbol_table) in &state.symbol_tables {
-            if let Some(text) = state.documents.get(uri) {
-                for (name, info) in symbol_table.all_symbols() {
-                    if name.to_lowercase().contains(&query) {
-                        let kind = match info.kind {
-                            SymbolKind::Function => tower_lsp::lsp_types::SymbolKind::FUNCTION,
-                            SymbolKind::Variable | SymbolKind::Parameter => {
-                                tower_lsp::lsp_types::SymbolKind::VARIABLE
-                            }
-                            SymbolKind::Struct => tower_lsp::lsp_types::SymbolKind::STRUCT,
-                            SymbolKind::Enum => tower_lsp::lsp_types::SymbolKind::ENUM,
-                            SymbolKind::TypeAlias => {
-                                tower_lsp::lsp_types::SymbolKind::TYPE_PARAMETER
-                            }
-                            SymbolKind::Method => tower_lsp::lsp_types::SymbolKind::METHOD,
-                        };
-                        #[expect(
-                            deprecated,
-                            reason = "We are not using this deprecated field but it's required for constructing SymbolInformation"
-                        )]
-                        let info = SymbolInformation {
-                            name: name.clone(),
-                            kind,
-                            location: Location {
-                                uri: uri.clone(),
-                                range: span_to_range(info.span, text),
-                            },
-                            container_name: None,
-                            deprecated: None,
-                            tags: None,
-                        };
-                        results.push(info);
-                    }
+        for (uri, analysis) in &state.analyses {
+            for (name, info) in analysis.symbols.all_symbols() {
+                if name.to_lowercase().contains(&query) {
+                    let kind = match info.kind {
+                        SymbolKind::Function => tower_lsp::lsp_types::SymbolKind::FUNCTION,
+                        SymbolKind::Variable | SymbolKind::Parameter => {
+                            tower_lsp::lsp_types::SymbolKind::VARIABLE
+                        }
+                        SymbolKind::Struct => tower_lsp::lsp_types::SymbolKind::STRUCT,
+                        SymbolKind::Enum => tower_lsp::lsp_types::SymbolKind::ENUM,
+                        SymbolKind::TypeAlias => tower_lsp::lsp_types::SymbolKind::TYPE_PARAMETER,
+                        SymbolKind::Method => tower_lsp::lsp_types::SymbolKind::METHOD,
+                    };
+                    #[expect(
+                        deprecated,
+                        reason = "We are not using this deprecated field but it's required for constructing SymbolInformation"
+                    )]
+                    let info = SymbolInformation {
+                        name: name.clone(),
+                        kind,
+                        location: Location {
+                            uri: uri.clone(),
+                            range: analysis.document.range(info.span),
+                        },
+                        container_name: None,
+                        deprecated: None,
+                        tags: None,
+                    };
+                    results.push(info);
                 }
             }
         }
@@ -598,31 +927,24 @@ impl LanguageServer for Backend {
         let position = params.text_document_position.position;
         let new_name = params.new_name;
 
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table)
-            && let Some(old_name) = word_at_position(&text, position)
+        if let Some(analysis) = self.analysis(&uri).await
+            && let Some(old_name) = word_at_position(&analysis.document.text, position)
         {
             let mut changes = HashMap::new();
             let mut edits = Vec::new();
 
             // Add definition rename
-            if let Some(symbol_info) = symbol_table.find_definition(&old_name) {
+            if let Some(symbol_info) = analysis.symbols.find_definition(&old_name) {
                 edits.push(TextEdit {
-                    range: span_to_range(symbol_info.span, &text),
+                    range: analysis.document.range(symbol_info.span),
                     new_text: new_name.clone(),
                 });
             }
 
             // Add all references
-            for span in symbol_table.find_references(&old_name) {
+            for span in analysis.symbols.find_references(&old_name) {
                 edits.push(TextEdit {
-                    range: span_to_range(*span, &text),
+                    range: analysis.document.range(*span),
                     new_text: new_name.clone(),
                 });
             }
@@ -644,16 +966,9 @@ impl LanguageServer for Backend {
         let uri = params.text_document_position_params.text_document.uri;
         let position = params.text_document_position_params.position;
 
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table)
-            && let Some(var_name) = word_at_position(&text, position)
-            && let Some(symbol_info) = symbol_table.find_definition(&var_name)
+        if let Some(analysis) = self.analysis(&uri).await
+            && let Some(var_name) = word_at_position(&analysis.document.text, position)
+            && let Some(symbol_info) = analysis.symbols.find_definition(&var_name)
         {
             let kind_str = match symbol_info.kind {
                 SymbolKind::Function => "function",
@@ -673,7 +988,7 @@ impl LanguageServer for Backend {
             let contents = HoverContents::Scalar(MarkedString::String(detail));
             return Ok(Some(Hover {
                 contents,
-                range: Some(span_to_range(symbol_info.span, &text)),
+                range: Some(analysis.document.range(symbol_info.span)),
             }));
         }
 
@@ -684,12 +999,7 @@ impl LanguageServer for Backend {
         let uri = params.text_document_position.text_document.uri;
         let _position = params.text_document_position.position;
 
-        let (_text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
+        let analysis = self.analysis(&uri).await;
 
         let mut items = Vec::new();
 
@@ -723,8 +1033,8 @@ impl LanguageServer for Backend {
         }
 
         // Add symbols from symbol table
-        if let Some(symbol_table) = symbol_table {
-            for (name, info) in symbol_table.all_symbols() {
+        if let Some(analysis) = analysis {
+            for (name, info) in analysis.symbols.all_symbols() {
                 let kind = match info.kind {
                     SymbolKind::Function | SymbolKind::Variable | SymbolKind::Parameter => {
                         CompletionItemKind::VARIABLE
@@ -750,17 +1060,11 @@ impl LanguageServer for Backend {
         let uri = params.text_document_position_params.text_document.uri;
         let position = params.text_document_position_params.position;
 
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table) {
-            let offset = position_to_offset(&text, position);
-            if let Some((func_name, active_param)) = find_call_context(&text, offset)
-                && let Some(symbol) = symbol_table.get(&func_name)
+        if let Some(analysis) = self.analysis(&uri).await {
+            let offset = analysis.document.offset(position);
+            if let Some((func_name, active_param)) =
+                find_call_context(&analysis.document.text, offset)
+                && let Some(symbol) = analysis.symbols.get(&func_name)
                 && let Some(callable) = &symbol.callable
             {
                 let parameters: Vec<ParameterInformation> = callable
@@ -833,20 +1137,13 @@ impl LanguageServer for Backend {
         params: SemanticTokensParams,
     ) -> Result<Option<SemanticTokensResult>> {
         let uri = params.text_document.uri;
-        let (text, symbol_table) = {
-            let state = self.state.read().await;
-            let text = state.documents.get(&uri).cloned();
-            let symbol_table = state.symbol_tables.get(&uri).cloned();
-            (text, symbol_table)
-        };
-
-        if let (Some(text), Some(symbol_table)) = (text, symbol_table) {
+        if let Some(analysis) = self.analysis(&uri).await {
             let mut tokens = Vec::new();
             let mut prev_line = 0;
             let mut prev_col = 0;
 
-            for (_name, info) in symbol_table.all_symbols() {
-                let pos = span_to_position(info.span.start(), &text);
+            for (_name, info) in analysis.symbols.all_symbols() {
+                let pos = analysis.document.position(info.span.start());
                 let token_type = match info.kind {
                     SymbolKind::Function | SymbolKind::Method => 0, // FUNCTION
                     SymbolKind::Variable => 1,                      // VARIABLE
@@ -927,24 +1224,67 @@ impl LanguageServer for Backend {
     }
 }
 
-/// Convert span start to Position
-fn span_to_position(byte_offset: usize, text: &str) -> Position {
-    let mut line = 0;
-    let mut character = 0;
+/// Key under which a document is stored in the workspace index.
+fn module_key(uri: &Url) -> Option<String> {
+    uri.to_file_path()
+        .ok()
+        .map(|path| path.to_string_lossy().into_owned())
+}
 
-    for (i, ch) in text.char_indices() {
-        if i >= byte_offset {
-            break;
-        }
-        if ch == '\n' {
-            line += 1;
-            character = 0;
-        } else {
-            character += 1;
-        }
+fn index_entry(index: &WorkspaceIndex, location: &SymbolLocation) -> (String, Span) {
+    (
+        index.module_name(location.module).to_string(),
+        location.span(),
+    )
+}
+
+/// Snapshot location for a workspace, inside the shared otter cache directory.
+fn index_snapshot_path(root: &Path) -> Option<PathBuf> {
+    let mut hasher = DefaultHasher::new();
+    root.hash(&mut hasher);
+    let cache_dir = otterc_cache::cache_root().ok()?;
+    Some(
+        cache_dir
+            .join("lsp-index")
+            .join(format!("{:016x}.json", hasher.finish())),
+    )
+}
+
+fn save_index_snapshot(state: &DocumentStore) {
+    if let Some(path) = state
+        .workspace_root
+        .as_deref()
+        .and_then(index_snapshot_path)
+    {
+        let _ = state.index.save(&path);
     }
+}
 
-    Position { line, character }
+/// Read every `.ot` file under `root`, skipping hidden and build directories,
+/// and return `(module key, content hash, text)` triples.
+fn workspace_sources(root: &Path) -> Vec<(String, u64, String)> {
+    let pattern = root.join("**").join("*.ot");
+    let Ok(paths) = glob::glob(&pattern.to_string_lossy()) else {
+        return Vec::new();
+    };
+
+    paths
+        .filter_map(|entry| entry.ok())
+        .filter(|path| {
+            path.strip_prefix(root).is_ok_and(|relative| {
+                relative.components().all(|component| {
+                    let name = component.as_os_str().to_string_lossy();
+                    !name.starts_with('.') && name != "target"
+                })
+            })
+        })
+        .filter_map(|path| {
+            let text = std::fs::read_to_string(&path).ok()?;
+            let mut hasher = DefaultHasher::new();
+            text.hash(&mut hasher);
+            Some((path.to_string_lossy().into_owned(), hasher.finish(), text))
+        })
+        .collect()
 }
 
 /// Run a standard I/O LSP server using the backend above.
@@ -1277,8 +1617,11 @@ fn infer_type_from_expr(_expr: &Expr) -> Option<String> {
 }
 
 /// Compute diagnostics and build symbol table from source text
-fn compute_lsp_diagnostics_and_symbols(text: &str) -> (Vec<Diagnostic>, SymbolTable) {
+fn compute_lsp_diagnostics_and_symbols(
+    document: &TextDocument,
+) -> (Vec<Diagnostic>, SymbolTable, Option<Program>) {
     let source_id = "lsp";
+    let text = document.text.as_str();
     match tokenize(text) {
         Ok(tokens) => match parse(&tokens) {
             Ok(program) => {
@@ -1294,14 +1637,14 @@ fn compute_lsp_diagnostics_and_symbols(text: &str) -> (Vec<Diagnostic>, SymbolTa
                             text,
                         )
                         .into_iter()
-                        .map(|diag| otter_diag_to_lsp(DiagnosticKind::Type, &diag, text))
+                        .map(|diag| otter_diag_to_lsp(DiagnosticKind::Type, &diag, document))
                         .collect()
                     } else {
                         Vec::new()
                     }
                 };
 
-                (diagnostics, symbol_table)
+                (diagnostics, symbol_table, Some(program))
             }
             Err(errors) => {
                 let diagnostics = errors
@@ -1310,11 +1653,11 @@ fn compute_lsp_diagnostics_and_symbols(text: &str) -> (Vec<Diagnostic>, SymbolTa
                         otter_diag_to_lsp(
                             DiagnosticKind::Parser,
                             &err.to_diagnostic(source_id),
-                            text,
+                            document,
                         )
                     })
                     .collect();
-                (diagnostics, SymbolTable::new())
+                (diagnostics, SymbolTable::new(), None)
             }
         },
         Err(errors) => {
@@ -1324,11 +1667,11 @@ fn compute_lsp_diagnostics_and_symbols(text: &str) -> (Vec<Diagnostic>, SymbolTa
                     otter_diag_to_lsp(
                         DiagnosticKind::Lexer,
                         &lexer_error_to_diag(source_id, &err),
-                        text,
+                        document,
                     )
                 })
                 .collect();
-            (diagnostics, SymbolTable::new())
+            (diagnostics, SymbolTable::new(), None)
         }
     }
 }
@@ -1392,11 +1735,15 @@ fn lexer_error_to_diag(source: &str, err: &LexerError) -> OtterDiagnostic {
     err.to_diagnostic(source)
 }
 
-fn otter_diag_to_lsp(kind: DiagnosticKind, diag: &OtterDiagnostic, text: &str) -> Diagnostic {
-    let range = span_to_range(diag.span(), text);
+fn otter_diag_to_lsp(
+    kind: DiagnosticKind,
+    diag: &OtterDiagnostic,
+    document: &TextDocument,
+) -> Diagnostic {
+    let range = document.range(diag.span());
     let mut message = diag.message().to_string();
 
-    if let Some(snippet) = snippet_with_highlight(text, diag.span()) {
+    if let Some(snippet) = snippet_with_highlight(&document.text, diag.span()) {
         message.push('\n');
         message.push_str(&snippet);
     }
@@ -1456,58 +1803,6 @@ fn snippet_with_highlight(text: &str, span: Span) -> Option<String> {
     Some(format!("{}\n{}", line, marker))
 }
 
-fn span_to_range(span: Span, text: &str) -> Range {
-    Range {
-        start: offset_to_position(text, span.start()),
-        end: offset_to_position(text, span.end()),
-    }
-}
-
-fn offset_to_position(text: &str, offset: usize) -> Position {
-    let mut counted = 0usize;
-    let mut line = 0u32;
-    let mut character = 0u32;
-    for ch in text.chars() {
-        if counted >= offset {
-            break;
-        }
-        if ch == '\n' {
-            line += 1;
-            character = 0;
-        } else {
-            character += 1;
-        }
-        counted += ch.len_utf8();
-    }
-    Position { line, character }
-}
-
-fn position_to_offset(text: &str, position: Position) -> usize {
-    let mut offset = 0usize;
-    for (current_line, line) in text.split_inclusive('\n').enumerate() {
-        if current_line == position.line as usize {
-            let mut byte_index = 0usize;
-            let mut seen_chars = 0usize;
-            for (idx, ch) in line.char_indices() {
-                if seen_chars == position.character as usize {
-                    byte_index = idx;
-                    break;
-                }
-                seen_chars += 1;
-                byte_index = idx + ch.len_utf8();
-            }
-            let target = if seen_chars >= position.character as usize {
-                byte_index
-            } else {
-                line.len()
-            };
-            return offset + target;
-        }
-        offset += line.len();
-    }
-    text.len()
-}
-
 fn find_call_context(text: &str, offset: usize) -> Option<(String, usize)> {
     if offset == 0 || offset > text.len() {
         return None;
@@ -1675,4 +1970,112 @@ for i in [1, 2, 3]:
             }
         }
     }
+
+    fn edit(start: (u32, u32), end: (u32, u32), text: &str) -> TextDocumentContentChangeEvent {
+        TextDocumentContentChangeEvent {
+            range: Some(Range {
+                start: Position::new(start.0, start.1),
+                end: Position::new(end.0, end.1),
+            }),
+            range_length: None,
+            text: text.into(),
+        }
+    }
+
+    fn assert_line_starts_fresh(document: &TextDocument) {
+        assert_eq!(
+            document.line_starts,
+            TextDocument::new(document.version, document.text.clone()).line_starts
+        );
+    }
+
+    #[test]
+    fn test_incremental_document_edits() {
+        let mut document = TextDocument::new(1, "let x = 1\nlet y = 2\nprint(x)\n".into());
+
+        document.apply_change(edit((1, 4), (1, 5), "why\nlet z"));
+        assert_eq!(document.text, "let x = 1\nlet why\nlet z = 2\nprint(x)\n");
+        assert_eq!(
+            document.line_starts,
+            TextDocument::new(1, document.text.clone()).line_starts
+        );
+
+        document.apply_change(edit((0, 9), (2, 0), ""));
+        assert_eq!(document.text, "let x = 1let z = 2\nprint(x)\n");
+        assert_eq!(
+            document.line_starts,
+            TextDocument::new(1, document.text.clone()).line_starts
+        );
+
+        let print_offset = document.text.find("print").unwrap_or_default();
+        assert_eq!(document.position(print_offset), Position::new(1, 0));
+        assert_eq!(document.offset(Position::new(1, 0)), print_offset);
+    }
+
+    #[test]
+    fn test_multi_line_edit_replaces_lines() {
+        let mut document = TextDocument::new(1, "fn a():\n    pass\nfn b():\n    pass\n".into());
+
+        document.apply_change(edit((0, 3), (2, 3), "c():\n    return 1\n\nfn "));
+        assert_eq!(
+            document.text,
+            "fn c():\n    return 1\n\nfn b():\n    pass\n"
+        );
+        assert_line_starts_fresh(&document);
+        assert_eq!(document.position(document.text.len()), Position::new(5, 0));
+
+        document.apply_change(edit((1, 4), (4, 8), "pass"));
+        assert_eq!(document.text, "fn c():\n    pass\n");
+        assert_line_starts_fresh(&document);
+    }
+
+    #[test]
+    fn test_edits_count_utf16_code_units() {
+        // 'é' is one UTF-16 unit and two bytes; the emoji is two units and
+        // four bytes.
+        let mut document =
+            TextDocument::new(1, "let s = \"h\u{e9}llo \u{1F600}\"\nprint(s)\n".into());
+        let emoji = document.text.find('\u{1F600}').unwrap_or_default();
+        assert_eq!(document.position(emoji), Position::new(0, 15));
+        assert_eq!(document.offset(Position::new(0, 15)), emoji);
+        assert_eq!(document.position(emoji + 4), Position::new(0, 17));
+
+        document.apply_change(edit((0, 15), (0, 17), "w\u{f6}rld"));
+        assert_eq!(
+            document.text,
+            "let s = \"h\u{e9}llo w\u{f6}rld\"\nprint(s)\n"
+        );
+        assert_line_starts_fresh(&document);
+
+        document.apply_change(edit((1, 6), (1, 7), "\u{1F600}"));
+        assert_eq!(
+            document.text,
+            "let s = \"h\u{e9}llo w\u{f6}rld\"\nprint(\u{1F600})\n"
+        );
+        let close = document.text.rfind(')').unwrap_or_default();
+        assert_eq!(document.position(close), Position::new(1, 8));
+    }
+
+    #[test]
+    fn test_edits_at_end_of_document() {
+        let mut document = TextDocument::new(1, "let x = 1\n".into());
+
+        document.apply_change(edit((1, 0), (1, 0), "let y = 2"));
+        assert_eq!(document.text, "let x = 1\nlet y = 2");
+        assert_line_starts_fresh(&document);
+
+        document.apply_change(edit((1, 9), (1, 9), "\n"));
+        assert_eq!(document.text, "let x = 1\nlet y = 2\n");
+        assert_line_starts_fresh(&document);
+
+        // Positions past the end clamp to it.
+        document.apply_change(edit((7, 3), (9, 0), "print(y)\n"));
+        assert_eq!(document.text, "let x = 1\nlet y = 2\nprint(y)\n");
+        assert_line_starts_fresh(&document);
+        assert_eq!(document.position(document.text.len()), Position::new(3, 0));
+
+        document.apply_change(edit((1, 0), (3, 0), ""));
+        assert_eq!(document.text, "let x = 1\n");
+        assert_line_starts_fresh(&document);
+    }
 }
@@ -38,7 +38,7 @@ mod tests {
             "target/app",
         ]);
         match cli.command() {
-            Command::Build { path, output } => {
+            Command::Build { path, output, .. } => {
                 assert_eq!(path.to_string_lossy(), "examples/app.ot");
                 assert_eq!(
                     output.as_ref().map(|p| p.to_string_lossy().into_owned()),
@@ -0,0 +1,127 @@
+//! Passing-test cache for `otter test`
+//!
+//! A test is skipped when it passed on a previous run and none of its inputs
+//! have changed since: the compiler version, the relevant compilation settings,
+//! the test file, every module it transitively imports and its snapshot file.
+
+use anyhow::Result;
+use serde::{Deserialize, Serialize};
+use std::collections::HashMap;
+use std::fs;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
+
+use otterc_ast::nodes::Statement;
+use otterc_config::VERSION;
+use otterc_lexer::tokenize;
+use otterc_module::ModuleProcessor;
+use otterc_parser::parse;
+
+use crate::test::TestCase;
+use crate::test::snapshot::{content_hash, snapshot_path};
+
+#[derive(Debug, Default, Serialize, Deserialize)]
+pub struct ResultCache {
+    version: String,
+    /// `file::test` -> input fingerprint of the last passing run.
+    passed: HashMap<String, u64>,
+    #[serde(skip)]
+    location: Option<PathBuf>,
+}
+
+impl ResultCache {
+    /// Load the cache for the current working directory, or start an empty one
+    /// if there is none or it was written by another compiler version.
+    pub fn load() -> Self {
+        let location = Self::location();
+        let mut cache = location
+            .as_deref()
+            .and_then(|path| fs::read(path).ok())
+            .and_then(|bytes| serde_json::from_slice::<Self>(&bytes).ok())
+            .filter(|cache| cache.version == VERSION)
+            .unwrap_or_else(|| Self {
+                version: VERSION.to_string(),
+                ..Self::default()
+            });
+        cache.location = location;
+        cache
+    }
+
+    fn location() -> Option<PathBuf> {
+        let cwd = std::env::current_dir().ok()?;
+        let mut hasher = DefaultHasher::new();
+        cwd.canonicalize().unwrap_or(cwd).hash(&mut hasher);
+        let cache_dir = otterc_cache::cache_root().ok()?;
+        Some(
+            cache_dir
+                .join("test-results")
+                .join(format!("{:016x}.json", hasher.finish())),
+        )
+    }
+
+    pub fn is_fresh(&self, test: &TestCase, fingerprint: u64) -> bool {
+        self.passed.get(&Self::key(test)) == Some(&fingerprint)
+    }
+
+    pub fn record_pass(&mut self, test: &TestCase, fingerprint: u64) {
+        self.passed.insert(Self::key(test), fingerprint);
+    }
+
+    pub fn forget(&mut self, test: &TestCase) {
+        self.passed.remove(&Self::key(test));
+    }
+
+    pub fn save(&self) -> Result<()> {
+        let Some(path) = &self.location else {
+            return Ok(());
+        };
+        if let Some(parent) = path.parent() {
+            fs::create_dir_all(parent)?;
+        }
+        fs::write(path, serde_json::to_vec(self)?)?;
+        Ok(())
+    }
+
+    fn key(test: &TestCase) -> String {
+        format!("{}::{}", test.file_path.display(), test.function_name)
+    }
+}
+
+/// Fingerprint everything the tests in `file` depend on, mixed with `salt`.
+///
+/// Returns `None` when the inputs cannot be enumerated precisely — the file
+/// fails to parse, an import cannot be resolved, or it imports Rust crates
+/// whose sources we do not track — in which case the tests always run.
+pub fn input_fingerprint(file: &Path, stdlib_dir: Option<PathBuf>, salt: u64) -> Option<u64> {
+    let source = fs::read_to_string(file).ok()?;
+    let tokens = tokenize(&source).ok()?;
+    let program = parse(&tokens).ok()?;
+
+    let imports_rust = program.statements.iter().any(|statement| {
+        matches!(statement.as_ref(), Statement::Use { imports }
+            if imports.iter().any(|import| import.as_ref().module.starts_with("rust:")))
+    });
+    if imports_rust {
+        return None;
+    }
+
+    let source_dir = file.parent().unwrap_or(Path::new(".")).to_path_buf();
+    let mut processor = ModuleProcessor::new(source_dir, stdlib_dir);
+    let mut dependencies = processor.process_imports(&program).ok()?;
+    dependencies.sort();
+    dependencies.dedup();
+
+    let mut hasher = DefaultHasher::new();
+    VERSION.hash(&mut hasher);
+    salt.hash(&mut hasher);
+    content_hash(source.as_bytes()).hash(&mut hasher);
+    for dependency in &dependencies {
+        dependency.hash(&mut hasher);
+        content_hash(&fs::read(dependency).ok()?).hash(&mut hasher);
+    }
+    fs::read(snapshot_path(file))
+        .ok()
+        .map(|bytes| content_hash(&bytes))
+        .hash(&mut hasher);
+    Some(hasher.finish())
+}
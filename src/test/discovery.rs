@@ -3,9 +3,11 @@
     reason = "Printing to stderr is acceptable in tests"
 )]
 
-use anyhow::{Context, Result};
+use anyhow::{Context, Result, bail};
 use glob::glob;
+use rayon::prelude::*;
 use std::path::{Path, PathBuf};
+use std::str::FromStr;
 
 use otterc_ast::nodes::{Function, Statement};
 use otterc_lexer::tokenize;
@@ -19,6 +21,55 @@ pub struct TestCase {
     pub line_number: usize,
 }
 
+/// One slice of the test suite, written `i/n` on the command line (1-based).
+///
+/// Tests are assigned round-robin over the sorted `(file, name)` order, so every
+/// machine that sees the same tree computes the same partition.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Shard {
+    pub index: usize,
+    pub count: usize,
+}
+
+impl Shard {
+    pub fn select(&self, mut tests: Vec<TestCase>) -> Vec<TestCase> {
+        tests.sort_by(|a, b| {
+            (&a.file_path, &a.function_name).cmp(&(&b.file_path, &b.function_name))
+        });
+        tests
+            .into_iter()
+            .enumerate()
+            .filter(|(position, _)| position % self.count == self.index - 1)
+            .map(|(_, test)| test)
+            .collect()
+    }
+}
+
+impl FromStr for Shard {
+    type Err = anyhow::Error;
+
+    fn from_str(value: &str) -> Result<Self> {
+        let Some((index, count)) = value.split_once('/') else {
+            bail!("shard must be written as i/n, got '{value}'");
+        };
+        let index: usize = index
+            .trim()
+            .parse()
+            .with_context(|| format!("invalid shard index in '{value}'"))?;
+        let count: usize = count
+            .trim()
+            .parse()
+            .with_context(|| format!("invalid shard count in '{value}'"))?;
+        if count == 0 {
+            bail!("shard count must be at least 1, got '{value}'");
+        }
+        if index == 0 || index > count {
+            bail!("shard index must be between 1 and {count}, got '{value}'");
+        }
+        Ok(Self { index, count })
+    }
+}
+
 pub struct TestDiscovery {
     test_files: Vec<PathBuf>,
 }
@@ -82,11 +133,18 @@ impl TestDiscovery {
         Ok(tests)
     }
 
+    /// Parse every discovered file in parallel and collect its tests, keeping
+    /// the files in sorted order.
     pub fn discover_all_tests(&self) -> Result<Vec<TestCase>> {
-        let mut all_tests = Vec::new();
+        let per_file: Vec<_> = self
+            .test_files
+            .par_iter()
+            .map(|file_path| (file_path, self.discover_tests_in_file(file_path)))
+            .collect();
 
-        for file_path in &self.test_files {
-            match self.discover_tests_in_file(file_path) {
+        let mut all_tests = Vec::new();
+        for (file_path, result) in per_file {
+            match result {
                 Ok(tests) => all_tests.extend(tests),
                 Err(e) => {
                     eprintln!(
@@ -120,3 +178,20 @@ impl Default for TestDiscovery {
         Self::new()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn parses_shard_specs() {
+        assert_eq!(
+            "2/4".parse::<Shard>().ok(),
+            Some(Shard { index: 2, count: 4 })
+        );
+        assert!("0/4".parse::<Shard>().is_err());
+        assert!("5/4".parse::<Shard>().is_err());
+        assert!("1/0".parse::<Shard>().is_err());
+        assert!("3".parse::<Shard>().is_err());
+    }
+}
@@ -1,9 +1,11 @@
+pub mod cache;
 pub mod discovery;
 pub mod reporter;
 pub mod runner;
 pub mod snapshot;
 
-pub use discovery::{TestCase, TestDiscovery};
+pub use cache::ResultCache;
+pub use discovery::{Shard, TestCase, TestDiscovery};
 pub use reporter::{TestReporter, TestResult};
 pub use runner::TestRunner;
 pub use snapshot::SnapshotManager;
@@ -23,6 +23,8 @@ pub enum TestResult {
     Skipped {
         reason: String,
     },
+    /// Passed on an earlier run and none of its inputs have changed since.
+    Cached,
 }
 
 pub struct TestReporter {
@@ -93,6 +95,10 @@ impl TestReporter {
                 print!("{}", "⊘".yellow());
                 println!(" {} ({})", test.function_name, reason);
             }
+            TestResult::Cached => {
+                print!("{}", "✓".green());
+                println!(" {} {}", test.function_name, "(cached)".dimmed());
+            }
         }
     }
 
@@ -101,7 +107,12 @@ impl TestReporter {
         let passed = self
             .results
             .iter()
-            .filter(|(_, r)| matches!(r, TestResult::Passed { .. }))
+            .filter(|(_, r)| matches!(r, TestResult::Passed { .. } | TestResult::Cached))
+            .count();
+        let cached = self
+            .results
+            .iter()
+            .filter(|(_, r)| matches!(r, TestResult::Cached))
             .count();
         let failed = self
             .results
@@ -117,7 +128,11 @@ impl TestReporter {
 
         println!("\n{}", "Test Summary".bold());
         println!("  Total:   {}", total);
-        println!("  {} {}", "Passed:".green(), passed);
+        if cached > 0 {
+            println!("  {} {} ({} cached)", "Passed:".green(), passed, cached);
+        } else {
+            println!("  {} {}", "Passed:".green(), passed);
+        }
         println!("  {} {}", "Failed:".red(), failed);
         if skipped > 0 {
             println!("  {} {}", "Skipped:".yellow(), skipped);
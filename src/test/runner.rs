@@ -1,14 +1,21 @@
 use anyhow::{Context, Result};
-use std::path::Path;
-use std::process::Command;
-use std::time::Instant;
+use rayon::prelude::*;
+use std::collections::HashMap;
+use std::io::Read;
+use std::path::{Path, PathBuf};
+use std::process::{Child, Command, ExitStatus, Stdio};
+use std::thread;
+use std::time::{Duration, Instant};
 
 use crate::cli::CompilationSettings;
+use crate::test::cache::{ResultCache, input_fingerprint};
 use crate::test::{TestCase, TestResult};
 
 pub struct TestRunner {
     settings: CompilationSettings,
     update_snapshots: bool,
+    timeout: Option<Duration>,
+    result_cache: bool,
 }
 
 impl TestRunner {
@@ -16,25 +23,126 @@ impl TestRunner {
         Self {
             settings,
             update_snapshots,
+            timeout: None,
+            result_cache: false,
         }
     }
 
+    /// Kill and fail any test process that runs longer than `timeout`.
+    pub fn with_timeout(mut self, timeout: Option<Duration>) -> Self {
+        self.timeout = timeout;
+        self
+    }
+
+    /// Skip tests that passed last time and whose inputs are unchanged.
+    pub fn with_result_cache(mut self, enabled: bool) -> Self {
+        self.result_cache = enabled && !self.update_snapshots;
+        self
+    }
+
+    /// Compile and run a single test.
     pub fn run_test(&self, test: &TestCase) -> TestResult {
         let start = Instant::now();
+        match self.compile_test_file(&test.file_path) {
+            Ok(binary) => self.run_compiled(test, &binary),
+            Err(e) => Self::compile_failure(test, &format!("{e}"), start.elapsed()),
+        }
+    }
 
-        let compile_result = self.compile_test_file(&test.file_path);
-        if let Err(e) = compile_result {
-            return TestResult::Failed {
-                error: format!("Compilation failed: {}", e),
-                duration: start.elapsed(),
-                output: String::new(),
-                span: Some((test.line_number, test.line_number)),
-            };
+    /// Run `tests` on `jobs` worker threads, each test in its own process.
+    ///
+    /// Every test file is compiled once up front; the binaries are then shared by
+    /// all tests of that file. Results come back in the order of `tests`.
+    pub fn run_all(
+        &self,
+        tests: Vec<TestCase>,
+        jobs: usize,
+    ) -> Result<Vec<(TestCase, TestResult)>> {
+        let pool = rayon::ThreadPoolBuilder::new()
+            .num_threads(jobs.max(1))
+            .build()
+            .context("failed to start the test worker pool")?;
+
+        let mut files: Vec<&Path> = tests.iter().map(|test| test.file_path.as_path()).collect();
+        files.sort_unstable();
+        files.dedup();
+
+        let mut cache = self.result_cache.then(ResultCache::load);
+        let fingerprints: HashMap<&Path, u64> = if cache.is_some() {
+            let stdlib_dir = crate::cli::find_stdlib_dir().ok();
+            let salt = self.settings.result_cache_salt();
+            pool.install(|| {
+                files
+                    .par_iter()
+                    .filter_map(|&file| {
+                        input_fingerprint(file, stdlib_dir.clone(), salt)
+                            .map(|fingerprint| (file, fingerprint))
+                    })
+                    .collect()
+            })
+        } else {
+            HashMap::new()
+        };
+
+        let is_fresh = |test: &TestCase| {
+            cache.as_ref().is_some_and(|cache| {
+                fingerprints
+                    .get(test.file_path.as_path())
+                    .is_some_and(|&fingerprint| cache.is_fresh(test, fingerprint))
+            })
+        };
+
+        // Compilation shares the pipeline's output path and global symbol
+        // registries, so it stays serial; only test execution fans out.
+        let mut binaries: HashMap<&Path, Result<PathBuf, (String, Duration)>> = HashMap::new();
+        for test in &tests {
+            let file = test.file_path.as_path();
+            if is_fresh(test) || binaries.contains_key(file) {
+                continue;
+            }
+            let start = Instant::now();
+            let binary = self
+                .compile_test_file(file)
+                .map_err(|e| (format!("{e}"), start.elapsed()));
+            binaries.insert(file, binary);
         }
 
-        let binary_path = compile_result.unwrap();
+        let results: Vec<TestResult> = pool.install(|| {
+            tests
+                .par_iter()
+                .map(|test| {
+                    if is_fresh(test) {
+                        return TestResult::Cached;
+                    }
+                    match &binaries[test.file_path.as_path()] {
+                        Ok(binary) => self.run_compiled(test, binary),
+                        Err((error, duration)) => Self::compile_failure(test, error, *duration),
+                    }
+                })
+                .collect()
+        });
 
-        let mut command = Command::new(&binary_path);
+        if let Some(cache) = cache.as_mut() {
+            for (test, result) in tests.iter().zip(&results) {
+                match (result, fingerprints.get(test.file_path.as_path())) {
+                    (TestResult::Passed { .. }, Some(&fingerprint)) => {
+                        cache.record_pass(test, fingerprint);
+                    }
+                    (TestResult::Cached, _) => {}
+                    _ => cache.forget(test),
+                }
+            }
+            // The cache only saves time; failing to persist it must not fail the run.
+            let _ = cache.save();
+        }
+
+        Ok(tests.into_iter().zip(results).collect())
+    }
+
+    fn run_compiled(&self, test: &TestCase, binary_path: &Path) -> TestResult {
+        let start = Instant::now();
+
+        let mut command = Command::new(binary_path);
         self.settings.apply_runtime_env(&mut command);
         command.env("OTTER_TEST_MODE", "1");
         command.env("OTTER_TEST_NAME", &test.function_name);
@@ -42,34 +150,40 @@ impl TestRunner {
             command.env("OTTER_UPDATE_SNAPSHOTS", "1");
         }
 
-        let output = command.output();
+        let output = self.execute(command);
         let duration = start.elapsed();
 
         match output {
             Ok(output) => {
-                let stdout = String::from_utf8_lossy(&output.stdout).to_string();
-                let stderr = String::from_utf8_lossy(&output.stderr).to_string();
-                let combined_output = if stderr.is_empty() {
-                    stdout
+                let combined_output = if output.stderr.is_empty() {
+                    output.stdout
                 } else {
-                    format!("{}\n{}", stdout, stderr)
+                    format!("{}\n{}", output.stdout, output.stderr)
                 };
 
-                if output.status.success() {
-                    TestResult::Passed {
+                match output.status {
+                    Some(status) if status.success() => TestResult::Passed {
                         duration,
                         output: combined_output,
-                    }
-                } else {
-                    TestResult::Failed {
+                    },
+                    Some(status) => TestResult::Failed {
                         error: format!(
                             "Test failed with exit code {}",
-                            output.status.code().unwrap_or(-1)
+                            status.code().unwrap_or(-1)
                         ),
                         duration,
                         output: combined_output,
                         span: Some((test.line_number, test.line_number)),
-                    }
+                    },
+                    None => TestResult::Failed {
+                        error: format!(
+                            "Test timed out after {:.1}s",
+                            self.timeout.unwrap_or_default().as_secs_f64()
+                        ),
+                        duration,
+                        output: combined_output,
+                        span: Some((test.line_number, test.line_number)),
+                    },
                 }
             }
             Err(e) => TestResult::Failed {
@@ -81,7 +195,51 @@ impl TestRunner {
         }
     }
 
-    fn compile_test_file(&self, file_path: &Path) -> Result<std::path::PathBuf> {
+    /// Run `command` to completion, or kill it once the timeout expires. The
+    /// returned status is `None` when the process was killed.
+    fn execute(&self, mut command: Command) -> std::io::Result<ProcessOutput> {
+        command.stdout(Stdio::piped()).stderr(Stdio::piped());
+        let mut child = command.spawn()?;
+
+        // Drain both pipes concurrently so a chatty test cannot block on a full pipe.
+        let stdout = child
+            .stdout
+            .take()
+            .map(|pipe| thread::spawn(move || read_pipe(pipe)));
+        let stderr = child
+            .stderr
+            .take()
+            .map(|pipe| thread::spawn(move || read_pipe(pipe)));
+
+        let status = match self.timeout {
+            Some(timeout) => wait_with_timeout(&mut child, timeout)?,
+            None => Some(child.wait()?),
+        };
+
+        let join = |reader: Option<thread::JoinHandle<String>>| {
+            reader
+                .and_then(|reader| reader.join().ok())
+                .unwrap_or_default()
+        };
+        Ok(ProcessOutput {
+            status,
+            stdout: join(stdout),
+            stderr: join(stderr),
+        })
+    }
+
+    fn compile_failure(test: &TestCase, error: &str, duration: Duration) -> TestResult {
+        TestResult::Failed {
+            error: format!("Compilation failed: {}", error),
+            duration,
+            output: String::new(),
+            span: Some((test.line_number, test.line_number)),
+        }
+    }
+
+    /// Compile `file_path` and move the binary to a location owned by this file,
+    /// since the pipeline reuses one output path for every uncached build.
+    fn compile_test_file(&self, file_path: &Path) -> Result<PathBuf> {
         use crate::cli::{compile_pipeline, read_source};
 
         let source = read_source(file_path)?;
@@ -89,13 +247,53 @@ impl TestRunner {
             .with_context(|| format!("failed to compile test file {}", file_path.display()))?;
 
         let binary_path = match &stage.result {
-            crate::cli::CompilationResult::CacheHit(entry) => entry.binary_path.clone(),
+            crate::cli::CompilationResult::CacheHit(entry) => return Ok(entry.binary_path.clone()),
             crate::cli::CompilationResult::Compiled { artifact, .. } => artifact.binary.clone(),
             crate::cli::CompilationResult::Checked => {
                 unreachable!("check_only should be false for tests")
             }
         };
 
-        Ok(binary_path)
+        let test_binary = PathBuf::from("./target/otter-test").join(format!(
+            "{}-{}",
+            file_path.file_stem().unwrap_or_default().to_string_lossy(),
+            otterc_cache::cache_key_for_file(file_path)
+        ));
+        std::fs::create_dir_all("./target/otter-test")?;
+        std::fs::rename(&binary_path, &test_binary)
+            .or_else(|_| std::fs::copy(&binary_path, &test_binary).map(|_| ()))
+            .with_context(|| format!("failed to stage test binary {}", test_binary.display()))?;
+
+        Ok(test_binary)
+    }
+}
+
+struct ProcessOutput {
+    status: Option<ExitStatus>,
+    stdout: String,
+    stderr: String,
+}
+
+fn read_pipe(mut pipe: impl Read) -> String {
+    let mut bytes = Vec::new();
+    let _ = pipe.read_to_end(&mut bytes);
+    String::from_utf8_lossy(&bytes).into_owned()
+}
+
+fn wait_with_timeout(child: &mut Child, timeout: Duration) -> std::io::Result<Option<ExitStatus>> {
+    let deadline = Instant::now() + timeout;
+    let mut poll = Duration::from_millis(1);
+    loop {
+        if let Some(status) = child.try_wait()? {
+            return Ok(Some(status));
+        }
+        let now = Instant::now();
+        if now >= deadline {
+            let _ = child.kill();
+            let _ = child.wait();
+            return Ok(None);
+        }
+        thread::sleep(poll.min(deadline - now));
+        poll = (poll * 2).min(Duration::from_millis(50));
     }
 }
@@ -2,14 +2,38 @@ use anyhow::{Context, Result};
 use serde::{Deserialize, Serialize};
 use std::collections::HashMap;
 use std::fs;
+use std::hash::{DefaultHasher, Hash, Hasher};
 use std::path::{Path, PathBuf};
 
+/// Snapshots are compared by content hash; the stored text is only consulted
+/// to report a mismatch.
 pub struct SnapshotManager {
-    snapshot_dir: PathBuf,
     snapshots: HashMap<String, String>,
+    hashes: HashMap<String, u64>,
+    /// Hash of the snapshot file as loaded, so an unchanged file is not rewritten.
+    file_hash: Option<u64>,
     update_mode: bool,
 }
 
+/// Content hash used for snapshot values, snapshot files and test fingerprints.
+pub fn content_hash(bytes: &[u8]) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    bytes.hash(&mut hasher);
+    hasher.finish()
+}
+
+/// The `.snap` file that holds the snapshots of `test_file`.
+pub fn snapshot_path(test_file: &Path) -> PathBuf {
+    test_file
+        .parent()
+        .unwrap_or(Path::new("."))
+        .join("__snapshots__")
+        .join(format!(
+            "{}.snap",
+            test_file.file_stem().unwrap_or_default().to_string_lossy()
+        ))
+}
+
 #[derive(Debug, Serialize, Deserialize)]
 struct SnapshotFile {
     snapshots: HashMap<String, String>,
@@ -29,20 +53,25 @@ impl SnapshotManager {
             )
         })?;
 
-        let snapshot_file = snapshot_dir.join(format!(
-            "{}.snap",
-            test_file.file_stem().unwrap_or_default().to_string_lossy()
-        ));
+        let snapshot_file = snapshot_path(test_file);
+        let file_hash = fs::read(&snapshot_file)
+            .ok()
+            .map(|bytes| content_hash(&bytes));
 
         let snapshots = if update_mode {
             HashMap::new()
         } else {
             Self::load_snapshots(&snapshot_file)?
         };
+        let hashes = snapshots
+            .iter()
+            .map(|(name, value)| (name.clone(), content_hash(value.as_bytes())))
+            .collect();
 
         Ok(Self {
-            snapshot_dir,
             snapshots,
+            hashes,
+            file_hash,
             update_mode,
         })
     }
@@ -66,10 +95,7 @@ impl SnapshotManager {
             return Ok(());
         }
 
-        let snapshot_file = self.snapshot_dir.join(format!(
-            "{}.snap",
-            test_file.file_stem().unwrap_or_default().to_string_lossy()
-        ));
+        let snapshot_file = snapshot_path(test_file);
 
         let snapshot_data = SnapshotFile {
             snapshots: self.snapshots.clone(),
@@ -77,6 +103,9 @@ impl SnapshotManager {
 
         let content = serde_json::to_string_pretty(&snapshot_data)
             .context("failed to serialize snapshots")?;
+        if self.file_hash == Some(content_hash(content.as_bytes())) {
+            return Ok(());
+        }
 
         fs::write(&snapshot_file, content).with_context(|| {
             format!("failed to write snapshot file {}", snapshot_file.display())
@@ -86,22 +115,19 @@ impl SnapshotManager {
     }
 
     pub fn assert_snapshot(&mut self, name: &str, value: &str) -> Result<SnapshotResult> {
+        let hash = content_hash(value.as_bytes());
         if self.update_mode {
             self.snapshots.insert(name.to_string(), value.to_string());
+            self.hashes.insert(name.to_string(), hash);
             return Ok(SnapshotResult::Updated);
         }
 
-        match self.snapshots.get(name) {
-            Some(expected) => {
-                if expected == value {
-                    Ok(SnapshotResult::Match)
-                } else {
-                    Ok(SnapshotResult::Mismatch {
-                        expected: expected.clone(),
-                        actual: value.to_string(),
-                    })
-                }
-            }
+        match self.hashes.get(name) {
+            Some(&expected) if expected == hash => Ok(SnapshotResult::Match),
+            Some(_) => Ok(SnapshotResult::Mismatch {
+                expected: self.snapshots.get(name).cloned().unwrap_or_default(),
+                actual: value.to_string(),
+            }),
             None => Ok(SnapshotResult::Missing {
                 actual: value.to_string(),
             }),
@@ -0,0 +1,256 @@
+#![expect(
+    clippy::print_stdout,
+    clippy::print_stderr,
+    reason = "TODO: Use robust logging"
+)]
+
+//! `otter bench` driver
+//!
+//! Discovers zero-argument `bench_*` functions, JIT-compiles each file once and
+//! times the functions in-process with `otterc_runtime::benchmark`: a timed
+//! warm-up, batched samples sized to the function's cost, and Tukey outlier
+//! rejection. Every run is saved as a baseline under `target/otter-bench/` and
+//! compared to the previous one with Welch's t-test.
+
+use std::collections::BTreeMap;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::time::Duration;
+
+use anyhow::{Context, Result, bail};
+use colored::Colorize;
+
+use otterc_ast::nodes::{Program, Statement};
+use otterc_jit::JitEngine;
+use otterc_lexer::tokenize;
+use otterc_parser::parse;
+use otterc_runtime::benchmark::{
+    Benchmark, BenchmarkResult, Comparison, Verdict, compare_significance,
+};
+use otterc_symbol::registry::SymbolRegistry;
+
+use crate::test::TestDiscovery;
+
+/// Baseline every run is saved under unless `--save-baseline` names another.
+const LATEST_BASELINE: &str = "latest";
+/// Significance level for reporting a change.
+const ALPHA: f64 = 0.05;
+/// Relative changes below this are reported as noise even when significant.
+const NOISE_THRESHOLD: f64 = 0.02;
+
+#[derive(clap::Args, Debug)]
+pub struct BenchArgs {
+    /// Files or directories to search for `bench_*` functions
+    #[arg(default_value = ".")]
+    paths: Vec<PathBuf>,
+    /// Only run benchmarks whose name contains this string
+    #[arg(long)]
+    filter: Option<String>,
+    /// Number of samples per benchmark
+    #[arg(long, default_value_t = 50)]
+    samples: usize,
+    /// Warm-up time per benchmark, in seconds
+    #[arg(long, value_name = "SECS", default_value_t = 0.3)]
+    warmup: f64,
+    /// Measurement time per benchmark, in seconds
+    #[arg(long, value_name = "SECS", default_value_t = 1.0)]
+    measurement_time: f64,
+    /// Compare against this saved baseline (defaults to the previous run)
+    #[arg(long, value_name = "NAME")]
+    baseline: Option<String>,
+    /// Save this run under NAME instead of as the latest run
+    #[arg(long, value_name = "NAME")]
+    save_baseline: Option<String>,
+}
+
+struct BenchFile {
+    path: PathBuf,
+    program: Program,
+    benches: Vec<String>,
+}
+
+pub fn run(args: &BenchArgs) -> Result<()> {
+    let warmup = seconds(args.warmup, "--warmup")?;
+    let measurement_time = seconds(args.measurement_time, "--measurement-time")?;
+
+    let files = discover(args)?;
+    let total: usize = files.iter().map(|file| file.benches.len()).sum();
+    if total == 0 {
+        println!("No benchmarks found");
+        return Ok(());
+    }
+    println!("Running {} benchmark(s)...\n", total);
+
+    let baseline_name = args.baseline.as_deref().unwrap_or(LATEST_BASELINE);
+    let baseline = load_baseline(baseline_name);
+    if args.baseline.is_some() && baseline.is_empty() {
+        bail!("baseline '{}' not found", baseline_name);
+    }
+
+    let mut results = BTreeMap::new();
+    for file in files {
+        let mut engine = JitEngine::new(SymbolRegistry::global())?;
+        engine
+            .compile_program(file.program)
+            .with_context(|| format!("failed to compile {}", file.path.display()))?;
+
+        for name in file.benches {
+            let function = engine.nullary_function(&name)?;
+            let result = Benchmark::new(name.clone())
+                .iterations(args.samples.max(2))
+                .warmup_time(warmup)
+                .measurement_time(measurement_time)
+                .run(|| {
+                    std::hint::black_box(function.call());
+                });
+
+            let key = format!("{}::{}", file.path.display(), name);
+            let comparison = baseline.get(&key).and_then(|previous| {
+                compare_significance(previous, &result, ALPHA, NOISE_THRESHOLD)
+            });
+            print_result(&result, comparison.as_ref());
+            results.insert(key, result);
+        }
+    }
+
+    let save_name = args.save_baseline.as_deref().unwrap_or(LATEST_BASELINE);
+    if let Err(err) = save_baseline(save_name, &results) {
+        eprintln!("Warning: failed to save baseline '{}': {}", save_name, err);
+    }
+
+    Ok(())
+}
+
+fn seconds(value: f64, flag: &str) -> Result<Duration> {
+    if !value.is_finite() || value <= 0.0 {
+        bail!("{flag} must be a positive number of seconds, got {value}");
+    }
+    Ok(Duration::from_secs_f64(value))
+}
+
+/// Parse every candidate file and keep those that declare benchmarks.
+fn discover(args: &BenchArgs) -> Result<Vec<BenchFile>> {
+    let mut discovery = TestDiscovery::new();
+    let mut files = Vec::new();
+
+    for path in discovery.discover_files(&args.paths)? {
+        let source = fs::read_to_string(&path)
+            .with_context(|| format!("failed to read {}", path.display()))?;
+        let Ok(tokens) = tokenize(&source) else {
+            continue;
+        };
+        let Ok(program) = parse(&tokens) else {
+            continue;
+        };
+
+        let mut benches = Vec::new();
+        for statement in &program.statements {
+            let Statement::Function(function) = statement.as_ref() else {
+                continue;
+            };
+            let function = function.as_ref();
+            if !function.name.starts_with("bench_") {
+                continue;
+            }
+            if args
+                .filter
+                .as_deref()
+                .is_some_and(|filter| !function.name.contains(filter))
+            {
+                continue;
+            }
+            if !function.params.is_empty() {
+                eprintln!(
+                    "Warning: skipping {} in {}: benchmarks must take no arguments",
+                    function.name,
+                    path.display()
+                );
+                continue;
+            }
+            benches.push(function.name.clone());
+        }
+
+        if !benches.is_empty() {
+            files.push(BenchFile {
+                path,
+                program,
+                benches,
+            });
+        }
+    }
+
+    Ok(files)
+}
+
+fn print_result(result: &BenchmarkResult, comparison: Option<&Comparison>) {
+    let mut line = format!(
+        "{:<32} time: {:>10} ± {:<10} thrpt: {}",
+        result.name.bold(),
+        format!("{:.2?}", result.stats.median),
+        format!("{:.2?}", result.stats.std_dev),
+        format_rate(result.throughput()),
+    );
+    if result.outliers > 0 {
+        line.push_str(
+            &format!(" ({} outliers)", result.outliers)
+                .dimmed()
+                .to_string(),
+        );
+    }
+    println!("{line}");
+
+    if let Some(comparison) = comparison {
+        let change = format!(
+            "{:+.2}% (p = {:.3})",
+            comparison.change * 100.0,
+            comparison.p_value
+        );
+        let verdict = match comparison.verdict {
+            Verdict::Improved => format!("{change} improved").green(),
+            Verdict::Regressed => format!("{change} regressed").red(),
+            Verdict::NoChange => format!("{change} no significant change").normal(),
+        };
+        println!("{:<32} change: {}", "", verdict);
+    }
+}
+
+fn format_rate(per_second: f64) -> String {
+    if per_second >= 1e9 {
+        format!("{:.2} G calls/s", per_second / 1e9)
+    } else if per_second >= 1e6 {
+        format!("{:.2} M calls/s", per_second / 1e6)
+    } else if per_second >= 1e3 {
+        format!("{:.2} K calls/s", per_second / 1e3)
+    } else {
+        format!("{:.2} calls/s", per_second)
+    }
+}
+
+fn baseline_path(name: &str) -> PathBuf {
+    Path::new("target")
+        .join("otter-bench")
+        .join(format!("{name}.json"))
+}
+
+fn load_baseline(name: &str) -> BTreeMap<String, BenchmarkResult> {
+    fs::read(baseline_path(name))
+        .ok()
+        .and_then(|bytes| serde_json::from_slice(&bytes).ok())
+        .unwrap_or_default()
+}
+
+fn save_baseline(name: &str, results: &BTreeMap<String, BenchmarkResult>) -> Result<()> {
+    let path = baseline_path(name);
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    // Keep entries for benchmarks that were filtered out of this run.
+    let mut merged = load_baseline(name);
+    merged.extend(
+        results
+            .iter()
+            .map(|(key, result)| (key.clone(), result.clone())),
+    );
+    fs::write(&path, serde_json::to_vec_pretty(&merged)?)
+        .with_context(|| format!("failed to write {}", path.display()))
+}
@@ -0,0 +1,280 @@
+#![expect(clippy::print_stdout, reason = "TODO: Use robust logging")]
+
+//! `otter fmt` driver
+//!
+//! Walks the requested paths in parallel, formats every `.ot` file on the rayon
+//! pool and only rewrites files whose output differs. A per-workspace cache of
+//! content hashes remembers which files were already formatted, so repeat runs
+//! over a large tree only tokenize and parse the files that actually changed.
+
+use std::collections::HashMap;
+use std::fs;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+
+use anyhow::{Context, Result, bail};
+use rayon::prelude::*;
+use serde::{Deserialize, Serialize};
+
+use otterc_config::VERSION;
+use otterc_fmt::Formatter;
+use otterc_lexer::tokenize;
+use otterc_parser::parse;
+
+/// What happened to a single file during a run.
+enum FileOutcome {
+    /// The content hash matched the cache; the file was not parsed.
+    Cached,
+    /// The file was parsed and is already formatted.
+    Clean(u64),
+    /// The file was rewritten; carries the hash of the new content.
+    Rewritten(u64),
+    /// `--check` found a difference; the file was left untouched.
+    NeedsFormatting,
+}
+
+/// Content hashes of files known to be formatted, keyed by path.
+///
+/// Entries are only trusted when written by the same compiler version, since a
+/// formatter change can make previously clean files dirty again.
+#[derive(Debug, Default, Serialize, Deserialize)]
+struct FormatCache {
+    version: String,
+    files: HashMap<PathBuf, u64>,
+}
+
+impl FormatCache {
+    fn location() -> Option<PathBuf> {
+        let cwd = std::env::current_dir().ok()?;
+        let mut hasher = DefaultHasher::new();
+        cwd.canonicalize().unwrap_or(cwd).hash(&mut hasher);
+        let cache_dir = otterc_cache::cache_root().ok()?;
+        Some(
+            cache_dir
+                .join("fmt")
+                .join(format!("{:016x}.json", hasher.finish())),
+        )
+    }
+
+    fn load(path: Option<&Path>) -> Self {
+        path.and_then(|path| fs::read(path).ok())
+            .and_then(|bytes| serde_json::from_slice::<Self>(&bytes).ok())
+            .filter(|cache| cache.version == VERSION)
+            .unwrap_or_else(|| Self {
+                version: VERSION.to_string(),
+                files: HashMap::new(),
+            })
+    }
+
+    fn save(&mut self, path: &Path) -> Result<()> {
+        self.files.retain(|file, _| file.exists());
+        let bytes = serde_json::to_vec(&*self)?;
+        write_atomic(path, &bytes)
+    }
+}
+
+/// Format `paths` (files or directories). With `check`, nothing is written and
+/// the run fails as soon as any file is found to need formatting.
+pub fn run(paths: &[PathBuf], check: bool) -> Result<()> {
+    if !check {
+        println!("Formatting OtterLang files...");
+    }
+
+    let files = collect_files(paths);
+    let cache_path = FormatCache::location();
+    let mut cache = FormatCache::load(cache_path.as_deref());
+    let formatter = Formatter::new();
+    let stop = AtomicBool::new(false);
+
+    let mut outcomes = files
+        .par_iter()
+        .filter_map(|path| {
+            if stop.load(Ordering::Relaxed) {
+                return None;
+            }
+            let outcome = format_file(&formatter, path, cache.files.get(path).copied(), check);
+            if matches!(outcome, Ok(FileOutcome::NeedsFormatting) | Err(_)) {
+                stop.store(true, Ordering::Relaxed);
+            }
+            Some(outcome.map(|outcome| (path, outcome)))
+        })
+        .collect::<Result<Vec<_>>>()?;
+    outcomes.sort_unstable_by(|a, b| a.0.cmp(b.0));
+
+    let mut changed = Vec::new();
+    for (path, outcome) in outcomes {
+        match outcome {
+            FileOutcome::Cached => {}
+            FileOutcome::Clean(hash) => {
+                cache.files.insert(path.clone(), hash);
+            }
+            FileOutcome::Rewritten(hash) => {
+                cache.files.insert(path.clone(), hash);
+                changed.push(path);
+            }
+            FileOutcome::NeedsFormatting => changed.push(path),
+        }
+    }
+
+    if let Some(cache_path) = &cache_path {
+        // The cache is an optimisation only; a failed save must not fail the run.
+        let _ = cache.save(cache_path);
+    }
+
+    if check {
+        if let Some(first) = changed.first() {
+            bail!("{} is not formatted", first.display());
+        }
+        println!("All files are formatted");
+        return Ok(());
+    }
+
+    for path in &changed {
+        println!("  {}", path.display());
+    }
+    if changed.is_empty() {
+        println!("All files are already formatted");
+    } else {
+        println!("\nFormatted {} file(s)", changed.len());
+    }
+
+    Ok(())
+}
+
+fn format_file(
+    formatter: &Formatter,
+    path: &Path,
+    cached_hash: Option<u64>,
+    check: bool,
+) -> Result<FileOutcome> {
+    let bytes = fs::read(path).with_context(|| format!("failed to read {}", path.display()))?;
+    let hash = content_hash(&bytes);
+    if cached_hash == Some(hash) {
+        return Ok(FileOutcome::Cached);
+    }
+
+    let source = String::from_utf8(bytes)
+        .with_context(|| format!("{} is not valid UTF-8", path.display()))?;
+
+    #[expect(
+        clippy::map_err_ignore,
+        reason = "TODO: Use the provided error when reporting"
+    )]
+    let tokens =
+        tokenize(&source).map_err(|_| anyhow::anyhow!("failed to tokenize {}", path.display()))?;
+
+    #[expect(
+        clippy::map_err_ignore,
+        reason = "TODO: Use the provided error when reporting"
+    )]
+    let program =
+        parse(&tokens).map_err(|_| anyhow::anyhow!("failed to parse {}", path.display()))?;
+
+    let formatted = formatter.format_program(&program);
+    if formatted == source {
+        return Ok(FileOutcome::Clean(hash));
+    }
+    if check {
+        return Ok(FileOutcome::NeedsFormatting);
+    }
+
+    write_atomic(path, formatted.as_bytes())?;
+    Ok(FileOutcome::Rewritten(content_hash(formatted.as_bytes())))
+}
+
+fn content_hash(bytes: &[u8]) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    bytes.hash(&mut hasher);
+    hasher.finish()
+}
+
+/// Replace `path` by writing a sibling temporary file and renaming it over the
+/// original, so an interrupted run never leaves a truncated source file.
+fn write_atomic(path: &Path, contents: &[u8]) -> Result<()> {
+    let file_name = path
+        .file_name()
+        .with_context(|| format!("invalid path {}", path.display()))?;
+    let mut tmp_name = std::ffi::OsString::from(".");
+    tmp_name.push(file_name);
+    tmp_name.push(".otterfmt.tmp");
+    let tmp_path = path.with_file_name(tmp_name);
+
+    if let Some(parent) = path
+        .parent()
+        .filter(|parent| !parent.as_os_str().is_empty())
+    {
+        fs::create_dir_all(parent)
+            .with_context(|| format!("failed to create {}", parent.display()))?;
+    }
+    fs::write(&tmp_path, contents)
+        .with_context(|| format!("failed to write {}", tmp_path.display()))?;
+    if let Ok(metadata) = fs::metadata(path) {
+        let _ = fs::set_permissions(&tmp_path, metadata.permissions());
+    }
+    fs::rename(&tmp_path, path).with_context(|| {
+        let _ = fs::remove_file(&tmp_path);
+        format!("failed to write {}", path.display())
+    })
+}
+
+/// Expand the command-line paths into a sorted list of `.ot` files.
+fn collect_files(paths: &[PathBuf]) -> Vec<PathBuf> {
+    let default = [PathBuf::from(".")];
+    let paths = if paths.is_empty() {
+        &default[..]
+    } else {
+        paths
+    };
+
+    let mut files: Vec<PathBuf> = paths
+        .par_iter()
+        .flat_map_iter(|path| {
+            if path.is_dir() {
+                walk_dir(path)
+            } else if is_source(path) {
+                vec![path.clone()]
+            } else {
+                Vec::new()
+            }
+        })
+        .map(|path| match path.strip_prefix(".") {
+            Ok(relative) => relative.to_path_buf(),
+            Err(_) => path,
+        })
+        .collect();
+    files.sort_unstable();
+    files.dedup();
+    files
+}
+
+/// Recursively list `.ot` files under `dir`, descending into subdirectories in
+/// parallel. Hidden and `target` directories are skipped, matching the LSP
+/// workspace scan.
+fn walk_dir(dir: &Path) -> Vec<PathBuf> {
+    let Ok(entries) = fs::read_dir(dir) else {
+        return Vec::new();
+    };
+
+    let mut files = Vec::new();
+    let mut subdirs = Vec::new();
+    for entry in entries.flatten() {
+        let path = entry.path();
+        if entry.file_type().is_ok_and(|kind| kind.is_dir()) {
+            let name = entry.file_name();
+            let name = name.to_string_lossy();
+            if !name.starts_with('.') && name != "target" {
+                subdirs.push(path);
+            }
+        } else if is_source(&path) {
+            files.push(path);
+        }
+    }
+
+    files.par_extend(subdirs.par_iter().flat_map_iter(|subdir| walk_dir(subdir)));
+    files
+}
+
+fn is_source(path: &Path) -> bool {
+    path.extension().is_some_and(|ext| ext == "ot")
+}
@@ -1,7 +1,9 @@
 //! Developer tools for OtterLang
 //!
-//! Includes profiler tools
+//! Includes the formatter and benchmark drivers and profiler tools
 
+pub mod bench;
+pub mod fmt;
 pub mod profiler;
 
 // LSP server requires tower-lsp dependency (optional feature)